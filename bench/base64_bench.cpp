@@ -0,0 +1,90 @@
+#include "openai/utils/base64.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::string encode(const std::vector<std::uint8_t>& data) {
+  static constexpr char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  out.reserve((data.size() + 2) / 3 * 4);
+  std::size_t i = 0;
+  for (; i + 3 <= data.size(); i += 3) {
+    const std::uint32_t word = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+    out += kAlphabet[(word >> 18) & 0x3F];
+    out += kAlphabet[(word >> 12) & 0x3F];
+    out += kAlphabet[(word >> 6) & 0x3F];
+    out += kAlphabet[word & 0x3F];
+  }
+  if (data.size() - i == 1) {
+    out += kAlphabet[data[i] >> 2];
+    out += kAlphabet[(data[i] & 0x03) << 4];
+    out += "==";
+  } else if (data.size() - i == 2) {
+    out += kAlphabet[data[i] >> 2];
+    out += kAlphabet[((data[i] & 0x03) << 4) | (data[i + 1] >> 4)];
+    out += kAlphabet[(data[i + 1] & 0x0F) << 2];
+    out += '=';
+  }
+  return out;
+}
+
+template <typename Run>
+double measure_us(std::size_t rounds, Run run) {
+  const auto start = Clock::now();
+  float checksum = 0.0f;
+  for (std::size_t round = 0; round < rounds; ++round) {
+    checksum += run();
+  }
+  if (checksum == 0.0f) {
+    std::fprintf(stderr, "unexpected zero checksum\n");
+  }
+  return std::chrono::duration<double, std::micro>(Clock::now() - start).count() / static_cast<double>(rounds);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t rounds = argc > 1 ? static_cast<std::size_t>(std::strtoul(argv[1], nullptr, 10)) : 2000;
+  std::printf("base64 embeddings: decode one vector into float32\n");
+  for (std::size_t dimensions : {256, 1536, 3072}) {
+    std::vector<float> values(dimensions);
+    for (std::size_t i = 0; i < dimensions; ++i) {
+      values[i] = static_cast<float>(i % 113) * 0.01f + 0.5f;
+    }
+    std::vector<std::uint8_t> bytes(dimensions * sizeof(float));
+    std::memcpy(bytes.data(), values.data(), bytes.size());
+    const auto encoded = encode(bytes);
+
+    // The previous path: decode into a byte vector, then assemble each float from four bytes.
+    const double two_step = measure_us(rounds, [&] {
+      const auto decoded = openai::utils::decode_base64(encoded);
+      std::vector<float> out(decoded.size() / 4);
+      for (std::size_t i = 0; i < out.size(); ++i) {
+        const std::uint32_t word = static_cast<std::uint32_t>(decoded[i * 4]) |
+                                   (static_cast<std::uint32_t>(decoded[i * 4 + 1]) << 8) |
+                                   (static_cast<std::uint32_t>(decoded[i * 4 + 2]) << 16) |
+                                   (static_cast<std::uint32_t>(decoded[i * 4 + 3]) << 24);
+        std::memcpy(&out[i], &word, sizeof(float));
+      }
+      return out.back();
+    });
+
+    const double direct = measure_us(rounds, [&] {
+      std::vector<float> out(dimensions);
+      openai::utils::decode_base64_floats(encoded, out.data(), out.size());
+      return out.back();
+    });
+
+    std::printf("  %5zu dims: bytes+assemble %8.2f us   decode_base64_floats %8.2f us\n", dimensions, two_step, direct);
+  }
+  return 0;
+}
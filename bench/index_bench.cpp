@@ -0,0 +1,86 @@
+#include "openai/index/flat_index.hpp"
+#include "openai/index/hnsw_index.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+std::vector<std::vector<float>> random_vectors(std::size_t count, std::size_t dimensions, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::normal_distribution<float> normal(0.0f, 1.0f);
+  std::vector<std::vector<float>> vectors(count, std::vector<float>(dimensions));
+  for (auto& vector : vectors) {
+    for (auto& value : vector) {
+      value = normal(rng);
+    }
+  }
+  return vectors;
+}
+
+double elapsed_ms(Clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t rows = argc > 1 ? static_cast<std::size_t>(std::strtoul(argv[1], nullptr, 10)) : 20000;
+  const std::size_t dimensions = argc > 2 ? static_cast<std::size_t>(std::strtoul(argv[2], nullptr, 10)) : 256;
+  constexpr std::size_t k = 10;
+  const auto data = random_vectors(rows, dimensions, 1);
+  const auto queries = random_vectors(200, dimensions, 2);
+  std::printf("%zu x %zu vectors, %zu queries, k=%zu, dot kernel: %s\n", rows, dimensions, queries.size(), k,
+              openai::index::dot_kernel_name());
+
+  openai::index::FlatIndex flat(dimensions);
+  openai::index::HnswIndex hnsw(dimensions);
+  flat.reserve(rows);
+  hnsw.reserve(rows);
+  auto start = Clock::now();
+  for (std::size_t i = 0; i < rows; ++i) {
+    flat.add(i, data[i]);
+  }
+  std::printf("  flat build  %10.1f ms\n", elapsed_ms(start));
+  start = Clock::now();
+  for (std::size_t i = 0; i < rows; ++i) {
+    hnsw.add(i, data[i]);
+  }
+  std::printf("  hnsw build  %10.1f ms\n", elapsed_ms(start));
+
+  start = Clock::now();
+  std::vector<std::vector<openai::index::SearchResult>> exact;
+  for (const auto& query : queries) {
+    exact.push_back(flat.search(query, k));
+  }
+  std::printf("  flat search %10.3f ms/query\n", elapsed_ms(start) / static_cast<double>(queries.size()));
+
+  start = Clock::now();
+  const auto tiled = flat.search_batch(queries, k, 1);
+  std::printf("  flat batch  %10.3f ms/query (1 thread, tiled)\n", elapsed_ms(start) / static_cast<double>(queries.size()));
+
+  for (std::size_t ef : {16, 64, 256}) {
+    start = Clock::now();
+    std::size_t hits = 0;
+    for (std::size_t q = 0; q < queries.size(); ++q) {
+      const auto approximate = hnsw.search(queries[q], k, ef);
+      std::set<std::uint64_t> truth;
+      for (const auto& result : exact[q]) {
+        truth.insert(result.id);
+      }
+      for (const auto& result : approximate) {
+        hits += truth.count(result.id);
+      }
+    }
+    std::printf("  hnsw ef=%-3zu %10.3f ms/query  recall@%zu %.3f\n", ef,
+                elapsed_ms(start) / static_cast<double>(queries.size()), k,
+                static_cast<double>(hits) / static_cast<double>(queries.size() * k));
+  }
+  return tiled.size() == queries.size() ? 0 : 1;
+}
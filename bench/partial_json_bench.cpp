@@ -0,0 +1,80 @@
+#include "openai/partial_json.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+using json = nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+// Tool-call arguments shaped like a typical structured payload, split into token-sized fragments.
+std::vector<std::string> make_fragments(std::size_t records) {
+  std::string document = "{\"rows\":[";
+  for (std::size_t i = 0; i < records; ++i) {
+    if (i > 0) document += ",";
+    document += "{\"id\":" + std::to_string(i) + ",\"name\":\"item number " + std::to_string(i) +
+                "\",\"tags\":[\"alpha\",\"beta\"],\"score\":0." + std::to_string(i % 97) + ",\"active\":true}";
+  }
+  document += "]}";
+
+  std::vector<std::string> fragments;
+  for (std::size_t offset = 0; offset < document.size(); offset += 4) {
+    fragments.push_back(document.substr(offset, 4));
+  }
+  return fragments;
+}
+
+template <typename Run>
+double measure_ms(std::size_t rounds, Run run) {
+  const auto start = Clock::now();
+  std::size_t checksum = 0;
+  for (std::size_t round = 0; round < rounds; ++round) {
+    checksum += run();
+  }
+  if (checksum == 0) {
+    std::fprintf(stderr, "unexpected empty parse\n");
+  }
+  return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / static_cast<double>(rounds);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t rounds = argc > 1 ? static_cast<std::size_t>(std::strtoul(argv[1], nullptr, 10)) : 5;
+  std::printf("streamed arguments: inspect the value after every fragment\n");
+  for (std::size_t records : {10, 100, 400}) {
+    const auto fragments = make_fragments(records);
+
+    // What callers had to do before: append, then re-parse the whole prefix (only complete prefixes parse).
+    const double reparse = measure_ms(rounds, [&] {
+      std::string buffer;
+      std::size_t parsed = 0;
+      for (const auto& fragment : fragments) {
+        buffer += fragment;
+        auto value = json::parse(buffer, nullptr, false);
+        parsed += value.is_discarded() ? 0 : 1;
+      }
+      return parsed + buffer.size();
+    });
+
+    const double incremental = measure_ms(rounds, [&] {
+      openai::PartialJsonParser parser;
+      std::size_t visible = 0;
+      for (const auto& fragment : fragments) {
+        parser.feed(fragment);
+        visible += parser.value().size();
+      }
+      return visible;
+    });
+
+    std::printf("  %4zu records, %5zu fragments: re-parse %9.3f ms, incremental %7.3f ms (%.1fx)\n", records,
+                fragments.size(), reparse, incremental, reparse / incremental);
+  }
+  return 0;
+}
@@ -0,0 +1,61 @@
+#include "openai/responses.hpp"
+#include "openai/streaming.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <typename Decode>
+double measure_ns_per_event(const std::vector<openai::ServerSentEvent>& events, std::size_t rounds, Decode decode) {
+  std::size_t checksum = 0;
+  const auto start = Clock::now();
+  for (std::size_t round = 0; round < rounds; ++round) {
+    for (const auto& event : events) {
+      auto parsed = decode(event);
+      checksum += parsed.text_delta ? parsed.text_delta->delta.size() : 0;
+    }
+  }
+  const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+  if (checksum == 0) {
+    std::fprintf(stderr, "unexpected empty decode\n");
+  }
+  return static_cast<double>(elapsed) / static_cast<double>(rounds * events.size());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const std::size_t rounds = argc > 1 ? static_cast<std::size_t>(std::strtoul(argv[1], nullptr, 10)) : 200;
+  const std::vector<std::string> tokens = {"Hello", ",", " world", "!", " The", " answer", " is", " 42", "\\n", " é"};
+
+  std::vector<openai::ServerSentEvent> events;
+  events.reserve(1000);
+  for (int i = 0; i < 1000; ++i) {
+    openai::ServerSentEvent event;
+    event.event = "response.output_text.delta";
+    event.data = std::string(R"({"type":"response.output_text.delta","sequence_number":)") + std::to_string(i + 4) +
+                 R"(,"item_id":"msg_68c1f0b2c4e08190a7d2e0f3b9c1d2e3","output_index":0,"content_index":0,"delta":")" +
+                 tokens[static_cast<std::size_t>(i) % tokens.size()] + R"(","logprobs":[],"obfuscation":"q8Zr4"})";
+    events.push_back(std::move(event));
+  }
+
+  const double dom = measure_ns_per_event(events, rounds, [](const openai::ServerSentEvent& event) {
+    return *openai::parse_response_stream_event(event);
+  });
+  const openai::ResponseStreamDecodeOptions fast_options{.fast_text_deltas = true};
+  const double fast = measure_ns_per_event(events, rounds, [&](const openai::ServerSentEvent& event) {
+    return *openai::parse_response_stream_event(event, fast_options);
+  });
+
+  std::printf("response.output_text.delta decode (%zu events x %zu rounds)\n", events.size(), rounds);
+  std::printf("  json DOM     : %8.1f ns/event\n", dom);
+  std::printf("  fast path    : %8.1f ns/event\n", fast);
+  std::printf("  speedup      : %8.2fx\n", dom / fast);
+  return 0;
+}
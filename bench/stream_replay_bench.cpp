@@ -0,0 +1,117 @@
+#include "openai/assistant_stream.hpp"
+#include "openai/responses.hpp"
+#include "openai/stream_capture.hpp"
+#include "openai/streaming.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Writes a capture shaped like a Responses text stream: one event per token, split into
+// network-sized chunks that do not align with event boundaries.
+std::string synthesize_capture() {
+  const auto path = (std::filesystem::temp_directory_path() / "openai-bench-stream.bin").string();
+  std::filesystem::remove(path);
+
+  std::string body;
+  for (int i = 0; i < 4000; ++i) {
+    body += "event: response.output_text.delta\ndata: {\"type\":\"response.output_text.delta\",\"sequence_number\":" +
+            std::to_string(i) +
+            ",\"item_id\":\"msg_1\",\"output_index\":0,\"content_index\":0,\"delta\":\" token\",\"logprobs\":[]}\n\n";
+  }
+
+  openai::StreamCaptureWriter writer(path);
+  const auto id = writer.begin_exchange("POST", "https://api.openai.com/v1/responses");
+  for (std::size_t offset = 0; offset < body.size(); offset += 1371) {
+    const auto size = std::min<std::size_t>(1371, body.size() - offset);
+    writer.record_chunk(id, body.data() + offset, size);
+  }
+  writer.end_exchange(id, 200, {{"content-type", "text/event-stream"}});
+  return path;
+}
+
+struct Totals {
+  std::size_t bytes = 0;
+  std::size_t events = 0;
+  double seconds = 0;
+};
+
+template <typename Body>
+Totals run(const std::vector<openai::CapturedExchange>& exchanges, std::size_t rounds, Body body) {
+  Totals totals;
+  const auto start = Clock::now();
+  for (std::size_t round = 0; round < rounds; ++round) {
+    for (const auto& exchange : exchanges) {
+      totals.events += body(exchange);
+      for (const auto& chunk : exchange.chunks) {
+        totals.bytes += chunk.data.size();
+      }
+    }
+  }
+  totals.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  return totals;
+}
+
+void report(const char* name, const Totals& totals) {
+  std::printf("  %-26s %9.1f MB/s %12.0f events/s\n", name,
+              static_cast<double>(totals.bytes) / totals.seconds / 1e6,
+              static_cast<double>(totals.events) / totals.seconds);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const std::string path = argc > 1 && argv[1][0] != '\0' ? argv[1] : synthesize_capture();
+  const std::size_t rounds = argc > 2 ? static_cast<std::size_t>(std::strtoul(argv[2], nullptr, 10)) : 20;
+  const auto exchanges = openai::read_stream_capture(path);
+
+  std::size_t chunks = 0;
+  for (const auto& exchange : exchanges) {
+    chunks += exchange.chunks.size();
+  }
+  std::printf("%s: %zu exchanges, %zu chunks, %zu rounds\n", path.c_str(), exchanges.size(), chunks, rounds);
+
+  report("SSEParser", run(exchanges, rounds, [](const openai::CapturedExchange& exchange) {
+           openai::SSEParser parser;
+           std::size_t events = 0;
+           for (const auto& chunk : exchange.chunks) {
+             events += parser.feed(chunk.data.data(), chunk.data.size()).size();
+           }
+           return events + parser.finalize().size();
+         }));
+
+  report("Responses typed events", run(exchanges, rounds, [](const openai::CapturedExchange& exchange) {
+           std::size_t events = 0;
+           openai::SSEEventStream stream([&](const openai::ServerSentEvent& event) {
+             events += openai::parse_response_stream_event(event).has_value() ? 1 : 0;
+             return true;
+           });
+           for (const auto& chunk : exchange.chunks) {
+             stream.feed(chunk.data.data(), chunk.data.size());
+           }
+           stream.finalize();
+           return events;
+         }));
+
+  report("AssistantStreamParser", run(exchanges, rounds, [](const openai::CapturedExchange& exchange) {
+           std::size_t events = 0;
+           openai::AssistantStreamParser parser([&](const openai::AssistantStreamEvent&) { ++events; });
+           openai::SSEEventStream stream([&](const openai::ServerSentEvent& event) {
+             parser.feed(event);
+             return true;
+           });
+           for (const auto& chunk : exchange.chunks) {
+             stream.feed(chunk.data.data(), chunk.data.size());
+           }
+           stream.finalize();
+           return events;
+         }));
+  return 0;
+}
@@ -2,4 +2,5 @@
 
 // Umbrella header that pulls in the primary client surface.
 #include "openai/client.hpp"
-
+#include "openai/stream_hub.hpp"
+#include "openai/partial_json.hpp"
@@ -25,6 +25,9 @@ private:
   EventCallback callback_;
 };
 
+// True for `thread.message.delta` events, the ones that carry generated text.
+bool is_assistant_content_event(const ServerSentEvent& event);
+
 struct AssistantStreamSnapshot {
   void ingest(const AssistantStreamEvent& event);
 
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <map>
 #include <optional>
 #include <string>
@@ -8,6 +12,7 @@
 #include <nlohmann/json.hpp>
 
 #include "openai/files.hpp"
+#include "openai/streaming.hpp"
 
 namespace openai {
 
@@ -57,6 +62,26 @@ struct TranscriptionTextDeltaEvent {
   nlohmann::json raw = nlohmann::json::object();
 };
 
+struct TranscriptionTextDoneEvent {
+  std::string type;
+  std::string text;
+  std::optional<std::vector<TranscriptionLogprob>> logprobs;
+  std::optional<TranscriptionUsage> usage;
+  nlohmann::json raw = nlohmann::json::object();
+};
+
+struct TranscriptionStreamEvent {
+  enum class Type { TextDelta, TextDone, Unknown };
+
+  Type type = Type::Unknown;
+  std::string type_name;
+  std::optional<TranscriptionTextDeltaEvent> text_delta;
+  std::optional<TranscriptionTextDoneEvent> text_done;
+  nlohmann::json raw = nlohmann::json::object();
+};
+
+std::optional<TranscriptionStreamEvent> parse_transcription_stream_event(const ServerSentEvent& event);
+
 struct TranscriptionWord {
   double end = 0.0;
   double start = 0.0;
@@ -89,6 +114,23 @@ struct TranscriptionResponse {
   nlohmann::json raw = nlohmann::json::object();
 };
 
+/**
+ * Builds the transcript from stream events as they arrive: deltas are appended to text() until
+ * `transcript.text.done` supplies the final text, logprobs and usage.
+ */
+class TranscriptionStreamAccumulator {
+public:
+  void add(const TranscriptionStreamEvent& event);
+
+  [[nodiscard]] const std::string& text() const { return response_.text; }
+  [[nodiscard]] bool done() const { return done_; }
+  [[nodiscard]] const TranscriptionResponse& response() const { return response_; }
+
+private:
+  TranscriptionResponse response_;
+  bool done_ = false;
+};
+
 struct TranscriptionChunkingStrategy {
   enum class Type { Auto, ServerVad };
   Type type = Type::Auto;
@@ -145,6 +187,35 @@ struct SpeechRequest {
   std::optional<std::string> stream_format;
 };
 
+struct SpeechUsage {
+  int input_tokens = 0;
+  int output_tokens = 0;
+  int total_tokens = 0;
+  nlohmann::json raw = nlohmann::json::object();
+};
+
+struct SpeechAudioChunk {
+  // Raw audio, valid only during the callback: a slice of the response body, or one decoded
+  // `speech.audio.delta` event when SpeechRequest::stream_format is "sse".
+  const std::uint8_t* data = nullptr;
+  std::size_t size = 0;
+  std::size_t index = 0;
+  std::chrono::steady_clock::time_point received_at;
+  // Since the request was sent; on the first chunk this is the time to first audio.
+  std::chrono::nanoseconds elapsed{0};
+};
+
+struct SpeechStreamResult {
+  std::size_t chunks = 0;
+  std::uint64_t bytes = 0;
+  std::optional<std::chrono::nanoseconds> time_to_first_audio;
+  // From the `speech.audio.done` event in SSE mode.
+  std::optional<SpeechUsage> usage;
+  std::map<std::string, std::string> headers;
+  // The callback returned false before the audio ended.
+  bool stopped = false;
+};
+
 struct RequestOptions;
 class OpenAIClient;
 
@@ -155,6 +226,14 @@ public:
   TranscriptionResponse create(const TranscriptionRequest& request) const;
   TranscriptionResponse create(const TranscriptionRequest& request, const RequestOptions& options) const;
 
+  // Sends the request with stream=true and hands each event to `on_event`; return false to stop. The
+  // transcript accumulated so far is returned.
+  TranscriptionResponse create_stream(const TranscriptionRequest& request,
+                                      const std::function<bool(const TranscriptionStreamEvent&)>& on_event) const;
+  TranscriptionResponse create_stream(const TranscriptionRequest& request,
+                                      const std::function<bool(const TranscriptionStreamEvent&)>& on_event,
+                                      const RequestOptions& options) const;
+
   TranslationResponse translate(const TranslationRequest& request) const;
   TranslationResponse translate(const TranslationRequest& request, const RequestOptions& options) const;
 
@@ -179,6 +258,23 @@ public:
 
   SpeechResponse create(const SpeechRequest& request) const;
   SpeechResponse create(const SpeechRequest& request, const RequestOptions& options) const;
+  // Streams the audio into `sink` as it is generated instead of buffering it. Generated audio has no
+  // byte ranges, so DownloadOptions::parallel_ranges is ignored here.
+  DownloadResult create(const SpeechRequest& request,
+                        const DownloadSink& sink,
+                        const DownloadOptions& download_options = {}) const;
+  DownloadResult create(const SpeechRequest& request,
+                        const DownloadSink& sink,
+                        const DownloadOptions& download_options,
+                        const RequestOptions& options) const;
+
+  // Hands audio to `on_chunk` as it arrives; return false to stop early. With stream_format "sse" the
+  // base64 deltas are decoded first. Not retried, since delivered audio cannot be taken back.
+  SpeechStreamResult stream(const SpeechRequest& request,
+                            const std::function<bool(const SpeechAudioChunk&)>& on_chunk) const;
+  SpeechStreamResult stream(const SpeechRequest& request,
+                            const std::function<bool(const SpeechAudioChunk&)>& on_chunk,
+                            const RequestOptions& options) const;
 
 private:
   OpenAIClient& client_;
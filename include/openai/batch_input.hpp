@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "openai/chat.hpp"
+#include "openai/embeddings.hpp"
+#include "openai/files.hpp"
+#include "openai/responses.hpp"
+
+namespace openai {
+
+struct RequestOptions;
+
+struct BatchInputOptions {
+  // Shards are written as <directory>/<prefix>-<n>.jsonl, truncating any file already there. Defaults to a
+  // fresh "openai-batch-<uuid>" directory under the system temp directory, so writers running side by side,
+  // in one process or several, never share shard paths; set it to keep the shards somewhere known.
+  std::string directory;
+  std::string prefix = "batch-input";
+  // A Batch input file holds at most 200 MB and 50,000 requests.
+  std::size_t max_file_bytes = 200 * 1024 * 1024;
+  std::size_t max_lines = 50000;
+};
+
+struct BatchInputShard {
+  std::string path;
+  // The url shared by every line, e.g. "/v1/chat/completions"; pass it as BatchCreateRequest::endpoint.
+  std::string endpoint;
+  std::size_t lines = 0;
+  std::size_t bytes = 0;
+};
+
+/**
+ * Writes Batch API input files one JSONL line at a time. Each request is encoded with the same body
+ * builder its resource uses and appended to the open shard; a shard is closed and the next one started
+ * when the line or byte limit would be exceeded, or when the endpoint changes, since a batch covers a
+ * single endpoint. A custom_id may appear once per shard. Shards are uploaded from disk through memory
+ * mappings, so neither writing nor uploading holds a whole file in memory.
+ */
+class BatchInputWriter {
+public:
+  explicit BatchInputWriter(BatchInputOptions options = {});
+  ~BatchInputWriter();
+
+  BatchInputWriter(const BatchInputWriter&) = delete;
+  BatchInputWriter& operator=(const BatchInputWriter&) = delete;
+
+  void add(const std::string& custom_id, const ChatCompletionRequest& request);
+  void add(const std::string& custom_id, const EmbeddingRequest& request);
+  void add(const std::string& custom_id, const ResponseRequest& request);
+  // For endpoints without a typed overload; `url` is the path, e.g. "/v1/completions".
+  void add(const std::string& custom_id, const std::string& url, nlohmann::json body);
+
+  // Closes the open shard. Later add() calls start a new one.
+  const std::vector<BatchInputShard>& finish();
+  // Every shard so far, including the open one.
+  [[nodiscard]] const std::vector<BatchInputShard>& shards() const { return shards_; }
+
+  // Finishes, then uploads each shard with purpose "batch", in shard order.
+  std::vector<FileObject> upload(const FilesResource& files);
+  std::vector<FileObject> upload(const FilesResource& files, const RequestOptions& options);
+
+private:
+  void open_shard(const std::string& endpoint);
+  void close_shard();
+
+  BatchInputOptions options_;
+  std::vector<BatchInputShard> shards_;
+  std::ofstream out_;
+  std::unordered_set<std::string> custom_ids_;
+};
+
+}  // namespace openai
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "openai/batch_input.hpp"
+#include "openai/batch_results.hpp"
+#include "openai/batches.hpp"
+
+namespace openai {
+
+class OpenAIClient;
+
+struct BatchJobOptions {
+  // Shard limits and the directory the input shards are written to; retry shards are written beside them.
+  BatchInputOptions input;
+  std::string completion_window = "24h";
+  std::optional<std::map<std::string, std::string>> metadata;
+  // Shards uploaded and submitted at once.
+  std::size_t max_concurrent_uploads = 4;
+  // Delay between polling rounds; one round retrieves every batch still running.
+  std::chrono::milliseconds poll_interval{30000};
+  // Times a line that expired, was rate limited or hit a server error is resubmitted in a new batch.
+  std::size_t max_resubmits = 2;
+  std::function<void(const Batch&)> on_batch_update;
+};
+
+struct BatchJobSummary {
+  std::size_t succeeded = 0;
+  std::size_t failed = 0;
+  std::size_t resubmitted = 0;
+  // Every batch submitted, in its last polled state.
+  std::vector<Batch> batches;
+};
+
+/**
+ * Runs an arbitrarily large set of requests through the Batch API. Requests are spooled to disk by a
+ * BatchInputWriter as they are added; run() uploads and submits the shards concurrently, then polls all
+ * of the batches from one thread. As each batch finishes its output and error files are streamed through
+ * a BatchResultReader and every final result is passed to the callback. Lines that expired or failed
+ * transiently are collected from the input shard and submitted again in a new batch.
+ */
+class BatchJob {
+public:
+  using Handler = std::function<void(const BatchResult&)>;
+
+  explicit BatchJob(OpenAIClient& client, BatchJobOptions options = {});
+
+  BatchJob(const BatchJob&) = delete;
+  BatchJob& operator=(const BatchJob&) = delete;
+
+  void add(const std::string& custom_id, const ChatCompletionRequest& request);
+  void add(const std::string& custom_id, const EmbeddingRequest& request);
+  void add(const std::string& custom_id, const ResponseRequest& request);
+  void add(const std::string& custom_id, const std::string& url, nlohmann::json body);
+
+  // Blocks until every line has a final result. Results of one batch arrive together, batches in the
+  // order they finish. Polls that fail transiently are tried again next round; when submitting or
+  // polling fails otherwise, batches still running are cancelled and the error rethrown. A job runs
+  // once: calling run() or start() again throws.
+  BatchJobSummary run(Handler on_result);
+  // Runs on a background thread; the job must outlive the future.
+  std::future<BatchJobSummary> start(Handler on_result);
+
+private:
+  struct Submission {
+    BatchInputShard shard;
+    std::size_t attempt = 0;
+    Batch batch;
+  };
+
+  void claim_run();
+  BatchJobSummary execute(const Handler& on_result);
+  void submit(std::vector<Submission>& submissions, std::size_t first);
+  void cancel_running(const std::vector<Submission>& submissions);
+  void collect(Submission& submission,
+               const Handler& on_result,
+               BatchJobSummary& summary,
+               std::vector<Submission>& resubmissions);
+
+  OpenAIClient& client_;
+  BatchJobOptions options_;
+  BatchInputWriter writer_;
+  std::size_t retry_shards_ = 0;
+  std::atomic<bool> started_{false};
+};
+
+}  // namespace openai
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "openai/chat.hpp"
+#include "openai/download.hpp"
+#include "openai/embeddings.hpp"
+#include "openai/files.hpp"
+#include "openai/responses.hpp"
+#include "openai/utils/mapped_file.hpp"
+
+namespace openai {
+
+struct RequestOptions;
+
+struct BatchResultError {
+  std::optional<std::string> code;
+  std::optional<std::string> message;
+};
+
+/** One line of a batch output or error file. */
+struct BatchResult {
+  std::string id;
+  std::string custom_id;
+  std::optional<int> status_code;
+  std::optional<std::string> request_id;
+  // The endpoint's response body; null when the request failed before reaching it.
+  nlohmann::json body;
+  std::optional<BatchResultError> error;
+  // Position of the line within its file.
+  std::uint64_t offset = 0;
+  std::uint64_t length = 0;
+  nlohmann::json raw = nlohmann::json::object();
+
+  [[nodiscard]] bool ok() const;
+  // Parse `body` with the parser of the matching resource; throws OpenAIError when !ok().
+  ChatCompletion chat_completion() const;
+  CreateEmbeddingResponse embedding() const;
+  Response response() const;
+};
+
+BatchResult parse_batch_result_line(std::string_view line);
+
+struct BatchResultReaderOptions {
+  // Keeps a copy of the file here while it streams, so results can be looked up again later.
+  std::optional<std::string> output_path;
+  // Writes a custom_id index for output_path here once the file is complete; see BatchResultIndex.
+  std::optional<std::string> index_path;
+};
+
+/**
+ * Splits a batch output or error file into lines as its bytes arrive and hands each parsed line to a
+ * callback, so a multi-gigabyte file is never held in memory. When a download restarts, restart()
+ * rewinds the copy on disk and lines already delivered are not delivered again.
+ */
+class BatchResultReader {
+public:
+  using Handler = std::function<void(const BatchResult&)>;
+
+  explicit BatchResultReader(Handler on_result, BatchResultReaderOptions options = {});
+  ~BatchResultReader();
+
+  BatchResultReader(const BatchResultReader&) = delete;
+  BatchResultReader& operator=(const BatchResultReader&) = delete;
+
+  void feed(const char* data, std::size_t size);
+  void restart();
+  // Parses a final line without a trailing newline, then writes the index if one was requested.
+  void finish();
+
+  [[nodiscard]] std::size_t results() const { return delivered_; }
+
+  // Streams `file_id` from the Files API through a reader.
+  static DownloadResult read(const FilesResource& files,
+                             const std::string& file_id,
+                             Handler on_result,
+                             const BatchResultReaderOptions& reader_options = {});
+  static DownloadResult read(const FilesResource& files,
+                             const std::string& file_id,
+                             Handler on_result,
+                             const BatchResultReaderOptions& reader_options,
+                             const RequestOptions& options);
+  // Reads a file already on disk through a memory mapping.
+  static void read_file(const std::string& path,
+                        Handler on_result,
+                        const std::optional<std::string>& index_path = std::nullopt);
+
+private:
+  struct IndexEntry {
+    std::uint64_t hash = 0;
+    std::uint64_t offset = 0;
+    std::uint64_t length = 0;
+  };
+
+  void deliver(std::string_view line);
+
+  Handler on_result_;
+  BatchResultReaderOptions options_;
+  std::ofstream copy_;
+  std::string pending_;
+  std::uint64_t offset_ = 0;
+  std::size_t lines_seen_ = 0;
+  // Lines delivered before the last restart, skipped when the body is read again.
+  std::size_t resume_after_ = 0;
+  std::size_t delivered_ = 0;
+  std::vector<IndexEntry> index_;
+
+  friend class BatchResultIndex;
+};
+
+/**
+ * Open-addressed hash table from custom_id to the byte range of its line, stored in its own file and
+ * read through a memory mapping together with the results file. A lookup touches one or two index slots
+ * and parses a single line, whatever the size of the file.
+ */
+class BatchResultIndex {
+public:
+  static BatchResultIndex open(const std::string& index_path, const std::string& results_path);
+
+  std::optional<BatchResult> find(const std::string& custom_id) const;
+  [[nodiscard]] std::size_t size() const { return entries_; }
+
+private:
+  BatchResultIndex() = default;
+
+  static std::uint64_t hash(std::string_view custom_id);
+  static void write(const std::string& path, const std::vector<BatchResultReader::IndexEntry>& entries);
+
+  std::shared_ptr<const utils::MappedFile> index_;
+  std::shared_ptr<const utils::MappedFile> results_;
+  std::uint64_t slots_ = 0;
+  std::size_t entries_ = 0;
+
+  friend class BatchResultReader;
+};
+
+}  // namespace openai
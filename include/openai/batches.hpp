@@ -126,5 +126,7 @@ private:
   OpenAIClient& client_;
 };
 
+Batch parse_batch_json(const nlohmann::json& payload);
+
 }  // namespace openai
 
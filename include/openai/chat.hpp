@@ -553,4 +553,8 @@ private:
   ChatCompletionsResource completions_;
 };
 
+// The /v1/chat/completions request body, as sent by ChatCompletionsResource::create.
+nlohmann::json build_chat_request_body(const ChatCompletionRequest& request);
+ChatCompletion parse_chat_completion_json(const nlohmann::json& payload);
+
 }  // namespace openai
@@ -14,9 +14,13 @@
 #include "openai/completions.hpp"
 #include "openai/logging.hpp"
 #include "openai/http_client.hpp"
+#include "openai/stream_capture.hpp"
+#include "openai/stream_stats.hpp"
 #include "openai/error.hpp"
 #include "openai/models.hpp"
 #include "openai/embeddings.hpp"
+#include "openai/embedding_cache.hpp"
+#include "openai/embedding_matrix.hpp"
 #include "openai/chat.hpp"
 #include "openai/moderations.hpp"
 #include "openai/responses.hpp"
@@ -48,9 +52,16 @@ struct RequestOptions {
   std::optional<nlohmann::json> query;
   std::optional<std::string> idempotency_key;
   std::optional<std::chrono::milliseconds> timeout;
+  std::optional<std::chrono::milliseconds> idle_timeout;
   std::optional<std::size_t> max_retries;
   std::function<void(const char*, std::size_t)> on_chunk;
+  // Called before every attempt, retries included, so a streamed consumer can start its body over.
+  std::function<void(std::size_t retry_count)> on_attempt;
+  // Status of each attempt's response, reported before its body reaches on_chunk.
+  std::function<void(long status_code)> on_status;
   bool collect_body = true;
+  std::shared_ptr<StreamCaptureWriter> stream_capture;
+  std::shared_ptr<StreamStats> stream_stats;
 };
 
 struct PageRequestOptions {
@@ -79,6 +90,11 @@ struct ClientOptions {
   std::string alternative_auth_prefix;
   bool azure_deployment_routing = false;
   std::optional<std::string> azure_deployment_name;
+  StreamStatsCallback on_stream_stats;
+  // Used by ResponsesResource when decoding typed stream events.
+  ResponseStreamDecodeOptions response_stream_decode;
+  // Consulted by EmbeddingsResource::create/embed_many for string inputs decoded as floats.
+  std::shared_ptr<EmbeddingCache> embedding_cache;
 };
 
 class OpenAIClient;
@@ -115,7 +131,23 @@ public:
   CreateEmbeddingResponse create(const EmbeddingRequest& request,
                                  const RequestOptions& options = {}) const;
 
+  // Splits list inputs into shards by item count and estimated tokens, embeds them concurrently and
+  // returns a single response in input order with summed usage.
+  CreateEmbeddingResponse embed_many(const EmbeddingRequest& request,
+                                     const EmbedManyOptions& batch_options = {},
+                                     const RequestOptions& options = {}) const;
+
+  // Decodes every embedding straight into one aligned row-major matrix instead of per-row vectors.
+  EmbeddingMatrixResponse create_matrix(const EmbeddingRequest& request,
+                                        EmbeddingStorage storage = EmbeddingStorage::Float32,
+                                        const RequestOptions& options = {}) const;
+
 private:
+  CreateEmbeddingResponse create_uncached(const EmbeddingRequest& request, const RequestOptions& options) const;
+  CreateEmbeddingResponse embed_many_uncached(const EmbeddingRequest& request,
+                                              const EmbedManyOptions& batch_options,
+                                              const RequestOptions& options) const;
+
   OpenAIClient& client_;
 };
 
@@ -259,14 +291,31 @@ private:
   friend class EvalsResource;
   friend class EvalsRunsResource;
   friend class EvalsRunsOutputItemsResource;
+  friend class LocalBatchExecutor;
+  friend class PollScheduler;
 
   HttpResponse perform_request(const std::string& method,
                                const std::string& path,
                                const std::string& body,
                                const RequestOptions& options) const;
 
+  // Sends a body assembled from borrowed segments; it is joined first when the HttpClient cannot stream it.
+  HttpResponse perform_request(const std::string& method,
+                               const std::string& path,
+                               std::shared_ptr<const HttpBodySegments> body,
+                               const RequestOptions& options) const;
+
   HttpResponse perform_request(const PageRequestOptions& options) const;
 
+  HttpResponse send_request(const std::string& method,
+                            const std::string& path,
+                            const std::string& body,
+                            const std::shared_ptr<const HttpBodySegments>& body_segments,
+                            const RequestOptions& options) const;
+
+  std::shared_ptr<StreamStatsRecorder> stream_stats_recorder(const std::string& endpoint,
+                                                             const RequestOptions& options) const;
+
   void log(LogLevel level, const std::string& message, const nlohmann::json& details = {}) const;
 
   ClientOptions options_;
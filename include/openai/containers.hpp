@@ -9,6 +9,7 @@
 
 #include <nlohmann/json.hpp>
 
+#include "openai/download.hpp"
 #include "openai/utils/to_file.hpp"
 
 namespace openai {
@@ -104,6 +105,16 @@ public:
   ContainerFileContent retrieve(const std::string& container_id,
                                 const std::string& file_id,
                                 const RequestOptions& options) const;
+  // Streams the content into `sink` instead of buffering it.
+  DownloadResult retrieve(const std::string& container_id,
+                          const std::string& file_id,
+                          const DownloadSink& sink,
+                          const DownloadOptions& download_options = {}) const;
+  DownloadResult retrieve(const std::string& container_id,
+                          const std::string& file_id,
+                          const DownloadSink& sink,
+                          const DownloadOptions& download_options,
+                          const RequestOptions& options) const;
 
 private:
   OpenAIClient& client_;
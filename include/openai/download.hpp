@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <variant>
+
+#include "openai/http_client.hpp"
+#include "openai/utils/md5.hpp"
+#include "openai/utils/sha256.hpp"
+
+namespace openai {
+
+struct RequestOptions;
+
+enum class DownloadChecksum { None, MD5, SHA256 };
+
+struct DownloadOptions {
+  // Reserves this many bytes before writing a file sink, so a large download fails fast when the disk is
+  // full and is laid out contiguously. Uses fallocate on Linux; a no-op where no equivalent exists.
+  std::optional<std::uint64_t> preallocate_bytes;
+  DownloadChecksum checksum = DownloadChecksum::None;
+  // Lowercase or uppercase hex digest; a mismatch fails the download.
+  std::optional<std::string> expected_checksum;
+  // Above 1, a file sink is fetched as concurrent byte ranges of `range_bytes` each, written in place
+  // with positional writes. A server without Range support gets a single stream instead.
+  std::size_t parallel_ranges = 1;
+  std::uint64_t range_bytes = 16 * 1024 * 1024;
+  // Per range; a failed range resumes after the last byte it wrote, without touching the others.
+  std::size_t max_range_attempts = 3;
+};
+
+struct DownloadResult {
+  std::uint64_t bytes = 0;
+  std::map<std::string, std::string> headers;
+  // Hex digest of the body when DownloadOptions::checksum is set.
+  std::optional<std::string> checksum;
+};
+
+/**
+ * Destination for a streamed response body: a file path, an std::ostream or a chunk callback. When a
+ * retry restarts the body, a file starts over from its beginning and a seekable stream from where it
+ * started; a callback sink is told through `on_restart`, and without one the retry fails instead.
+ */
+class DownloadSink {
+public:
+  static DownloadSink file(std::string path);
+  static DownloadSink stream(std::ostream& out);
+  static DownloadSink callback(std::function<void(const char*, std::size_t)> on_data,
+                               std::function<void()> on_restart = nullptr);
+
+private:
+  friend class DownloadWriter;
+  friend DownloadResult download(const DownloadSink&,
+                                 const DownloadOptions&,
+                                 const RequestOptions&,
+                                 const std::function<HttpResponse(const RequestOptions&)>&);
+
+  DownloadSink() = default;
+
+  std::variant<std::string, std::ostream*, std::function<void(const char*, std::size_t)>> target_;
+  std::function<void()> on_restart_;
+};
+
+/**
+ * Writes one streamed response body into a DownloadSink. attach() routes a request's body here through
+ * RequestOptions::on_chunk, skipping error responses and starting over on retries; finish() completes
+ * the download. A file sink that is never finished is removed.
+ */
+class DownloadWriter {
+public:
+  DownloadWriter(DownloadSink sink, DownloadOptions options);
+  ~DownloadWriter();
+
+  DownloadWriter(const DownloadWriter&) = delete;
+  DownloadWriter& operator=(const DownloadWriter&) = delete;
+
+  RequestOptions attach(const RequestOptions& options);
+  // Appends bytes directly, for callers that decode a response body themselves instead of attaching.
+  void write(const char* data, std::size_t size);
+  DownloadResult finish(std::map<std::string, std::string> headers);
+
+private:
+  void restart();
+
+  DownloadSink sink_;
+  DownloadOptions options_;
+  std::ofstream file_;
+  std::streampos stream_start_ = -1;
+  long status_ = 0;
+  std::uint64_t bytes_ = 0;
+  std::optional<utils::MD5> md5_;
+  std::optional<utils::SHA256> sha256_;
+  bool finished_ = false;
+};
+
+/**
+ * Runs a GET download into `sink`, where `send` performs the request with the options it is given. With
+ * DownloadOptions::parallel_ranges above 1 and a file sink, a one-byte Range probe learns the length and
+ * range support: a 206 answer switches to parallel ranges, anything else is streamed as the download.
+ */
+DownloadResult download(const DownloadSink& sink,
+                        const DownloadOptions& options,
+                        const RequestOptions& request_options,
+                        const std::function<HttpResponse(const RequestOptions&)>& send);
+
+}  // namespace openai
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "openai/utils/mapped_file.hpp"
+
+namespace openai {
+
+// SHA-256 of (model, dimensions, input text).
+using EmbeddingCacheKey = std::array<std::uint8_t, 32>;
+
+struct EmbeddingCacheKeyHash {
+  std::size_t operator()(const EmbeddingCacheKey& key) const;
+};
+
+struct EmbeddingCacheOptions {
+  // Vectors kept in the in-memory LRU tier; 0 disables it.
+  std::size_t memory_entries = 10000;
+  // Append-only disk tier; vectors are read back through a memory mapping of this file.
+  std::optional<std::string> disk_path;
+};
+
+struct EmbeddingCacheStats {
+  std::uint64_t memory_hits = 0;
+  std::uint64_t disk_hits = 0;
+  std::uint64_t misses = 0;
+  std::uint64_t stores = 0;
+};
+
+/**
+ * Two-tier cache for embedding vectors. Attach it through ClientOptions::embedding_cache and
+ * EmbeddingsResource::create/embed_many only send inputs that miss; cached vectors are spliced back in
+ * input order. The disk tier survives restarts: on open the file is scanned once to index its records,
+ * and a torn record left by a crash is truncated away. All methods are thread-safe.
+ */
+class EmbeddingCache {
+public:
+  explicit EmbeddingCache(EmbeddingCacheOptions options = {});
+  ~EmbeddingCache();
+
+  EmbeddingCache(const EmbeddingCache&) = delete;
+  EmbeddingCache& operator=(const EmbeddingCache&) = delete;
+
+  static EmbeddingCacheKey make_key(const std::string& model, std::optional<int> dimensions, std::string_view input);
+
+  // Disk hits are promoted into the memory tier.
+  std::optional<std::vector<float>> get(const EmbeddingCacheKey& key);
+  void put(const EmbeddingCacheKey& key, const std::vector<float>& embedding);
+
+  [[nodiscard]] EmbeddingCacheStats stats() const;
+  void reset_stats();
+
+  [[nodiscard]] std::size_t memory_entries() const;
+  [[nodiscard]] std::size_t disk_entries() const;
+
+  // Flushes buffered disk-tier appends to the operating system.
+  void flush();
+
+private:
+  struct MemoryEntry {
+    EmbeddingCacheKey key;
+    std::vector<float> embedding;
+  };
+
+  struct DiskRecord {
+    std::uint64_t offset = 0;
+    std::uint32_t dimensions = 0;
+  };
+
+  void open_disk_tier();
+  void remember(const EmbeddingCacheKey& key, std::vector<float> embedding);
+
+  EmbeddingCacheOptions options_;
+  mutable std::mutex mutex_;
+
+  std::list<MemoryEntry> lru_;
+  std::unordered_map<EmbeddingCacheKey, std::list<MemoryEntry>::iterator, EmbeddingCacheKeyHash> memory_;
+
+  std::unordered_map<EmbeddingCacheKey, DiskRecord, EmbeddingCacheKeyHash> disk_;
+  std::shared_ptr<const utils::MappedFile> mapping_;
+  std::ofstream writer_;
+  std::uint64_t disk_size_ = 0;
+
+  std::atomic<std::uint64_t> memory_hits_{0};
+  std::atomic<std::uint64_t> disk_hits_{0};
+  std::atomic<std::uint64_t> misses_{0};
+  std::atomic<std::uint64_t> stores_{0};
+};
+
+}  // namespace openai
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "openai/embeddings.hpp"
+
+namespace openai {
+
+enum class EmbeddingStorage {
+  Float32,
+  // IEEE 754 binary16, round-to-nearest-even.
+  Float16,
+  // Symmetric per-row quantisation: value ~= int8 * row_scale(row).
+  Int8,
+};
+
+class EmbeddingRowView {
+public:
+  EmbeddingRowView(const float* data, std::size_t size) : data_(data), size_(size) {}
+
+  [[nodiscard]] const float* data() const { return data_; }
+  [[nodiscard]] std::size_t size() const { return size_; }
+  [[nodiscard]] const float* begin() const { return data_; }
+  [[nodiscard]] const float* end() const { return data_ + size_; }
+  float operator[](std::size_t index) const { return data_[index]; }
+
+private:
+  const float* data_;
+  std::size_t size_;
+};
+
+/**
+ * Row-major embedding storage in a single 64-byte-aligned allocation. Each row is padded to a multiple
+ * of 64 bytes, so every row starts on a cache-line boundary; stride() gives the distance between rows
+ * in elements. Float16 and Int8 storage trade precision for a 2x/4x smaller footprint and are read back
+ * through copy_row().
+ */
+class EmbeddingMatrix {
+public:
+  static constexpr std::size_t kAlignment = 64;
+
+  EmbeddingMatrix() = default;
+  EmbeddingMatrix(std::size_t rows, std::size_t dimensions, EmbeddingStorage storage = EmbeddingStorage::Float32);
+
+  EmbeddingMatrix(EmbeddingMatrix&& other) noexcept;
+  EmbeddingMatrix& operator=(EmbeddingMatrix&& other) noexcept;
+  EmbeddingMatrix(const EmbeddingMatrix&) = delete;
+  EmbeddingMatrix& operator=(const EmbeddingMatrix&) = delete;
+
+  // Packs float embeddings (as returned by create/embed_many) by their `index`.
+  static EmbeddingMatrix from_response(const CreateEmbeddingResponse& response,
+                                       EmbeddingStorage storage = EmbeddingStorage::Float32);
+
+  [[nodiscard]] std::size_t rows() const { return rows_; }
+  [[nodiscard]] std::size_t dimensions() const { return dimensions_; }
+  [[nodiscard]] std::size_t stride() const { return stride_; }
+  [[nodiscard]] EmbeddingStorage storage() const { return storage_; }
+  [[nodiscard]] bool empty() const { return rows_ == 0; }
+  [[nodiscard]] std::size_t size_bytes() const { return rows_ * stride_ * element_size(); }
+
+  // Float32 storage only; throws OpenAIError for the compact formats.
+  [[nodiscard]] EmbeddingRowView row(std::size_t index) const;
+  [[nodiscard]] float* mutable_row(std::size_t index);
+
+  [[nodiscard]] const std::uint16_t* row_f16(std::size_t index) const;
+  [[nodiscard]] const std::int8_t* row_i8(std::size_t index) const;
+  [[nodiscard]] float row_scale(std::size_t index) const;
+
+  [[nodiscard]] const void* data() const { return buffer_.get(); }
+
+  void set_row(std::size_t index, const float* values);
+  void copy_row(std::size_t index, float* out) const;
+  [[nodiscard]] std::vector<float> row_vector(std::size_t index) const;
+
+private:
+  struct AlignedDelete {
+    void operator()(unsigned char* pointer) const;
+  };
+
+  [[nodiscard]] std::size_t element_size() const;
+  [[nodiscard]] unsigned char* row_bytes(std::size_t index) const;
+  void check_row(std::size_t index) const;
+
+  std::size_t rows_ = 0;
+  std::size_t dimensions_ = 0;
+  std::size_t stride_ = 0;
+  EmbeddingStorage storage_ = EmbeddingStorage::Float32;
+  std::unique_ptr<unsigned char[], AlignedDelete> buffer_;
+  std::vector<float> scales_;
+};
+
+struct EmbeddingMatrixResponse {
+  EmbeddingMatrix matrix;
+  std::string model;
+  std::string object;
+  EmbeddingUsage usage;
+};
+
+}  // namespace openai
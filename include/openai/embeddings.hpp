@@ -1,10 +1,14 @@
 #pragma once
 
+#include <cstddef>
+#include <functional>
 #include <optional>
 #include <string>
 #include <variant>
 #include <vector>
 
+#include <nlohmann/json.hpp>
+
 namespace openai {
 
 struct EmbeddingUsage {
@@ -45,4 +49,21 @@ struct EmbeddingRequest {
   std::optional<std::string> user;
 };
 
+struct EmbedManyOptions {
+  std::size_t max_items_per_request = 2048;
+  std::size_t max_tokens_per_request = 300000;
+  std::size_t max_concurrency = 4;
+  // Times a shard is sent before embed_many gives up on it. Only transient failures are resent: a
+  // connection error or a 408, 409, 429 or 5xx response. Any other error fails the call at once.
+  std::size_t max_shard_attempts = 3;
+  // Token estimate for string inputs; token-array inputs are counted exactly.
+  std::function<std::size_t(const std::string&)> estimate_tokens;
+  std::function<void(std::size_t completed_items, std::size_t total_items)> on_progress;
+};
+
+// The /v1/embeddings request body. Unlike EmbeddingsResource::create, no encoding_format is filled in.
+nlohmann::json build_embedding_request_body(const EmbeddingRequest& request);
+// Parses a response to a request that did not ask for base64; base64 values are kept undecoded.
+CreateEmbeddingResponse parse_embedding_response_json(const nlohmann::json& payload);
+
 }  // namespace openai
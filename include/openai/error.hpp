@@ -1,5 +1,6 @@
 #pragma once
 
+#include <exception>
 #include <map>
 #include <stdexcept>
 #include <string>
@@ -103,4 +104,21 @@ public:
       : OpenAIError(message) {}
 };
 
+// True for failures worth retrying at a coarser grain than a single request (a shard, a part, a
+// chunk): connection errors and 408/409/429/5xx responses.
+inline bool is_transient_error(const std::exception_ptr& error) {
+  try {
+    std::rethrow_exception(error);
+  } catch (const APIUserAbortError&) {
+    return false;
+  } catch (const APIConnectionError&) {
+    return true;
+  } catch (const APIError& api_error) {
+    const long status = api_error.status_code();
+    return status == 408 || status == 409 || status == 429 || status >= 500;
+  } catch (...) {
+    return false;
+  }
+}
+
 }  // namespace openai
@@ -8,6 +8,7 @@
 
 #include <nlohmann/json.hpp>
 
+#include "openai/download.hpp"
 #include "openai/utils/to_file.hpp"
 
 namespace openai {
@@ -65,6 +66,7 @@ struct FileUploadRequest {
   std::optional<std::string> content_type;
   std::optional<FileUploadExpiresAfter> expires_after;
 
+  // A file_path source is opened with utils::open_upload_file, so read the result through bytes().
   utils::UploadFile materialize(const std::string& default_filename = "file") const;
 };
 
@@ -98,6 +100,14 @@ public:
 
   FileContent content(const std::string& file_id) const;
   FileContent content(const std::string& file_id, const RequestOptions& options) const;
+  // Streams the content into `sink` instead of buffering it.
+  DownloadResult content(const std::string& file_id,
+                         const DownloadSink& sink,
+                         const DownloadOptions& download_options = {}) const;
+  DownloadResult content(const std::string& file_id,
+                         const DownloadSink& sink,
+                         const DownloadOptions& download_options,
+                         const RequestOptions& options) const;
 
 private:
   OpenAIClient& client_;
@@ -453,4 +453,6 @@ private:
   FineTuningAlphaResource alpha_;
 };
 
+FineTuningJob parse_fine_tuning_job_json(const nlohmann::json& payload);
+
 }  // namespace openai
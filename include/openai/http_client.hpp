@@ -4,17 +4,35 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace openai {
 
+// A request body kept as a list of byte ranges, e.g. multipart framing around a memory-mapped file.
+// `owners` keep the ranges alive for as long as the body is referenced.
+struct HttpBodySegments {
+  std::vector<std::string_view> segments;
+  std::vector<std::shared_ptr<const void>> owners;
+
+  [[nodiscard]] std::size_t size() const;
+  [[nodiscard]] std::string join() const;
+};
+
 struct HttpRequest {
   std::string method;
   std::string url;
   std::map<std::string, std::string> headers;
   std::string body;
+  // Replaces `body` when set. Only sent to clients whose supports_body_segments() is true.
+  std::shared_ptr<const HttpBodySegments> body_segments;
   std::chrono::milliseconds timeout{60000};
+  std::optional<std::chrono::milliseconds> idle_timeout;
   std::function<void(const char*, std::size_t)> on_chunk;
+  // Called with the status code once a response's headers arrive, before its body reaches on_chunk.
+  std::function<void(long)> on_status;
   bool collect_body = true;
 };
 
@@ -24,10 +42,18 @@ struct HttpResponse {
   std::string body;
 };
 
+// Looks a header up by name, ignoring case as HTTP does.
+std::optional<std::string> get_header_value(const std::map<std::string, std::string>& headers,
+                                            std::string_view name);
+
 class HttpClient {
 public:
   virtual ~HttpClient() = default;
   virtual HttpResponse request(const HttpRequest& request) = 0;
+
+  // Clients that can stream HttpRequest::body_segments without joining them return true; for the rest
+  // the SDK joins the segments into HttpRequest::body first.
+  virtual bool supports_body_segments() const { return false; }
 };
 
 std::unique_ptr<HttpClient> make_default_http_client();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <functional>
 #include <optional>
 #include <string>
@@ -12,8 +13,20 @@
 
 namespace openai {
 
+/**
+ * Destinations for base64 images decoded while the response is still arriving. `sink_for` is called
+ * with the ordinal of each b64_json payload as it begins: the index into ImagesResponse::data, or for
+ * streams the n-th image event, partial or final. A retried request asks for the sinks again from 0.
+ */
+struct ImageSinks {
+  std::function<DownloadSink(std::size_t)> sink_for;
+  DownloadOptions download_options;
+};
+
 struct ImageData {
   std::optional<std::string> b64_json;
+  // Set instead of b64_json when the image was decoded into an ImageSinks sink.
+  std::optional<DownloadResult> output;
   std::optional<std::string> url;
   std::optional<std::string> revised_prompt;
   nlohmann::json raw = nlohmann::json::object();
@@ -95,6 +108,7 @@ struct ImageEditRequest {
 
 struct ImageStreamPartialEvent {
   std::optional<std::string> b64_json;
+  std::optional<DownloadResult> output;
   std::optional<std::string> background;
   int created_at = 0;
   std::optional<std::string> output_format;
@@ -106,6 +120,7 @@ struct ImageStreamPartialEvent {
 
 struct ImageStreamCompletedEvent {
   std::optional<std::string> b64_json;
+  std::optional<DownloadResult> output;
   std::optional<std::string> background;
   int created_at = 0;
   std::optional<std::string> output_format;
@@ -152,6 +167,14 @@ public:
   ImagesResponse edit(const ImageEditRequest& request) const;
   ImagesResponse edit(const ImageEditRequest& request, const RequestOptions& options) const;
 
+  // Decode every b64_json image into its sink as the body arrives, so no base64 text is kept.
+  ImagesResponse generate(const ImageGenerateRequest& request, const ImageSinks& sinks) const;
+  ImagesResponse generate(const ImageGenerateRequest& request,
+                          const ImageSinks& sinks,
+                          const RequestOptions& options) const;
+  ImagesResponse edit(const ImageEditRequest& request, const ImageSinks& sinks) const;
+  ImagesResponse edit(const ImageEditRequest& request, const ImageSinks& sinks, const RequestOptions& options) const;
+
   std::vector<ServerSentEvent> generate_stream(const ImageGenerateRequest& request) const;
   std::vector<ServerSentEvent> generate_stream(const ImageGenerateRequest& request,
                                                const RequestOptions& options) const;
@@ -160,6 +183,13 @@ public:
   void generate_stream(const ImageGenerateRequest& request,
                        const std::function<bool(const ImageStreamEvent&)>& on_event,
                        const RequestOptions& options) const;
+  void generate_stream(const ImageGenerateRequest& request,
+                       const ImageSinks& sinks,
+                       const std::function<bool(const ImageStreamEvent&)>& on_event) const;
+  void generate_stream(const ImageGenerateRequest& request,
+                       const ImageSinks& sinks,
+                       const std::function<bool(const ImageStreamEvent&)>& on_event,
+                       const RequestOptions& options) const;
 
   std::vector<ServerSentEvent> edit_stream(const ImageEditRequest& request) const;
   std::vector<ServerSentEvent> edit_stream(const ImageEditRequest& request,
@@ -169,6 +199,13 @@ public:
   void edit_stream(const ImageEditRequest& request,
                    const std::function<bool(const ImageStreamEvent&)>& on_event,
                    const RequestOptions& options) const;
+  void edit_stream(const ImageEditRequest& request,
+                   const ImageSinks& sinks,
+                   const std::function<bool(const ImageStreamEvent&)>& on_event) const;
+  void edit_stream(const ImageEditRequest& request,
+                   const ImageSinks& sinks,
+                   const std::function<bool(const ImageStreamEvent&)>& on_event,
+                   const RequestOptions& options) const;
 
 private:
   OpenAIClient& client_;
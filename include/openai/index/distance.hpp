@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace openai::index {
+
+enum class Metric : std::uint32_t {
+  // Raw dot product; larger is closer.
+  InnerProduct = 0,
+  // Vectors are normalised on insert and queries on search, so the score is the cosine similarity.
+  Cosine = 1,
+};
+
+/**
+ * Dot product of two float vectors. Dispatches once per process to an AVX2/FMA kernel on x86 CPUs that
+ * support it, NEON on AArch64, and an unrolled scalar loop elsewhere.
+ */
+float dot(const float* a, const float* b, std::size_t size);
+
+/** Scales `values` to unit length in place; zero vectors are left unchanged. */
+void normalize(float* values, std::size_t size);
+
+/** Name of the dot-product kernel selected for this CPU ("avx2", "neon" or "scalar"). */
+const char* dot_kernel_name();
+
+}  // namespace openai::index
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "openai/embedding_matrix.hpp"
+#include "openai/index/distance.hpp"
+#include "openai/index/vector_storage.hpp"
+
+namespace openai::index {
+
+/**
+ * Exact nearest-neighbour search: every query is scored against every stored row with the SIMD dot
+ * kernel. Adding an id that is already present replaces its vector; remove() moves the last row into
+ * the freed slot. Searches may run concurrently with each other but not with add/remove.
+ */
+class FlatIndex {
+public:
+  explicit FlatIndex(std::size_t dimensions, Metric metric = Metric::Cosine);
+
+  [[nodiscard]] std::size_t dimensions() const { return vectors_.dimensions(); }
+  [[nodiscard]] Metric metric() const { return metric_; }
+  [[nodiscard]] std::size_t size() const { return ids_.size(); }
+  [[nodiscard]] bool contains(std::uint64_t id) const { return rows_.count(id) > 0; }
+
+  void reserve(std::size_t rows);
+  void add(std::uint64_t id, const float* values);
+  void add(std::uint64_t id, const std::vector<float>& values);
+  // Adds every row of a Float32 matrix, with ids first_id, first_id + 1, ...
+  void add(const EmbeddingMatrix& matrix, std::uint64_t first_id = 0);
+  bool remove(std::uint64_t id);
+
+  // Results are ordered best first.
+  [[nodiscard]] std::vector<SearchResult> search(const float* query, std::size_t k) const;
+  [[nodiscard]] std::vector<SearchResult> search(const std::vector<float>& query, std::size_t k) const;
+
+  // Splits the queries across `threads` workers (0 = hardware concurrency) and scores them in tiles
+  // so each block of stored rows is reused from cache by several queries.
+  [[nodiscard]] std::vector<std::vector<SearchResult>> search_batch(const std::vector<std::vector<float>>& queries,
+                                                                    std::size_t k,
+                                                                    std::size_t threads = 0) const;
+
+  void save(const std::string& path) const;
+  // With map = true the rows are served from the mapped file until the first add or remove.
+  static FlatIndex load(const std::string& path, bool map = true);
+
+private:
+  FlatIndex(Metric metric, VectorStorage vectors);
+
+  void score_block(const float* const* queries,
+                   std::size_t query_count,
+                   std::size_t first_row,
+                   std::size_t last_row,
+                   std::size_t k,
+                   std::vector<SearchResult>* heaps) const;
+
+  Metric metric_;
+  VectorStorage vectors_;
+  std::vector<std::uint64_t> ids_;
+  std::unordered_map<std::uint64_t, std::size_t> rows_;
+};
+
+}  // namespace openai::index
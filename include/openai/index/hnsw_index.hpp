@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "openai/embedding_matrix.hpp"
+#include "openai/index/distance.hpp"
+#include "openai/index/vector_storage.hpp"
+
+namespace openai::index {
+
+struct HnswOptions {
+  // Links per node on the upper layers; layer 0 keeps twice as many.
+  std::size_t m = 16;
+  std::size_t ef_construction = 200;
+  // Default candidate list size for search(); raised to k when smaller.
+  std::size_t ef_search = 64;
+  std::uint64_t seed = 100;
+};
+
+/**
+ * Approximate nearest-neighbour search over a hierarchical navigable small world graph. Vectors live in
+ * the same padded row layout as FlatIndex; each node's layer-0 links sit in one flat array so a search
+ * touches contiguous memory. remove() leaves a tombstone that is still traversed but never returned,
+ * so an index with many removals returns fewer than k results until it is rebuilt. Searches may run
+ * concurrently with each other but not with add/remove.
+ */
+class HnswIndex {
+public:
+  explicit HnswIndex(std::size_t dimensions, Metric metric = Metric::Cosine, HnswOptions options = {});
+
+  HnswIndex(HnswIndex&& other) noexcept;
+  HnswIndex& operator=(HnswIndex&& other) noexcept;
+  HnswIndex(const HnswIndex&) = delete;
+  HnswIndex& operator=(const HnswIndex&) = delete;
+
+  [[nodiscard]] std::size_t dimensions() const { return vectors_.dimensions(); }
+  [[nodiscard]] Metric metric() const { return metric_; }
+  [[nodiscard]] const HnswOptions& options() const { return options_; }
+  // Live (not removed) vectors.
+  [[nodiscard]] std::size_t size() const { return live_.size(); }
+  [[nodiscard]] std::size_t node_count() const { return ids_.size(); }
+  [[nodiscard]] bool contains(std::uint64_t id) const { return live_.count(id) > 0; }
+
+  void set_ef_search(std::size_t ef) { options_.ef_search = ef; }
+
+  void reserve(std::size_t nodes);
+  // Re-adding a live id tombstones the old node and inserts the new vector.
+  void add(std::uint64_t id, const float* values);
+  void add(std::uint64_t id, const std::vector<float>& values);
+  void add(const EmbeddingMatrix& matrix, std::uint64_t first_id = 0);
+  bool remove(std::uint64_t id);
+
+  // `ef` overrides options().ef_search for this call when non-zero. Results are ordered best first.
+  [[nodiscard]] std::vector<SearchResult> search(const float* query, std::size_t k, std::size_t ef = 0) const;
+  [[nodiscard]] std::vector<SearchResult> search(const std::vector<float>& query,
+                                                 std::size_t k,
+                                                 std::size_t ef = 0) const;
+  [[nodiscard]] std::vector<std::vector<SearchResult>> search_batch(const std::vector<std::vector<float>>& queries,
+                                                                    std::size_t k,
+                                                                    std::size_t threads = 0,
+                                                                    std::size_t ef = 0) const;
+
+  void save(const std::string& path) const;
+  // With map = true the vectors are served from the mapped file; the graph is always loaded into memory.
+  static HnswIndex load(const std::string& path, bool map = true);
+
+private:
+  struct Candidate {
+    float distance;
+    std::uint32_t node;
+  };
+
+  struct VisitedSet {
+    std::vector<std::uint32_t> marks;
+    std::uint32_t epoch = 0;
+  };
+
+  [[nodiscard]] std::size_t max_links(int level) const { return level == 0 ? 2 * options_.m : options_.m; }
+  [[nodiscard]] std::uint32_t* links(std::uint32_t node, int level);
+  [[nodiscard]] const std::uint32_t* links(std::uint32_t node, int level) const;
+  [[nodiscard]] float distance(const float* query, std::uint32_t node) const;
+
+  int random_level();
+  std::uint32_t greedy_descend(const float* query, std::uint32_t entry, int from_level, int to_level) const;
+  std::vector<Candidate> search_layer(const float* query, std::uint32_t entry, std::size_t ef, int level) const;
+  std::vector<std::uint32_t> select_neighbors(std::vector<Candidate> candidates, std::size_t limit) const;
+  void connect(std::uint32_t node, const std::vector<std::uint32_t>& neighbors, int level);
+
+  std::unique_ptr<VisitedSet> acquire_visited() const;
+  void release_visited(std::unique_ptr<VisitedSet> visited) const;
+
+  Metric metric_;
+  HnswOptions options_;
+  VectorStorage vectors_;
+  std::vector<std::uint64_t> ids_;
+  std::vector<std::uint8_t> deleted_;
+  std::vector<int> levels_;
+  // Layer 0: for each node, a count followed by 2 * m slots.
+  std::vector<std::uint32_t> level0_;
+  // Layers 1..level: for each node, `level` blocks of a count followed by m slots.
+  std::vector<std::vector<std::uint32_t>> upper_;
+  std::unordered_map<std::uint64_t, std::uint32_t> live_;
+  std::uint32_t entry_point_ = 0;
+  int max_level_ = -1;
+  std::mt19937_64 rng_;
+
+  mutable std::mutex visited_mutex_;
+  mutable std::vector<std::unique_ptr<VisitedSet>> visited_pool_;
+};
+
+}  // namespace openai::index
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "openai/embedding_matrix.hpp"
+#include "openai/index/distance.hpp"
+#include "openai/utils/mapped_file.hpp"
+
+namespace openai::index {
+
+struct SearchResult {
+  std::uint64_t id = 0;
+  float score = 0.0f;
+};
+
+/**
+ * Growable float32 rows in the EmbeddingMatrix layout: one 64-byte-aligned allocation with every row
+ * padded to a 64-byte stride. Rows may instead be borrowed from a memory-mapped index file, in which
+ * case the first mutation copies them into owned memory.
+ */
+class VectorStorage {
+public:
+  explicit VectorStorage(std::size_t dimensions = 0);
+
+  [[nodiscard]] std::size_t dimensions() const { return dimensions_; }
+  [[nodiscard]] std::size_t stride() const { return stride_; }
+  [[nodiscard]] std::size_t size() const { return size_; }
+  [[nodiscard]] bool mapped() const { return mapping_ != nullptr; }
+
+  [[nodiscard]] const float* row(std::size_t index) const { return base_ + index * stride_; }
+  [[nodiscard]] float* mutable_row(std::size_t index);
+
+  // Appends a row and returns its index; the padding after `dimensions` stays zero.
+  std::size_t push_back(const float* values);
+  void pop_back();
+  void reserve(std::size_t rows);
+
+  // Borrows `rows` rows that start at `data` inside `mapping`.
+  void borrow(std::shared_ptr<const utils::MappedFile> mapping, const float* data, std::size_t rows);
+
+private:
+  void reallocate(std::size_t capacity);
+
+  std::size_t dimensions_ = 0;
+  std::size_t stride_ = 0;
+  std::size_t size_ = 0;
+  EmbeddingMatrix owned_;
+  std::shared_ptr<const utils::MappedFile> mapping_;
+  const float* base_ = nullptr;
+};
+
+enum class IndexKind : std::uint32_t {
+  Flat = 0,
+  Hnsw = 1,
+};
+
+struct IndexFileContents {
+  Metric metric = Metric::Cosine;
+  std::vector<std::uint64_t> ids;
+  // Index-specific section, e.g. the HNSW graph.
+  std::string extra;
+  VectorStorage vectors;
+};
+
+/**
+ * Index files hold a fixed header, the row ids, an index-specific section and then the rows themselves
+ * at a 64-byte-aligned offset in their in-memory layout, so read_index_file(..., map = true) can serve
+ * them straight from the page cache. Files are written to a temporary path and renamed into place.
+ */
+void write_index_file(const std::string& path,
+                      IndexKind kind,
+                      Metric metric,
+                      const VectorStorage& vectors,
+                      const std::vector<std::uint64_t>& ids,
+                      std::string_view extra = {});
+
+IndexFileContents read_index_file(const std::string& path, IndexKind kind, bool map);
+
+}  // namespace openai::index
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+
+namespace openai {
+
+class OpenAIClient;
+
+struct LocalBatchOptions {
+  // Lines sent at once.
+  std::size_t max_concurrency = 8;
+  // Keeps lines already present in the output and error files and runs only the rest, appending to
+  // both. When false the files are truncated first.
+  bool resume = true;
+  std::function<void(std::size_t completed_lines, std::size_t total_lines)> on_progress;
+};
+
+struct LocalBatchSummary {
+  std::size_t total = 0;
+  std::size_t succeeded = 0;
+  std::size_t failed = 0;
+  // Lines found in the output or error file from an earlier run.
+  std::size_t skipped = 0;
+};
+
+/**
+ * Runs a Batch API input file right away instead of within the batch completion window. Each line's
+ * body is posted to its url through the client, with the url's leading "/v1" left to the client's base
+ * URL as for every other request, so the client's retries and Retry-After handling apply,
+ * with up to max_concurrency requests in flight. Results are appended in the Batch API's own line
+ * format: responses with a 2xx status to the output file, the rest to the error file, so
+ * BatchResultReader and other consumers of batch output read either. Lines are flushed as they finish;
+ * a torn final line left by a crash is dropped when the run is resumed.
+ */
+class LocalBatchExecutor {
+public:
+  explicit LocalBatchExecutor(OpenAIClient& client, LocalBatchOptions options = {});
+
+  LocalBatchSummary run(const std::string& input_path,
+                        const std::string& output_path,
+                        const std::string& error_path) const;
+
+private:
+  OpenAIClient& client_;
+  LocalBatchOptions options_;
+};
+
+}  // namespace openai
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace openai {
+
+struct ResponseStreamEvent;
+struct RunStepDeltaEvent;
+
+/**
+ * Resumable JSON parser for documents that arrive as string fragments, such as streamed tool-call
+ * arguments or `json_schema` structured output. Each fragment is scanned once; value() exposes the
+ * document built so far. Object members and array elements appear as soon as their value starts:
+ * strings grow in place while they stream, containers start empty, and numbers and literals are
+ * added once their token is terminated. Malformed input throws OpenAIError.
+ */
+class PartialJsonParser {
+public:
+  PartialJsonParser();
+
+  PartialJsonParser(const PartialJsonParser&) = delete;
+  PartialJsonParser& operator=(const PartialJsonParser&) = delete;
+
+  void feed(std::string_view fragment);
+
+  // Flushes a trailing top-level number and throws unless the document is complete.
+  const nlohmann::json& finish();
+
+  void reset();
+
+  [[nodiscard]] const nlohmann::json& value() const { return root_; }
+  [[nodiscard]] bool started() const { return started_; }
+  [[nodiscard]] bool complete() const { return state_ == State::Done; }
+  [[nodiscard]] std::size_t bytes_consumed() const { return consumed_; }
+
+private:
+  enum class State {
+    Value,
+    ArrayValueOrEnd,
+    ObjectKeyOrEnd,
+    ObjectKey,
+    Colon,
+    CommaOrEnd,
+    String,
+    Token,
+    Done,
+  };
+
+  void step(char c);
+  void begin_value(char c);
+  void end_value();
+  void string_char(char c);
+  void finish_token();
+  void append_code_point(std::uint32_t code_point);
+  void flush_surrogate();
+  nlohmann::json* place(nlohmann::json value);
+  [[noreturn]] void fail(const std::string& message) const;
+
+  nlohmann::json root_;
+  std::vector<nlohmann::json*> stack_;
+  State state_ = State::Value;
+  bool started_ = false;
+  std::size_t consumed_ = 0;
+
+  bool string_is_key_ = false;
+  std::string key_;
+  std::string pending_key_;
+  std::string* string_out_ = nullptr;
+  int escape_ = 0;
+  std::uint32_t unicode_ = 0;
+  std::uint32_t high_surrogate_ = 0;
+  std::string token_;
+};
+
+/**
+ * Keeps one PartialJsonParser per streamed call, keyed by whatever identifies the call in its stream.
+ * The overloads route the SDK's own delta shapes: Responses `response.function_call_arguments.delta`
+ * events (keyed by item_id), Chat Completions chunks (`<choice index>:<tool call index>`) and
+ * assistant run-step deltas (`<step id>:<tool call index>`).
+ */
+class PartialJsonTracker {
+public:
+  const nlohmann::json& feed(const std::string& key, std::string_view fragment);
+
+  void feed(const ResponseStreamEvent& event);
+  void feed(const RunStepDeltaEvent& event);
+  void feed_chat_chunk(const nlohmann::json& chunk);
+
+  [[nodiscard]] const PartialJsonParser* find(const std::string& key) const;
+  [[nodiscard]] std::vector<std::string> keys() const;
+
+  void erase(const std::string& key);
+
+private:
+  std::map<std::string, PartialJsonParser> parsers_;
+};
+
+}  // namespace openai
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "openai/batches.hpp"
+#include "openai/fine_tuning.hpp"
+#include "openai/responses.hpp"
+#include "openai/runs.hpp"
+#include "openai/vector_stores.hpp"
+#include "openai/videos.hpp"
+
+namespace openai {
+
+class OpenAIClient;
+struct HttpResponse;
+
+struct PollSchedulerOptions {
+  // Threads issuing poll requests; every pending poll shares them.
+  std::size_t workers = 2;
+  // Delay before the first poll of an object.
+  std::chrono::milliseconds first_poll_delay{0};
+  // Delay before the second poll of an object, growing by backoff_multiplier after each further poll up
+  // to max_interval. An openai-poll-after-ms response header takes precedence.
+  std::chrono::milliseconds initial_interval{1000};
+  std::chrono::milliseconds max_interval{30000};
+  double backoff_multiplier = 1.5;
+  // Each delay is scaled by a random factor in [1 - jitter, 1 + jitter] so polls started together spread out.
+  double jitter = 0.2;
+};
+
+// Receives the object in its terminal state, or a default value and the error that ended the poll.
+template <typename T>
+using PollCallback = std::function<void(T result, std::exception_ptr error)>;
+
+/**
+ * Polls many long-running objects without a thread per object. Each pending poll sits in a min-heap
+ * keyed by when it is next due; a small set of workers sleeps until the earliest one, retrieves it and
+ * either completes it or pushes it back with a longer delay. A poll that fails with a transient error
+ * (see is_transient_error) is pushed back the same way; any other error ends it. Completion is reported
+ * through a future or a callback, which runs on a worker thread. Destroying the scheduler fails the
+ * polls still pending.
+ */
+class PollScheduler {
+public:
+  explicit PollScheduler(OpenAIClient& client, PollSchedulerOptions options = {});
+  ~PollScheduler();
+
+  PollScheduler(const PollScheduler&) = delete;
+  PollScheduler& operator=(const PollScheduler&) = delete;
+
+  // Until the run is completed, requires_action, failed, cancelled, incomplete or expired.
+  std::future<Run> run(const std::string& thread_id, const std::string& run_id);
+  void run(const std::string& thread_id, const std::string& run_id, PollCallback<Run> on_done);
+
+  // Until the batch is completed, failed, expired or cancelled.
+  std::future<Batch> batch(const std::string& batch_id);
+  void batch(const std::string& batch_id, PollCallback<Batch> on_done);
+
+  // Until the file or file batch is no longer in_progress.
+  std::future<VectorStoreFile> vector_store_file(const std::string& vector_store_id, const std::string& file_id);
+  void vector_store_file(const std::string& vector_store_id,
+                         const std::string& file_id,
+                         PollCallback<VectorStoreFile> on_done);
+  std::future<VectorStoreFileBatch> vector_store_file_batch(const std::string& vector_store_id,
+                                                            const std::string& batch_id);
+  void vector_store_file_batch(const std::string& vector_store_id,
+                               const std::string& batch_id,
+                               PollCallback<VectorStoreFileBatch> on_done);
+
+  // Until the job succeeded, failed or was cancelled.
+  std::future<FineTuningJob> fine_tuning_job(const std::string& job_id);
+  void fine_tuning_job(const std::string& job_id, PollCallback<FineTuningJob> on_done);
+
+  // Until the video is completed or failed.
+  std::future<Video> video(const std::string& video_id);
+  void video(const std::string& video_id, PollCallback<Video> on_done);
+
+  // Until the background response is completed, failed, cancelled or incomplete.
+  std::future<Response> response(const std::string& response_id);
+  void response(const std::string& response_id, PollCallback<Response> on_done);
+
+  // Polls waiting for their next turn.
+  [[nodiscard]] std::size_t pending() const;
+
+private:
+  struct Task {
+    std::string path;
+    bool assistants_beta = false;
+    // Returns true once the response shows the object is done and the callback has been called.
+    std::function<bool(const HttpResponse&)> finish;
+    std::function<void(std::exception_ptr)> fail;
+    std::chrono::milliseconds interval{0};
+  };
+
+  struct Entry {
+    std::chrono::steady_clock::time_point due;
+    std::uint64_t sequence = 0;
+    std::shared_ptr<Task> task;
+
+    bool operator>(const Entry& other) const {
+      return due != other.due ? due > other.due : sequence > other.sequence;
+    }
+  };
+
+  template <typename T>
+  void schedule(std::string path,
+                bool assistants_beta,
+                std::function<T(const nlohmann::json&)> parse,
+                std::function<bool(const T&)> done,
+                PollCallback<T> on_done);
+  template <typename T>
+  static PollCallback<T> fulfil(std::shared_ptr<std::promise<T>> promise);
+
+  void push(std::shared_ptr<Task> task, std::chrono::milliseconds delay);
+  void work();
+  std::chrono::milliseconds next_delay(Task& task, const HttpResponse& response);
+  std::chrono::milliseconds backoff(Task& task);
+
+  OpenAIClient& client_;
+  PollSchedulerOptions options_;
+  mutable std::mutex mutex_;
+  std::condition_variable wake_;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap_;
+  std::uint64_t sequence_ = 0;
+  bool stopping_ = false;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace openai
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <map>
@@ -898,6 +900,12 @@ struct ResponseRetrieveOptions {
   std::optional<int> starting_after;
 };
 
+struct ResponseStreamResumeOptions {
+  std::size_t max_reconnects = 5;
+  std::optional<std::chrono::milliseconds> idle_timeout;
+  std::optional<std::chrono::milliseconds> reconnect_delay;
+};
+
 struct ResponseList {
   std::vector<Response> data;
   bool has_more = false;
@@ -1155,7 +1163,16 @@ struct ResponseStreamEvent {
   nlohmann::json raw = nlohmann::json::object();
 };
 
+struct ResponseStreamDecodeOptions {
+  // Decode `response.output_text.delta` events in one pass without building a JSON DOM. Such events
+  // leave `raw` and `text_delta->raw` empty, so fields the typed struct does not model (for example
+  // `obfuscation`) are dropped.
+  bool fast_text_deltas = false;
+};
+
 std::optional<ResponseStreamEvent> parse_response_stream_event(const struct ServerSentEvent& event);
+std::optional<ResponseStreamEvent> parse_response_stream_event(const struct ServerSentEvent& event,
+                                                               const ResponseStreamDecodeOptions& options);
 
 class OpenAIClient;
 template <typename Item>
@@ -1207,10 +1224,24 @@ public:
               const std::function<bool(const ResponseStreamEvent&)>& on_event,
               const struct RequestOptions& options) const;
 
+  // Reconnects after a dropped connection by resuming from the last delivered sequence_number. Only
+  // a stream that has already delivered response.created can be resumed; a drop before that point
+  // throws the connection error. Resuming requires a stored response (background=true).
+  void stream_resumable(const ResponseRequest& request,
+                        const std::function<bool(const ResponseStreamEvent&)>& on_event) const;
+  void stream_resumable(const ResponseRequest& request,
+                        const std::function<bool(const ResponseStreamEvent&)>& on_event,
+                        const ResponseStreamResumeOptions& resume_options,
+                        const struct RequestOptions& options) const;
+
   std::vector<ServerSentEvent> retrieve_stream(const std::string& response_id) const;
   std::vector<ServerSentEvent> retrieve_stream(const std::string& response_id,
                                                const ResponseRetrieveOptions& retrieve_options,
                                                const struct RequestOptions& options) const;
+  void retrieve_stream(const std::string& response_id,
+                       const ResponseRetrieveOptions& retrieve_options,
+                       const std::function<bool(const ResponseStreamEvent&)>& on_event,
+                       const struct RequestOptions& options) const;
 
   InputItemsResource& input_items() { return input_items_; }
   const InputItemsResource& input_items() const { return input_items_; }
@@ -1220,4 +1251,8 @@ private:
   InputItemsResource input_items_;
 };
 
+// The /v1/responses request body, as sent by ResponsesResource::create.
+nlohmann::json build_response_request_body(const ResponseRequest& request);
+Response parse_response_json(const nlohmann::json& payload);
+
 }  // namespace openai
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "openai/http_client.hpp"
+
+namespace openai {
+
+struct CapturedChunk {
+  std::chrono::nanoseconds offset{0};
+  std::string data;
+};
+
+struct CapturedExchange {
+  std::string method;
+  std::string url;
+  std::vector<CapturedChunk> chunks;
+  long status_code = 0;
+  std::map<std::string, std::string> headers;
+  std::optional<std::string> error;
+  std::chrono::nanoseconds duration{0};
+};
+
+/**
+ * Appends raw response chunks, with their arrival offsets relative to the start of each request,
+ * to a compact binary capture file. Attach it to a call through RequestOptions::stream_capture.
+ * A single writer may be shared by concurrent requests; records carry an exchange id. Opening an
+ * existing capture appends to it, continuing the exchange ids of earlier sessions and dropping a
+ * trailing record torn by a crash. Write failures throw OpenAIError.
+ */
+class StreamCaptureWriter {
+public:
+  explicit StreamCaptureWriter(const std::string& path);
+  ~StreamCaptureWriter();
+
+  StreamCaptureWriter(const StreamCaptureWriter&) = delete;
+  StreamCaptureWriter& operator=(const StreamCaptureWriter&) = delete;
+
+  std::uint32_t begin_exchange(const std::string& method, const std::string& url);
+  void record_chunk(std::uint32_t exchange_id, const char* data, std::size_t size);
+  void end_exchange(std::uint32_t exchange_id, long status_code, const std::map<std::string, std::string>& headers);
+  void fail_exchange(std::uint32_t exchange_id, const std::string& message);
+  void flush();
+
+private:
+  std::uint64_t elapsed_ns(std::uint32_t exchange_id) const;
+  void write_record(std::uint8_t type, std::uint32_t exchange_id, std::uint64_t offset_ns, const char* data,
+                    std::size_t size);
+
+  std::FILE* file_ = nullptr;
+  std::mutex mutex_;
+  std::uint32_t next_exchange_id_ = 0;
+  std::map<std::uint32_t, std::chrono::steady_clock::time_point> started_;
+};
+
+/**
+ * Reads every exchange from a capture file in the order the requests started. Exchanges that were
+ * still open when the file ends (e.g. the process crashed) are returned with an error set.
+ */
+std::vector<CapturedExchange> read_stream_capture(const std::string& path);
+
+enum class StreamReplayPacing {
+  Original,
+  MaxSpeed,
+};
+
+/**
+ * HttpClient that answers each request with the next captured exchange, delivering its chunks
+ * through on_chunk either at the recorded pacing or back-to-back.
+ */
+class StreamReplayHttpClient final : public HttpClient {
+public:
+  explicit StreamReplayHttpClient(std::vector<CapturedExchange> exchanges,
+                                  StreamReplayPacing pacing = StreamReplayPacing::MaxSpeed);
+
+  static std::unique_ptr<StreamReplayHttpClient> from_file(const std::string& path,
+                                                           StreamReplayPacing pacing = StreamReplayPacing::MaxSpeed);
+
+  HttpResponse request(const HttpRequest& request) override;
+
+  [[nodiscard]] std::size_t remaining() const;
+
+private:
+  std::deque<CapturedExchange> exchanges_;
+  StreamReplayPacing pacing_;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace openai
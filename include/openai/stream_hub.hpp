@@ -0,0 +1,274 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "openai/error.hpp"
+
+namespace openai {
+
+enum class StreamHubOverflowPolicy {
+  // The publisher waits for the subscriber to catch up; use for consumers that must see every event.
+  Block,
+  // Events that do not fit are discarded for that subscriber only and counted in dropped().
+  DropNewest,
+};
+
+struct StreamSubscriberOptions {
+  std::size_t capacity = 1024;
+  StreamHubOverflowPolicy overflow = StreamHubOverflowPolicy::DropNewest;
+  bool replay_history = true;
+};
+
+struct StreamHubOptions {
+  std::size_t history_size = 0;
+};
+
+namespace detail {
+
+// Single-producer / single-consumer ring. The hub serialises publishers, so each ring only ever sees
+// one writer, and a subscription has exactly one reader. The mutex/condvar pair only parks idle
+// threads: each side publishes its index and then checks the other's waiting flag (both seq_cst),
+// so a waiter either sees the new index in its predicate or is notified under wait_mutex_.
+template <typename Event>
+class StreamRing {
+public:
+  StreamRing(std::size_t capacity, StreamHubOverflowPolicy overflow)
+      : slots_(round_up_pow2(std::max<std::size_t>(capacity, 2))),
+        mask_(slots_.size() - 1),
+        overflow_(overflow) {}
+
+  bool push(const Event& event) {
+    const std::size_t tail = tail_.load(std::memory_order_relaxed);
+    while (tail - head_.load(std::memory_order_acquire) > mask_) {
+      if (overflow_ == StreamHubOverflowPolicy::DropNewest || cancelled_.load(std::memory_order_acquire)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      }
+      std::unique_lock<std::mutex> lock(wait_mutex_);
+      producer_waiting_.store(true);
+      space_ready_.wait(lock, [&] { return tail - head_.load() <= mask_ || cancelled_.load(); });
+      producer_waiting_.store(false);
+    }
+    slots_[tail & mask_] = event;
+    tail_.store(tail + 1);
+    wake(consumer_waiting_, data_ready_);
+    return true;
+  }
+
+  std::optional<Event> try_pop() {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) {
+      return std::nullopt;
+    }
+    std::optional<Event> event = std::move(slots_[head & mask_]);
+    slots_[head & mask_].reset();
+    head_.store(head + 1);
+    wake(producer_waiting_, space_ready_);
+    return event;
+  }
+
+  std::optional<Event> pop(std::optional<std::chrono::milliseconds> timeout) {
+    if (auto event = try_pop()) {
+      return event;
+    }
+    {
+      std::unique_lock<std::mutex> lock(wait_mutex_);
+      consumer_waiting_.store(true);
+      auto ready = [&] { return head_.load() != tail_.load() || closed_.load() || cancelled_.load(); };
+      if (timeout) {
+        data_ready_.wait_for(lock, *timeout, ready);
+      } else {
+        data_ready_.wait(lock, ready);
+      }
+      consumer_waiting_.store(false);
+    }
+    return try_pop();
+  }
+
+  void close() {
+    closed_.store(true, std::memory_order_release);
+    notify_all();
+  }
+
+  void cancel() {
+    cancelled_.store(true, std::memory_order_release);
+    notify_all();
+  }
+
+  bool empty() const { return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire); }
+  bool closed() const { return closed_.load(std::memory_order_acquire); }
+  bool cancelled() const { return cancelled_.load(std::memory_order_acquire); }
+  std::size_t capacity() const { return slots_.size(); }
+  std::size_t size() const {
+    return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+  }
+  std::size_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+  static std::size_t round_up_pow2(std::size_t value) {
+    std::size_t result = 1;
+    while (result < value) {
+      result <<= 1;
+    }
+    return result;
+  }
+
+  void wake(const std::atomic<bool>& waiting, std::condition_variable& cv) {
+    if (waiting.load()) {
+      std::lock_guard<std::mutex> lock(wait_mutex_);
+      cv.notify_one();
+    }
+  }
+
+  void notify_all() {
+    std::lock_guard<std::mutex> lock(wait_mutex_);
+    data_ready_.notify_all();
+    space_ready_.notify_all();
+  }
+
+  std::vector<std::optional<Event>> slots_;
+  const std::size_t mask_;
+  const StreamHubOverflowPolicy overflow_;
+  alignas(64) std::atomic<std::size_t> head_{0};
+  alignas(64) std::atomic<std::size_t> tail_{0};
+  std::atomic<std::size_t> dropped_{0};
+  std::atomic<bool> closed_{false};
+  std::atomic<bool> cancelled_{false};
+  std::atomic<bool> consumer_waiting_{false};
+  std::atomic<bool> producer_waiting_{false};
+  std::mutex wait_mutex_;
+  std::condition_variable data_ready_;
+  std::condition_variable space_ready_;
+};
+
+}  // namespace detail
+
+// A subscription has a single consumer: next()/try_next() must not be called from more than one
+// thread at a time.
+template <typename Event>
+class StreamSubscription {
+public:
+  explicit StreamSubscription(std::shared_ptr<detail::StreamRing<Event>> ring) : ring_(std::move(ring)) {}
+  ~StreamSubscription() { unsubscribe(); }
+
+  StreamSubscription(const StreamSubscription&) = delete;
+  StreamSubscription& operator=(const StreamSubscription&) = delete;
+
+  // Blocks until an event is available, the hub closes, or the timeout expires. Returns nullopt once
+  // the hub is closed and every buffered event has been consumed.
+  std::optional<Event> next(std::optional<std::chrono::milliseconds> timeout = std::nullopt) {
+    return ring_->pop(timeout);
+  }
+
+  std::optional<Event> try_next() { return ring_->try_pop(); }
+
+  void unsubscribe() { ring_->cancel(); }
+
+  [[nodiscard]] bool finished() const { return (ring_->closed() || ring_->cancelled()) && ring_->empty(); }
+  [[nodiscard]] std::size_t pending() const { return ring_->size(); }
+  [[nodiscard]] std::size_t dropped() const { return ring_->dropped(); }
+
+private:
+  std::shared_ptr<detail::StreamRing<Event>> ring_;
+};
+
+template <typename Event>
+class StreamHub {
+public:
+  explicit StreamHub(StreamHubOptions options = {}) : options_(options) {}
+  ~StreamHub() { close(); }
+
+  StreamHub(const StreamHub&) = delete;
+  StreamHub& operator=(const StreamHub&) = delete;
+
+  std::unique_ptr<StreamSubscription<Event>> subscribe(const StreamSubscriberOptions& options = {}) {
+    auto ring = std::make_shared<detail::StreamRing<Event>>(options.capacity, options.overflow);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (options.replay_history) {
+      const std::size_t replay = std::min(history_.size(), ring->capacity());
+      for (auto it = history_.end() - static_cast<std::ptrdiff_t>(replay); it != history_.end(); ++it) {
+        ring->push(*it);
+      }
+    }
+    if (closed_) {
+      ring->close();
+    } else {
+      rings_.push_back(ring);
+    }
+    return std::make_unique<StreamSubscription<Event>>(std::move(ring));
+  }
+
+  // Under StreamHubOverflowPolicy::Block this waits for slow subscribers, but only other publishers
+  // queue behind it; subscribe(), close() and subscriber_count() do not.
+  void publish(const Event& event) {
+    std::lock_guard<std::mutex> publish_lock(publish_mutex_);
+    std::vector<std::shared_ptr<detail::StreamRing<Event>>> rings;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (closed_) {
+        throw OpenAIError("StreamHub::publish called after close()");
+      }
+      if (options_.history_size > 0) {
+        if (history_.size() == options_.history_size) {
+          history_.pop_front();
+        }
+        history_.push_back(event);
+      }
+      rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                  [](const auto& ring) { return ring->cancelled(); }),
+                   rings_.end());
+      rings = rings_;
+    }
+    for (const auto& ring : rings) {
+      ring->push(event);
+    }
+  }
+
+  // Adapter for the `on_event` callbacks used by SSEEventStream and the typed stream() overloads.
+  std::function<bool(const Event&)> publisher() {
+    return [this](const Event& event) {
+      publish(event);
+      return true;
+    };
+  }
+
+  void close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (closed_) {
+      return;
+    }
+    closed_ = true;
+    for (const auto& ring : rings_) {
+      ring->close();
+    }
+    rings_.clear();
+  }
+
+  [[nodiscard]] std::size_t subscriber_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<std::size_t>(std::count_if(rings_.begin(), rings_.end(),
+                                                  [](const auto& ring) { return !ring->cancelled(); }));
+  }
+
+private:
+  StreamHubOptions options_;
+  // Held for a whole publish() so each ring keeps a single producer.
+  std::mutex publish_mutex_;
+  mutable std::mutex mutex_;
+  std::vector<std::shared_ptr<detail::StreamRing<Event>>> rings_;
+  std::deque<Event> history_;
+  bool closed_ = false;
+};
+
+}  // namespace openai
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace openai {
+
+struct StreamStats {
+  std::string endpoint;
+  std::optional<std::chrono::nanoseconds> time_to_first_byte;
+  std::optional<std::chrono::nanoseconds> time_to_first_content;
+  std::chrono::nanoseconds total_duration{0};
+  std::vector<std::chrono::nanoseconds> inter_delta_gaps;
+  std::size_t bytes = 0;
+  std::size_t events = 0;
+  std::size_t content_deltas = 0;
+
+  // Content deltas per second between the first and the last delta. The API emits roughly one token
+  // per delta, so this is the decode rate the caller observed.
+  [[nodiscard]] double tokens_per_second() const;
+
+  // Nearest-rank percentile of inter_delta_gaps; `percentile` is in [0, 100]. Zero when fewer than
+  // two deltas arrived.
+  [[nodiscard]] std::chrono::nanoseconds inter_delta_percentile(double percentile) const;
+};
+
+using StreamStatsCallback = std::function<void(const StreamStats&)>;
+
+/**
+ * Collects StreamStats for one streaming call. The streaming paths attach it to their SSEEventStream,
+ * which reports bytes as they reach on_chunk and classifies each dispatched event. The stats are
+ * published to the per-call target and the client-wide callback once, when the recorder finishes or
+ * is destroyed.
+ */
+class StreamStatsRecorder {
+public:
+  StreamStatsRecorder(std::string endpoint, std::shared_ptr<StreamStats> target, StreamStatsCallback callback);
+  ~StreamStatsRecorder();
+
+  StreamStatsRecorder(const StreamStatsRecorder&) = delete;
+  StreamStatsRecorder& operator=(const StreamStatsRecorder&) = delete;
+
+  void on_bytes(std::size_t size);
+  void on_event(bool content_delta);
+  void on_event(bool content_delta, std::chrono::steady_clock::time_point arrived);
+  void finish();
+
+  [[nodiscard]] const StreamStats& stats() const { return stats_; }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  StreamStats stats_;
+  std::shared_ptr<StreamStats> target_;
+  StreamStatsCallback callback_;
+  Clock::time_point start_;
+  Clock::time_point last_delta_;
+  bool finished_ = false;
+};
+
+}  // namespace openai
@@ -1,10 +1,13 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <optional>
 #include <string>
 #include <vector>
 
+#include "openai/stream_stats.hpp"
+
 namespace openai {
 
 struct ServerSentEvent {
@@ -31,9 +34,17 @@ private:
 class SSEEventStream {
 public:
   using EventHandler = std::function<bool(const ServerSentEvent&)>;
+  using ContentClassifier = bool (*)(const ServerSentEvent&);
 
   explicit SSEEventStream(EventHandler handler = nullptr);
 
+  // Reports bytes and events to `recorder`; `is_content` decides which events count as content deltas.
+  // A null recorder leaves the stream unmeasured. Handlers that parse each event can pass a null
+  // classifier and call mark_content() instead.
+  void track_stats(std::shared_ptr<StreamStatsRecorder> recorder, ContentClassifier is_content);
+  // Counts the event currently being handled as a content delta. Only meaningful inside the handler.
+  void mark_content() { current_is_content_ = true; }
+
   void feed(const char* data, std::size_t size);
   void finalize();
   void stop();
@@ -46,7 +57,10 @@ private:
 
   SSEParser parser_;
   EventHandler handler_;
+  std::shared_ptr<StreamStatsRecorder> stats_;
+  ContentClassifier is_content_ = nullptr;
   std::vector<ServerSentEvent> events_;
+  bool current_is_content_ = false;
   bool stopped_ = false;
 };
 
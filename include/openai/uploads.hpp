@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <optional>
 #include <string>
 #include <vector>
@@ -59,6 +60,26 @@ struct UploadPartCreateParams {
   std::optional<std::string> content_type;
 };
 
+struct UploadFileOptions {
+  // Bytes per part; the API accepts parts of up to 64 MB.
+  std::size_t part_size = 64 * 1024 * 1024;
+  // Parts uploaded at once. At most max_concurrency * part_size bytes of the file are held in memory.
+  std::size_t max_concurrency = 4;
+  // Sends of a single part before upload_file fails; a part is only resent after a failure that
+  // is_transient_error() accepts.
+  std::size_t max_part_attempts = 3;
+  // Defaults to the basename of the path.
+  std::optional<std::string> filename;
+  std::optional<UploadCreateExpiresAfter> expires_after;
+  // Sends the file's MD5 with complete() so the server can verify the assembled bytes.
+  bool verify_md5 = true;
+  // When set, progress is saved here after every finished part. A later call with the same file, part
+  // size and checkpoint path resumes that Upload, sending only the missing parts, unless it is about to
+  // expire. The file is removed once the Upload completes or is cancelled.
+  std::optional<std::string> checkpoint_path;
+  std::function<void(std::size_t uploaded_bytes, std::size_t total_bytes)> on_progress;
+};
+
 class UploadPartsResource {
 public:
   explicit UploadPartsResource(OpenAIClient& client) : client_(client) {}
@@ -87,6 +108,19 @@ public:
                   const UploadCompleteParams& params,
                   const RequestOptions& options) const;
 
+  // Creates an Upload, streams the file into it as concurrently uploaded parts and completes it with the
+  // parts in file order. On failure the Upload is cancelled and the error rethrown, except that a
+  // transient failure with a checkpoint_path leaves it open to be resumed.
+  Upload upload_file(const std::string& path,
+                     const std::string& purpose,
+                     const std::string& mime_type,
+                     const UploadFileOptions& upload_options = {}) const;
+  Upload upload_file(const std::string& path,
+                     const std::string& purpose,
+                     const std::string& mime_type,
+                     const UploadFileOptions& upload_options,
+                     const RequestOptions& options) const;
+
   UploadPartsResource& parts() { return parts_; }
   const UploadPartsResource& parts() const { return parts_; }
 
@@ -1,12 +1,24 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <string_view>
 #include <vector>
 
 namespace openai::utils {
 
+/** Number of bytes `input` decodes to, ignoring surrounding whitespace. Throws on a malformed length. */
+std::size_t decoded_base64_size(std::string_view input);
+
+/**
+ * Decodes `input` into `out` and returns the number of bytes written. Uses AVX2 or SSSE3 when the CPU
+ * supports them and a scalar loop otherwise; throws OpenAIError on characters outside the alphabet.
+ */
+std::size_t decode_base64_into(std::string_view input, std::uint8_t* out, std::size_t capacity);
+
 std::vector<std::uint8_t> decode_base64(std::string_view input);
 
-}
+/** Decodes little-endian float32 data (the embeddings wire format) directly into `count` floats. */
+void decode_base64_floats(std::string_view input, float* out, std::size_t count);
 
+}  // namespace openai::utils
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace openai::utils {
+
+/**
+ * Read-only memory mapping of a whole file. The mapping stays valid for as long as any shared_ptr to
+ * it is alive, so views into data() can be handed out alongside the owning pointer. Throws OpenAIError
+ * when the file cannot be opened or mapped.
+ */
+class MappedFile {
+public:
+  static std::shared_ptr<const MappedFile> open(const std::string& path);
+
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  [[nodiscard]] const std::uint8_t* data() const { return data_; }
+  [[nodiscard]] std::size_t size() const { return size_; }
+  [[nodiscard]] const std::string& path() const { return path_; }
+
+private:
+  MappedFile() = default;
+
+  std::string path_;
+  const std::uint8_t* data_ = nullptr;
+  std::size_t size_ = 0;
+#if defined(_WIN32)
+  void* file_ = nullptr;
+  void* mapping_ = nullptr;
+#endif
+};
+
+}  // namespace openai::utils
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace openai::utils {
+
+/** Incremental MD5. Used for the integrity checksum sent when completing an Upload. */
+class MD5 {
+public:
+  // The running state between updates, so a hash can be checkpointed and resumed in another process.
+  struct State {
+    std::array<std::uint32_t, 4> words{};
+    std::uint64_t length = 0;
+    // Input not yet folded into `words`; always shorter than one 64-byte block.
+    std::string pending;
+  };
+
+  MD5() { reset(); }
+
+  void reset();
+  void update(const std::uint8_t* data, std::size_t size);
+  void update(std::string_view data) { update(reinterpret_cast<const std::uint8_t*>(data.data()), data.size()); }
+  std::vector<std::uint8_t> digest();
+  // Lowercase hexadecimal form of digest().
+  std::string hex_digest();
+
+  [[nodiscard]] State state() const;
+  // Throws std::invalid_argument when `state` could not have come from state().
+  void restore(const State& state);
+
+private:
+  void process_block(const std::uint8_t* block);
+
+  std::uint32_t state_[4]{};
+  std::uint64_t byte_length_ = 0;
+  std::size_t buffer_size_ = 0;
+  std::array<std::uint8_t, 64> buffer_{};
+};
+
+std::string md5_hex(std::string_view data);
+
+}  // namespace openai::utils
@@ -2,12 +2,17 @@
 
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include <nlohmann/json.hpp>
 
+#include "openai/http_client.hpp"
+#include "openai/utils/to_file.hpp"
+
 namespace openai::utils {
 
 struct MultipartEncoded {
@@ -15,6 +20,11 @@ struct MultipartEncoded {
   std::string body;
 };
 
+struct MultipartSegments {
+  std::string content_type;
+  std::shared_ptr<const HttpBodySegments> body;
+};
+
 class MultipartFormData {
 public:
   MultipartFormData();
@@ -24,9 +34,13 @@ public:
                    const std::string& filename,
                    const std::string& content_type,
                    const std::vector<std::uint8_t>& data);
+  // Borrowed and memory-mapped files are referenced in place; owned data is moved, never copied.
+  void append_file(const std::string& name, UploadFile file, const std::string& default_content_type);
   void append_json(const std::string& name, const nlohmann::json& value);
 
   MultipartEncoded build() const;
+  // File contents become their own segments between shared framing text, so large files are not copied.
+  MultipartSegments build_segments() const;
 
 private:
   struct Part {
@@ -34,6 +48,9 @@ private:
     std::optional<std::string> filename;
     std::optional<std::string> content_type;
     std::string data;
+    // File contents referenced rather than held in `data`.
+    std::optional<std::string_view> borrowed = std::nullopt;
+    std::shared_ptr<const void> owner = nullptr;
   };
 
   void append_json_internal(const std::string& name, const nlohmann::json& value);
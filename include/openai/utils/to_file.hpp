@@ -1,8 +1,12 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <istream>
+#include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace openai::utils {
@@ -11,16 +15,54 @@ struct UploadFile {
   std::vector<std::uint8_t> data;
   std::string filename;
   std::optional<std::string> content_type;
+  // Bytes referenced in place instead of copied into `data`, such as a memory-mapped file or a caller's
+  // buffer. `owner`, when set, keeps them alive for as long as any copy of the UploadFile exists.
+  std::string_view borrowed;
+  std::shared_ptr<const void> owner;
+
+  [[nodiscard]] bool is_borrowed() const { return borrowed.data() != nullptr; }
+  // The file contents, whichever form holds them.
+  [[nodiscard]] std::string_view bytes() const;
+  [[nodiscard]] std::size_t size() const { return bytes().size(); }
 };
 
+// Files at least this large are memory-mapped by open_upload_file(path) rather than read into `data`.
+constexpr std::size_t kMapUploadThreshold = 64 * 1024;
+
 /**
- * Converts a filesystem path into an UploadFile by reading the contents from disk.
+ * Reads the file at `path` into an UploadFile's `data`.
  * When filename_override is provided it will be used instead of the basename of the path.
  */
 UploadFile to_file(const std::string& path,
                    std::optional<std::string> filename_override = std::nullopt,
                    std::optional<std::string> content_type = std::nullopt);
 
+/**
+ * Like to_file(path), but files of kMapUploadThreshold bytes or more are memory-mapped and borrowed,
+ * leaving `data` empty. Read the contents through bytes().
+ */
+UploadFile open_upload_file(const std::string& path,
+                            std::optional<std::string> filename_override = std::nullopt,
+                            std::optional<std::string> content_type = std::nullopt);
+
+/**
+ * Memory-maps the file at `path` regardless of its size. The mapping is released when the last copy
+ * of the UploadFile goes away.
+ */
+UploadFile map_file(const std::string& path,
+                    std::optional<std::string> filename_override = std::nullopt,
+                    std::optional<std::string> content_type = std::nullopt);
+
+/**
+ * References `size` bytes at `data` without copying them. The caller keeps the buffer alive until the
+ * upload has been sent, unless `owner` is given to hold it.
+ */
+UploadFile borrow_file(const void* data,
+                       std::size_t size,
+                       const std::string& filename,
+                       std::optional<std::string> content_type = std::nullopt,
+                       std::shared_ptr<const void> owner = nullptr);
+
 /**
  * Wraps an existing byte vector as an UploadFile with the provided filename.
  */
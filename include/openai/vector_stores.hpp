@@ -57,6 +57,8 @@ struct VectorStoreFilter {
     std::vector<VectorStoreFilter> filters;
   };
 
+  VectorStoreFilter() : expression(Comparison{}) {}
+
   std::variant<Comparison, Compound> expression;
 };
 
@@ -299,5 +301,8 @@ private:
   OpenAIClient& client_;
 };
 
+VectorStoreFile parse_vector_store_file_json(const nlohmann::json& payload);
+VectorStoreFileBatch parse_vector_store_file_batch_json(const nlohmann::json& payload);
+
 }  // namespace openai
 
@@ -8,6 +8,7 @@
 
 #include <nlohmann/json.hpp>
 
+#include "openai/download.hpp"
 #include "openai/utils/to_file.hpp"
 
 namespace openai {
@@ -142,6 +143,16 @@ public:
                                 const VideoDownloadContentParams& params,
                                 const RequestOptions& options) const;
   VideoContent download_content(const std::string& video_id) const;
+  // Streams the content into `sink` instead of buffering it.
+  DownloadResult download_content(const std::string& video_id,
+                                  const VideoDownloadContentParams& params,
+                                  const DownloadSink& sink,
+                                  const DownloadOptions& download_options = {}) const;
+  DownloadResult download_content(const std::string& video_id,
+                                  const VideoDownloadContentParams& params,
+                                  const DownloadSink& sink,
+                                  const DownloadOptions& download_options,
+                                  const RequestOptions& options) const;
 
   Video remix(const std::string& video_id, const VideoRemixParams& params) const;
   Video remix(const std::string& video_id,
@@ -152,4 +163,6 @@ private:
   OpenAIClient& client_;
 };
 
+Video parse_video_json(const nlohmann::json& payload);
+
 }  // namespace openai
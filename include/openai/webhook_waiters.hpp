@@ -0,0 +1,83 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "openai/batches.hpp"
+#include "openai/fine_tuning.hpp"
+#include "openai/poll_scheduler.hpp"
+#include "openai/responses.hpp"
+#include "openai/webhooks.hpp"
+
+namespace openai {
+
+class OpenAIClient;
+
+struct WebhookWaiterOptions {
+  // Passed to WebhooksResource::unwrap for each delivery.
+  WebhookVerifyOptions verify;
+  // How often a waited-on object is retrieved in case its webhook is never delivered. The first
+  // retrieval happens one interval after the first wait is registered.
+  std::chrono::milliseconds fallback_interval{std::chrono::minutes(10)};
+  std::size_t fallback_workers = 1;
+};
+
+/**
+ * Resolves futures for batches, fine-tuning jobs and background responses from webhook deliveries
+ * instead of polling. Register interest with one of the wait_for_* calls, then hand each delivery to
+ * deliver(): a verified batch.*, fine_tuning.job.* or response.* event for a waited-on object retrieves
+ * the object once and resolves every future waiting on it. A slow fallback poll on a PollScheduler
+ * covers webhooks that never arrive; it polls through transient errors, which never fail a future.
+ * Destroying the registry fails the futures still waiting.
+ */
+class WebhookWaiterRegistry {
+public:
+  explicit WebhookWaiterRegistry(OpenAIClient& client, WebhookWaiterOptions options = {});
+
+  WebhookWaiterRegistry(const WebhookWaiterRegistry&) = delete;
+  WebhookWaiterRegistry& operator=(const WebhookWaiterRegistry&) = delete;
+
+  std::future<Batch> wait_for_batch(const std::string& batch_id);
+  std::future<FineTuningJob> wait_for_fine_tuning_job(const std::string& job_id);
+  std::future<Response> wait_for_response(const std::string& response_id);
+
+  // Verifies and decodes the delivery, then resolves any waiters for it. The object is retrieved on the
+  // calling thread; if that fails the exception propagates and the waiters stay registered, so a
+  // handler that answers with an error status gets the webhook redelivered.
+  webhooks::WebhookEvent deliver(const std::string& payload, const std::map<std::string, std::string>& headers);
+  // Same for an event that has already been unwrapped. Returns true when it resolved waiters.
+  bool deliver(const webhooks::WebhookEvent& event);
+
+  // Objects with at least one unresolved future.
+  [[nodiscard]] std::size_t waiting() const;
+
+private:
+  template <typename T>
+  using Waiters = std::unordered_map<std::string, std::vector<std::shared_ptr<std::promise<T>>>>;
+
+  template <typename T>
+  std::future<T> wait(Waiters<T>& waiters, const std::string& id, bool& first);
+  template <typename T>
+  bool is_waiting(const Waiters<T>& waiters, const std::string& id) const;
+  template <typename T>
+  void settle(Waiters<T>& waiters, const std::string& id, T value, std::exception_ptr error);
+
+  OpenAIClient& client_;
+  WebhookWaiterOptions options_;
+  mutable std::mutex mutex_;
+  Waiters<Batch> batches_;
+  Waiters<FineTuningJob> jobs_;
+  Waiters<Response> responses_;
+  // Declared last so it is destroyed first, failing pending polls while the waiters still exist.
+  PollScheduler fallback_;
+};
+
+}  // namespace openai
@@ -297,4 +297,8 @@ void AssistantStreamSnapshot::apply_run_step_delta(const RunStepDeltaEvent& delt
   }
 }
 
+bool is_assistant_content_event(const ServerSentEvent& event) {
+  return event.event && *event.event == "thread.message.delta";
+}
+
 }  // namespace openai
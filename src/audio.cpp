@@ -2,6 +2,10 @@
 
 #include "openai/client.hpp"
 #include "openai/error.hpp"
+#include "openai/stream_stats.hpp"
+#include "openai/streaming.hpp"
+#include "openai/utils/base64.hpp"
+#include "openai/utils/values.hpp"
 
 #include <nlohmann/json.hpp>
 
@@ -367,16 +371,26 @@ TranslationResponse parse_translation_body(const std::string& body) {
   return response;
 }
 
-std::string build_transcription_multipart(const TranscriptionRequest& request) {
+// The audio is referenced in place between the framing text, so a memory-mapped file is streamed to the
+// connection rather than copied into the request body.
+std::shared_ptr<const HttpBodySegments> frame_audio_upload(utils::UploadFile upload, const std::string& fields) {
+  auto head = std::make_shared<std::string>();
+  *head += "--" + std::string(kBoundary) + "\r\n";
+  *head += "Content-Disposition: form-data; name=\"file\"; filename=\"" + upload.filename + "\"\r\n";
+  *head += "Content-Type: " + *upload.content_type + "\r\n\r\n";
+  auto tail = std::make_shared<std::string>("\r\n" + fields);
+  auto file = std::make_shared<utils::UploadFile>(std::move(upload));
+
+  auto body = std::make_shared<HttpBodySegments>();
+  body->segments = {*head, file->bytes(), *tail};
+  body->owners = {head, file, tail};
+  return body;
+}
+
+std::shared_ptr<const HttpBodySegments> build_transcription_multipart(const TranscriptionRequest& request) {
   std::ostringstream body;
   auto upload = request.file.materialize("audio.wav");
 
-  body << "--" << kBoundary << "\r\n";
-  body << "Content-Disposition: form-data; name=\"file\"; filename=\"" << upload.filename << "\"\r\n";
-  body << "Content-Type: " << *upload.content_type << "\r\n\r\n";
-  body.write(reinterpret_cast<const char*>(upload.data.data()), static_cast<std::streamsize>(upload.data.size()));
-  body << "\r\n";
-
   json fields = json::object();
   fields["model"] = request.model;
 
@@ -440,30 +454,110 @@ std::string build_transcription_multipart(const TranscriptionRequest& request) {
   }
 
   body << "--" << kBoundary << "--\r\n";
-  return body.str();
+  return frame_audio_upload(std::move(upload), body.str());
 }
 
-std::string build_translation_multipart(const TranslationRequest& request) {
+json build_speech_body(const SpeechRequest& request) {
+  json body;
+  body["input"] = request.input;
+  body["model"] = request.model;
+  body["voice"] = request.voice;
+  if (request.instructions) body["instructions"] = *request.instructions;
+  if (request.response_format) body["response_format"] = *request.response_format;
+  if (request.speed) body["speed"] = *request.speed;
+  if (request.stream_format) body["stream_format"] = *request.stream_format;
+  return body;
+}
+
+SpeechUsage parse_speech_usage(const json& payload) {
+  SpeechUsage usage;
+  usage.raw = payload;
+  usage.input_tokens = payload.value("input_tokens", 0);
+  usage.output_tokens = payload.value("output_tokens", 0);
+  usage.total_tokens = payload.value("total_tokens", 0);
+  return usage;
+}
+
+std::shared_ptr<const HttpBodySegments> build_translation_multipart(const TranslationRequest& request) {
   std::ostringstream body;
   auto upload = request.file.materialize("audio.wav");
 
-  body << "--" << kBoundary << "\r\n";
-  body << "Content-Disposition: form-data; name=\"file\"; filename=\"" << upload.filename << "\"\r\n";
-  body << "Content-Type: " << *upload.content_type << "\r\n\r\n";
-  body.write(reinterpret_cast<const char*>(upload.data.data()), static_cast<std::streamsize>(upload.data.size()));
-  body << "\r\n";
-
   append_field(body, "model", request.model);
   if (request.prompt) append_field(body, "prompt", *request.prompt);
   if (request.response_format) append_field(body, "response_format", *request.response_format);
   if (request.temperature) append_field(body, "temperature", std::to_string(*request.temperature));
 
   body << "--" << kBoundary << "--\r\n";
-  return body.str();
+  return frame_audio_upload(std::move(upload), body.str());
 }
 
 }  // namespace
 
+std::optional<TranscriptionStreamEvent> parse_transcription_stream_event(const ServerSentEvent& event) {
+  if (event.data == "[DONE]") {
+    return std::nullopt;
+  }
+  auto payload = utils::safe_json(event.data);
+  if (!payload || !payload->is_object()) {
+    return std::nullopt;
+  }
+
+  TranscriptionStreamEvent result;
+  result.raw = *payload;
+  result.type_name = payload->value("type", event.event.value_or(""));
+  const bool has_logprobs = payload->contains("logprobs") && (*payload)["logprobs"].is_array();
+
+  if (result.type_name == "transcript.text.delta") {
+    TranscriptionTextDeltaEvent delta;
+    delta.raw = *payload;
+    delta.type = result.type_name;
+    delta.delta = payload->value("delta", "");
+    if (has_logprobs) {
+      delta.logprobs = parse_logprobs((*payload)["logprobs"]);
+    }
+    if (payload->contains("segment_id") && (*payload)["segment_id"].is_string()) {
+      delta.segment_id = (*payload)["segment_id"].get<std::string>();
+    }
+    result.type = TranscriptionStreamEvent::Type::TextDelta;
+    result.text_delta = std::move(delta);
+  } else if (result.type_name == "transcript.text.done") {
+    TranscriptionTextDoneEvent done;
+    done.raw = *payload;
+    done.type = result.type_name;
+    done.text = payload->value("text", "");
+    if (has_logprobs) {
+      done.logprobs = parse_logprobs((*payload)["logprobs"]);
+    }
+    if (payload->contains("usage")) {
+      done.usage = parse_usage((*payload)["usage"]);
+    }
+    result.type = TranscriptionStreamEvent::Type::TextDone;
+    result.text_done = std::move(done);
+  }
+  return result;
+}
+
+void TranscriptionStreamAccumulator::add(const TranscriptionStreamEvent& event) {
+  if (event.text_delta && !done_) {
+    response_.text += event.text_delta->delta;
+    if (event.text_delta->logprobs) {
+      if (!response_.logprobs) {
+        response_.logprobs.emplace();
+      }
+      response_.logprobs->insert(response_.logprobs->end(), event.text_delta->logprobs->begin(),
+                                 event.text_delta->logprobs->end());
+    }
+  } else if (event.text_done) {
+    response_.text = event.text_done->text;
+    if (event.text_done->logprobs) {
+      response_.logprobs = event.text_done->logprobs;
+    }
+    response_.usage = event.text_done->usage;
+    response_.raw = event.text_done->raw;
+    done_ = true;
+  }
+}
+
 TranscriptionResponse AudioTranscriptionsResource::create(const TranscriptionRequest& request,
                                                           const RequestOptions& options) const {
   RequestOptions request_options = options;
@@ -477,6 +571,65 @@ TranscriptionResponse AudioTranscriptionsResource::create(const TranscriptionReq
   return create(request, RequestOptions{});
 }
 
+TranscriptionResponse AudioTranscriptionsResource::create_stream(
+    const TranscriptionRequest& request,
+    const std::function<bool(const TranscriptionStreamEvent&)>& on_event,
+    const RequestOptions& options) const {
+  TranscriptionRequest stream_request = request;
+  stream_request.stream = true;
+
+  TranscriptionStreamAccumulator accumulator;
+  bool stopped = false;
+  SSEEventStream stream([&](const ServerSentEvent& sse_event) {
+    if (auto parsed = parse_transcription_stream_event(sse_event)) {
+      if (parsed->type == TranscriptionStreamEvent::Type::TextDelta) {
+        stream.mark_content();
+      }
+      accumulator.add(*parsed);
+      if (on_event && !on_event(*parsed)) {
+        stopped = true;
+        return false;
+      }
+    }
+    return true;
+  });
+
+  RequestOptions request_options = options;
+  request_options.headers["Content-Type"] = "multipart/form-data; boundary=" + std::string(kBoundary);
+  request_options.headers["Accept"] = "text/event-stream";
+  request_options.collect_body = false;
+  // A replayed stream would hand the same deltas to the callback twice.
+  request_options.max_retries = 0;
+  stream.track_stats(client_.stream_stats_recorder(kAudioTranscriptions, options), nullptr);
+  long status = 0;
+  request_options.on_status = [&status](long status_code) { status = status_code; };
+  request_options.on_chunk = [&](const char* data, std::size_t size) {
+    // Error bodies are left to the client, which reports them in the thrown exception.
+    if (status >= 300) {
+      return;
+    }
+    stream.feed(data, size);
+    if (stopped) {
+      throw APIUserAbortError("Transcription stream stopped by handler");
+    }
+  };
+
+  try {
+    client_.perform_request("POST", kAudioTranscriptions, build_transcription_multipart(stream_request),
+                            request_options);
+    stream.finalize();
+  } catch (const APIUserAbortError&) {
+    // Thrown from on_chunk once the handler stopped the stream.
+  }
+  return accumulator.response();
+}
+
+TranscriptionResponse AudioTranscriptionsResource::create_stream(
+    const TranscriptionRequest& request,
+    const std::function<bool(const TranscriptionStreamEvent&)>& on_event) const {
+  return create_stream(request, on_event, RequestOptions{});
+}
+
 TranslationResponse AudioTranslationsResource::create(const TranslationRequest& request,
                                                        const RequestOptions& options) const {
   RequestOptions request_options = options;
@@ -491,18 +644,9 @@ TranslationResponse AudioTranslationsResource::create(const TranslationRequest&
 }
 
 SpeechResponse AudioSpeechResource::create(const SpeechRequest& request, const RequestOptions& options) const {
-  json body;
-  body["input"] = request.input;
-  body["model"] = request.model;
-  body["voice"] = request.voice;
-  if (request.instructions) body["instructions"] = *request.instructions;
-  if (request.response_format) body["response_format"] = *request.response_format;
-  if (request.speed) body["speed"] = *request.speed;
-  if (request.stream_format) body["stream_format"] = *request.stream_format;
-
   RequestOptions request_options = options;
   request_options.headers["Accept"] = "application/octet-stream";
-  auto response = client_.perform_request("POST", kAudioSpeech, body.dump(), request_options);
+  auto response = client_.perform_request("POST", kAudioSpeech, build_speech_body(request).dump(), request_options);
 
   SpeechResponse speech;
   speech.headers = response.headers;
@@ -514,5 +658,118 @@ SpeechResponse AudioSpeechResource::create(const SpeechRequest& request) const {
   return create(request, RequestOptions{});
 }
 
-}  // namespace openai
+DownloadResult AudioSpeechResource::create(const SpeechRequest& request,
+                                           const DownloadSink& sink,
+                                           const DownloadOptions& download_options,
+                                           const RequestOptions& options) const {
+  RequestOptions request_options = options;
+  request_options.headers["Accept"] = "application/octet-stream";
+  DownloadWriter writer(sink, download_options);
+  auto response =
+      client_.perform_request("POST", kAudioSpeech, build_speech_body(request).dump(), writer.attach(request_options));
+  return writer.finish(std::move(response.headers));
+}
+
+DownloadResult AudioSpeechResource::create(const SpeechRequest& request,
+                                           const DownloadSink& sink,
+                                           const DownloadOptions& download_options) const {
+  return create(request, sink, download_options, RequestOptions{});
+}
 
+SpeechStreamResult AudioSpeechResource::stream(const SpeechRequest& request,
+                                               const std::function<bool(const SpeechAudioChunk&)>& on_chunk,
+                                               const RequestOptions& options) const {
+  const bool sse = request.stream_format && *request.stream_format == "sse";
+  RequestOptions request_options = options;
+  request_options.headers["Accept"] = sse ? "text/event-stream" : "application/octet-stream";
+  request_options.collect_body = false;
+  request_options.max_retries = 0;
+
+  SpeechStreamResult result;
+  const auto start = std::chrono::steady_clock::now();
+  auto deliver = [&](const std::uint8_t* data, std::size_t size) {
+    if (size == 0 || result.stopped) {
+      return;
+    }
+    SpeechAudioChunk chunk;
+    chunk.data = data;
+    chunk.size = size;
+    chunk.index = result.chunks++;
+    chunk.received_at = std::chrono::steady_clock::now();
+    chunk.elapsed = chunk.received_at - start;
+    if (!result.time_to_first_audio) {
+      result.time_to_first_audio = chunk.elapsed;
+    }
+    result.bytes += size;
+    if (on_chunk && !on_chunk(chunk)) {
+      result.stopped = true;
+    }
+  };
+
+  // Reused across deltas so steady-state decoding does not allocate.
+  std::vector<std::uint8_t> decoded;
+  SSEEventStream events([&](const ServerSentEvent& sse_event) {
+    auto payload = utils::safe_json(sse_event.data);
+    if (!payload || !payload->is_object()) {
+      return true;
+    }
+    const std::string type = payload->value("type", sse_event.event.value_or(""));
+    if (type == "speech.audio.delta" && payload->contains("audio") && payload->at("audio").is_string()) {
+      events.mark_content();
+      const auto& audio = payload->at("audio").get_ref<const std::string&>();
+      decoded.resize(utils::decoded_base64_size(audio));
+      const std::size_t size = utils::decode_base64_into(audio, decoded.data(), decoded.size());
+      deliver(decoded.data(), size);
+    } else if (type == "speech.audio.done" && payload->contains("usage") && payload->at("usage").is_object()) {
+      result.usage = parse_speech_usage(payload->at("usage"));
+    }
+    return !result.stopped;
+  });
+  auto stats = client_.stream_stats_recorder(kAudioSpeech, options);
+  if (sse) {
+    events.track_stats(stats, nullptr);
+  }
+
+  long status = 0;
+  request_options.on_status = [&status](long status_code) { status = status_code; };
+  request_options.on_chunk = [&](const char* data, std::size_t size) {
+    // Error bodies are left to the client, which reports them in the thrown exception.
+    if (status >= 300) {
+      return;
+    }
+    if (sse) {
+      events.feed(data, size);
+    } else {
+      if (stats) {
+        stats->on_bytes(size);
+        stats->on_event(true);
+      }
+      deliver(reinterpret_cast<const std::uint8_t*>(data), size);
+    }
+    if (result.stopped) {
+      throw APIUserAbortError("Speech stream stopped by handler");
+    }
+  };
+
+  try {
+    auto response =
+        client_.perform_request("POST", kAudioSpeech, build_speech_body(request).dump(), request_options);
+    result.headers = std::move(response.headers);
+    if (sse) {
+      events.finalize();
+    }
+  } catch (const APIUserAbortError&) {
+    // Thrown from on_chunk once the handler stopped the stream.
+  }
+  if (stats) {
+    stats->finish();
+  }
+  return result;
+}
+
+SpeechStreamResult AudioSpeechResource::stream(const SpeechRequest& request,
+                                               const std::function<bool(const SpeechAudioChunk&)>& on_chunk) const {
+  return stream(request, on_chunk, RequestOptions{});
+}
+
+}  // namespace openai
@@ -0,0 +1,125 @@
+#include "openai/batch_input.hpp"
+
+#include "openai/client.hpp"
+#include "openai/error.hpp"
+#include "openai/utils/uuid.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <utility>
+
+namespace openai {
+
+using json = nlohmann::json;
+
+BatchInputWriter::BatchInputWriter(BatchInputOptions options) : options_(std::move(options)) {
+  if (options_.directory.empty()) {
+    options_.directory = (std::filesystem::temp_directory_path() / ("openai-batch-" + utils::uuid4())).string();
+  }
+  if (options_.max_lines == 0) {
+    throw OpenAIError("BatchInputOptions::max_lines must be positive");
+  }
+}
+
+BatchInputWriter::~BatchInputWriter() = default;
+
+void BatchInputWriter::add(const std::string& custom_id, const ChatCompletionRequest& request) {
+  add(custom_id, "/v1/chat/completions", build_chat_request_body(request));
+}
+
+void BatchInputWriter::add(const std::string& custom_id, const EmbeddingRequest& request) {
+  add(custom_id, "/v1/embeddings", build_embedding_request_body(request));
+}
+
+void BatchInputWriter::add(const std::string& custom_id, const ResponseRequest& request) {
+  add(custom_id, "/v1/responses", build_response_request_body(request));
+}
+
+void BatchInputWriter::add(const std::string& custom_id, const std::string& url, json body) {
+  if (custom_id.empty()) {
+    throw OpenAIError("Batch input lines need a custom_id");
+  }
+  json line = json::object();
+  line["custom_id"] = custom_id;
+  line["method"] = "POST";
+  line["url"] = url;
+  line["body"] = std::move(body);
+  std::string text = line.dump();
+  text.push_back('\n');
+  if (text.size() > options_.max_file_bytes) {
+    throw OpenAIError("Batch input line for " + custom_id + " is larger than max_file_bytes");
+  }
+
+  if (out_.is_open()) {
+    const auto& shard = shards_.back();
+    if (shard.endpoint != url || shard.lines >= options_.max_lines ||
+        shard.bytes + text.size() > options_.max_file_bytes) {
+      close_shard();
+    }
+  }
+  if (!out_.is_open()) {
+    open_shard(url);
+  }
+  if (!custom_ids_.insert(custom_id).second) {
+    throw OpenAIError("Duplicate custom_id in batch input shard: " + custom_id);
+  }
+
+  auto& shard = shards_.back();
+  out_.write(text.data(), static_cast<std::streamsize>(text.size()));
+  if (!out_) {
+    throw OpenAIError("Failed to write batch input file: " + shard.path);
+  }
+  ++shard.lines;
+  shard.bytes += text.size();
+}
+
+const std::vector<BatchInputShard>& BatchInputWriter::finish() {
+  if (out_.is_open()) {
+    close_shard();
+  }
+  return shards_;
+}
+
+std::vector<FileObject> BatchInputWriter::upload(const FilesResource& files, const RequestOptions& options) {
+  finish();
+  std::vector<FileObject> uploaded;
+  uploaded.reserve(shards_.size());
+  for (const auto& shard : shards_) {
+    FileUploadRequest request;
+    request.purpose = "batch";
+    request.file_path = shard.path;
+    request.content_type = "application/jsonl";
+    uploaded.push_back(files.create(request, options));
+  }
+  return uploaded;
+}
+
+std::vector<FileObject> BatchInputWriter::upload(const FilesResource& files) {
+  return upload(files, RequestOptions{});
+}
+
+void BatchInputWriter::open_shard(const std::string& endpoint) {
+  std::error_code error;
+  std::filesystem::create_directories(options_.directory, error);
+  char suffix[32];
+  std::snprintf(suffix, sizeof(suffix), "-%05zu.jsonl", shards_.size());
+  BatchInputShard shard;
+  shard.path = (std::filesystem::path(options_.directory) / (options_.prefix + suffix)).string();
+  shard.endpoint = endpoint;
+  out_.open(shard.path, std::ios::binary | std::ios::trunc);
+  if (!out_) {
+    throw OpenAIError("Failed to open batch input file: " + shard.path);
+  }
+  shards_.push_back(std::move(shard));
+}
+
+void BatchInputWriter::close_shard() {
+  out_.close();
+  custom_ids_.clear();
+  if (!out_) {
+    out_.clear();
+    throw OpenAIError("Failed to write batch input file: " + shards_.back().path);
+  }
+}
+
+}  // namespace openai
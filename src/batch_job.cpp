@@ -0,0 +1,276 @@
+#include "openai/batch_job.hpp"
+
+#include "openai/client.hpp"
+#include "openai/error.hpp"
+#include "openai/utils/time.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+
+namespace openai {
+namespace {
+
+bool is_terminal_batch_status(const std::string& status) {
+  return status == "completed" || status == "failed" || status == "expired" || status == "cancelled";
+}
+
+// Lines worth sending again: those the batch ran out of time for, and transient request failures.
+bool is_resubmittable(const BatchResult& result) {
+  if (result.error) {
+    return result.error->code && *result.error->code == "batch_expired";
+  }
+  return result.status_code && (*result.status_code == 429 || *result.status_code >= 500);
+}
+
+BatchResult unreported_result(const std::string& custom_id, const Batch& batch) {
+  BatchResult result;
+  result.custom_id = custom_id;
+  BatchResultError error;
+  error.code = "batch_" + batch.status;
+  error.message = "Batch " + batch.id + " is " + batch.status + " without a result for this request";
+  if (batch.errors && !batch.errors->data.empty()) {
+    const auto& first = batch.errors->data.front();
+    if (first.code) {
+      error.code = first.code;
+    }
+    if (first.message) {
+      error.message = first.message;
+    }
+  }
+  result.error = std::move(error);
+  return result;
+}
+
+}  // namespace
+
+BatchJob::BatchJob(OpenAIClient& client, BatchJobOptions options)
+    : client_(client), options_(std::move(options)), writer_(options_.input) {}
+
+void BatchJob::add(const std::string& custom_id, const ChatCompletionRequest& request) {
+  writer_.add(custom_id, request);
+}
+
+void BatchJob::add(const std::string& custom_id, const EmbeddingRequest& request) {
+  writer_.add(custom_id, request);
+}
+
+void BatchJob::add(const std::string& custom_id, const ResponseRequest& request) {
+  writer_.add(custom_id, request);
+}
+
+void BatchJob::add(const std::string& custom_id, const std::string& url, nlohmann::json body) {
+  writer_.add(custom_id, url, std::move(body));
+}
+
+BatchJobSummary BatchJob::run(Handler on_result) {
+  claim_run();
+  return execute(on_result);
+}
+
+std::future<BatchJobSummary> BatchJob::start(Handler on_result) {
+  claim_run();
+  return std::async(std::launch::async, [this, on_result = std::move(on_result)]() { return execute(on_result); });
+}
+
+void BatchJob::claim_run() {
+  if (started_.exchange(true)) {
+    throw OpenAIError("BatchJob::run and BatchJob::start may only be called once per job");
+  }
+}
+
+BatchJobSummary BatchJob::execute(const Handler& on_result) {
+  std::vector<Submission> submissions;
+  for (const auto& shard : writer_.finish()) {
+    Submission submission;
+    submission.shard = shard;
+    submissions.push_back(std::move(submission));
+  }
+  submit(submissions, 0);
+
+  BatchJobSummary summary;
+  std::vector<std::size_t> active(submissions.size());
+  for (std::size_t i = 0; i < active.size(); ++i) {
+    active[i] = i;
+  }
+  while (!active.empty()) {
+    std::vector<std::size_t> running;
+    std::vector<Submission> resubmissions;
+    for (const std::size_t index : active) {
+      auto& submission = submissions[index];
+      try {
+        submission.batch = client_.batches().retrieve(submission.batch.id);
+      } catch (...) {
+        const auto error = std::current_exception();
+        if (!is_transient_error(error)) {
+          cancel_running(submissions);
+          std::rethrow_exception(error);
+        }
+        // The client already retried; look at this batch again next round.
+        running.push_back(index);
+        continue;
+      }
+      if (options_.on_batch_update) {
+        options_.on_batch_update(submission.batch);
+      }
+      if (is_terminal_batch_status(submission.batch.status)) {
+        collect(submission, on_result, summary, resubmissions);
+      } else {
+        running.push_back(index);
+      }
+    }
+    if (!resubmissions.empty()) {
+      const std::size_t first = submissions.size();
+      for (auto& resubmission : resubmissions) {
+        summary.resubmitted += resubmission.shard.lines;
+        submissions.push_back(std::move(resubmission));
+      }
+      submit(submissions, first);
+      for (std::size_t i = first; i < submissions.size(); ++i) {
+        running.push_back(i);
+      }
+    }
+    active = std::move(running);
+    if (!active.empty()) {
+      utils::sleep_for(options_.poll_interval);
+    }
+  }
+
+  for (auto& submission : submissions) {
+    summary.batches.push_back(std::move(submission.batch));
+  }
+  return summary;
+}
+
+void BatchJob::submit(std::vector<Submission>& submissions, std::size_t first) {
+  std::atomic<std::size_t> next{first};
+  std::atomic<bool> failed{false};
+  std::exception_ptr first_error;
+  std::mutex mutex;
+
+  auto worker = [&]() {
+    while (!failed.load()) {
+      const std::size_t index = next.fetch_add(1);
+      if (index >= submissions.size()) {
+        return;
+      }
+      auto& submission = submissions[index];
+      try {
+        FileUploadRequest upload;
+        upload.purpose = "batch";
+        upload.file_path = submission.shard.path;
+        upload.content_type = "application/jsonl";
+        const auto file = client_.files().create(upload);
+
+        BatchCreateRequest request;
+        request.completion_window = options_.completion_window;
+        request.endpoint = submission.shard.endpoint;
+        request.input_file_id = file.id;
+        request.metadata = options_.metadata;
+        submission.batch = client_.batches().create(request);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!first_error) {
+          first_error = std::current_exception();
+        }
+        failed.store(true);
+      }
+    }
+  };
+
+  const std::size_t pending = submissions.size() - first;
+  const std::size_t concurrency = std::min(std::max<std::size_t>(options_.max_concurrent_uploads, 1), pending);
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < concurrency; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  if (first_error) {
+    cancel_running(submissions);
+    std::rethrow_exception(first_error);
+  }
+}
+
+void BatchJob::cancel_running(const std::vector<Submission>& submissions) {
+  for (const auto& submission : submissions) {
+    if (submission.batch.id.empty() || is_terminal_batch_status(submission.batch.status)) {
+      continue;
+    }
+    try {
+      client_.batches().cancel(submission.batch.id);
+    } catch (const std::exception&) {
+      // Best effort; the error that stopped the job is the one worth reporting.
+    }
+  }
+}
+
+void BatchJob::collect(Submission& submission,
+                       const Handler& on_result,
+                       BatchJobSummary& summary,
+                       std::vector<Submission>& resubmissions) {
+  const bool can_resubmit = submission.attempt < options_.max_resubmits;
+  std::unordered_set<std::string> settled;
+  std::unordered_set<std::string> resubmit;
+  auto settle = [&](const BatchResult& result) {
+    settled.insert(result.custom_id);
+    if (result.ok()) {
+      ++summary.succeeded;
+    } else {
+      ++summary.failed;
+    }
+    on_result(result);
+  };
+  auto handle = [&](const BatchResult& result) {
+    if (can_resubmit && is_resubmittable(result)) {
+      resubmit.insert(result.custom_id);
+    } else {
+      settle(result);
+    }
+  };
+  if (submission.batch.output_file_id) {
+    BatchResultReader::read(client_.files(), *submission.batch.output_file_id, handle);
+  }
+  if (submission.batch.error_file_id) {
+    BatchResultReader::read(client_.files(), *submission.batch.error_file_id, handle);
+  }
+  if (settled.size() == submission.shard.lines) {
+    return;
+  }
+
+  // Walk the input shard for lines to send again and for lines the batch never reported on, which is
+  // every line of a batch that failed validation or was cancelled.
+  BatchInputOptions retry_options = options_.input;
+  retry_options.directory = std::filesystem::path(submission.shard.path).parent_path().string();
+  retry_options.prefix += "-retry-" + std::to_string(retry_shards_++);
+  BatchInputWriter retry_writer(retry_options);
+  const bool expired = submission.batch.status == "expired";
+  BatchResultReader::read_file(submission.shard.path, [&](const BatchResult& line) {
+    if (settled.count(line.custom_id) != 0) {
+      return;
+    }
+    if (resubmit.count(line.custom_id) != 0 || (expired && can_resubmit)) {
+      retry_writer.add(line.custom_id,
+                       line.raw.value("url", submission.shard.endpoint),
+                       line.raw.value("body", nlohmann::json::object()));
+    } else {
+      settle(unreported_result(line.custom_id, submission.batch));
+    }
+  });
+  for (const auto& shard : retry_writer.finish()) {
+    Submission retry;
+    retry.shard = shard;
+    retry.attempt = submission.attempt + 1;
+    resubmissions.push_back(std::move(retry));
+  }
+}
+
+}  // namespace openai
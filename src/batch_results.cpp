@@ -0,0 +1,329 @@
+#include "openai/batch_results.hpp"
+
+#include "openai/client.hpp"
+#include "openai/error.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <utility>
+
+namespace openai {
+namespace {
+
+using json = nlohmann::json;
+
+// The index file is: magic, reserved word, slot count, entry count, then the slots. A slot holds the
+// custom_id hash (0 when empty) and the offset and length of its line in the results file.
+constexpr std::uint32_t kIndexMagic = 0x5242414Fu;  // "OABR"
+constexpr std::size_t kIndexHeader = 2 * sizeof(std::uint32_t) + 2 * sizeof(std::uint64_t);
+constexpr std::size_t kIndexSlot = 3 * sizeof(std::uint64_t);
+
+std::optional<std::string> optional_string(const json& payload, const char* key) {
+  if (payload.contains(key) && payload.at(key).is_string()) {
+    return payload.at(key).get<std::string>();
+  }
+  return std::nullopt;
+}
+
+std::string failure_message(const BatchResult& result) {
+  std::string message = "Batch request " + result.custom_id + " failed";
+  if (result.error && result.error->message) {
+    message += ": " + *result.error->message;
+  } else if (result.body.is_object() && result.body.contains("error") && result.body.at("error").is_object()) {
+    if (auto detail = optional_string(result.body.at("error"), "message")) {
+      message += ": " + *detail;
+    }
+  } else if (result.status_code) {
+    message += " with status " + std::to_string(*result.status_code);
+  }
+  return message;
+}
+
+template <typename Parse>
+auto parse_body(const BatchResult& result, const char* what, Parse parse) {
+  if (!result.ok()) {
+    throw OpenAIError(failure_message(result));
+  }
+  try {
+    return parse(result.body);
+  } catch (const json::exception& ex) {
+    throw OpenAIError(std::string("Failed to parse batch ") + what + ": " + ex.what());
+  }
+}
+
+}  // namespace
+
+bool BatchResult::ok() const {
+  return !error && status_code && *status_code >= 200 && *status_code < 300;
+}
+
+ChatCompletion BatchResult::chat_completion() const {
+  return parse_body(*this, "chat completion", [](const json& body) { return parse_chat_completion_json(body); });
+}
+
+CreateEmbeddingResponse BatchResult::embedding() const {
+  return parse_body(*this, "embedding", [](const json& body) { return parse_embedding_response_json(body); });
+}
+
+Response BatchResult::response() const {
+  return parse_body(*this, "response", [](const json& body) { return parse_response_json(body); });
+}
+
+BatchResult parse_batch_result_line(std::string_view line) {
+  try {
+    BatchResult result;
+    result.raw = json::parse(line.begin(), line.end());
+    result.id = result.raw.value("id", "");
+    result.custom_id = result.raw.value("custom_id", "");
+    if (result.raw.contains("response") && result.raw.at("response").is_object()) {
+      const auto& response = result.raw.at("response");
+      if (response.contains("status_code") && response.at("status_code").is_number_integer()) {
+        result.status_code = response.at("status_code").get<int>();
+      }
+      result.request_id = optional_string(response, "request_id");
+      if (response.contains("body")) {
+        result.body = response.at("body");
+      }
+    }
+    if (result.raw.contains("error") && result.raw.at("error").is_object()) {
+      const auto& error = result.raw.at("error");
+      BatchResultError parsed;
+      parsed.code = optional_string(error, "code");
+      parsed.message = optional_string(error, "message");
+      result.error = std::move(parsed);
+    }
+    return result;
+  } catch (const json::exception& ex) {
+    throw OpenAIError(std::string("Failed to parse batch result line: ") + ex.what());
+  }
+}
+
+BatchResultReader::BatchResultReader(Handler on_result, BatchResultReaderOptions options)
+    : on_result_(std::move(on_result)), options_(std::move(options)) {
+  if (options_.index_path && !options_.output_path) {
+    throw OpenAIError("BatchResultReaderOptions::index_path needs an output_path to index");
+  }
+  if (options_.output_path) {
+    copy_.open(*options_.output_path, std::ios::binary | std::ios::trunc);
+    if (!copy_) {
+      throw OpenAIError("Failed to open batch result file: " + *options_.output_path);
+    }
+  }
+}
+
+BatchResultReader::~BatchResultReader() = default;
+
+void BatchResultReader::feed(const char* data, std::size_t size) {
+  if (copy_.is_open()) {
+    copy_.write(data, static_cast<std::streamsize>(size));
+    if (!copy_) {
+      throw OpenAIError("Failed to write batch result file: " + *options_.output_path);
+    }
+  }
+  const char* end = data + size;
+  while (data < end) {
+    const char* newline = static_cast<const char*>(std::memchr(data, '\n', static_cast<std::size_t>(end - data)));
+    if (!newline) {
+      pending_.append(data, end);
+      return;
+    }
+    if (pending_.empty()) {
+      deliver(std::string_view(data, static_cast<std::size_t>(newline - data)));
+    } else {
+      pending_.append(data, newline);
+      deliver(pending_);
+      pending_.clear();
+    }
+    data = newline + 1;
+  }
+}
+
+void BatchResultReader::restart() {
+  resume_after_ = std::max(resume_after_, lines_seen_);
+  lines_seen_ = 0;
+  offset_ = 0;
+  pending_.clear();
+  if (copy_.is_open()) {
+    copy_.close();
+    copy_.open(*options_.output_path, std::ios::binary | std::ios::trunc);
+    if (!copy_) {
+      throw OpenAIError("Failed to reopen batch result file: " + *options_.output_path);
+    }
+  }
+}
+
+void BatchResultReader::finish() {
+  if (!pending_.empty()) {
+    deliver(pending_);
+    pending_.clear();
+  }
+  if (copy_.is_open()) {
+    copy_.close();
+    if (!copy_) {
+      throw OpenAIError("Failed to write batch result file: " + *options_.output_path);
+    }
+  }
+  if (options_.index_path) {
+    BatchResultIndex::write(*options_.index_path, index_);
+  }
+}
+
+void BatchResultReader::deliver(std::string_view line) {
+  const std::uint64_t offset = offset_;
+  offset_ += line.size() + 1;
+  ++lines_seen_;
+  if (lines_seen_ <= resume_after_ || line.find_first_not_of(" \t\r") == std::string_view::npos) {
+    return;
+  }
+  auto result = parse_batch_result_line(line);
+  result.offset = offset;
+  result.length = line.size();
+  if (options_.index_path) {
+    index_.push_back(IndexEntry{BatchResultIndex::hash(result.custom_id), offset, line.size()});
+  }
+  ++delivered_;
+  on_result_(result);
+}
+
+DownloadResult BatchResultReader::read(const FilesResource& files,
+                                       const std::string& file_id,
+                                       Handler on_result,
+                                       const BatchResultReaderOptions& reader_options,
+                                       const RequestOptions& options) {
+  BatchResultReader reader(std::move(on_result), reader_options);
+  // A failing line must not look like a broken connection, which would be retried; the rest of the body
+  // is drained and the error rethrown once the download returns.
+  std::exception_ptr failure;
+  auto sink = DownloadSink::callback(
+      [&](const char* data, std::size_t size) {
+        if (failure) {
+          return;
+        }
+        try {
+          reader.feed(data, size);
+        } catch (...) {
+          failure = std::current_exception();
+        }
+      },
+      [&]() {
+        if (!failure) {
+          reader.restart();
+        }
+      });
+  auto result = files.content(file_id, sink, DownloadOptions{}, options);
+  if (failure) {
+    std::rethrow_exception(failure);
+  }
+  reader.finish();
+  return result;
+}
+
+DownloadResult BatchResultReader::read(const FilesResource& files,
+                                       const std::string& file_id,
+                                       Handler on_result,
+                                       const BatchResultReaderOptions& reader_options) {
+  return read(files, file_id, std::move(on_result), reader_options, RequestOptions{});
+}
+
+void BatchResultReader::read_file(const std::string& path,
+                                  Handler on_result,
+                                  const std::optional<std::string>& index_path) {
+  auto mapping = utils::MappedFile::open(path);
+  BatchResultReader reader(std::move(on_result));
+  // The file being read is the one the index points into, so no copy is needed.
+  reader.options_.index_path = index_path;
+  if (mapping->size() > 0) {
+    reader.feed(reinterpret_cast<const char*>(mapping->data()), mapping->size());
+  }
+  reader.finish();
+}
+
+BatchResultIndex BatchResultIndex::open(const std::string& index_path, const std::string& results_path) {
+  BatchResultIndex index;
+  index.index_ = utils::MappedFile::open(index_path);
+  std::uint32_t magic = 0;
+  std::uint64_t entries = 0;
+  if (index.index_->size() >= kIndexHeader) {
+    std::memcpy(&magic, index.index_->data(), sizeof(magic));
+    std::memcpy(&index.slots_, index.index_->data() + 2 * sizeof(std::uint32_t), sizeof(index.slots_));
+    std::memcpy(&entries, index.index_->data() + 2 * sizeof(std::uint32_t) + sizeof(std::uint64_t), sizeof(entries));
+  }
+  if (magic != kIndexMagic || index.slots_ == 0 || (index.slots_ & (index.slots_ - 1)) != 0 ||
+      index.index_->size() != kIndexHeader + index.slots_ * kIndexSlot) {
+    throw OpenAIError("Not a batch result index: " + index_path);
+  }
+  index.entries_ = static_cast<std::size_t>(entries);
+  index.results_ = utils::MappedFile::open(results_path);
+  return index;
+}
+
+std::optional<BatchResult> BatchResultIndex::find(const std::string& custom_id) const {
+  const std::uint64_t key = hash(custom_id);
+  const std::uint64_t mask = slots_ - 1;
+  for (std::uint64_t probe = 0, slot = key & mask; probe < slots_; ++probe, slot = (slot + 1) & mask) {
+    std::uint64_t fields[3];
+    std::memcpy(fields, index_->data() + kIndexHeader + slot * kIndexSlot, sizeof(fields));
+    if (fields[0] == 0) {
+      return std::nullopt;
+    }
+    if (fields[0] != key) {
+      continue;
+    }
+    if (fields[1] + fields[2] > results_->size()) {
+      throw OpenAIError("Batch result index points past the end of " + results_->path());
+    }
+    auto result = parse_batch_result_line(
+        std::string_view(reinterpret_cast<const char*>(results_->data()) + fields[1], fields[2]));
+    if (result.custom_id == custom_id) {
+      result.offset = fields[1];
+      result.length = fields[2];
+      return result;
+    }
+  }
+  return std::nullopt;
+}
+
+std::uint64_t BatchResultIndex::hash(std::string_view custom_id) {
+  // FNV-1a; 0 marks an empty slot, so it is remapped.
+  std::uint64_t hash = 14695981039346656037ull;
+  for (const char c : custom_id) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 1099511628211ull;
+  }
+  return hash == 0 ? 1 : hash;
+}
+
+void BatchResultIndex::write(const std::string& path, const std::vector<BatchResultReader::IndexEntry>& entries) {
+  // At most half full, so probe sequences stay short.
+  std::uint64_t slots = 8;
+  while (slots < 2 * static_cast<std::uint64_t>(entries.size())) {
+    slots *= 2;
+  }
+  std::vector<BatchResultReader::IndexEntry> table(slots);
+  for (const auto& entry : entries) {
+    std::uint64_t slot = entry.hash & (slots - 1);
+    while (table[slot].hash != 0) {
+      slot = (slot + 1) & (slots - 1);
+    }
+    table[slot] = entry;
+  }
+
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  const std::uint32_t reserved = 0;
+  const std::uint64_t count = entries.size();
+  out.write(reinterpret_cast<const char*>(&kIndexMagic), sizeof(kIndexMagic));
+  out.write(reinterpret_cast<const char*>(&reserved), sizeof(reserved));
+  out.write(reinterpret_cast<const char*>(&slots), sizeof(slots));
+  out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+  for (const auto& entry : table) {
+    const std::uint64_t fields[3] = {entry.hash, entry.offset, entry.length};
+    out.write(reinterpret_cast<const char*>(fields), sizeof(fields));
+  }
+  out.close();
+  if (!out) {
+    throw OpenAIError("Failed to write batch result index: " + path);
+  }
+}
+
+}  // namespace openai
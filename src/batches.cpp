@@ -240,6 +240,10 @@ CursorPage<Batch> make_batch_cursor_page(const PageRequestOptions& request_optio
 
 }  // namespace
 
+Batch parse_batch_json(const nlohmann::json& payload) {
+  return parse_batch(payload);
+}
+
 Batch BatchesResource::create(const BatchCreateRequest& request) const {
   return create(request, RequestOptions{});
 }
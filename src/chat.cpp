@@ -853,8 +853,38 @@ ChatCompletionStoreMessageList parse_chat_completion_store_message_list(const js
   return list;
 }
 
+// True when `key` occurs with a non-empty string value. Chunks are compact JSON, so a scan is enough
+// to classify them without parsing.
+bool has_non_empty_string_field(const std::string& data, const std::string& key) {
+  for (auto pos = data.find(key); pos != std::string::npos; pos = data.find(key, pos + 1)) {
+    auto cursor = pos + key.size();
+    while (cursor < data.size() && (data[cursor] == ' ' || data[cursor] == ':')) {
+      ++cursor;
+    }
+    if (cursor + 1 < data.size() && data[cursor] == '"' && data[cursor + 1] != '"') {
+      return true;
+    }
+  }
+  return false;
+}
+
+// A chunk is content when its delta carries text, a refusal or tool-call arguments.
+bool is_chat_content_event(const ServerSentEvent& event) {
+  return has_non_empty_string_field(event.data, "\"content\"") ||
+         has_non_empty_string_field(event.data, "\"refusal\"") ||
+         has_non_empty_string_field(event.data, "\"arguments\"");
+}
+
 }  // namespace
 
+json build_chat_request_body(const ChatCompletionRequest& request) {
+  return build_chat_request_body(request, std::nullopt);
+}
+
+ChatCompletion parse_chat_completion_json(const json& payload) {
+  return parse_chat_completion(payload);
+}
+
 ChatCompletion ChatCompletionsResource::create(const ChatCompletionRequest& request) const {
   return create(request, RequestOptions{});
 }
@@ -886,6 +916,7 @@ void ChatCompletionsResource::stream(const ChatCompletionRequest& request,
     }
     return true;
   });
+  stream.track_stats(client_.stream_stats_recorder(kChatCompletionsPath, options), is_chat_content_event);
   request_options.on_chunk = [&](const char* data, std::size_t size) {
     stream.feed(data, size);
   };
@@ -41,6 +41,7 @@ using json = nlohmann::json;
 
 constexpr std::chrono::milliseconds kMaxRetryAfter = std::chrono::milliseconds(60'000);
 constexpr const char* kDefaultBaseUrl = "https://api.openai.com/v1";
+constexpr std::size_t kStreamedErrorPrefixLimit = 64 * 1024;
 
 const std::set<std::string> kAzureDeploymentEndpoints = {
     "/completions",
@@ -60,16 +61,6 @@ bool iequals(std::string_view lhs, std::string_view rhs) {
          });
 }
 
-std::optional<std::string> get_header_value(const std::map<std::string, std::string>& headers,
-                                            std::string_view key) {
-  for (const auto& [name, value] : headers) {
-    if (iequals(name, key)) {
-      return value;
-    }
-  }
-  return std::nullopt;
-}
-
 std::optional<std::chrono::milliseconds> parse_numeric_retry_after_ms(const std::string& value) {
   char* end = nullptr;
   double parsed = std::strtod(value.c_str(), &end);
@@ -486,23 +477,6 @@ std::string append_query_string(const std::string& url, const std::string& query
   return result;
 }
 
-std::vector<float> bytes_to_float32(const std::vector<std::uint8_t>& bytes) {
-  if (bytes.size() % 4 != 0) {
-    throw OpenAIError("Embedding bytes length must be a multiple of 4");
-  }
-  std::vector<float> values(bytes.size() / 4);
-  for (std::size_t i = 0; i < values.size(); ++i) {
-    std::uint32_t word = static_cast<std::uint32_t>(bytes[i * 4]) |
-                         (static_cast<std::uint32_t>(bytes[i * 4 + 1]) << 8) |
-                         (static_cast<std::uint32_t>(bytes[i * 4 + 2]) << 16) |
-                         (static_cast<std::uint32_t>(bytes[i * 4 + 3]) << 24);
-    float value;
-    std::memcpy(&value, &word, sizeof(float));
-    values[i] = value;
-  }
-  return values;
-}
-
 Embedding parse_embedding(const json& payload, bool decode_base64) {
   Embedding embedding;
   embedding.index = payload.value("index", 0);
@@ -513,8 +487,14 @@ Embedding parse_embedding(const json& payload, bool decode_base64) {
     if (!data.is_string()) {
       throw OpenAIError("Expected base64 string for embedding data");
     }
-    auto bytes = utils::decode_base64(data.get<std::string>());
-    embedding.embedding = bytes_to_float32(bytes);
+    const auto& encoded = data.get_ref<const std::string&>();
+    const std::size_t bytes = utils::decoded_base64_size(encoded);
+    if (bytes % sizeof(float) != 0) {
+      throw OpenAIError("Embedding bytes length must be a multiple of 4");
+    }
+    std::vector<float> values(bytes / sizeof(float));
+    utils::decode_base64_floats(encoded, values.data(), values.size());
+    embedding.embedding = std::move(values);
   } else {
     if (data.is_string()) {
       embedding.embedding = data.get<std::string>();
@@ -531,6 +511,78 @@ Embedding parse_embedding(const json& payload, bool decode_base64) {
   return embedding;
 }
 
+std::size_t embedding_dimensions(const json& data) {
+  if (data.is_string()) {
+    // Four bytes per float32; base64 expands three bytes into four characters.
+    const auto& encoded = data.get_ref<const std::string&>();
+    std::size_t padding = 0;
+    if (!encoded.empty() && encoded.back() == '=') {
+      padding = encoded.size() >= 2 && encoded[encoded.size() - 2] == '=' ? 2 : 1;
+    }
+    if (encoded.size() % 4 != 0 || encoded.size() <= padding) {
+      throw OpenAIError("Malformed base64 embedding of length " + std::to_string(encoded.size()));
+    }
+    const std::size_t bytes = encoded.size() / 4 * 3 - padding;
+    if (bytes % 4 != 0) {
+      throw OpenAIError("Base64 embedding is not a whole number of float32 values");
+    }
+    return bytes / 4;
+  }
+  if (!data.is_array()) {
+    throw OpenAIError("Embedding must be an array or a base64 string");
+  }
+  return data.size();
+}
+
+EmbeddingMatrixResponse parse_embedding_matrix_response(const json& payload, EmbeddingStorage storage) {
+  EmbeddingMatrixResponse response;
+  response.model = payload.value("model", "");
+  response.object = payload.value("object", "");
+
+  if (payload.contains("data") && payload.at("data").is_array() && !payload.at("data").empty()) {
+    const auto& data = payload.at("data");
+    const std::size_t dimensions = embedding_dimensions(data.front().at("embedding"));
+    response.matrix = EmbeddingMatrix(data.size(), dimensions, storage);
+
+    std::vector<float> scratch(dimensions);
+    // With one entry per row and every index in range, rejecting duplicates also rules out gaps.
+    std::vector<bool> filled(data.size(), false);
+    for (const auto& embedding_json : data) {
+      const int index = embedding_json.value("index", 0);
+      if (index < 0 || static_cast<std::size_t>(index) >= data.size()) {
+        throw OpenAIError("Embedding index out of range: " + std::to_string(index));
+      }
+      if (filled[static_cast<std::size_t>(index)]) {
+        throw OpenAIError("Duplicate embedding index: " + std::to_string(index));
+      }
+      filled[static_cast<std::size_t>(index)] = true;
+      const auto& values = embedding_json.at("embedding");
+      if (embedding_dimensions(values) != dimensions) {
+        throw OpenAIError("Embeddings in one response must share a dimension");
+      }
+      const bool direct = storage == EmbeddingStorage::Float32;
+      float* out = direct ? response.matrix.mutable_row(static_cast<std::size_t>(index)) : scratch.data();
+      if (values.is_string()) {
+        utils::decode_base64_floats(values.get_ref<const std::string&>(), out, dimensions);
+      } else {
+        for (std::size_t i = 0; i < dimensions; ++i) {
+          out[i] = static_cast<float>(values[i].get<double>());
+        }
+      }
+      if (!direct) {
+        response.matrix.set_row(static_cast<std::size_t>(index), scratch.data());
+      }
+    }
+  }
+
+  if (payload.contains("usage") && payload.at("usage").is_object()) {
+    const auto& usage_json = payload.at("usage");
+    response.usage.prompt_tokens = usage_json.value("prompt_tokens", 0);
+    response.usage.total_tokens = usage_json.value("total_tokens", 0);
+  }
+  return response;
+}
+
 CreateEmbeddingResponse parse_embedding_response(const json& payload, bool decode_base64) {
   CreateEmbeddingResponse response;
   response.model = payload.value("model", "");
@@ -691,6 +743,14 @@ nlohmann::json build_response_log_details(const HttpRequest& request,
 
 }  // namespace
 
+json build_embedding_request_body(const EmbeddingRequest& request) {
+  return embedding_request_to_json(request);
+}
+
+CreateEmbeddingResponse parse_embedding_response_json(const json& payload) {
+  return parse_embedding_response(payload, false);
+}
+
 OpenAIClient::OpenAIClient(ClientOptions options,
                            std::unique_ptr<HttpClient> http_client)
     : options_(std::move(options)),
@@ -788,9 +848,30 @@ HttpResponse OpenAIClient::perform_request(const std::string& method,
                                            const std::string& path,
                                            const std::string& body,
                                            const RequestOptions& options) const {
+  return send_request(method, path, body, nullptr, options);
+}
+
+HttpResponse OpenAIClient::perform_request(const std::string& method,
+                                           const std::string& path,
+                                           std::shared_ptr<const HttpBodySegments> body,
+                                           const RequestOptions& options) const {
+  if (!http_client_->supports_body_segments()) {
+    return send_request(method, path, body->join(), nullptr, options);
+  }
+  return send_request(method, path, std::string(), std::move(body), options);
+}
+
+HttpResponse OpenAIClient::send_request(const std::string& method,
+                                        const std::string& path,
+                                        const std::string& body,
+                                        const std::shared_ptr<const HttpBodySegments>& body_segments,
+                                        const RequestOptions& options) const {
   if (options.timeout) {
     utils::validate_positive_integer("RequestOptions.timeout", options.timeout->count());
   }
+  if (options.idle_timeout) {
+    utils::validate_positive_integer("RequestOptions.idle_timeout", options.idle_timeout->count());
+  }
   if (options.max_retries) {
     utils::validate_positive_integer("RequestOptions.max_retries",
                                      static_cast<long long>(*options.max_retries));
@@ -830,8 +911,11 @@ HttpResponse OpenAIClient::perform_request(const std::string& method,
     url = append_query_string(url, query_string);
     http_request.url = std::move(url);
     http_request.body = body;
+    http_request.body_segments = body_segments;
     http_request.timeout = options.timeout.value_or(options_.timeout);
+    http_request.idle_timeout = options.idle_timeout;
     http_request.on_chunk = options.on_chunk;
+    http_request.on_status = options.on_status;
     http_request.collect_body = options.collect_body;
 
     std::map<std::string, std::string> headers;
@@ -876,7 +960,7 @@ HttpResponse OpenAIClient::perform_request(const std::string& method,
     }
 
     // The API expects JSON by default.
-    if (!body.empty()) {
+    if (!body.empty() || body_segments) {
       headers["Content-Type"] = "application/json";
     }
 
@@ -889,11 +973,73 @@ HttpResponse OpenAIClient::perform_request(const std::string& method,
     const std::size_t retry_count = max_retries - retries_remaining;
     HttpRequest http_request = build_request(retry_count);
     log(LogLevel::Debug, "sending request", build_request_log_details(http_request, retry_count));
+    std::optional<std::uint32_t> capture_id;
+    if (options.stream_capture) {
+      capture_id = options.stream_capture->begin_exchange(http_request.method, http_request.url);
+      http_request.on_chunk = [capture = options.stream_capture, id = *capture_id,
+                               downstream = std::move(http_request.on_chunk)](const char* data, std::size_t size) {
+        capture->record_chunk(id, data, size);
+        if (downstream) {
+          downstream(data, size);
+        }
+      };
+    }
+    // A streamed body is not collected, so keep its start to describe an error response.
+    std::string streamed_prefix;
+    if (!http_request.collect_body && http_request.on_chunk) {
+      http_request.on_chunk = [&streamed_prefix, downstream = std::move(http_request.on_chunk)](const char* data,
+                                                                                               std::size_t size) {
+        if (streamed_prefix.size() < kStreamedErrorPrefixLimit) {
+          streamed_prefix.append(data, std::min(size, kStreamedErrorPrefixLimit - streamed_prefix.size()));
+        }
+        downstream(data, size);
+      };
+    }
+    // Failures raised by on_chunk/on_status (a full disk, a handler stopping the stream) are not
+    // transport errors: they are rethrown as they are instead of being retried.
+    std::exception_ptr callback_error;
+    if (http_request.on_chunk) {
+      http_request.on_chunk = [&callback_error, downstream = std::move(http_request.on_chunk)](const char* data,
+                                                                                              std::size_t size) {
+        try {
+          downstream(data, size);
+        } catch (...) {
+          callback_error = std::current_exception();
+          throw;
+        }
+      };
+    }
+    if (http_request.on_status) {
+      http_request.on_status = [&callback_error, downstream = std::move(http_request.on_status)](long status) {
+        try {
+          downstream(status);
+        } catch (...) {
+          callback_error = std::current_exception();
+          throw;
+        }
+      };
+    }
+    if (options.on_attempt) {
+      options.on_attempt(retry_count);
+    }
     auto start_time = std::chrono::steady_clock::now();
     HttpResponse response;
+    auto rethrow_callback_error = [&](const std::exception& error) {
+      if (!callback_error) {
+        return;
+      }
+      if (capture_id) {
+        options.stream_capture->fail_exchange(*capture_id, error.what());
+      }
+      std::rethrow_exception(callback_error);
+    };
     try {
       response = http_client_->request(http_request);
     } catch (const OpenAIError& error) {
+      rethrow_callback_error(error);
+      if (capture_id) {
+        options.stream_capture->fail_exchange(*capture_id, error.what());
+      }
       if (retries_remaining == 0) {
         throw APIConnectionError(error.what());
       }
@@ -903,6 +1049,10 @@ HttpResponse OpenAIClient::perform_request(const std::string& method,
       --retries_remaining;
       continue;
     } catch (const std::exception& error) {
+      rethrow_callback_error(error);
+      if (capture_id) {
+        options.stream_capture->fail_exchange(*capture_id, error.what());
+      }
       if (retries_remaining == 0) {
         throw APIConnectionError(error.what());
       }
@@ -912,6 +1062,9 @@ HttpResponse OpenAIClient::perform_request(const std::string& method,
       --retries_remaining;
       continue;
     }
+    if (capture_id) {
+      options.stream_capture->end_exchange(*capture_id, response.status_code, response.headers);
+    }
 
     if (response.status_code < 400) {
       auto duration = std::chrono::steady_clock::now() - start_time;
@@ -932,7 +1085,7 @@ HttpResponse OpenAIClient::perform_request(const std::string& method,
 
     nlohmann::json error_payload = nlohmann::json::object();
     std::string message;
-    if (auto payload = utils::safe_json(response.body)) {
+    if (auto payload = utils::safe_json(response.body.empty() ? streamed_prefix : response.body)) {
       message = extract_error_message(*payload);
       error_payload = extract_error_payload(*payload);
     }
@@ -944,6 +1097,14 @@ HttpResponse OpenAIClient::perform_request(const std::string& method,
   throw OpenAIError("Retry loop exited unexpectedly");
 }
 
+std::shared_ptr<StreamStatsRecorder> OpenAIClient::stream_stats_recorder(const std::string& endpoint,
+                                                                         const RequestOptions& options) const {
+  if (!options.stream_stats && !options_.on_stream_stats) {
+    return nullptr;
+  }
+  return std::make_shared<StreamStatsRecorder>(endpoint, options.stream_stats, options_.on_stream_stats);
+}
+
 HttpResponse OpenAIClient::perform_request(const PageRequestOptions& options) const {
   RequestOptions request_options;
   for (const auto& [key, value] : options.headers) {
@@ -997,8 +1158,8 @@ ModelDeleted ModelsResource::Delete(const std::string& model_id, const RequestOp
   }
 }
 
-CreateEmbeddingResponse EmbeddingsResource::create(const EmbeddingRequest& request,
-                                                   const RequestOptions& options) const {
+CreateEmbeddingResponse EmbeddingsResource::create_uncached(const EmbeddingRequest& request,
+                                                            const RequestOptions& options) const {
   const bool has_user_encoding = request.encoding_format.has_value();
   EmbeddingRequest request_body = request;
   if (!request_body.encoding_format) {
@@ -1017,4 +1178,22 @@ CreateEmbeddingResponse EmbeddingsResource::create(const EmbeddingRequest& reque
   }
 }
 
+EmbeddingMatrixResponse EmbeddingsResource::create_matrix(const EmbeddingRequest& request,
+                                                          EmbeddingStorage storage,
+                                                          const RequestOptions& options) const {
+  EmbeddingRequest request_body = request;
+  if (!request_body.encoding_format) {
+    request_body.encoding_format = std::string("base64");
+  }
+
+  auto body = embedding_request_to_json(request_body).dump();
+  auto response = client_.perform_request("POST", "/embeddings", body, options);
+  try {
+    auto payload = json::parse(response.body);
+    return parse_embedding_matrix_response(payload, storage);
+  } catch (const json::exception& ex) {
+    throw OpenAIError(std::string("Failed to parse embedding response: ") + ex.what());
+  }
+}
+
 }  // namespace openai
@@ -257,6 +257,7 @@ ContainerFile ContainerFilesResource::create(const std::string& container_id,
   RequestOptions request_options = options;
 
   std::string body;
+  std::shared_ptr<const HttpBodySegments> segments;
   if (request.file_id) {
     body = file_create_json_body(request).dump();
   } else {
@@ -270,7 +271,7 @@ ContainerFile ContainerFilesResource::create(const std::string& container_id,
       }
       upload = utils::to_file(*request.file_data, *request.file_name, request.content_type);
     } else if (request.file_path) {
-      upload = utils::to_file(*request.file_path);
+      upload = utils::open_upload_file(*request.file_path);
     }
 
     if (!upload.has_value()) {
@@ -292,13 +293,14 @@ ContainerFile ContainerFilesResource::create(const std::string& container_id,
     }
 
     utils::MultipartFormData form;
-    form.append_file("file", upload->filename, *upload->content_type, upload->data);
-    auto encoded = form.build();
+    form.append_file("file", std::move(*upload), "application/octet-stream");
+    auto encoded = form.build_segments();
     request_options.headers["Content-Type"] = encoded.content_type;
-    body.assign(encoded.body.begin(), encoded.body.end());
+    segments = std::move(encoded.body);
   }
 
-  auto response = client_.perform_request("POST", path, body, request_options);
+  auto response = segments ? client_.perform_request("POST", path, std::move(segments), request_options)
+                           : client_.perform_request("POST", path, body, request_options);
   try {
     return parse_container_file(json::parse(response.body));
   } catch (const json::exception& ex) {
@@ -436,4 +438,24 @@ ContainerFileContent ContainerFilesContentResource::retrieve(const std::string&
   return content;
 }
 
+DownloadResult ContainerFilesContentResource::retrieve(const std::string& container_id,
+                                                       const std::string& file_id,
+                                                       const DownloadSink& sink,
+                                                       const DownloadOptions& download_options) const {
+  return retrieve(container_id, file_id, sink, download_options, RequestOptions{});
+}
+
+DownloadResult ContainerFilesContentResource::retrieve(const std::string& container_id,
+                                                       const std::string& file_id,
+                                                       const DownloadSink& sink,
+                                                       const DownloadOptions& download_options,
+                                                       const RequestOptions& options) const {
+  const std::string path = std::string(kContainersPath) + "/" + container_id + "/files/" + file_id + "/content";
+  RequestOptions request_options = options;
+  request_options.headers["Accept"] = "application/octet-stream";
+  return download(sink, download_options, request_options, [&](const RequestOptions& attached) {
+    return client_.perform_request("GET", path, "", attached);
+  });
+}
+
 }  // namespace openai
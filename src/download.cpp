@@ -0,0 +1,510 @@
+#include "openai/download.hpp"
+
+#include "openai/client.hpp"
+#include "openai/error.hpp"
+#include "openai/utils/mapped_file.hpp"
+#include "openai/utils/time.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace openai {
+namespace {
+
+std::string to_hex(const std::vector<std::uint8_t>& bytes) {
+  static constexpr char kDigits[] = "0123456789abcdef";
+  std::string hex;
+  hex.reserve(bytes.size() * 2);
+  for (const auto byte : bytes) {
+    hex.push_back(kDigits[byte >> 4]);
+    hex.push_back(kDigits[byte & 0x0fu]);
+  }
+  return hex;
+}
+
+void preallocate(const std::string& path, std::uint64_t bytes) {
+#if defined(__linux__)
+  const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    throw OpenAIError("Failed to open download file: " + path);
+  }
+  const int result = ::fallocate(fd, 0, 0, static_cast<off_t>(bytes));
+  const int error = errno;
+  ::close(fd);
+  // Filesystems without fallocate support still accept the download; only a full disk is fatal.
+  if (result != 0 && error == ENOSPC) {
+    throw OpenAIError("Not enough disk space to download " + std::to_string(bytes) + " bytes to " + path);
+  }
+#else
+  (void)path;
+  (void)bytes;
+#endif
+}
+
+std::optional<std::string> checksum_of(DownloadChecksum checksum, const std::uint8_t* data, std::size_t size) {
+  if (checksum == DownloadChecksum::MD5) {
+    utils::MD5 md5;
+    md5.update(data, size);
+    return md5.hex_digest();
+  }
+  if (checksum == DownloadChecksum::SHA256) {
+    utils::SHA256 sha256;
+    sha256.update(data, size);
+    return to_hex(sha256.digest());
+  }
+  return std::nullopt;
+}
+
+void verify_checksum(const DownloadOptions& options, const std::optional<std::string>& actual) {
+  if (!options.expected_checksum) {
+    return;
+  }
+  std::string expected = *options.expected_checksum;
+  std::transform(expected.begin(), expected.end(), expected.begin(),
+                 [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+  if (expected != *actual) {
+    throw OpenAIError("Download checksum mismatch: expected " + expected + ", got " + *actual);
+  }
+}
+
+// The complete length from a "bytes first-last/length" Content-Range; nullopt when it is "*" or malformed.
+std::optional<std::uint64_t> content_range_length(const std::string& value) {
+  const auto slash = value.rfind('/');
+  if (value.rfind("bytes ", 0) != 0 || slash == std::string::npos || slash + 1 == value.size()) {
+    return std::nullopt;
+  }
+  const std::string length = value.substr(slash + 1);
+  if (length.find_first_not_of("0123456789") != std::string::npos) {
+    return std::nullopt;
+  }
+  return std::stoull(length);
+}
+
+// A file of known size that several threads write at independent offsets.
+class RangedFile {
+public:
+  RangedFile(const std::string& path, std::uint64_t size) : path_(path) {
+#if defined(_WIN32)
+    file_.open(path, std::ios::binary | std::ios::trunc | std::ios::out);
+    file_.close();
+    std::error_code error;
+    std::filesystem::resize_file(path, size, error);
+    file_.open(path, std::ios::binary | std::ios::in | std::ios::out);
+    if (error || !file_) {
+      throw OpenAIError("Failed to open download file: " + path);
+    }
+#else
+    fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+      throw OpenAIError("Failed to open download file: " + path);
+    }
+#if defined(__linux__)
+    if (::fallocate(fd_, 0, 0, static_cast<off_t>(size)) != 0 && errno == ENOSPC) {
+      close();
+      throw OpenAIError("Not enough disk space to download " + std::to_string(size) + " bytes to " + path);
+    }
+#endif
+    if (::ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+      close();
+      throw OpenAIError("Failed to size download file: " + path);
+    }
+#endif
+  }
+
+  ~RangedFile() { close(); }
+
+  RangedFile(const RangedFile&) = delete;
+  RangedFile& operator=(const RangedFile&) = delete;
+
+  void write_at(std::uint64_t offset, const char* data, std::size_t size) {
+#if defined(_WIN32)
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_.seekp(static_cast<std::streamoff>(offset));
+    file_.write(data, static_cast<std::streamsize>(size));
+    if (!file_) {
+      throw OpenAIError("Failed to write download file: " + path_);
+    }
+#else
+    while (size > 0) {
+      const auto written = ::pwrite(fd_, data, size, static_cast<off_t>(offset));
+      if (written < 0 && errno == EINTR) {
+        continue;
+      }
+      if (written <= 0) {
+        throw OpenAIError("Failed to write download file: " + path_);
+      }
+      data += written;
+      size -= static_cast<std::size_t>(written);
+      offset += static_cast<std::uint64_t>(written);
+    }
+#endif
+  }
+
+  void close() {
+#if defined(_WIN32)
+    if (file_.is_open()) {
+      file_.close();
+    }
+#else
+    if (fd_ >= 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+#endif
+  }
+
+private:
+  std::string path_;
+#if defined(_WIN32)
+  std::mutex mutex_;
+  std::fstream file_;
+#else
+  int fd_ = -1;
+#endif
+};
+
+DownloadResult download_ranges(const std::string& path,
+                               std::uint64_t length,
+                               const DownloadOptions& options,
+                               const RequestOptions& request_options,
+                               const std::function<HttpResponse(const RequestOptions&)>& send) {
+  struct Range {
+    std::uint64_t begin;
+    std::uint64_t end;
+  };
+  const std::uint64_t range_bytes = std::max<std::uint64_t>(options.range_bytes, 1);
+  std::vector<Range> ranges;
+  for (std::uint64_t begin = 0; begin < length; begin += range_bytes) {
+    ranges.push_back(Range{begin, std::min(length, begin + range_bytes)});
+  }
+
+  RangedFile file(path, length);
+  std::atomic<std::size_t> next{0};
+  std::atomic<bool> failed{false};
+  std::mutex mutex;
+  std::exception_ptr first_error;
+  std::map<std::string, std::string> headers;
+
+  auto fetch = [&](const Range& range) {
+    const std::size_t max_attempts = std::max<std::size_t>(options.max_range_attempts, 1);
+    std::uint64_t written = 0;
+    for (std::size_t attempt = 1;; ++attempt) {
+      const std::uint64_t start = range.begin + written;
+      long status = 0;
+      bool ignored_range = false;
+      std::uint64_t received = 0;
+      RequestOptions range_options = request_options;
+      range_options.collect_body = false;
+      // Retried below instead, so a retry asks only for the bytes this range is still missing.
+      range_options.max_retries = 0;
+      range_options.headers["Range"] = "bytes=" + std::to_string(start) + "-" + std::to_string(range.end - 1);
+      range_options.on_status = [&status](long status_code) { status = status_code; };
+      range_options.on_chunk = [&](const char* data, std::size_t size) {
+        if (status >= 300) {
+          return;
+        }
+        if (status != 206) {
+          ignored_range = true;
+          throw OpenAIError("Server ignored the Range request");
+        }
+        if (size > range.end - start - received) {
+          throw OpenAIError("Server sent more bytes than the requested range");
+        }
+        file.write_at(start + received, data, size);
+        received += size;
+      };
+
+      std::exception_ptr error;
+      HttpResponse response;
+      try {
+        response = send(range_options);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      written += received;
+      if (!error && range.begin + written == range.end) {
+        return std::move(response.headers);
+      }
+      if (ignored_range) {
+        throw OpenAIError("Server stopped honouring Range requests during a parallel download");
+      }
+      if (!error) {
+        error = std::make_exception_ptr(APIConnectionError(
+            "Range response ended after " + std::to_string(written) + " of " +
+            std::to_string(range.end - range.begin) + " bytes"));
+      }
+      if (attempt >= max_attempts || !is_transient_error(error) || failed) {
+        std::rethrow_exception(error);
+      }
+      utils::sleep_for(utils::calculate_default_retry_delay(max_attempts - attempt, max_attempts));
+    }
+  };
+
+  auto worker = [&]() {
+    while (!failed) {
+      const std::size_t index = next++;
+      if (index >= ranges.size()) {
+        return;
+      }
+      try {
+        auto range_headers = fetch(ranges[index]);
+        if (index == 0) {
+          std::lock_guard<std::mutex> lock(mutex);
+          headers = std::move(range_headers);
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!first_error) {
+          first_error = std::current_exception();
+        }
+        failed = true;
+      }
+    }
+  };
+
+  const std::size_t concurrency = std::min(options.parallel_ranges, ranges.size());
+  std::vector<std::thread> threads;
+  threads.reserve(concurrency);
+  for (std::size_t i = 1; i < concurrency; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  file.close();
+
+  try {
+    if (first_error) {
+      std::rethrow_exception(first_error);
+    }
+    DownloadResult result;
+    result.bytes = length;
+    result.headers = std::move(headers);
+    if (options.checksum != DownloadChecksum::None) {
+      // Ranges land out of order, so the digest is taken over the finished file.
+      const auto mapping = utils::MappedFile::open(path);
+      result.checksum = checksum_of(options.checksum, mapping->data(), mapping->size());
+    }
+    verify_checksum(options, result.checksum);
+    return result;
+  } catch (...) {
+    std::error_code ignored;
+    std::filesystem::remove(path, ignored);
+    throw;
+  }
+}
+
+}  // namespace
+
+DownloadSink DownloadSink::file(std::string path) {
+  DownloadSink sink;
+  sink.target_ = std::move(path);
+  return sink;
+}
+
+DownloadSink DownloadSink::stream(std::ostream& out) {
+  DownloadSink sink;
+  sink.target_ = &out;
+  return sink;
+}
+
+DownloadSink DownloadSink::callback(std::function<void(const char*, std::size_t)> on_data,
+                                    std::function<void()> on_restart) {
+  DownloadSink sink;
+  sink.target_ = std::move(on_data);
+  sink.on_restart_ = std::move(on_restart);
+  return sink;
+}
+
+DownloadWriter::DownloadWriter(DownloadSink sink, DownloadOptions options)
+    : sink_(std::move(sink)), options_(std::move(options)) {
+  if (options_.checksum == DownloadChecksum::MD5) {
+    md5_.emplace();
+  } else if (options_.checksum == DownloadChecksum::SHA256) {
+    sha256_.emplace();
+  } else if (options_.expected_checksum) {
+    throw OpenAIError("DownloadOptions.expected_checksum requires a checksum algorithm");
+  }
+
+  if (const auto* path = std::get_if<std::string>(&sink_.target_)) {
+    if (options_.preallocate_bytes) {
+      preallocate(*path, *options_.preallocate_bytes);
+      // Keep the reserved extent; finish() trims the file to the bytes actually written.
+      file_.open(*path, std::ios::binary | std::ios::in | std::ios::out);
+    } else {
+      file_.open(*path, std::ios::binary | std::ios::trunc);
+    }
+    if (!file_) {
+      throw OpenAIError("Failed to open download file: " + *path);
+    }
+  } else if (auto* const* out = std::get_if<std::ostream*>(&sink_.target_)) {
+    stream_start_ = (*out)->tellp();
+  }
+}
+
+DownloadWriter::~DownloadWriter() {
+  if (const auto* path = std::get_if<std::string>(&sink_.target_); path && !finished_) {
+    file_.close();
+    std::error_code ignored;
+    std::filesystem::remove(*path, ignored);
+  }
+}
+
+RequestOptions DownloadWriter::attach(const RequestOptions& options) {
+  RequestOptions attached = options;
+  attached.collect_body = false;
+  attached.on_attempt = [this, downstream = options.on_attempt](std::size_t retry_count) {
+    restart();
+    if (downstream) {
+      downstream(retry_count);
+    }
+  };
+  attached.on_status = [this, downstream = options.on_status](long status_code) {
+    status_ = status_code;
+    if (downstream) {
+      downstream(status_code);
+    }
+  };
+  attached.on_chunk = [this, downstream = options.on_chunk](const char* data, std::size_t size) {
+    write(data, size);
+    if (downstream) {
+      downstream(data, size);
+    }
+  };
+  return attached;
+}
+
+void DownloadWriter::restart() {
+  status_ = 0;
+  if (bytes_ == 0) {
+    return;
+  }
+  if (std::holds_alternative<std::string>(sink_.target_)) {
+    file_.seekp(0);
+  } else if (auto* const* out = std::get_if<std::ostream*>(&sink_.target_)) {
+    if (stream_start_ == std::streampos(-1) || !(*out)->seekp(stream_start_)) {
+      throw OpenAIError("Download was interrupted after " + std::to_string(bytes_) +
+                        " bytes and the output stream cannot be rewound");
+    }
+  } else if (sink_.on_restart_) {
+    sink_.on_restart_();
+  } else {
+    throw OpenAIError("Download was interrupted after " + std::to_string(bytes_) +
+                      " bytes and the callback sink has no on_restart handler");
+  }
+  bytes_ = 0;
+  if (md5_) {
+    md5_->reset();
+  }
+  if (sha256_) {
+    sha256_->reset();
+  }
+}
+
+void DownloadWriter::write(const char* data, std::size_t size) {
+  // Error bodies are kept by the client for its exception message, never delivered to the sink.
+  if (status_ >= 300) {
+    return;
+  }
+  if (std::holds_alternative<std::string>(sink_.target_)) {
+    file_.write(data, static_cast<std::streamsize>(size));
+    if (!file_) {
+      throw OpenAIError("Failed to write download file: " + std::get<std::string>(sink_.target_));
+    }
+  } else if (auto* const* out = std::get_if<std::ostream*>(&sink_.target_)) {
+    (*out)->write(data, static_cast<std::streamsize>(size));
+    if (!**out) {
+      throw OpenAIError("Failed to write download stream");
+    }
+  } else {
+    std::get<std::function<void(const char*, std::size_t)>>(sink_.target_)(data, size);
+  }
+  const auto* bytes = reinterpret_cast<const std::uint8_t*>(data);
+  if (md5_) {
+    md5_->update(bytes, size);
+  }
+  if (sha256_) {
+    sha256_->update(bytes, size);
+  }
+  bytes_ += size;
+}
+
+DownloadResult DownloadWriter::finish(std::map<std::string, std::string> headers) {
+  if (const auto* path = std::get_if<std::string>(&sink_.target_)) {
+    file_.close();
+    if (!file_) {
+      throw OpenAIError("Failed to write download file: " + *path);
+    }
+    // Drops any preallocated tail and anything left by a longer, restarted attempt.
+    std::error_code error;
+    if (std::filesystem::file_size(*path, error) != bytes_ && !error) {
+      std::filesystem::resize_file(*path, bytes_, error);
+    }
+    if (error) {
+      throw OpenAIError("Failed to finalize download file: " + *path);
+    }
+  } else if (auto* const* out = std::get_if<std::ostream*>(&sink_.target_)) {
+    (*out)->flush();
+  }
+
+  DownloadResult result;
+  result.bytes = bytes_;
+  result.headers = std::move(headers);
+  if (md5_) {
+    result.checksum = md5_->hex_digest();
+  } else if (sha256_) {
+    result.checksum = to_hex(sha256_->digest());
+  }
+  verify_checksum(options_, result.checksum);
+  finished_ = true;
+  return result;
+}
+
+DownloadResult download(const DownloadSink& sink,
+                        const DownloadOptions& options,
+                        const RequestOptions& request_options,
+                        const std::function<HttpResponse(const RequestOptions&)>& send) {
+  const auto* path = std::get_if<std::string>(&sink.target_);
+  if (path && options.parallel_ranges > 1) {
+    std::optional<std::uint64_t> length;
+    try {
+      DownloadWriter writer(sink, options);
+      RequestOptions probe_options = request_options;
+      probe_options.headers["Range"] = "bytes=0-0";
+      auto response = send(writer.attach(probe_options));
+      if (response.status_code != 206) {
+        // The server sent the whole body, which was streamed into the sink as the download.
+        return writer.finish(std::move(response.headers));
+      }
+      if (auto content_range = get_header_value(response.headers, "Content-Range")) {
+        length = content_range_length(*content_range);
+      }
+    } catch (const APIError& error) {
+      // An empty file has no first byte to return.
+      if (error.status_code() != 416) {
+        throw;
+      }
+    }
+    if (length && *length > 0) {
+      return download_ranges(*path, *length, options, request_options, send);
+    }
+  }
+  DownloadWriter writer(sink, options);
+  auto response = send(writer.attach(request_options));
+  return writer.finish(std::move(response.headers));
+}
+
+}  // namespace openai
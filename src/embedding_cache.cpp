@@ -0,0 +1,193 @@
+#include "openai/embedding_cache.hpp"
+
+#include "openai/error.hpp"
+#include "openai/utils/sha256.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <utility>
+
+namespace openai {
+namespace {
+
+// Each disk record is: magic, dimension count, key, then the float32 values in host byte order.
+constexpr std::uint32_t kRecordMagic = 0x4345414Fu;  // "OAEC"
+constexpr std::size_t kRecordHeader = 2 * sizeof(std::uint32_t) + sizeof(EmbeddingCacheKey);
+
+std::uint64_t record_size(std::uint32_t dimensions) {
+  return kRecordHeader + static_cast<std::uint64_t>(dimensions) * sizeof(float);
+}
+
+}  // namespace
+
+std::size_t EmbeddingCacheKeyHash::operator()(const EmbeddingCacheKey& key) const {
+  // The key is already a cryptographic digest, so any slice of it is uniformly distributed.
+  std::size_t hash;
+  std::memcpy(&hash, key.data(), sizeof(hash));
+  return hash;
+}
+
+EmbeddingCache::EmbeddingCache(EmbeddingCacheOptions options) : options_(std::move(options)) {
+  if (options_.disk_path) {
+    open_disk_tier();
+  }
+}
+
+EmbeddingCache::~EmbeddingCache() = default;
+
+EmbeddingCacheKey EmbeddingCache::make_key(const std::string& model,
+                                           std::optional<int> dimensions,
+                                           std::string_view input) {
+  utils::SHA256 ctx;
+  ctx.update(model);
+  const std::string separator(1, '\0');
+  ctx.update(separator);
+  ctx.update(dimensions ? std::to_string(*dimensions) : std::string("-"));
+  ctx.update(separator);
+  ctx.update(input);
+  const auto digest = ctx.digest();
+  EmbeddingCacheKey key;
+  std::copy(digest.begin(), digest.end(), key.begin());
+  return key;
+}
+
+void EmbeddingCache::open_disk_tier() {
+  const std::string& path = *options_.disk_path;
+  std::error_code error;
+  if (std::filesystem::exists(path, error)) {
+    auto mapping = utils::MappedFile::open(path);
+    std::uint64_t offset = 0;
+    while (offset + kRecordHeader <= mapping->size()) {
+      const std::uint8_t* record = mapping->data() + offset;
+      std::uint32_t magic;
+      std::uint32_t dimensions;
+      std::memcpy(&magic, record, sizeof(magic));
+      std::memcpy(&dimensions, record + sizeof(magic), sizeof(dimensions));
+      if (magic != kRecordMagic || dimensions == 0 || offset + record_size(dimensions) > mapping->size()) {
+        break;
+      }
+      EmbeddingCacheKey key;
+      std::memcpy(key.data(), record + 2 * sizeof(std::uint32_t), key.size());
+      disk_[key] = DiskRecord{offset, dimensions};
+      offset += record_size(dimensions);
+    }
+    if (offset < mapping->size()) {
+      // A torn tail from an interrupted append; drop it so new records start on a boundary.
+      mapping.reset();
+      std::filesystem::resize_file(path, offset, error);
+      if (error) {
+        throw OpenAIError("Failed to truncate embedding cache file: " + path);
+      }
+      if (offset > 0) {
+        mapping = utils::MappedFile::open(path);
+      }
+    }
+    mapping_ = std::move(mapping);
+    disk_size_ = offset;
+  }
+  writer_.open(path, std::ios::binary | std::ios::app);
+  if (!writer_) {
+    throw OpenAIError("Failed to open embedding cache file: " + path);
+  }
+}
+
+std::optional<std::vector<float>> EmbeddingCache::get(const EmbeddingCacheKey& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (auto it = memory_.find(key); it != memory_.end()) {
+    lru_.splice(lru_.begin(), lru_, it->second);
+    ++memory_hits_;
+    return it->second->embedding;
+  }
+  if (auto it = disk_.find(key); it != disk_.end()) {
+    const DiskRecord record = it->second;
+    if (!mapping_ || record.offset + record_size(record.dimensions) > mapping_->size()) {
+      // The record was appended after the file was last mapped.
+      writer_.flush();
+      mapping_ = utils::MappedFile::open(*options_.disk_path);
+      if (record.offset + record_size(record.dimensions) > mapping_->size()) {
+        throw OpenAIError("Embedding cache file is shorter than its index: " + *options_.disk_path);
+      }
+    }
+    std::vector<float> embedding(record.dimensions);
+    std::memcpy(embedding.data(), mapping_->data() + record.offset + kRecordHeader, embedding.size() * sizeof(float));
+    ++disk_hits_;
+    remember(key, embedding);
+    return embedding;
+  }
+  ++misses_;
+  return std::nullopt;
+}
+
+void EmbeddingCache::put(const EmbeddingCacheKey& key, const std::vector<float>& embedding) {
+  if (embedding.empty()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (writer_.is_open() && disk_.count(key) == 0) {
+    const auto dimensions = static_cast<std::uint32_t>(embedding.size());
+    writer_.write(reinterpret_cast<const char*>(&kRecordMagic), sizeof(kRecordMagic));
+    writer_.write(reinterpret_cast<const char*>(&dimensions), sizeof(dimensions));
+    writer_.write(reinterpret_cast<const char*>(key.data()), static_cast<std::streamsize>(key.size()));
+    writer_.write(reinterpret_cast<const char*>(embedding.data()),
+                  static_cast<std::streamsize>(embedding.size() * sizeof(float)));
+    if (!writer_) {
+      throw OpenAIError("Failed to append to embedding cache file: " + *options_.disk_path);
+    }
+    disk_[key] = DiskRecord{disk_size_, dimensions};
+    disk_size_ += record_size(dimensions);
+  }
+  remember(key, embedding);
+  ++stores_;
+}
+
+void EmbeddingCache::remember(const EmbeddingCacheKey& key, std::vector<float> embedding) {
+  if (options_.memory_entries == 0) {
+    return;
+  }
+  if (auto it = memory_.find(key); it != memory_.end()) {
+    it->second->embedding = std::move(embedding);
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return;
+  }
+  lru_.push_front(MemoryEntry{key, std::move(embedding)});
+  memory_.emplace(key, lru_.begin());
+  while (lru_.size() > options_.memory_entries) {
+    memory_.erase(lru_.back().key);
+    lru_.pop_back();
+  }
+}
+
+EmbeddingCacheStats EmbeddingCache::stats() const {
+  EmbeddingCacheStats stats;
+  stats.memory_hits = memory_hits_.load();
+  stats.disk_hits = disk_hits_.load();
+  stats.misses = misses_.load();
+  stats.stores = stores_.load();
+  return stats;
+}
+
+void EmbeddingCache::reset_stats() {
+  memory_hits_ = 0;
+  disk_hits_ = 0;
+  misses_ = 0;
+  stores_ = 0;
+}
+
+std::size_t EmbeddingCache::memory_entries() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return lru_.size();
+}
+
+std::size_t EmbeddingCache::disk_entries() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return disk_.size();
+}
+
+void EmbeddingCache::flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (writer_.is_open()) {
+    writer_.flush();
+  }
+}
+
+}  // namespace openai
@@ -0,0 +1,254 @@
+#include "openai/embedding_matrix.hpp"
+
+#include "openai/error.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace openai {
+namespace {
+
+std::uint32_t float_bits(float value) {
+  std::uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+float bits_float(std::uint32_t bits) {
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+std::uint16_t float_to_half(float value) {
+  const std::uint32_t bits = float_bits(value);
+  const auto sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000u);
+  std::uint32_t magnitude = bits & 0x7FFFFFFFu;
+  if (magnitude >= 0x7F800000u) {
+    // Inf stays Inf; NaN keeps a quiet payload bit.
+    return static_cast<std::uint16_t>(sign | 0x7C00u | (magnitude > 0x7F800000u ? 0x200u : 0u));
+  }
+  if (magnitude >= 0x477FF000u) {
+    // 65520 and above round past the largest finite half.
+    return static_cast<std::uint16_t>(sign | 0x7C00u);
+  }
+  if (magnitude < 0x38800000u) {
+    // Below the smallest normal half: the result is a subnormal multiple of 2^-24.
+    const auto mantissa = static_cast<std::uint32_t>(std::nearbyint(bits_float(magnitude) * 16777216.0f));
+    return static_cast<std::uint16_t>(sign | mantissa);
+  }
+  // Rebias the exponent from 127 to 15 and round the dropped 13 mantissa bits to nearest even.
+  magnitude += 0xC8000FFFu + ((magnitude >> 13) & 1u);
+  return static_cast<std::uint16_t>(sign | (magnitude >> 13));
+}
+
+float half_to_float(std::uint16_t half) {
+  const std::uint32_t sign = static_cast<std::uint32_t>(half & 0x8000u) << 16;
+  const std::uint32_t exponent = (half >> 10) & 0x1Fu;
+  const std::uint32_t mantissa = half & 0x3FFu;
+  if (exponent == 0) {
+    const float magnitude = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+    return sign ? -magnitude : magnitude;
+  }
+  if (exponent == 0x1F) {
+    return bits_float(sign | 0x7F800000u | (mantissa << 13));
+  }
+  return bits_float(sign | ((exponent + 112u) << 23) | (mantissa << 13));
+}
+
+}  // namespace
+
+void EmbeddingMatrix::AlignedDelete::operator()(unsigned char* pointer) const {
+  ::operator delete(pointer, std::align_val_t{kAlignment});
+}
+
+EmbeddingMatrix::EmbeddingMatrix(std::size_t rows, std::size_t dimensions, EmbeddingStorage storage)
+    : rows_(rows), dimensions_(dimensions), storage_(storage) {
+  const std::size_t element = element_size();
+  const std::size_t row_bytes = (dimensions * element + kAlignment - 1) / kAlignment * kAlignment;
+  stride_ = row_bytes / element;
+  const std::size_t total = rows * row_bytes;
+  if (total > 0) {
+    buffer_.reset(static_cast<unsigned char*>(::operator new(total, std::align_val_t{kAlignment})));
+    std::memset(buffer_.get(), 0, total);
+  }
+  if (storage_ == EmbeddingStorage::Int8) {
+    scales_.assign(rows, 0.0f);
+  }
+}
+
+EmbeddingMatrix::EmbeddingMatrix(EmbeddingMatrix&& other) noexcept
+    : rows_(std::exchange(other.rows_, 0)),
+      dimensions_(std::exchange(other.dimensions_, 0)),
+      stride_(std::exchange(other.stride_, 0)),
+      storage_(other.storage_),
+      buffer_(std::move(other.buffer_)),
+      scales_(std::move(other.scales_)) {}
+
+EmbeddingMatrix& EmbeddingMatrix::operator=(EmbeddingMatrix&& other) noexcept {
+  if (this != &other) {
+    rows_ = std::exchange(other.rows_, 0);
+    dimensions_ = std::exchange(other.dimensions_, 0);
+    stride_ = std::exchange(other.stride_, 0);
+    storage_ = other.storage_;
+    buffer_ = std::move(other.buffer_);
+    scales_ = std::move(other.scales_);
+  }
+  return *this;
+}
+
+EmbeddingMatrix EmbeddingMatrix::from_response(const CreateEmbeddingResponse& response, EmbeddingStorage storage) {
+  std::size_t dimensions = 0;
+  for (const auto& embedding : response.data) {
+    const auto* values = std::get_if<std::vector<float>>(&embedding.embedding);
+    if (!values) {
+      throw OpenAIError("EmbeddingMatrix requires decoded float embeddings");
+    }
+    if (dimensions == 0) {
+      dimensions = values->size();
+    } else if (values->size() != dimensions) {
+      throw OpenAIError("Embeddings in one matrix must share a dimension");
+    }
+  }
+
+  EmbeddingMatrix matrix(response.data.size(), dimensions, storage);
+  std::vector<bool> filled(response.data.size(), false);
+  for (const auto& embedding : response.data) {
+    if (embedding.index < 0 || static_cast<std::size_t>(embedding.index) >= matrix.rows()) {
+      throw OpenAIError("Embedding index out of range: " + std::to_string(embedding.index));
+    }
+    if (filled[static_cast<std::size_t>(embedding.index)]) {
+      throw OpenAIError("Duplicate embedding index: " + std::to_string(embedding.index));
+    }
+    filled[static_cast<std::size_t>(embedding.index)] = true;
+    matrix.set_row(static_cast<std::size_t>(embedding.index), std::get<std::vector<float>>(embedding.embedding).data());
+  }
+  return matrix;
+}
+
+EmbeddingRowView EmbeddingMatrix::row(std::size_t index) const {
+  check_row(index);
+  if (storage_ != EmbeddingStorage::Float32) {
+    throw OpenAIError("EmbeddingMatrix::row requires Float32 storage; use copy_row");
+  }
+  return EmbeddingRowView(reinterpret_cast<const float*>(row_bytes(index)), dimensions_);
+}
+
+float* EmbeddingMatrix::mutable_row(std::size_t index) {
+  check_row(index);
+  if (storage_ != EmbeddingStorage::Float32) {
+    throw OpenAIError("EmbeddingMatrix::mutable_row requires Float32 storage; use set_row");
+  }
+  return reinterpret_cast<float*>(row_bytes(index));
+}
+
+const std::uint16_t* EmbeddingMatrix::row_f16(std::size_t index) const {
+  check_row(index);
+  if (storage_ != EmbeddingStorage::Float16) {
+    throw OpenAIError("EmbeddingMatrix::row_f16 requires Float16 storage");
+  }
+  return reinterpret_cast<const std::uint16_t*>(row_bytes(index));
+}
+
+const std::int8_t* EmbeddingMatrix::row_i8(std::size_t index) const {
+  check_row(index);
+  if (storage_ != EmbeddingStorage::Int8) {
+    throw OpenAIError("EmbeddingMatrix::row_i8 requires Int8 storage");
+  }
+  return reinterpret_cast<const std::int8_t*>(row_bytes(index));
+}
+
+float EmbeddingMatrix::row_scale(std::size_t index) const {
+  check_row(index);
+  return storage_ == EmbeddingStorage::Int8 ? scales_[index] : 1.0f;
+}
+
+void EmbeddingMatrix::set_row(std::size_t index, const float* values) {
+  check_row(index);
+  unsigned char* out = row_bytes(index);
+  switch (storage_) {
+    case EmbeddingStorage::Float32:
+      std::memcpy(out, values, dimensions_ * sizeof(float));
+      return;
+    case EmbeddingStorage::Float16: {
+      auto* halves = reinterpret_cast<std::uint16_t*>(out);
+      for (std::size_t i = 0; i < dimensions_; ++i) {
+        halves[i] = float_to_half(values[i]);
+      }
+      return;
+    }
+    case EmbeddingStorage::Int8: {
+      float max_abs = 0.0f;
+      for (std::size_t i = 0; i < dimensions_; ++i) {
+        max_abs = std::max(max_abs, std::fabs(values[i]));
+      }
+      const float scale = max_abs / 127.0f;
+      scales_[index] = scale;
+      auto* quantized = reinterpret_cast<std::int8_t*>(out);
+      const float inverse = scale > 0.0f ? 1.0f / scale : 0.0f;
+      for (std::size_t i = 0; i < dimensions_; ++i) {
+        const float q = std::nearbyint(values[i] * inverse);
+        quantized[i] = static_cast<std::int8_t>(std::clamp(q, -127.0f, 127.0f));
+      }
+      return;
+    }
+  }
+}
+
+void EmbeddingMatrix::copy_row(std::size_t index, float* out) const {
+  check_row(index);
+  const unsigned char* in = row_bytes(index);
+  switch (storage_) {
+    case EmbeddingStorage::Float32:
+      std::memcpy(out, in, dimensions_ * sizeof(float));
+      return;
+    case EmbeddingStorage::Float16: {
+      const auto* halves = reinterpret_cast<const std::uint16_t*>(in);
+      for (std::size_t i = 0; i < dimensions_; ++i) {
+        out[i] = half_to_float(halves[i]);
+      }
+      return;
+    }
+    case EmbeddingStorage::Int8: {
+      const auto* quantized = reinterpret_cast<const std::int8_t*>(in);
+      const float scale = scales_[index];
+      for (std::size_t i = 0; i < dimensions_; ++i) {
+        out[i] = static_cast<float>(quantized[i]) * scale;
+      }
+      return;
+    }
+  }
+}
+
+std::vector<float> EmbeddingMatrix::row_vector(std::size_t index) const {
+  std::vector<float> values(dimensions_);
+  copy_row(index, values.data());
+  return values;
+}
+
+std::size_t EmbeddingMatrix::element_size() const {
+  switch (storage_) {
+    case EmbeddingStorage::Float16:
+      return sizeof(std::uint16_t);
+    case EmbeddingStorage::Int8:
+      return sizeof(std::int8_t);
+    case EmbeddingStorage::Float32:
+      break;
+  }
+  return sizeof(float);
+}
+
+unsigned char* EmbeddingMatrix::row_bytes(std::size_t index) const {
+  return buffer_.get() + index * stride_ * element_size();
+}
+
+void EmbeddingMatrix::check_row(std::size_t index) const {
+  if (index >= rows_) {
+    throw OpenAIError("EmbeddingMatrix row " + std::to_string(index) + " out of range");
+  }
+}
+
+}  // namespace openai
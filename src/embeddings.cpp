@@ -0,0 +1,292 @@
+#include "openai/client.hpp"
+
+#include "openai/error.hpp"
+#include "openai/utils/time.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace openai {
+namespace {
+
+struct EmbeddingShard {
+  std::size_t begin = 0;
+  std::size_t end = 0;
+};
+
+std::size_t default_token_estimate(const std::string& text) {
+  // English averages about four bytes per token; dividing by three errs high so shards stay under the
+  // server's per-request token limit.
+  return text.size() / 3 + 1;
+}
+
+template <typename Item>
+std::size_t estimate_item_tokens(const Item& item, const EmbedManyOptions& batch_options) {
+  if constexpr (std::is_same_v<Item, std::string>) {
+    return batch_options.estimate_tokens ? batch_options.estimate_tokens(item) : default_token_estimate(item);
+  } else {
+    return item.size();
+  }
+}
+
+template <typename Item>
+std::vector<EmbeddingShard> plan_embedding_shards(const std::vector<Item>& items, const EmbedManyOptions& batch_options) {
+  const std::size_t max_items = std::max<std::size_t>(batch_options.max_items_per_request, 1);
+  std::vector<EmbeddingShard> shards;
+  EmbeddingShard current;
+  std::size_t tokens = 0;
+  for (std::size_t i = 0; i < items.size(); ++i) {
+    const std::size_t cost = estimate_item_tokens(items[i], batch_options);
+    const std::size_t count = i - current.begin;
+    if (count > 0 && (count >= max_items || tokens + cost > batch_options.max_tokens_per_request)) {
+      current.end = i;
+      shards.push_back(current);
+      current.begin = i;
+      tokens = 0;
+    }
+    tokens += cost;
+  }
+  if (current.begin < items.size()) {
+    current.end = items.size();
+    shards.push_back(current);
+  }
+  return shards;
+}
+
+// Serves cached string inputs and fetches the rest in one request (or one embed_many run), keeping the
+// caller's input order. Inputs the cache cannot key, and non-float encodings, go straight to `fetch`.
+template <typename Fetch>
+CreateEmbeddingResponse with_embedding_cache(EmbeddingCache& cache, const EmbeddingRequest& request, Fetch fetch) {
+  if (request.encoding_format && *request.encoding_format != "float") {
+    return fetch(request);
+  }
+  std::vector<std::string> single;
+  const std::vector<std::string>* inputs = nullptr;
+  if (const auto* text = std::get_if<std::string>(&request.input)) {
+    single.push_back(*text);
+    inputs = &single;
+  } else if (const auto* texts = std::get_if<std::vector<std::string>>(&request.input)) {
+    inputs = texts;
+  } else {
+    return fetch(request);
+  }
+
+  const std::size_t count = inputs->size();
+  std::vector<EmbeddingCacheKey> keys(count);
+  std::vector<std::optional<std::vector<float>>> vectors(count);
+  // Repeated inputs within one request are fetched once.
+  std::unordered_map<EmbeddingCacheKey, std::size_t, EmbeddingCacheKeyHash> pending;
+  std::vector<std::string> missing;
+  std::vector<std::size_t> source(count, SIZE_MAX);
+  for (std::size_t i = 0; i < count; ++i) {
+    keys[i] = EmbeddingCache::make_key(request.model, request.dimensions, (*inputs)[i]);
+    if (auto it = pending.find(keys[i]); it != pending.end()) {
+      source[i] = it->second;
+    } else if (auto cached = cache.get(keys[i])) {
+      vectors[i] = std::move(cached);
+    } else {
+      source[i] = missing.size();
+      pending.emplace(keys[i], missing.size());
+      missing.push_back((*inputs)[i]);
+    }
+  }
+
+  CreateEmbeddingResponse response;
+  response.model = request.model;
+  response.object = "list";
+  if (!missing.empty()) {
+    EmbeddingRequest miss_request = request;
+    if (single.empty()) {
+      miss_request.input = missing;
+    }
+    auto fetched = fetch(miss_request);
+    std::vector<const std::vector<float>*> fetched_vectors(missing.size(), nullptr);
+    for (const auto& embedding : fetched.data) {
+      const auto* values = std::get_if<std::vector<float>>(&embedding.embedding);
+      if (!values || embedding.index < 0 || static_cast<std::size_t>(embedding.index) >= missing.size()) {
+        throw OpenAIError("Embedding response does not match the uncached inputs");
+      }
+      fetched_vectors[static_cast<std::size_t>(embedding.index)] = values;
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+      if (vectors[i]) {
+        continue;
+      }
+      const auto* values = fetched_vectors[source[i]];
+      if (!values) {
+        throw OpenAIError("Embedding response is missing input " + std::to_string(source[i]));
+      }
+      vectors[i] = *values;
+    }
+    for (const auto& [key, index] : pending) {
+      cache.put(key, *fetched_vectors[index]);
+    }
+    response.model = std::move(fetched.model);
+    response.object = std::move(fetched.object);
+    response.usage = fetched.usage;
+  }
+
+  response.data.resize(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    response.data[i].embedding = std::move(*vectors[i]);
+    response.data[i].index = static_cast<int>(i);
+    response.data[i].object = "embedding";
+  }
+  return response;
+}
+
+}  // namespace
+
+CreateEmbeddingResponse EmbeddingsResource::embed_many_uncached(const EmbeddingRequest& request,
+                                                                const EmbedManyOptions& batch_options,
+                                                                const RequestOptions& options) const {
+  return std::visit(
+      [&](const auto& input) -> CreateEmbeddingResponse {
+        using Input = std::decay_t<decltype(input)>;
+        constexpr bool is_batch = std::is_same_v<Input, std::vector<std::string>> ||
+                                  std::is_same_v<Input, std::vector<std::vector<int>>> ||
+                                  std::is_same_v<Input, std::vector<std::vector<float>>> ||
+                                  std::is_same_v<Input, std::vector<std::vector<double>>>;
+        if constexpr (!is_batch) {
+          return create_uncached(request, options);
+        } else {
+          using Item = typename Input::value_type;
+          const auto shards = plan_embedding_shards(input, batch_options);
+          if (shards.size() <= 1) {
+            return create_uncached(request, options);
+          }
+
+          std::vector<CreateEmbeddingResponse> results(shards.size());
+          std::atomic<std::size_t> next_shard{0};
+          std::atomic<bool> failed{false};
+          std::exception_ptr first_error;
+          std::mutex mutex;
+          std::size_t completed_items = 0;
+
+          auto run_shard = [&](std::size_t shard_index) {
+            const auto& shard = shards[shard_index];
+            EmbeddingRequest sub_request;
+            sub_request.model = request.model;
+            sub_request.dimensions = request.dimensions;
+            sub_request.encoding_format = request.encoding_format;
+            sub_request.user = request.user;
+            sub_request.input = std::vector<Item>(input.begin() + static_cast<std::ptrdiff_t>(shard.begin),
+                                                  input.begin() + static_cast<std::ptrdiff_t>(shard.end));
+
+            RequestOptions shard_options = options;
+            if (shard_options.idempotency_key) {
+              *shard_options.idempotency_key += "-shard-" + std::to_string(shard_index);
+            }
+
+            const std::size_t max_attempts = std::max<std::size_t>(batch_options.max_shard_attempts, 1);
+            for (std::size_t attempt = 1;; ++attempt) {
+              try {
+                results[shard_index] = create_uncached(sub_request, shard_options);
+                break;
+              } catch (...) {
+                auto error = std::current_exception();
+                if (attempt >= max_attempts || failed.load() || !is_transient_error(error)) {
+                  throw;
+                }
+              }
+              utils::sleep_for(utils::calculate_default_retry_delay(max_attempts - attempt, max_attempts));
+            }
+
+            if (batch_options.on_progress) {
+              std::lock_guard<std::mutex> lock(mutex);
+              completed_items += shard.end - shard.begin;
+              batch_options.on_progress(completed_items, input.size());
+            }
+          };
+
+          auto worker = [&]() {
+            while (!failed.load()) {
+              const std::size_t shard_index = next_shard.fetch_add(1);
+              if (shard_index >= shards.size()) {
+                return;
+              }
+              try {
+                run_shard(shard_index);
+              } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!first_error) {
+                  first_error = std::current_exception();
+                }
+                failed.store(true);
+              }
+            }
+          };
+
+          const std::size_t concurrency =
+              std::min(std::max<std::size_t>(batch_options.max_concurrency, 1), shards.size());
+          std::vector<std::thread> threads;
+          threads.reserve(concurrency - 1);
+          for (std::size_t i = 1; i < concurrency; ++i) {
+            threads.emplace_back(worker);
+          }
+          worker();
+          for (auto& thread : threads) {
+            thread.join();
+          }
+          if (first_error) {
+            std::rethrow_exception(first_error);
+          }
+
+          CreateEmbeddingResponse merged;
+          merged.model = results.front().model;
+          merged.object = results.front().object;
+          merged.data.resize(input.size());
+          std::vector<bool> filled(input.size(), false);
+          for (std::size_t shard_index = 0; shard_index < shards.size(); ++shard_index) {
+            auto& result = results[shard_index];
+            const auto& shard = shards[shard_index];
+            for (auto& embedding : result.data) {
+              const std::size_t index = shard.begin + static_cast<std::size_t>(embedding.index);
+              if (embedding.index < 0 || index >= shard.end || filled[index]) {
+                throw OpenAIError("Embedding shard returned an unexpected index " + std::to_string(embedding.index));
+              }
+              embedding.index = static_cast<int>(index);
+              merged.data[index] = std::move(embedding);
+              filled[index] = true;
+            }
+            merged.usage.prompt_tokens += result.usage.prompt_tokens;
+            merged.usage.total_tokens += result.usage.total_tokens;
+          }
+          if (std::find(filled.begin(), filled.end(), false) != filled.end()) {
+            throw OpenAIError("Embedding shards returned fewer embeddings than inputs");
+          }
+          return merged;
+        }
+      },
+      request.input);
+}
+
+CreateEmbeddingResponse EmbeddingsResource::create(const EmbeddingRequest& request,
+                                                   const RequestOptions& options) const {
+  if (const auto& cache = client_.options().embedding_cache) {
+    return with_embedding_cache(*cache, request, [&](const EmbeddingRequest& misses) {
+      return create_uncached(misses, options);
+    });
+  }
+  return create_uncached(request, options);
+}
+
+CreateEmbeddingResponse EmbeddingsResource::embed_many(const EmbeddingRequest& request,
+                                                       const EmbedManyOptions& batch_options,
+                                                       const RequestOptions& options) const {
+  if (const auto& cache = client_.options().embedding_cache) {
+    return with_embedding_cache(*cache, request, [&](const EmbeddingRequest& misses) {
+      return embed_many_uncached(misses, batch_options, options);
+    });
+  }
+  return embed_many_uncached(request, batch_options, options);
+}
+
+}  // namespace openai
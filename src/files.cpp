@@ -41,7 +41,7 @@ utils::UploadFile FileUploadRequest::materialize(const std::string& default_file
   } else if (file_data.has_value()) {
     source = *file_data;
   } else if (file_path.has_value()) {
-    source = utils::to_file(*file_path);
+    source = utils::open_upload_file(*file_path);
   }
 
   if (!source.has_value()) {
@@ -226,12 +226,12 @@ FileObject FilesResource::create(const FileUploadRequest& request, const Request
 
   utils::MultipartFormData form;
   form.append_text("purpose", request.purpose);
-  form.append_file("file", upload.filename, content_type, upload.data);
+  form.append_file("file", std::move(upload), content_type);
   if (request.expires_after) {
     form.append_text("expires_after[anchor]", request.expires_after->anchor);
     form.append_text("expires_after[seconds]", std::to_string(request.expires_after->seconds));
   }
-  auto encoded = form.build();
+  auto encoded = form.build_segments();
 
   RequestOptions request_options = options;
   request_options.headers["Content-Type"] = encoded.content_type;
@@ -264,4 +264,22 @@ FileContent FilesResource::content(const std::string& file_id) const {
   return content(file_id, RequestOptions{});
 }
 
+DownloadResult FilesResource::content(const std::string& file_id,
+                                      const DownloadSink& sink,
+                                      const DownloadOptions& download_options,
+                                      const RequestOptions& options) const {
+  auto path = std::string(kFilesPath) + "/" + file_id + "/content";
+  RequestOptions request_options = options;
+  request_options.headers["Accept"] = "application/octet-stream";
+  return download(sink, download_options, request_options, [&](const RequestOptions& attached) {
+    return client_.perform_request("GET", path, "", attached);
+  });
+}
+
+DownloadResult FilesResource::content(const std::string& file_id,
+                                      const DownloadSink& sink,
+                                      const DownloadOptions& download_options) const {
+  return content(file_id, sink, download_options, RequestOptions{});
+}
+
 }  // namespace openai
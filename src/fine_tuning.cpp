@@ -815,6 +815,10 @@ std::string checkpoint_permissions_path(const std::string& checkpoint_id) {
 
 }  // namespace
 
+FineTuningJob parse_fine_tuning_job_json(const nlohmann::json& payload) {
+  return parse_job(payload);
+}
+
 FineTuningJob FineTuningJobsResource::create(const JobCreateParams& request) const {
   return create(request, RequestOptions{});
 }
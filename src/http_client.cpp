@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <cctype>
 #include <cstring>
+#include <exception>
 #include <map>
 #include <memory>
 #include <stdexcept>
@@ -16,11 +17,12 @@
 namespace openai {
 namespace {
 
+// Exceptions must not unwind through libcurl's C frames. The callbacks below park them here, make
+// libcurl abort the transfer, and request() rethrows the original once curl_easy_perform returns.
 struct WriteContext {
   std::string* body;
   std::function<void(const char*, std::size_t)>* on_chunk;
-  bool error = false;
-  std::string error_message;
+  std::exception_ptr* error;
 };
 
 size_t write_callback(char* ptr, size_t size, size_t nmemb, void* userdata) {
@@ -29,9 +31,8 @@ size_t write_callback(char* ptr, size_t size, size_t nmemb, void* userdata) {
   if (context->on_chunk && *context->on_chunk) {
     try {
       (*context->on_chunk)(ptr, total);
-    } catch (const std::exception& ex) {
-      context->error = true;
-      context->error_message = ex.what();
+    } catch (...) {
+      *context->error = std::current_exception();
       return 0;
     }
   }
@@ -41,11 +42,79 @@ size_t write_callback(char* ptr, size_t size, size_t nmemb, void* userdata) {
   return total;
 }
 
+// Feeds HttpBodySegments to libcurl one buffer at a time, so the body is never joined in memory.
+struct ReadContext {
+  const HttpBodySegments* body = nullptr;
+  std::size_t segment = 0;
+  std::size_t offset = 0;
+};
+
+size_t read_callback(char* buffer, size_t size, size_t nitems, void* userdata) {
+  auto* context = static_cast<ReadContext*>(userdata);
+  const auto& segments = context->body->segments;
+  const size_t capacity = size * nitems;
+  size_t written = 0;
+  while (written < capacity && context->segment < segments.size()) {
+    const auto& segment = segments[context->segment];
+    const size_t count = std::min(capacity - written, segment.size() - context->offset);
+    std::memcpy(buffer + written, segment.data() + context->offset, count);
+    written += count;
+    context->offset += count;
+    if (context->offset == segment.size()) {
+      ++context->segment;
+      context->offset = 0;
+    }
+  }
+  return written;
+}
+
+// libcurl rewinds the body when it has to resend it, e.g. after a redirect.
+int seek_callback(void* userdata, curl_off_t offset, int origin) {
+  if (origin != SEEK_SET || offset < 0) {
+    return CURL_SEEKFUNC_CANTSEEK;
+  }
+  auto* context = static_cast<ReadContext*>(userdata);
+  auto remaining = static_cast<std::size_t>(offset);
+  context->segment = 0;
+  context->offset = 0;
+  const auto& segments = context->body->segments;
+  while (context->segment < segments.size() && remaining >= segments[context->segment].size()) {
+    remaining -= segments[context->segment].size();
+    ++context->segment;
+  }
+  if (remaining > 0 && context->segment == segments.size()) {
+    return CURL_SEEKFUNC_FAIL;
+  }
+  context->offset = remaining;
+  return CURL_SEEKFUNC_OK;
+}
+
+struct HeaderContext {
+  std::map<std::string, std::string>* headers;
+  CURL* curl;
+  const std::function<void(long)>* on_status;
+  std::exception_ptr* error;
+};
+
 size_t header_callback(char* buffer, size_t size, size_t nitems, void* userdata) {
   std::size_t total_size = size * nitems;
   std::string line(buffer, total_size);
 
-  auto* headers = static_cast<std::map<std::string, std::string>*>(userdata);
+  auto* context = static_cast<HeaderContext*>(userdata);
+  if ((line == "\r\n" || line == "\n") && context->on_status && *context->on_status) {
+    // End of a header block; redirects produce one per hop, each followed by its own status.
+    long status_code = 0;
+    curl_easy_getinfo(context->curl, CURLINFO_RESPONSE_CODE, &status_code);
+    try {
+      (*context->on_status)(status_code);
+    } catch (...) {
+      *context->error = std::current_exception();
+      return 0;
+    }
+    return total_size;
+  }
+
+  auto* headers = context->headers;
   auto colon_pos = line.find(':');
   if (colon_pos != std::string::npos) {
     std::string key = line.substr(0, colon_pos);
@@ -82,6 +151,10 @@ public:
       std::string header = key + ": " + value;
       header_list = curl_slist_append(header_list, header.c_str());
     }
+    if (request.body_segments) {
+      // Large streamed bodies would otherwise wait on "Expect: 100-continue" before sending.
+      header_list = curl_slist_append(header_list, "Expect:");
+    }
 
     std::string response_body;
     std::map<std::string, std::string> response_headers;
@@ -90,27 +163,52 @@ public:
     curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, request.method.c_str());
     curl_easy_setopt(curl, CURLOPT_HTTPHEADER, header_list);
   std::function<void(const char*, std::size_t)> on_chunk = request.on_chunk;
+  std::exception_ptr callback_error;
   WriteContext context{
       request.collect_body ? &response_body : nullptr,
       on_chunk ? &on_chunk : nullptr,
+      &callback_error,
   };
 
   curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
   curl_easy_setopt(curl, CURLOPT_WRITEDATA, &context);
+    HeaderContext header_context{&response_headers, curl, &request.on_status, &callback_error};
     curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, header_callback);
-    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &response_headers);
+    curl_easy_setopt(curl, CURLOPT_HEADERDATA, &header_context);
     curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
     curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, static_cast<long>(request.timeout.count()));
+    if (request.idle_timeout) {
+      // libcurl only exposes stall detection with second granularity.
+      const auto idle_seconds = std::max<long>(
+          1, static_cast<long>((request.idle_timeout->count() + 999) / 1000));
+      curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, 1L);
+      curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, idle_seconds);
+    }
     const std::string& user_agent = utils::user_agent();
     curl_easy_setopt(curl, CURLOPT_USERAGENT, user_agent.c_str());
 
-    if (!request.body.empty()) {
+    ReadContext read_context;
+    if (request.body_segments) {
+      read_context.body = request.body_segments.get();
+      curl_easy_setopt(curl, CURLOPT_POST, 1L);
+      curl_easy_setopt(curl, CURLOPT_READFUNCTION, read_callback);
+      curl_easy_setopt(curl, CURLOPT_READDATA, &read_context);
+      curl_easy_setopt(curl, CURLOPT_SEEKFUNCTION, seek_callback);
+      curl_easy_setopt(curl, CURLOPT_SEEKDATA, &read_context);
+      curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE_LARGE, static_cast<curl_off_t>(request.body_segments->size()));
+    } else if (!request.body.empty()) {
       curl_easy_setopt(curl, CURLOPT_POSTFIELDS, request.body.c_str());
       curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, request.body.size());
     }
 
     CURLcode res = curl_easy_perform(curl);
 
+    if (callback_error) {
+      curl_slist_free_all(header_list);
+      curl_easy_cleanup(curl);
+      std::rethrow_exception(callback_error);
+    }
+
     if (res != CURLE_OK) {
       std::string message = std::string("libcurl error: ") + curl_easy_strerror(res);
       curl_slist_free_all(header_list);
@@ -121,15 +219,13 @@ public:
   long status_code = 0;
   curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status_code);
 
-  if (context.error) {
-    throw OpenAIError(context.error_message.empty() ? "Streaming callback failed" : context.error_message);
-  }
-
     curl_slist_free_all(header_list);
     curl_easy_cleanup(curl);
 
     return HttpResponse{status_code, response_headers, response_body};
   }
+
+  bool supports_body_segments() const override { return true; }
 };
 
 struct CurlGlobalState {
@@ -144,6 +240,36 @@ CurlGlobalState& curl_state() {
 
 }  // namespace
 
+std::size_t HttpBodySegments::size() const {
+  std::size_t total = 0;
+  for (const auto& segment : segments) {
+    total += segment.size();
+  }
+  return total;
+}
+
+std::string HttpBodySegments::join() const {
+  std::string body;
+  body.reserve(size());
+  for (const auto& segment : segments) {
+    body.append(segment.data(), segment.size());
+  }
+  return body;
+}
+
+std::optional<std::string> get_header_value(const std::map<std::string, std::string>& headers,
+                                            std::string_view name) {
+  for (const auto& [key, value] : headers) {
+    if (key.size() == name.size() &&
+        std::equal(key.begin(), key.end(), name.begin(), [](unsigned char lhs, unsigned char rhs) {
+          return std::tolower(lhs) == std::tolower(rhs);
+        })) {
+      return value;
+    }
+  }
+  return std::nullopt;
+}
+
 std::unique_ptr<HttpClient> make_default_http_client() {
   (void)curl_state();
   return std::make_unique<CurlHttpClient>();
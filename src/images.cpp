@@ -2,8 +2,11 @@
 
 #include "openai/client.hpp"
 #include "openai/error.hpp"
+#include "openai/utils/base64.hpp"
 
+#include <deque>
 #include <iomanip>
+#include <memory>
 #include <nlohmann/json.hpp>
 #include <sstream>
 
@@ -77,7 +80,7 @@ ImagesResponse parse_images_response(const json& payload) {
 std::string materialize_file_as_string(const FileUploadRequest& request,
                                        const std::string& default_filename) {
   auto upload = request.materialize(default_filename);
-  return std::string(upload.data.begin(), upload.data.end());
+  return std::string(upload.bytes());
 }
 
 std::string build_multipart_body(const std::vector<std::pair<std::string, std::string>>& parts,
@@ -224,6 +227,285 @@ ImageStreamCompletedEvent parse_stream_completed_event(const json& payload) {
   return completed;
 }
 
+bool is_image_partial_event(const ServerSentEvent& event) {
+  if (event.event && *event.event != "message") {
+    return event.event->find("partial_image") != std::string::npos;
+  }
+  return event.data.find("partial_image\"") != std::string::npos;
+}
+
+// The typed counterpart of is_image_partial_event, for paths that have already parsed the event.
+bool is_image_partial(const ImageStreamEvent& event) {
+  return event.generation_partial.has_value() || event.edit_partial.has_value();
+}
+
+/**
+ * Copies a JSON or SSE body through to `on_text` while decoding every "b64_json" string value into the
+ * sink for that image, leaving "" in its place. Base64 text is decoded in small windows as it arrives,
+ * so neither the encoded nor the decoded image is held in memory.
+ */
+class Base64ImageExtractor {
+public:
+  Base64ImageExtractor(const ImageSinks& sinks,
+                       std::deque<DownloadResult>& finished,
+                       std::function<void(const char*, std::size_t)> on_text,
+                       std::function<void()> on_restart = nullptr)
+      : sinks_(sinks), finished_(finished), on_text_(std::move(on_text)), on_restart_(std::move(on_restart)) {
+    if (!sinks_.sink_for) {
+      throw OpenAIError("ImageSinks.sink_for is required");
+    }
+  }
+
+  void feed(const char* data, std::size_t size) {
+    std::size_t i = 0;
+    while (i < size) {
+      const char c = data[i];
+      switch (state_) {
+        case State::Base64: {
+          std::size_t stop = i;
+          while (stop < size && data[stop] != '"' && data[stop] != '\\') {
+            ++stop;
+          }
+          pending_.append(data + i, stop - i);
+          if (pending_.size() >= kDecodeWindow) {
+            decode_pending(false);
+          }
+          i = stop;
+          if (i < size) {
+            if (data[i] == '\\') {
+              state_ = State::Base64Escape;
+            } else {
+              end_image();
+            }
+            ++i;
+          }
+          continue;
+        }
+        case State::Base64Escape:
+          // JSON may escape the '/' of the base64 alphabet; other escapes are line breaks.
+          if (c == '/') {
+            pending_.push_back(c);
+          }
+          state_ = State::Base64;
+          break;
+        case State::Text:
+          text_.push_back(c);
+          if (c == '"') {
+            key_.clear();
+            state_ = State::String;
+          }
+          break;
+        case State::String:
+          text_.push_back(c);
+          if (c == '\\') {
+            state_ = State::StringEscape;
+          } else if (c == '"') {
+            state_ = State::AfterString;
+          } else if (key_.size() <= kImageKey.size()) {
+            key_.push_back(c);
+          }
+          break;
+        case State::StringEscape:
+          text_.push_back(c);
+          key_.push_back('\\');
+          state_ = State::String;
+          break;
+        case State::AfterString:
+          if (c == ':' && key_ == kImageKey) {
+            text_.push_back(c);
+            state_ = State::AwaitValue;
+            break;
+          }
+          if (c == ' ' || c == '\t') {
+            text_.push_back(c);
+            break;
+          }
+          state_ = State::Text;
+          continue;
+        case State::AwaitValue:
+          if (c == ' ' || c == '\t') {
+            text_.push_back(c);
+            break;
+          }
+          if (c == '"') {
+            begin_image();
+            break;
+          }
+          state_ = State::Text;
+          continue;
+      }
+      ++i;
+    }
+    if (!text_.empty()) {
+      on_text_(text_.data(), text_.size());
+      text_.clear();
+    }
+  }
+
+  // Forgets a partially received body, for a retried request; `on_restart` drops what `on_text` was given.
+  void reset() {
+    state_ = State::Text;
+    key_.clear();
+    text_.clear();
+    pending_.clear();
+    writer_.reset();
+    ordinal_ = 0;
+    finished_.clear();
+    if (on_restart_) {
+      on_restart_();
+    }
+  }
+
+private:
+  enum class State { Text, String, StringEscape, AfterString, AwaitValue, Base64, Base64Escape };
+
+  static constexpr std::string_view kImageKey = "b64_json";
+  static constexpr std::size_t kDecodeWindow = 64 * 1024;
+
+  void begin_image() {
+    writer_ = std::make_unique<DownloadWriter>(sinks_.sink_for(ordinal_++), sinks_.download_options);
+    pending_.clear();
+    state_ = State::Base64;
+  }
+
+  void decode_pending(bool final) {
+    std::size_t usable = pending_.size() / 4 * 4;
+    if (final && usable != pending_.size()) {
+      // Unpadded base64; a single dangling character still fails to decode below.
+      pending_.append(4 - pending_.size() % 4, '=');
+      usable = pending_.size();
+    }
+    if (usable == 0) {
+      return;
+    }
+    decoded_.resize(usable / 4 * 3);
+    const std::size_t size =
+        utils::decode_base64_into(std::string_view(pending_.data(), usable), decoded_.data(), decoded_.size());
+    writer_->write(reinterpret_cast<const char*>(decoded_.data()), size);
+    pending_.erase(0, usable);
+  }
+
+  void end_image() {
+    decode_pending(true);
+    finished_.push_back(writer_->finish({}));
+    writer_.reset();
+    text_ += "\"\"";
+    state_ = State::Text;
+  }
+
+  const ImageSinks& sinks_;
+  std::deque<DownloadResult>& finished_;
+  std::function<void(const char*, std::size_t)> on_text_;
+  std::function<void()> on_restart_;
+  State state_ = State::Text;
+  std::string key_;
+  std::string text_;
+  std::string pending_;
+  std::vector<std::uint8_t> decoded_;
+  std::unique_ptr<DownloadWriter> writer_;
+  std::size_t ordinal_ = 0;
+};
+
+// Moves the next decoded image into `output` in place of the emptied b64_json field.
+void take_output(std::optional<std::string>& b64_json,
+                 std::optional<DownloadResult>& output,
+                 json& raw,
+                 std::deque<DownloadResult>& finished) {
+  if (!b64_json || finished.empty()) {
+    return;
+  }
+  output = std::move(finished.front());
+  finished.pop_front();
+  b64_json.reset();
+  raw.erase("b64_json");
+}
+
+// Wires the extractor into a request's body callbacks; a retry starts every sink over.
+RequestOptions attach_extractor(const RequestOptions& options, Base64ImageExtractor& extractor, long& status) {
+  RequestOptions attached = options;
+  attached.collect_body = false;
+  attached.on_attempt = [&extractor, &status, downstream = options.on_attempt](std::size_t retry_count) {
+    status = 0;
+    extractor.reset();
+    if (downstream) {
+      downstream(retry_count);
+    }
+  };
+  attached.on_status = [&status](long status_code) { status = status_code; };
+  attached.on_chunk = [&extractor, &status](const char* data, std::size_t size) {
+    // Error bodies stay with the client for its exception message.
+    if (status < 300) {
+      extractor.feed(data, size);
+    }
+  };
+  return attached;
+}
+
+ImagesResponse receive_images(const ImageSinks& sinks,
+                              const RequestOptions& options,
+                              const std::string& what,
+                              const std::function<HttpResponse(const RequestOptions&)>& send) {
+  std::deque<DownloadResult> finished;
+  std::string skeleton;
+  Base64ImageExtractor extractor(
+      sinks, finished, [&skeleton](const char* data, std::size_t size) { skeleton.append(data, size); },
+      [&skeleton] { skeleton.clear(); });
+  long status = 0;
+  send(attach_extractor(options, extractor, status));
+
+  ImagesResponse response;
+  try {
+    response = parse_images_response(json::parse(skeleton));
+  } catch (const json::exception& ex) {
+    throw OpenAIError("Failed to parse " + what + ": " + ex.what());
+  }
+  for (auto& image : response.data) {
+    take_output(image.b64_json, image.output, image.raw, finished);
+  }
+  return response;
+}
+
+void receive_image_stream(const ImageSinks& sinks,
+                          const std::function<bool(const ImageStreamEvent&)>& on_event,
+                          const RequestOptions& options,
+                          std::shared_ptr<StreamStatsRecorder> stats,
+                          const std::function<HttpResponse(const RequestOptions&)>& send) {
+  std::deque<DownloadResult> finished;
+  SSEEventStream stream([&](const ServerSentEvent& sse_event) {
+    auto parsed = parse_image_stream_event(sse_event);
+    if (!parsed) {
+      return true;
+    }
+    if (is_image_partial(*parsed)) {
+      stream.mark_content();
+    }
+    for (auto* partial : {&parsed->generation_partial, &parsed->edit_partial}) {
+      if (*partial) {
+        take_output((*partial)->b64_json, (*partial)->output, (*partial)->raw, finished);
+      }
+    }
+    for (auto* completed : {&parsed->generation_completed, &parsed->edit_completed}) {
+      if (*completed) {
+        take_output((*completed)->b64_json, (*completed)->output, (*completed)->raw, finished);
+      }
+    }
+    parsed->raw.erase("b64_json");
+    return on_event ? on_event(*parsed) : true;
+  });
+  stream.track_stats(std::move(stats), nullptr);
+  Base64ImageExtractor extractor(sinks, finished, [&stream](const char* data, std::size_t size) {
+    stream.feed(data, size);
+  });
+
+  RequestOptions request_options = options;
+  request_options.headers["Accept"] = "text/event-stream";
+  // Events already handed to on_event point at their sinks and cannot be taken back on a retry.
+  request_options.max_retries = 0;
+  long status = 0;
+  send(attach_extractor(request_options, extractor, status));
+  stream.finalize();
+}
+
 }  // namespace
 
 std::optional<ImageStreamEvent> parse_image_stream_event(const ServerSentEvent& event) {
@@ -291,6 +573,40 @@ ImagesResponse ImagesResource::generate(const ImageGenerateRequest& request) con
   return generate(request, RequestOptions{});
 }
 
+ImagesResponse ImagesResource::generate(const ImageGenerateRequest& request,
+                                        const ImageSinks& sinks,
+                                        const RequestOptions& options) const {
+  if (request.stream && *request.stream) {
+    throw OpenAIError("Use generate_stream() to receive streaming image generation events.");
+  }
+
+  const std::string body = build_generate_body(request, false).dump();
+  return receive_images(sinks, options, "image response", [&](const RequestOptions& attached) {
+    return client_.perform_request("POST", kImagesGenerate, body, attached);
+  });
+}
+
+ImagesResponse ImagesResource::generate(const ImageGenerateRequest& request, const ImageSinks& sinks) const {
+  return generate(request, sinks, RequestOptions{});
+}
+
+void ImagesResource::generate_stream(const ImageGenerateRequest& request,
+                                     const ImageSinks& sinks,
+                                     const std::function<bool(const ImageStreamEvent&)>& on_event,
+                                     const RequestOptions& options) const {
+  const std::string body = build_generate_body(request, true).dump();
+  receive_image_stream(sinks, on_event, options, client_.stream_stats_recorder(kImagesGenerate, options),
+                       [&](const RequestOptions& attached) {
+                         return client_.perform_request("POST", kImagesGenerate, body, attached);
+                       });
+}
+
+void ImagesResource::generate_stream(const ImageGenerateRequest& request,
+                                     const ImageSinks& sinks,
+                                     const std::function<bool(const ImageStreamEvent&)>& on_event) const {
+  generate_stream(request, sinks, on_event, RequestOptions{});
+}
+
 std::vector<ServerSentEvent> ImagesResource::generate_stream(const ImageGenerateRequest& request,
                                                              const RequestOptions& options) const {
   SSEEventStream stream;
@@ -300,6 +616,7 @@ std::vector<ServerSentEvent> ImagesResource::generate_stream(const ImageGenerate
   RequestOptions request_options = options;
   request_options.headers["Accept"] = "text/event-stream";
   request_options.collect_body = false;
+  stream.track_stats(client_.stream_stats_recorder(kImagesGenerate, options), is_image_partial_event);
   request_options.on_chunk = [&](const char* data, std::size_t size) { stream.feed(data, size); };
 
   client_.perform_request("POST", kImagesGenerate, body.dump(), request_options);
@@ -316,13 +633,14 @@ void ImagesResource::generate_stream(const ImageGenerateRequest& request,
                                      const std::function<bool(const ImageStreamEvent&)>& on_event,
                                      const RequestOptions& options) const {
   SSEEventStream stream([&](const ServerSentEvent& sse_event) {
-    if (!on_event) {
+    auto parsed = parse_image_stream_event(sse_event);
+    if (!parsed) {
       return true;
     }
-    if (auto parsed = parse_image_stream_event(sse_event)) {
-      return on_event(*parsed);
+    if (is_image_partial(*parsed)) {
+      stream.mark_content();
     }
-    return true;
+    return on_event ? on_event(*parsed) : true;
   });
 
   auto body = build_generate_body(request, true);
@@ -330,6 +648,7 @@ void ImagesResource::generate_stream(const ImageGenerateRequest& request,
   RequestOptions request_options = options;
   request_options.headers["Accept"] = "text/event-stream";
   request_options.collect_body = false;
+  stream.track_stats(client_.stream_stats_recorder(kImagesGenerate, options), nullptr);
   request_options.on_chunk = [&](const char* data, std::size_t size) { stream.feed(data, size); };
 
   client_.perform_request("POST", kImagesGenerate, body.dump(), request_options);
@@ -387,6 +706,26 @@ ImagesResponse ImagesResource::edit(const ImageEditRequest& request) const {
   return edit(request, RequestOptions{});
 }
 
+ImagesResponse ImagesResource::edit(const ImageEditRequest& request,
+                                    const ImageSinks& sinks,
+                                    const RequestOptions& options) const {
+  if (request.stream && *request.stream) {
+    throw OpenAIError("Use edit_stream() to receive streaming image edit events.");
+  }
+
+  const std::string boundary = "----openai-cpp-image-boundary";
+  const std::string body = build_edit_multipart(request, boundary, false);
+  RequestOptions request_options = options;
+  request_options.headers["Content-Type"] = "multipart/form-data; boundary=" + boundary;
+  return receive_images(sinks, request_options, "image edit response", [&](const RequestOptions& attached) {
+    return client_.perform_request("POST", kImagesEdit, body, attached);
+  });
+}
+
+ImagesResponse ImagesResource::edit(const ImageEditRequest& request, const ImageSinks& sinks) const {
+  return edit(request, sinks, RequestOptions{});
+}
+
 std::vector<ServerSentEvent> ImagesResource::edit_stream(const ImageEditRequest& request,
                                                          const RequestOptions& options) const {
   SSEEventStream stream;
@@ -398,6 +737,7 @@ std::vector<ServerSentEvent> ImagesResource::edit_stream(const ImageEditRequest&
   request_options.headers["Accept"] = "text/event-stream";
   request_options.headers["Content-Type"] = "multipart/form-data; boundary=" + boundary;
   request_options.collect_body = false;
+  stream.track_stats(client_.stream_stats_recorder(kImagesEdit, options), is_image_partial_event);
   request_options.on_chunk = [&](const char* data, std::size_t size) { stream.feed(data, size); };
 
   client_.perform_request("POST", kImagesEdit, body, request_options);
@@ -414,13 +754,14 @@ void ImagesResource::edit_stream(const ImageEditRequest& request,
                                  const std::function<bool(const ImageStreamEvent&)>& on_event,
                                  const RequestOptions& options) const {
   SSEEventStream stream([&](const ServerSentEvent& sse_event) {
-    if (!on_event) {
+    auto parsed = parse_image_stream_event(sse_event);
+    if (!parsed) {
       return true;
     }
-    if (auto parsed = parse_image_stream_event(sse_event)) {
-      return on_event(*parsed);
+    if (is_image_partial(*parsed)) {
+      stream.mark_content();
     }
-    return true;
+    return on_event ? on_event(*parsed) : true;
   });
 
   const std::string boundary = "----openai-cpp-image-boundary";
@@ -430,6 +771,7 @@ void ImagesResource::edit_stream(const ImageEditRequest& request,
   request_options.headers["Accept"] = "text/event-stream";
   request_options.headers["Content-Type"] = "multipart/form-data; boundary=" + boundary;
   request_options.collect_body = false;
+  stream.track_stats(client_.stream_stats_recorder(kImagesEdit, options), nullptr);
   request_options.on_chunk = [&](const char* data, std::size_t size) { stream.feed(data, size); };
 
   client_.perform_request("POST", kImagesEdit, body, request_options);
@@ -442,4 +784,24 @@ void ImagesResource::edit_stream(const ImageEditRequest& request,
   edit_stream(request, on_event, RequestOptions{});
 }
 
+void ImagesResource::edit_stream(const ImageEditRequest& request,
+                                 const ImageSinks& sinks,
+                                 const std::function<bool(const ImageStreamEvent&)>& on_event,
+                                 const RequestOptions& options) const {
+  const std::string boundary = "----openai-cpp-image-boundary";
+  const std::string body = build_edit_multipart(request, boundary, true);
+  RequestOptions request_options = options;
+  request_options.headers["Content-Type"] = "multipart/form-data; boundary=" + boundary;
+  receive_image_stream(sinks, on_event, request_options, client_.stream_stats_recorder(kImagesEdit, options),
+                       [&](const RequestOptions& attached) {
+                         return client_.perform_request("POST", kImagesEdit, body, attached);
+                       });
+}
+
+void ImagesResource::edit_stream(const ImageEditRequest& request,
+                                 const ImageSinks& sinks,
+                                 const std::function<bool(const ImageStreamEvent&)>& on_event) const {
+  edit_stream(request, sinks, on_event, RequestOptions{});
+}
+
 }  // namespace openai
@@ -0,0 +1,135 @@
+#include "openai/index/distance.hpp"
+
+#include <cmath>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define OPENAI_INDEX_X86_SIMD 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define OPENAI_INDEX_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace openai::index {
+namespace {
+
+float dot_scalar(const float* a, const float* b, std::size_t size) {
+  // Four independent accumulators let the compiler keep several multiply-adds in flight.
+  float sum0 = 0.0f;
+  float sum1 = 0.0f;
+  float sum2 = 0.0f;
+  float sum3 = 0.0f;
+  std::size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    sum0 += a[i] * b[i];
+    sum1 += a[i + 1] * b[i + 1];
+    sum2 += a[i + 2] * b[i + 2];
+    sum3 += a[i + 3] * b[i + 3];
+  }
+  for (; i < size; ++i) {
+    sum0 += a[i] * b[i];
+  }
+  return (sum0 + sum1) + (sum2 + sum3);
+}
+
+#if defined(OPENAI_INDEX_X86_SIMD)
+
+__attribute__((target("avx2,fma"))) float dot_avx2(const float* a, const float* b, std::size_t size) {
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+  __m256 sum2 = _mm256_setzero_ps();
+  __m256 sum3 = _mm256_setzero_ps();
+  std::size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+    sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), sum1);
+    sum2 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 16), _mm256_loadu_ps(b + i + 16), sum2);
+    sum3 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 24), _mm256_loadu_ps(b + i + 24), sum3);
+  }
+  for (; i + 8 <= size; i += 8) {
+    sum0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+  }
+  const __m256 sum = _mm256_add_ps(_mm256_add_ps(sum0, sum1), _mm256_add_ps(sum2, sum3));
+  __m128 low = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+  low = _mm_add_ps(low, _mm_movehl_ps(low, low));
+  low = _mm_add_ss(low, _mm_shuffle_ps(low, low, 0x55));
+  float result = _mm_cvtss_f32(low);
+  for (; i < size; ++i) {
+    result += a[i] * b[i];
+  }
+  return result;
+}
+
+#endif
+
+#if defined(OPENAI_INDEX_NEON)
+
+float dot_neon(const float* a, const float* b, std::size_t size) {
+  float32x4_t sum0 = vdupq_n_f32(0.0f);
+  float32x4_t sum1 = vdupq_n_f32(0.0f);
+  float32x4_t sum2 = vdupq_n_f32(0.0f);
+  float32x4_t sum3 = vdupq_n_f32(0.0f);
+  std::size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    sum0 = vfmaq_f32(sum0, vld1q_f32(a + i), vld1q_f32(b + i));
+    sum1 = vfmaq_f32(sum1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    sum2 = vfmaq_f32(sum2, vld1q_f32(a + i + 8), vld1q_f32(b + i + 8));
+    sum3 = vfmaq_f32(sum3, vld1q_f32(a + i + 12), vld1q_f32(b + i + 12));
+  }
+  for (; i + 4 <= size; i += 4) {
+    sum0 = vfmaq_f32(sum0, vld1q_f32(a + i), vld1q_f32(b + i));
+  }
+  float result = vaddvq_f32(vaddq_f32(vaddq_f32(sum0, sum1), vaddq_f32(sum2, sum3)));
+  for (; i < size; ++i) {
+    result += a[i] * b[i];
+  }
+  return result;
+}
+
+#endif
+
+using DotKernel = float (*)(const float*, const float*, std::size_t);
+
+struct SelectedKernel {
+  DotKernel kernel;
+  const char* name;
+};
+
+SelectedKernel select_kernel() {
+#if defined(OPENAI_INDEX_X86_SIMD)
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return {dot_avx2, "avx2"};
+  }
+#elif defined(OPENAI_INDEX_NEON)
+  return {dot_neon, "neon"};
+#endif
+  return {dot_scalar, "scalar"};
+}
+
+const SelectedKernel& selected_kernel() {
+  static const SelectedKernel selected = select_kernel();
+  return selected;
+}
+
+}  // namespace
+
+float dot(const float* a, const float* b, std::size_t size) {
+  return selected_kernel().kernel(a, b, size);
+}
+
+void normalize(float* values, std::size_t size) {
+  const float norm = std::sqrt(dot(values, values, size));
+  if (norm == 0.0f || !std::isfinite(norm)) {
+    return;
+  }
+  const float scale = 1.0f / norm;
+  for (std::size_t i = 0; i < size; ++i) {
+    values[i] *= scale;
+  }
+}
+
+const char* dot_kernel_name() {
+  return selected_kernel().name;
+}
+
+}  // namespace openai::index
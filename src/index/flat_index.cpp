@@ -0,0 +1,228 @@
+#include "openai/index/flat_index.hpp"
+
+#include "openai/error.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+
+namespace openai::index {
+namespace {
+
+// Keeps roughly this many bytes of stored rows hot while a tile of queries is scored against them.
+constexpr std::size_t kRowBlockBytes = 256 * 1024;
+constexpr std::size_t kQueryTile = 8;
+
+bool better(const SearchResult& a, const SearchResult& b) {
+  return a.score > b.score || (a.score == b.score && a.id < b.id);
+}
+
+// `heap` is a heap under better(), so its front is the worst result kept so far.
+void offer(std::vector<SearchResult>& heap, std::size_t k, SearchResult candidate) {
+  if (heap.size() < k) {
+    heap.push_back(candidate);
+    std::push_heap(heap.begin(), heap.end(), better);
+  } else if (better(candidate, heap.front())) {
+    std::pop_heap(heap.begin(), heap.end(), better);
+    heap.back() = candidate;
+    std::push_heap(heap.begin(), heap.end(), better);
+  }
+}
+
+std::vector<SearchResult> sorted_results(std::vector<SearchResult> heap) {
+  std::sort_heap(heap.begin(), heap.end(), better);
+  return heap;
+}
+
+std::size_t resolve_threads(std::size_t requested, std::size_t work) {
+  std::size_t threads = requested == 0 ? std::thread::hardware_concurrency() : requested;
+  return std::max<std::size_t>(1, std::min(threads, work));
+}
+
+}  // namespace
+
+FlatIndex::FlatIndex(std::size_t dimensions, Metric metric) : metric_(metric), vectors_(dimensions) {
+  if (dimensions == 0) {
+    throw OpenAIError("FlatIndex dimensions must be positive");
+  }
+}
+
+FlatIndex::FlatIndex(Metric metric, VectorStorage vectors) : metric_(metric), vectors_(std::move(vectors)) {}
+
+void FlatIndex::reserve(std::size_t rows) {
+  vectors_.reserve(rows);
+  ids_.reserve(rows);
+  rows_.reserve(rows);
+}
+
+void FlatIndex::add(std::uint64_t id, const float* values) {
+  auto existing = rows_.find(id);
+  float* row = nullptr;
+  if (existing != rows_.end()) {
+    row = vectors_.mutable_row(existing->second);
+    std::copy(values, values + dimensions(), row);
+  } else {
+    const std::size_t index = vectors_.push_back(values);
+    ids_.push_back(id);
+    rows_.emplace(id, index);
+    row = vectors_.mutable_row(index);
+  }
+  if (metric_ == Metric::Cosine) {
+    normalize(row, dimensions());
+  }
+}
+
+void FlatIndex::add(std::uint64_t id, const std::vector<float>& values) {
+  if (values.size() != dimensions()) {
+    throw OpenAIError("Vector has " + std::to_string(values.size()) + " dimensions; index expects " +
+                      std::to_string(dimensions()));
+  }
+  add(id, values.data());
+}
+
+void FlatIndex::add(const EmbeddingMatrix& matrix, std::uint64_t first_id) {
+  if (matrix.dimensions() != dimensions()) {
+    throw OpenAIError("EmbeddingMatrix has " + std::to_string(matrix.dimensions()) + " dimensions; index expects " +
+                      std::to_string(dimensions()));
+  }
+  reserve(size() + matrix.rows());
+  for (std::size_t row = 0; row < matrix.rows(); ++row) {
+    add(first_id + row, matrix.row(row).data());
+  }
+}
+
+bool FlatIndex::remove(std::uint64_t id) {
+  auto it = rows_.find(id);
+  if (it == rows_.end()) {
+    return false;
+  }
+  const std::size_t row = it->second;
+  const std::size_t last = ids_.size() - 1;
+  rows_.erase(it);
+  if (row != last) {
+    // mutable_row() may copy a mapped index into owned memory, so take it before reading the last row.
+    float* destination = vectors_.mutable_row(row);
+    std::copy(vectors_.row(last), vectors_.row(last) + vectors_.stride(), destination);
+    ids_[row] = ids_[last];
+    rows_[ids_[row]] = row;
+  }
+  ids_.pop_back();
+  vectors_.pop_back();
+  return true;
+}
+
+void FlatIndex::score_block(const float* const* queries,
+                            std::size_t query_count,
+                            std::size_t first_row,
+                            std::size_t last_row,
+                            std::size_t k,
+                            std::vector<SearchResult>* heaps) const {
+  const std::size_t dims = dimensions();
+  for (std::size_t row = first_row; row < last_row; ++row) {
+    const float* values = vectors_.row(row);
+    for (std::size_t q = 0; q < query_count; ++q) {
+      offer(heaps[q], k, SearchResult{ids_[row], dot(queries[q], values, dims)});
+    }
+  }
+}
+
+std::vector<SearchResult> FlatIndex::search(const float* query, std::size_t k) const {
+  if (k == 0 || ids_.empty()) {
+    return {};
+  }
+  std::vector<float> normalized;
+  if (metric_ == Metric::Cosine) {
+    normalized.assign(query, query + dimensions());
+    normalize(normalized.data(), normalized.size());
+    query = normalized.data();
+  }
+  std::vector<SearchResult> heap;
+  heap.reserve(std::min(k, ids_.size()));
+  score_block(&query, 1, 0, ids_.size(), k, &heap);
+  return sorted_results(std::move(heap));
+}
+
+std::vector<SearchResult> FlatIndex::search(const std::vector<float>& query, std::size_t k) const {
+  if (query.size() != dimensions()) {
+    throw OpenAIError("Query has " + std::to_string(query.size()) + " dimensions; index expects " +
+                      std::to_string(dimensions()));
+  }
+  return search(query.data(), k);
+}
+
+std::vector<std::vector<SearchResult>> FlatIndex::search_batch(const std::vector<std::vector<float>>& queries,
+                                                               std::size_t k,
+                                                               std::size_t threads) const {
+  std::vector<std::vector<SearchResult>> results(queries.size());
+  if (queries.empty() || k == 0 || ids_.empty()) {
+    return results;
+  }
+  std::vector<std::vector<float>> prepared;
+  std::vector<const float*> pointers(queries.size());
+  if (metric_ == Metric::Cosine) {
+    prepared = queries;
+  }
+  for (std::size_t q = 0; q < queries.size(); ++q) {
+    if (queries[q].size() != dimensions()) {
+      throw OpenAIError("Query " + std::to_string(q) + " has " + std::to_string(queries[q].size()) +
+                        " dimensions; index expects " + std::to_string(dimensions()));
+    }
+    if (metric_ == Metric::Cosine) {
+      normalize(prepared[q].data(), prepared[q].size());
+      pointers[q] = prepared[q].data();
+    } else {
+      pointers[q] = queries[q].data();
+    }
+  }
+
+  const std::size_t row_block =
+      std::max<std::size_t>(16, kRowBlockBytes / (vectors_.stride() * sizeof(float)));
+  auto run = [&](std::size_t first_query, std::size_t last_query) {
+    for (std::size_t tile = first_query; tile < last_query; tile += kQueryTile) {
+      const std::size_t count = std::min(kQueryTile, last_query - tile);
+      for (std::size_t row = 0; row < ids_.size(); row += row_block) {
+        score_block(pointers.data() + tile, count, row, std::min(row + row_block, ids_.size()), k,
+                    results.data() + tile);
+      }
+      for (std::size_t q = tile; q < tile + count; ++q) {
+        results[q] = sorted_results(std::move(results[q]));
+      }
+    }
+  };
+
+  const std::size_t workers = resolve_threads(threads, queries.size());
+  const std::size_t per_worker = (queries.size() + workers - 1) / workers;
+  std::vector<std::thread> pool;
+  pool.reserve(workers - 1);
+  for (std::size_t worker = 1; worker < workers; ++worker) {
+    const std::size_t first = worker * per_worker;
+    if (first >= queries.size()) {
+      break;
+    }
+    pool.emplace_back(run, first, std::min(first + per_worker, queries.size()));
+  }
+  run(0, std::min(per_worker, queries.size()));
+  for (auto& thread : pool) {
+    thread.join();
+  }
+  return results;
+}
+
+void FlatIndex::save(const std::string& path) const {
+  write_index_file(path, IndexKind::Flat, metric_, vectors_, ids_);
+}
+
+FlatIndex FlatIndex::load(const std::string& path, bool map) {
+  auto contents = read_index_file(path, IndexKind::Flat, map);
+  FlatIndex index(contents.metric, std::move(contents.vectors));
+  index.ids_ = std::move(contents.ids);
+  index.rows_.reserve(index.ids_.size());
+  for (std::size_t row = 0; row < index.ids_.size(); ++row) {
+    if (!index.rows_.emplace(index.ids_[row], row).second) {
+      throw OpenAIError("Index file repeats id " + std::to_string(index.ids_[row]) + ": " + path);
+    }
+  }
+  return index;
+}
+
+}  // namespace openai::index
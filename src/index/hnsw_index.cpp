@@ -0,0 +1,502 @@
+#include "openai/index/hnsw_index.hpp"
+
+#include "openai/error.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <queue>
+#include <thread>
+#include <utility>
+
+namespace openai::index {
+namespace {
+
+struct ByDistance {
+  template <typename T>
+  bool operator()(const T& a, const T& b) const {
+    return a.distance < b.distance;
+  }
+};
+
+struct ByDistanceDescending {
+  template <typename T>
+  bool operator()(const T& a, const T& b) const {
+    return a.distance > b.distance;
+  }
+};
+
+template <typename T>
+void append_pod(std::string& out, const T* values, std::size_t count) {
+  out.append(reinterpret_cast<const char*>(values), count * sizeof(T));
+}
+
+class SectionReader {
+public:
+  SectionReader(const std::string& data, const std::string& path) : data_(data), path_(path) {}
+
+  template <typename T>
+  void read(T* values, std::size_t count) {
+    const std::size_t bytes = count * sizeof(T);
+    if (bytes == 0) {
+      return;
+    }
+    if (bytes > data_.size() - offset_) {
+      throw OpenAIError("HNSW graph section is truncated: " + path_);
+    }
+    std::memcpy(values, data_.data() + offset_, bytes);
+    offset_ += bytes;
+  }
+
+  template <typename T>
+  T read() {
+    T value{};
+    read(&value, 1);
+    return value;
+  }
+
+  [[nodiscard]] bool done() const { return offset_ == data_.size(); }
+
+private:
+  const std::string& data_;
+  const std::string& path_;
+  std::size_t offset_ = 0;
+};
+
+}  // namespace
+
+HnswIndex::HnswIndex(std::size_t dimensions, Metric metric, HnswOptions options)
+    : metric_(metric), options_(options), vectors_(dimensions), rng_(options.seed) {
+  if (dimensions == 0) {
+    throw OpenAIError("HnswIndex dimensions must be positive");
+  }
+  if (options_.m < 2) {
+    throw OpenAIError("HnswOptions::m must be at least 2");
+  }
+  options_.ef_construction = std::max(options_.ef_construction, options_.m);
+}
+
+HnswIndex::HnswIndex(HnswIndex&& other) noexcept
+    : metric_(other.metric_),
+      options_(other.options_),
+      vectors_(std::move(other.vectors_)),
+      ids_(std::move(other.ids_)),
+      deleted_(std::move(other.deleted_)),
+      levels_(std::move(other.levels_)),
+      level0_(std::move(other.level0_)),
+      upper_(std::move(other.upper_)),
+      live_(std::move(other.live_)),
+      entry_point_(other.entry_point_),
+      max_level_(std::exchange(other.max_level_, -1)),
+      rng_(other.rng_) {}
+
+HnswIndex& HnswIndex::operator=(HnswIndex&& other) noexcept {
+  if (this != &other) {
+    metric_ = other.metric_;
+    options_ = other.options_;
+    vectors_ = std::move(other.vectors_);
+    ids_ = std::move(other.ids_);
+    deleted_ = std::move(other.deleted_);
+    levels_ = std::move(other.levels_);
+    level0_ = std::move(other.level0_);
+    upper_ = std::move(other.upper_);
+    live_ = std::move(other.live_);
+    entry_point_ = other.entry_point_;
+    max_level_ = std::exchange(other.max_level_, -1);
+    rng_ = other.rng_;
+    std::lock_guard<std::mutex> lock(visited_mutex_);
+    visited_pool_.clear();
+  }
+  return *this;
+}
+
+std::uint32_t* HnswIndex::links(std::uint32_t node, int level) {
+  if (level == 0) {
+    return level0_.data() + static_cast<std::size_t>(node) * (1 + 2 * options_.m);
+  }
+  return upper_[node].data() + static_cast<std::size_t>(level - 1) * (1 + options_.m);
+}
+
+const std::uint32_t* HnswIndex::links(std::uint32_t node, int level) const {
+  return const_cast<HnswIndex*>(this)->links(node, level);
+}
+
+float HnswIndex::distance(const float* query, std::uint32_t node) const {
+  return -dot(query, vectors_.row(node), dimensions());
+}
+
+int HnswIndex::random_level() {
+  const double multiplier = 1.0 / std::log(static_cast<double>(options_.m));
+  const double uniform = std::uniform_real_distribution<double>(0.0, 1.0)(rng_);
+  return static_cast<int>(-std::log(std::max(uniform, 1e-12)) * multiplier);
+}
+
+void HnswIndex::reserve(std::size_t nodes) {
+  vectors_.reserve(nodes);
+  ids_.reserve(nodes);
+  deleted_.reserve(nodes);
+  levels_.reserve(nodes);
+  level0_.reserve(nodes * (1 + 2 * options_.m));
+  upper_.reserve(nodes);
+  live_.reserve(nodes);
+}
+
+void HnswIndex::add(std::uint64_t id, const float* values) {
+  if (ids_.size() >= UINT32_MAX) {
+    throw OpenAIError("HnswIndex is full");
+  }
+  remove(id);
+
+  const auto node = static_cast<std::uint32_t>(ids_.size());
+  vectors_.push_back(values);
+  float* row = vectors_.mutable_row(node);
+  if (metric_ == Metric::Cosine) {
+    normalize(row, dimensions());
+  }
+  const int level = random_level();
+  ids_.push_back(id);
+  deleted_.push_back(0);
+  levels_.push_back(level);
+  level0_.resize(level0_.size() + 1 + 2 * options_.m, 0);
+  upper_.emplace_back(static_cast<std::size_t>(level) * (1 + options_.m), 0);
+  live_[id] = node;
+
+  if (max_level_ < 0) {
+    entry_point_ = node;
+    max_level_ = level;
+    return;
+  }
+
+  std::uint32_t current = greedy_descend(row, entry_point_, max_level_, level);
+  for (int layer = std::min(level, max_level_); layer >= 0; --layer) {
+    auto candidates = search_layer(row, current, options_.ef_construction, layer);
+    current = candidates.front().node;
+    connect(node, select_neighbors(std::move(candidates), options_.m), layer);
+  }
+  if (level > max_level_) {
+    entry_point_ = node;
+    max_level_ = level;
+  }
+}
+
+void HnswIndex::add(std::uint64_t id, const std::vector<float>& values) {
+  if (values.size() != dimensions()) {
+    throw OpenAIError("Vector has " + std::to_string(values.size()) + " dimensions; index expects " +
+                      std::to_string(dimensions()));
+  }
+  add(id, values.data());
+}
+
+void HnswIndex::add(const EmbeddingMatrix& matrix, std::uint64_t first_id) {
+  if (matrix.dimensions() != dimensions()) {
+    throw OpenAIError("EmbeddingMatrix has " + std::to_string(matrix.dimensions()) + " dimensions; index expects " +
+                      std::to_string(dimensions()));
+  }
+  reserve(node_count() + matrix.rows());
+  for (std::size_t row = 0; row < matrix.rows(); ++row) {
+    add(first_id + row, matrix.row(row).data());
+  }
+}
+
+bool HnswIndex::remove(std::uint64_t id) {
+  auto it = live_.find(id);
+  if (it == live_.end()) {
+    return false;
+  }
+  deleted_[it->second] = 1;
+  live_.erase(it);
+  return true;
+}
+
+std::uint32_t HnswIndex::greedy_descend(const float* query, std::uint32_t entry, int from_level, int to_level) const {
+  std::uint32_t current = entry;
+  float current_distance = distance(query, current);
+  for (int level = from_level; level > to_level; --level) {
+    bool improved = true;
+    while (improved) {
+      improved = false;
+      const std::uint32_t* list = links(current, level);
+      for (std::uint32_t i = 1; i <= list[0]; ++i) {
+        const float candidate = distance(query, list[i]);
+        if (candidate < current_distance) {
+          current_distance = candidate;
+          current = list[i];
+          improved = true;
+        }
+      }
+    }
+  }
+  return current;
+}
+
+std::vector<HnswIndex::Candidate> HnswIndex::search_layer(const float* query,
+                                                          std::uint32_t entry,
+                                                          std::size_t ef,
+                                                          int level) const {
+  auto visited = acquire_visited();
+  const std::uint32_t epoch = visited->epoch;
+  auto& marks = visited->marks;
+
+  std::priority_queue<Candidate, std::vector<Candidate>, ByDistanceDescending> frontier;
+  std::priority_queue<Candidate, std::vector<Candidate>, ByDistance> nearest;
+  const Candidate start{distance(query, entry), entry};
+  frontier.push(start);
+  nearest.push(start);
+  marks[entry] = epoch;
+
+  while (!frontier.empty()) {
+    const Candidate closest = frontier.top();
+    if (closest.distance > nearest.top().distance && nearest.size() >= ef) {
+      break;
+    }
+    frontier.pop();
+    const std::uint32_t* list = links(closest.node, level);
+    for (std::uint32_t i = 1; i <= list[0]; ++i) {
+      const std::uint32_t neighbor = list[i];
+      if (marks[neighbor] == epoch) {
+        continue;
+      }
+      marks[neighbor] = epoch;
+      const float neighbor_distance = distance(query, neighbor);
+      if (nearest.size() < ef || neighbor_distance < nearest.top().distance) {
+        frontier.push({neighbor_distance, neighbor});
+        nearest.push({neighbor_distance, neighbor});
+        if (nearest.size() > ef) {
+          nearest.pop();
+        }
+      }
+    }
+  }
+  release_visited(std::move(visited));
+
+  std::vector<Candidate> result(nearest.size());
+  for (std::size_t i = result.size(); i > 0; --i) {
+    result[i - 1] = nearest.top();
+    nearest.pop();
+  }
+  return result;
+}
+
+std::vector<std::uint32_t> HnswIndex::select_neighbors(std::vector<Candidate> candidates, std::size_t limit) const {
+  // Keep a candidate only if it is closer to the base point than to every neighbour already kept; this
+  // spreads links across directions instead of clustering them.
+  std::sort(candidates.begin(), candidates.end(), ByDistance{});
+  std::vector<std::uint32_t> selected;
+  selected.reserve(limit);
+  for (const auto& candidate : candidates) {
+    if (selected.size() >= limit) {
+      break;
+    }
+    const float* values = vectors_.row(candidate.node);
+    bool diverse = true;
+    for (const auto kept : selected) {
+      if (distance(values, kept) < candidate.distance) {
+        diverse = false;
+        break;
+      }
+    }
+    if (diverse) {
+      selected.push_back(candidate.node);
+    }
+  }
+  return selected;
+}
+
+void HnswIndex::connect(std::uint32_t node, const std::vector<std::uint32_t>& neighbors, int level) {
+  std::uint32_t* own = links(node, level);
+  own[0] = static_cast<std::uint32_t>(neighbors.size());
+  std::copy(neighbors.begin(), neighbors.end(), own + 1);
+
+  const std::size_t limit = max_links(level);
+  for (const auto neighbor : neighbors) {
+    std::uint32_t* list = links(neighbor, level);
+    if (list[0] < limit) {
+      list[1 + list[0]] = node;
+      ++list[0];
+      continue;
+    }
+    const float* base = vectors_.row(neighbor);
+    std::vector<Candidate> candidates;
+    candidates.reserve(limit + 1);
+    candidates.push_back({distance(base, node), node});
+    for (std::uint32_t i = 1; i <= list[0]; ++i) {
+      candidates.push_back({distance(base, list[i]), list[i]});
+    }
+    const auto pruned = select_neighbors(std::move(candidates), limit);
+    list[0] = static_cast<std::uint32_t>(pruned.size());
+    std::copy(pruned.begin(), pruned.end(), list + 1);
+  }
+}
+
+std::vector<SearchResult> HnswIndex::search(const float* query, std::size_t k, std::size_t ef) const {
+  if (k == 0 || live_.empty()) {
+    return {};
+  }
+  std::vector<float> normalized;
+  if (metric_ == Metric::Cosine) {
+    normalized.assign(query, query + dimensions());
+    normalize(normalized.data(), normalized.size());
+    query = normalized.data();
+  }
+  const std::uint32_t entry = greedy_descend(query, entry_point_, max_level_, 0);
+  const auto candidates = search_layer(query, entry, std::max(ef == 0 ? options_.ef_search : ef, k), 0);
+
+  std::vector<SearchResult> results;
+  results.reserve(std::min(k, candidates.size()));
+  for (const auto& candidate : candidates) {
+    if (deleted_[candidate.node]) {
+      continue;
+    }
+    results.push_back({ids_[candidate.node], -candidate.distance});
+    if (results.size() == k) {
+      break;
+    }
+  }
+  return results;
+}
+
+std::vector<SearchResult> HnswIndex::search(const std::vector<float>& query, std::size_t k, std::size_t ef) const {
+  if (query.size() != dimensions()) {
+    throw OpenAIError("Query has " + std::to_string(query.size()) + " dimensions; index expects " +
+                      std::to_string(dimensions()));
+  }
+  return search(query.data(), k, ef);
+}
+
+std::vector<std::vector<SearchResult>> HnswIndex::search_batch(const std::vector<std::vector<float>>& queries,
+                                                               std::size_t k,
+                                                               std::size_t threads,
+                                                               std::size_t ef) const {
+  for (std::size_t q = 0; q < queries.size(); ++q) {
+    if (queries[q].size() != dimensions()) {
+      throw OpenAIError("Query " + std::to_string(q) + " has " + std::to_string(queries[q].size()) +
+                        " dimensions; index expects " + std::to_string(dimensions()));
+    }
+  }
+  std::vector<std::vector<SearchResult>> results(queries.size());
+  if (queries.empty()) {
+    return results;
+  }
+  std::size_t workers = threads == 0 ? std::thread::hardware_concurrency() : threads;
+  workers = std::max<std::size_t>(1, std::min(workers, queries.size()));
+
+  // Queries vary in cost, so workers pull the next one instead of taking fixed slices.
+  std::atomic<std::size_t> next{0};
+  auto run = [&]() {
+    for (std::size_t q = next.fetch_add(1); q < queries.size(); q = next.fetch_add(1)) {
+      results[q] = search(queries[q].data(), k, ef);
+    }
+  };
+  std::vector<std::thread> pool;
+  pool.reserve(workers - 1);
+  for (std::size_t worker = 1; worker < workers; ++worker) {
+    pool.emplace_back(run);
+  }
+  run();
+  for (auto& thread : pool) {
+    thread.join();
+  }
+  return results;
+}
+
+std::unique_ptr<HnswIndex::VisitedSet> HnswIndex::acquire_visited() const {
+  std::unique_ptr<VisitedSet> visited;
+  {
+    std::lock_guard<std::mutex> lock(visited_mutex_);
+    if (!visited_pool_.empty()) {
+      visited = std::move(visited_pool_.back());
+      visited_pool_.pop_back();
+    }
+  }
+  if (!visited) {
+    visited = std::make_unique<VisitedSet>();
+  }
+  if (visited->marks.size() < ids_.size()) {
+    visited->marks.resize(ids_.size(), 0);
+  }
+  // Bumping the epoch clears the set without touching every mark.
+  if (++visited->epoch == 0) {
+    std::fill(visited->marks.begin(), visited->marks.end(), 0);
+    visited->epoch = 1;
+  }
+  return visited;
+}
+
+void HnswIndex::release_visited(std::unique_ptr<VisitedSet> visited) const {
+  std::lock_guard<std::mutex> lock(visited_mutex_);
+  visited_pool_.push_back(std::move(visited));
+}
+
+void HnswIndex::save(const std::string& path) const {
+  std::string graph;
+  const std::uint64_t settings[4] = {options_.m, options_.ef_construction, options_.ef_search, options_.seed};
+  append_pod(graph, settings, 4);
+  const std::int64_t entry[2] = {entry_point_, max_level_};
+  append_pod(graph, entry, 2);
+  append_pod(graph, deleted_.data(), deleted_.size());
+  append_pod(graph, levels_.data(), levels_.size());
+  append_pod(graph, level0_.data(), level0_.size());
+  for (const auto& layers : upper_) {
+    append_pod(graph, layers.data(), layers.size());
+  }
+  write_index_file(path, IndexKind::Hnsw, metric_, vectors_, ids_, graph);
+}
+
+HnswIndex HnswIndex::load(const std::string& path, bool map) {
+  auto contents = read_index_file(path, IndexKind::Hnsw, map);
+  SectionReader reader(contents.extra, path);
+  std::uint64_t settings[4];
+  reader.read(settings, 4);
+  HnswOptions options;
+  options.m = static_cast<std::size_t>(settings[0]);
+  options.ef_construction = static_cast<std::size_t>(settings[1]);
+  options.ef_search = static_cast<std::size_t>(settings[2]);
+  options.seed = settings[3];
+
+  HnswIndex index(contents.vectors.dimensions(), contents.metric, options);
+  const std::size_t nodes = contents.ids.size();
+  index.vectors_ = std::move(contents.vectors);
+  index.ids_ = std::move(contents.ids);
+  std::int64_t entry[2];
+  reader.read(entry, 2);
+  if (entry[0] < 0 || entry[0] > static_cast<std::int64_t>(UINT32_MAX) || entry[1] < -1 || entry[1] > 64) {
+    throw OpenAIError("HNSW graph section is corrupt: " + path);
+  }
+  index.entry_point_ = static_cast<std::uint32_t>(entry[0]);
+  index.max_level_ = static_cast<int>(entry[1]);
+  index.deleted_.resize(nodes);
+  reader.read(index.deleted_.data(), nodes);
+  index.levels_.resize(nodes);
+  reader.read(index.levels_.data(), nodes);
+  index.level0_.resize(nodes * (1 + 2 * options.m));
+  reader.read(index.level0_.data(), index.level0_.size());
+  index.upper_.resize(nodes);
+  for (std::size_t node = 0; node < nodes; ++node) {
+    if (index.levels_[node] < 0 || index.levels_[node] > index.max_level_) {
+      throw OpenAIError("HNSW graph section is corrupt: " + path);
+    }
+    index.upper_[node].resize(static_cast<std::size_t>(index.levels_[node]) * (1 + options.m));
+    reader.read(index.upper_[node].data(), index.upper_[node].size());
+  }
+  if (!reader.done() || (nodes > 0 && index.entry_point_ >= nodes) || (nodes == 0) != (index.max_level_ < 0)) {
+    throw OpenAIError("HNSW graph section is corrupt: " + path);
+  }
+  for (std::size_t node = 0; node < nodes; ++node) {
+    for (int level = 0; level <= index.levels_[node]; ++level) {
+      const std::uint32_t* list = index.links(static_cast<std::uint32_t>(node), level);
+      if (list[0] > index.max_links(level) ||
+          std::any_of(list + 1, list + 1 + list[0], [&](std::uint32_t target) { return target >= nodes; })) {
+        throw OpenAIError("HNSW graph section is corrupt: " + path);
+      }
+    }
+    if (!index.deleted_[node]) {
+      index.live_[index.ids_[node]] = static_cast<std::uint32_t>(node);
+    }
+  }
+  // Continue the level sequence rather than replaying the one used to build the saved nodes.
+  index.rng_.seed(options.seed ^ nodes);
+  return index;
+}
+
+}  // namespace openai::index
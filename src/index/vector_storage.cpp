@@ -0,0 +1,197 @@
+#include "openai/index/vector_storage.hpp"
+
+#include "openai/error.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <utility>
+
+namespace openai::index {
+namespace {
+
+constexpr char kMagic[8] = {'O', 'A', 'I', 'I', 'N', 'D', 'E', 'X'};
+constexpr std::uint32_t kByteOrderMark = 0x01020304u;
+constexpr std::uint32_t kFormatVersion = 1;
+
+struct IndexFileHeader {
+  char magic[8];
+  std::uint32_t byte_order_mark;
+  std::uint32_t version;
+  std::uint32_t kind;
+  std::uint32_t metric;
+  std::uint64_t dimensions;
+  std::uint64_t stride;
+  std::uint64_t rows;
+  std::uint64_t extra_bytes;
+  std::uint64_t vectors_offset;
+};
+
+static_assert(sizeof(IndexFileHeader) == 64, "index file header must stay 64 bytes");
+
+std::size_t padded_stride(std::size_t dimensions) {
+  constexpr std::size_t per_line = EmbeddingMatrix::kAlignment / sizeof(float);
+  return (dimensions + per_line - 1) / per_line * per_line;
+}
+
+std::uint64_t align_up(std::uint64_t offset) {
+  return (offset + EmbeddingMatrix::kAlignment - 1) / EmbeddingMatrix::kAlignment * EmbeddingMatrix::kAlignment;
+}
+
+}  // namespace
+
+VectorStorage::VectorStorage(std::size_t dimensions)
+    : dimensions_(dimensions), stride_(padded_stride(dimensions)) {}
+
+float* VectorStorage::mutable_row(std::size_t index) {
+  if (mapping_) {
+    reallocate(size_);
+  }
+  return const_cast<float*>(row(index));
+}
+
+std::size_t VectorStorage::push_back(const float* values) {
+  if (mapping_ || size_ == owned_.rows()) {
+    reallocate(std::max<std::size_t>(16, size_ * 2));
+  }
+  float* out = const_cast<float*>(row(size_));
+  std::memcpy(out, values, dimensions_ * sizeof(float));
+  std::fill(out + dimensions_, out + stride_, 0.0f);
+  return size_++;
+}
+
+void VectorStorage::pop_back() {
+  if (size_ > 0) {
+    --size_;
+  }
+}
+
+void VectorStorage::reserve(std::size_t rows) {
+  if (mapping_ || rows > owned_.rows()) {
+    reallocate(std::max(rows, size_));
+  }
+}
+
+void VectorStorage::borrow(std::shared_ptr<const utils::MappedFile> mapping, const float* data, std::size_t rows) {
+  owned_ = EmbeddingMatrix();
+  mapping_ = std::move(mapping);
+  base_ = data;
+  size_ = rows;
+}
+
+void VectorStorage::reallocate(std::size_t capacity) {
+  EmbeddingMatrix next(capacity, dimensions_);
+  if (capacity == 0) {
+    owned_ = std::move(next);
+    mapping_.reset();
+    base_ = nullptr;
+    return;
+  }
+  float* destination = next.mutable_row(0);
+  if (size_ > 0) {
+    std::memcpy(destination, base_, size_ * stride_ * sizeof(float));
+  }
+  owned_ = std::move(next);
+  mapping_.reset();
+  base_ = destination;
+}
+
+void write_index_file(const std::string& path,
+                      IndexKind kind,
+                      Metric metric,
+                      const VectorStorage& vectors,
+                      const std::vector<std::uint64_t>& ids,
+                      std::string_view extra) {
+  if (ids.size() != vectors.size()) {
+    throw OpenAIError("Index ids and vectors are out of sync");
+  }
+  IndexFileHeader header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.byte_order_mark = kByteOrderMark;
+  header.version = kFormatVersion;
+  header.kind = static_cast<std::uint32_t>(kind);
+  header.metric = static_cast<std::uint32_t>(metric);
+  header.dimensions = vectors.dimensions();
+  header.stride = vectors.stride();
+  header.rows = vectors.size();
+  header.extra_bytes = extra.size();
+  header.vectors_offset = align_up(sizeof(header) + ids.size() * sizeof(std::uint64_t) + extra.size());
+
+  const std::string temporary = path + ".tmp";
+  {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      throw OpenAIError("Failed to open index file for writing: " + temporary);
+    }
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(ids.data()), static_cast<std::streamsize>(ids.size() * sizeof(std::uint64_t)));
+    out.write(extra.data(), static_cast<std::streamsize>(extra.size()));
+    const std::uint64_t written = sizeof(header) + ids.size() * sizeof(std::uint64_t) + extra.size();
+    const std::string padding(header.vectors_offset - written, '\0');
+    out.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+    if (vectors.size() > 0) {
+      // Rows are contiguous, padding included, so the whole block goes out in one write.
+      out.write(reinterpret_cast<const char*>(vectors.row(0)),
+                static_cast<std::streamsize>(vectors.size() * vectors.stride() * sizeof(float)));
+    }
+    out.flush();
+    if (!out) {
+      throw OpenAIError("Failed to write index file: " + temporary);
+    }
+  }
+  std::error_code error;
+  std::filesystem::rename(temporary, path, error);
+  if (error) {
+    std::filesystem::remove(temporary, error);
+    throw OpenAIError("Failed to replace index file: " + path);
+  }
+}
+
+IndexFileContents read_index_file(const std::string& path, IndexKind kind, bool map) {
+  auto file = utils::MappedFile::open(path);
+  IndexFileHeader header{};
+  if (file->size() < sizeof(header)) {
+    throw OpenAIError("Index file is truncated: " + path);
+  }
+  std::memcpy(&header, file->data(), sizeof(header));
+  if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+    throw OpenAIError("Not an openai-cpp index file: " + path);
+  }
+  if (header.byte_order_mark != kByteOrderMark) {
+    throw OpenAIError("Index file was written on a host with a different byte order: " + path);
+  }
+  if (header.version != kFormatVersion) {
+    throw OpenAIError("Unsupported index file version " + std::to_string(header.version) + ": " + path);
+  }
+  if (header.kind != static_cast<std::uint32_t>(kind)) {
+    throw OpenAIError("Index file holds a different index type: " + path);
+  }
+  if (header.metric > static_cast<std::uint32_t>(Metric::Cosine) || header.dimensions == 0 ||
+      header.stride != padded_stride(header.dimensions)) {
+    throw OpenAIError("Index file header is corrupt: " + path);
+  }
+  const std::uint64_t ids_end = sizeof(header) + header.rows * sizeof(std::uint64_t);
+  const std::uint64_t vectors_bytes = header.rows * header.stride * sizeof(float);
+  if (header.vectors_offset % EmbeddingMatrix::kAlignment != 0 || ids_end + header.extra_bytes > header.vectors_offset ||
+      header.vectors_offset + vectors_bytes > file->size()) {
+    throw OpenAIError("Index file is truncated: " + path);
+  }
+
+  IndexFileContents contents;
+  contents.metric = static_cast<Metric>(header.metric);
+  const std::size_t rows = static_cast<std::size_t>(header.rows);
+  contents.ids.resize(rows);
+  std::memcpy(contents.ids.data(), file->data() + sizeof(header), rows * sizeof(std::uint64_t));
+  contents.extra.assign(reinterpret_cast<const char*>(file->data() + ids_end), static_cast<std::size_t>(header.extra_bytes));
+
+  contents.vectors = VectorStorage(static_cast<std::size_t>(header.dimensions));
+  const auto* rows_data = reinterpret_cast<const float*>(file->data() + header.vectors_offset);
+  contents.vectors.borrow(file, rows_data, rows);
+  if (!map) {
+    contents.vectors.reserve(rows);
+  }
+  return contents;
+}
+
+}  // namespace openai::index
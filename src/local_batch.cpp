@@ -0,0 +1,256 @@
+#include "openai/local_batch.hpp"
+
+#include "openai/batch_results.hpp"
+#include "openai/client.hpp"
+#include "openai/error.hpp"
+#include "openai/utils/mapped_file.hpp"
+#include "openai/utils/uuid.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+namespace openai {
+namespace {
+
+using ordered_json = nlohmann::ordered_json;
+
+// The endpoints the Batch API accepts.
+constexpr const char* kBatchUrls[] = {"/v1/chat/completions", "/v1/embeddings", "/v1/responses", "/v1/completions",
+                                      "/v1/moderations"};
+
+struct LineRange {
+  std::size_t offset = 0;
+  std::size_t length = 0;
+};
+
+std::optional<std::string> find_header(const std::map<std::string, std::string>& headers, std::string_view name) {
+  for (const auto& [key, value] : headers) {
+    if (key.size() == name.size() &&
+        std::equal(key.begin(), key.end(), name.begin(), [](char a, char b) {
+          return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+        })) {
+      return value;
+    }
+  }
+  return std::nullopt;
+}
+
+std::string batch_request_id() {
+  std::string id = utils::uuid4();
+  id.erase(std::remove(id.begin(), id.end(), '-'), id.end());
+  return "batch_req_" + id;
+}
+
+ordered_json result_line(const std::string& custom_id) {
+  ordered_json line = ordered_json::object();
+  line["id"] = batch_request_id();
+  line["custom_id"] = custom_id;
+  line["response"] = nullptr;
+  line["error"] = nullptr;
+  return line;
+}
+
+ordered_json response_object(long status_code,
+                             const std::map<std::string, std::string>& headers,
+                             ordered_json body) {
+  ordered_json response = ordered_json::object();
+  response["status_code"] = status_code;
+  response["request_id"] = find_header(headers, "x-request-id").value_or("");
+  response["body"] = std::move(body);
+  return response;
+}
+
+ordered_json error_object(const std::string& code, const std::string& message) {
+  ordered_json error = ordered_json::object();
+  error["code"] = code;
+  error["message"] = message;
+  return error;
+}
+
+// Batch lines name the API path, e.g. "/v1/chat/completions", while client paths are relative to the
+// base URL, which carries the version itself: "https://api.openai.com/v1", an Azure endpoint or a proxy.
+std::string client_path(const std::string& url) {
+  constexpr std::string_view kVersionPrefix = "/v1/";
+  if (url.compare(0, kVersionPrefix.size(), kVersionPrefix) == 0) {
+    return url.substr(kVersionPrefix.size() - 1);
+  }
+  return url;
+}
+
+// Drops a torn final line left by an interrupted run and collects the custom_ids already written.
+void recover_results(const std::string& path, std::unordered_set<std::string>& done) {
+  std::error_code error;
+  if (!std::filesystem::exists(path, error)) {
+    return;
+  }
+  std::size_t complete = 0;
+  std::size_t size = 0;
+  {
+    auto mapping = utils::MappedFile::open(path);
+    size = mapping->size();
+    const char* data = reinterpret_cast<const char*>(mapping->data());
+    complete = size;
+    while (complete > 0 && data[complete - 1] != '\n') {
+      --complete;
+    }
+    BatchResultReader reader([&](const BatchResult& result) { done.insert(result.custom_id); });
+    reader.feed(data, complete);
+    reader.finish();
+  }
+  if (complete < size) {
+    std::filesystem::resize_file(path, complete, error);
+    if (error) {
+      throw OpenAIError("Failed to truncate batch result file: " + path);
+    }
+  }
+}
+
+}  // namespace
+
+LocalBatchExecutor::LocalBatchExecutor(OpenAIClient& client, LocalBatchOptions options)
+    : client_(client), options_(std::move(options)) {}
+
+LocalBatchSummary LocalBatchExecutor::run(const std::string& input_path,
+                                          const std::string& output_path,
+                                          const std::string& error_path) const {
+  auto input = utils::MappedFile::open(input_path);
+  const char* data = reinterpret_cast<const char*>(input->data());
+  std::vector<LineRange> lines;
+  for (std::size_t offset = 0; offset < input->size();) {
+    const void* found = std::memchr(data + offset, '\n', input->size() - offset);
+    const std::size_t end = found ? static_cast<std::size_t>(static_cast<const char*>(found) - data) : input->size();
+    if (std::string_view(data + offset, end - offset).find_first_not_of(" \t\r") != std::string_view::npos) {
+      lines.push_back(LineRange{offset, end - offset});
+    }
+    offset = end + 1;
+  }
+
+  std::unordered_set<std::string> done;
+  if (options_.resume) {
+    recover_results(output_path, done);
+    recover_results(error_path, done);
+  }
+  const auto mode = std::ios::binary | (options_.resume ? std::ios::app : std::ios::trunc);
+  std::ofstream output(output_path, mode);
+  std::ofstream errors(error_path, mode);
+  if (!output || !errors) {
+    throw OpenAIError("Failed to open batch result files: " + output_path + ", " + error_path);
+  }
+
+  LocalBatchSummary summary;
+  summary.total = lines.size();
+  std::mutex mutex;
+  std::atomic<std::size_t> next{0};
+  std::atomic<bool> failed{false};
+  std::exception_ptr first_error;
+  std::size_t completed = 0;
+
+  auto write = [&](const ordered_json& line, bool ok) {
+    const std::string text = line.dump() + "\n";
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& out = ok ? output : errors;
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+    out.flush();
+    if (!out) {
+      throw OpenAIError("Failed to write batch result file: " + (ok ? output_path : error_path));
+    }
+    ++(ok ? summary.succeeded : summary.failed);
+    ++completed;
+    if (options_.on_progress) {
+      options_.on_progress(completed + summary.skipped, summary.total);
+    }
+  };
+
+  auto run_line = [&](const LineRange& range) {
+    const std::string_view text(data + range.offset, range.length);
+    ordered_json request;
+    try {
+      request = ordered_json::parse(text.begin(), text.end());
+    } catch (const nlohmann::json::exception& ex) {
+      throw OpenAIError(std::string("Failed to parse batch input line: ") + ex.what());
+    }
+    const std::string custom_id = request.value("custom_id", "");
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (done.count(custom_id) != 0) {
+        ++summary.skipped;
+        return;
+      }
+    }
+
+    auto line = result_line(custom_id);
+    const std::string url = request.value("url", "");
+    const std::string method = request.value("method", "");
+    if (method != "POST" || std::find(std::begin(kBatchUrls), std::end(kBatchUrls), url) == std::end(kBatchUrls)) {
+      line["error"] = error_object("invalid_request", "Unsupported batch request: " + method + " " + url);
+      write(line, false);
+      return;
+    }
+
+    try {
+      const auto body = request.contains("body") ? request.at("body").dump() : std::string("{}");
+      const auto response = client_.perform_request("POST", client_path(url), body, RequestOptions{});
+      auto parsed = ordered_json::parse(response.body, nullptr, false);
+      line["response"] = response_object(response.status_code, response.headers,
+                                         parsed.is_discarded() ? ordered_json(response.body) : std::move(parsed));
+      write(line, true);
+    } catch (const APIError& error) {
+      ordered_json body = ordered_json::object();
+      body["error"] = ordered_json::parse(error.error_body().dump());
+      line["response"] = response_object(error.status_code(), error.headers(), std::move(body));
+      write(line, false);
+    } catch (const APIConnectionError& error) {
+      line["error"] = error_object("connection_error", error.what());
+      write(line, false);
+    }
+  };
+
+  auto worker = [&]() {
+    while (!failed.load()) {
+      const std::size_t index = next.fetch_add(1);
+      if (index >= lines.size()) {
+        return;
+      }
+      try {
+        run_line(lines[index]);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!first_error) {
+          first_error = std::current_exception();
+        }
+        failed.store(true);
+      }
+    }
+  };
+
+  const std::size_t concurrency =
+      std::min(std::max<std::size_t>(options_.max_concurrency, 1), std::max<std::size_t>(lines.size(), 1));
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < concurrency; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (first_error) {
+    std::rethrow_exception(first_error);
+  }
+  return summary;
+}
+
+}  // namespace openai
@@ -0,0 +1,405 @@
+#include "openai/partial_json.hpp"
+
+#include "openai/error.hpp"
+#include "openai/responses.hpp"
+#include "openai/run_steps.hpp"
+
+#include <utility>
+
+namespace openai {
+namespace {
+
+using json = nlohmann::json;
+
+bool is_json_whitespace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool is_number_char(char c) {
+  return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+}
+
+int hex_value(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+void append_utf8(std::string& out, std::uint32_t code_point) {
+  if (code_point < 0x80) {
+    out += static_cast<char>(code_point);
+  } else if (code_point < 0x800) {
+    out += static_cast<char>(0xC0 | (code_point >> 6));
+    out += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else if (code_point < 0x10000) {
+    out += static_cast<char>(0xE0 | (code_point >> 12));
+    out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else {
+    out += static_cast<char>(0xF0 | (code_point >> 18));
+    out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+    out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (code_point & 0x3F));
+  }
+}
+
+constexpr std::uint32_t kReplacementCharacter = 0xFFFD;
+
+}  // namespace
+
+PartialJsonParser::PartialJsonParser() = default;
+
+void PartialJsonParser::feed(std::string_view fragment) {
+  std::size_t i = 0;
+  while (i < fragment.size()) {
+    // Plain string content is the bulk of most arguments; copy it in runs rather than per character.
+    if (state_ == State::String && escape_ == 0 && high_surrogate_ == 0) {
+      std::size_t end = i;
+      while (end < fragment.size()) {
+        const char c = fragment[end];
+        if (c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20) {
+          break;
+        }
+        ++end;
+      }
+      if (end > i) {
+        string_out_->append(fragment.data() + i, end - i);
+        consumed_ += end - i;
+        i = end;
+        continue;
+      }
+    }
+    step(fragment[i]);
+    ++consumed_;
+    ++i;
+  }
+}
+
+const nlohmann::json& PartialJsonParser::finish() {
+  if (state_ == State::Token && stack_.empty()) {
+    finish_token();
+  }
+  if (state_ != State::Done) {
+    fail("incomplete JSON document");
+  }
+  return root_;
+}
+
+void PartialJsonParser::reset() {
+  root_ = json();
+  stack_.clear();
+  state_ = State::Value;
+  started_ = false;
+  consumed_ = 0;
+  string_is_key_ = false;
+  key_.clear();
+  pending_key_.clear();
+  string_out_ = nullptr;
+  escape_ = 0;
+  unicode_ = 0;
+  high_surrogate_ = 0;
+  token_.clear();
+}
+
+void PartialJsonParser::step(char c) {
+  switch (state_) {
+    case State::Value:
+      if (!is_json_whitespace(c)) {
+        begin_value(c);
+      }
+      return;
+    case State::ArrayValueOrEnd:
+      if (is_json_whitespace(c)) {
+        return;
+      }
+      if (c == ']') {
+        stack_.pop_back();
+        end_value();
+        return;
+      }
+      begin_value(c);
+      return;
+    case State::ObjectKeyOrEnd:
+      if (is_json_whitespace(c)) {
+        return;
+      }
+      if (c == '}') {
+        stack_.pop_back();
+        end_value();
+        return;
+      }
+      [[fallthrough]];
+    case State::ObjectKey:
+      if (is_json_whitespace(c)) {
+        return;
+      }
+      if (c != '"') {
+        fail("expected an object key");
+      }
+      key_.clear();
+      string_is_key_ = true;
+      string_out_ = &key_;
+      state_ = State::String;
+      return;
+    case State::Colon:
+      if (is_json_whitespace(c)) {
+        return;
+      }
+      if (c != ':') {
+        fail("expected ':' after object key");
+      }
+      state_ = State::Value;
+      return;
+    case State::CommaOrEnd: {
+      if (is_json_whitespace(c)) {
+        return;
+      }
+      const bool in_object = stack_.back()->is_object();
+      if (c == ',') {
+        state_ = in_object ? State::ObjectKey : State::Value;
+      } else if ((c == '}' && in_object) || (c == ']' && !in_object)) {
+        stack_.pop_back();
+        end_value();
+      } else {
+        fail(in_object ? "expected ',' or '}'" : "expected ',' or ']'");
+      }
+      return;
+    }
+    case State::String:
+      string_char(c);
+      return;
+    case State::Token: {
+      const bool literal = token_[0] >= 'a' && token_[0] <= 'z';
+      if (literal ? (c >= 'a' && c <= 'z') : is_number_char(c)) {
+        token_ += c;
+        if (literal && std::string_view("true").substr(0, token_.size()) != token_ &&
+            std::string_view("false").substr(0, token_.size()) != token_ &&
+            std::string_view("null").substr(0, token_.size()) != token_) {
+          fail("invalid literal '" + token_ + "'");
+        }
+        return;
+      }
+      finish_token();
+      step(c);
+      return;
+    }
+    case State::Done:
+      if (!is_json_whitespace(c)) {
+        fail("unexpected data after the JSON document");
+      }
+      return;
+  }
+}
+
+void PartialJsonParser::begin_value(char c) {
+  started_ = true;
+  if (c == '{') {
+    stack_.push_back(place(json::object()));
+    state_ = State::ObjectKeyOrEnd;
+  } else if (c == '[') {
+    stack_.push_back(place(json::array()));
+    state_ = State::ArrayValueOrEnd;
+  } else if (c == '"') {
+    string_is_key_ = false;
+    string_out_ = &place(std::string())->get_ref<std::string&>();
+    state_ = State::String;
+  } else if (c == '-' || (c >= '0' && c <= '9') || c == 't' || c == 'f' || c == 'n') {
+    token_.assign(1, c);
+    state_ = State::Token;
+  } else {
+    fail(std::string("unexpected character '") + c + "'");
+  }
+}
+
+void PartialJsonParser::end_value() {
+  state_ = stack_.empty() ? State::Done : State::CommaOrEnd;
+}
+
+void PartialJsonParser::string_char(char c) {
+  if (escape_ == 1) {
+    escape_ = 0;
+    if (c == 'u') {
+      escape_ = 2;
+      unicode_ = 0;
+      return;
+    }
+    flush_surrogate();
+    switch (c) {
+      case '"': *string_out_ += '"'; return;
+      case '\\': *string_out_ += '\\'; return;
+      case '/': *string_out_ += '/'; return;
+      case 'b': *string_out_ += '\b'; return;
+      case 'f': *string_out_ += '\f'; return;
+      case 'n': *string_out_ += '\n'; return;
+      case 'r': *string_out_ += '\r'; return;
+      case 't': *string_out_ += '\t'; return;
+      default: fail(std::string("invalid escape '\\") + c + "'");
+    }
+  }
+  if (escape_ >= 2) {
+    const int digit = hex_value(c);
+    if (digit < 0) {
+      fail("invalid \\u escape");
+    }
+    unicode_ = (unicode_ << 4) | static_cast<std::uint32_t>(digit);
+    if (++escape_ == 6) {
+      escape_ = 0;
+      append_code_point(unicode_);
+    }
+    return;
+  }
+  if (c == '\\') {
+    escape_ = 1;
+    return;
+  }
+  flush_surrogate();
+  if (c == '"') {
+    string_out_ = nullptr;
+    if (string_is_key_) {
+      pending_key_ = std::move(key_);
+      key_.clear();
+      state_ = State::Colon;
+    } else {
+      end_value();
+    }
+    return;
+  }
+  if (static_cast<unsigned char>(c) < 0x20) {
+    fail("unescaped control character in string");
+  }
+  *string_out_ += c;
+}
+
+void PartialJsonParser::append_code_point(std::uint32_t code_point) {
+  if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+    flush_surrogate();
+    high_surrogate_ = code_point;
+    return;
+  }
+  if (code_point >= 0xDC00 && code_point <= 0xDFFF) {
+    if (high_surrogate_ == 0) {
+      append_utf8(*string_out_, kReplacementCharacter);
+      return;
+    }
+    code_point = 0x10000 + ((high_surrogate_ - 0xD800) << 10) + (code_point - 0xDC00);
+    high_surrogate_ = 0;
+  }
+  flush_surrogate();
+  append_utf8(*string_out_, code_point);
+}
+
+void PartialJsonParser::flush_surrogate() {
+  if (high_surrogate_ != 0) {
+    high_surrogate_ = 0;
+    append_utf8(*string_out_, kReplacementCharacter);
+  }
+}
+
+void PartialJsonParser::finish_token() {
+  json value;
+  if (token_ == "true") {
+    value = true;
+  } else if (token_ == "false") {
+    value = false;
+  } else if (token_ == "null") {
+    value = nullptr;
+  } else {
+    value = json::parse(token_, nullptr, false);
+    if (!value.is_number()) {
+      fail("invalid number '" + token_ + "'");
+    }
+  }
+  token_.clear();
+  place(std::move(value));
+  end_value();
+}
+
+nlohmann::json* PartialJsonParser::place(nlohmann::json value) {
+  if (stack_.empty()) {
+    root_ = std::move(value);
+    return &root_;
+  }
+  // Only the innermost open container is ever mutated, so pointers held for the outer levels of
+  // stack_ stay valid even when this push reallocates an array.
+  json& container = *stack_.back();
+  if (container.is_object()) {
+    json& slot = container[pending_key_];
+    slot = std::move(value);
+    return &slot;
+  }
+  container.push_back(std::move(value));
+  return &container.back();
+}
+
+void PartialJsonParser::fail(const std::string& message) const {
+  throw OpenAIError("Invalid JSON at byte " + std::to_string(consumed_) + ": " + message);
+}
+
+const nlohmann::json& PartialJsonTracker::feed(const std::string& key, std::string_view fragment) {
+  auto& parser = parsers_.try_emplace(key).first->second;
+  parser.feed(fragment);
+  return parser.value();
+}
+
+void PartialJsonTracker::feed(const ResponseStreamEvent& event) {
+  if (event.function_arguments_delta) {
+    feed(event.function_arguments_delta->item_id, event.function_arguments_delta->delta);
+  }
+}
+
+void PartialJsonTracker::feed(const RunStepDeltaEvent& event) {
+  const auto& details = event.delta.step_details ? event.delta.step_details : event.delta.details;
+  if (!details) {
+    return;
+  }
+  for (const auto& tool_call : details->tool_calls) {
+    if (tool_call.function && !tool_call.function->arguments.empty()) {
+      feed(event.id + ":" + std::to_string(tool_call.index), tool_call.function->arguments);
+    }
+  }
+}
+
+void PartialJsonTracker::feed_chat_chunk(const nlohmann::json& chunk) {
+  if (!chunk.contains("choices") || !chunk.at("choices").is_array()) {
+    return;
+  }
+  for (const auto& choice : chunk.at("choices")) {
+    if (!choice.contains("delta") || !choice.at("delta").contains("tool_calls") ||
+        !choice.at("delta").at("tool_calls").is_array()) {
+      continue;
+    }
+    const int choice_index = choice.value("index", 0);
+    for (const auto& tool_call : choice.at("delta").at("tool_calls")) {
+      if (!tool_call.contains("function") || !tool_call.at("function").contains("arguments") ||
+          !tool_call.at("function").at("arguments").is_string()) {
+        continue;
+      }
+      const auto& arguments = tool_call.at("function").at("arguments").get_ref<const std::string&>();
+      if (!arguments.empty()) {
+        feed(std::to_string(choice_index) + ":" + std::to_string(tool_call.value("index", 0)), arguments);
+      }
+    }
+  }
+}
+
+const PartialJsonParser* PartialJsonTracker::find(const std::string& key) const {
+  auto it = parsers_.find(key);
+  return it == parsers_.end() ? nullptr : &it->second;
+}
+
+std::vector<std::string> PartialJsonTracker::keys() const {
+  std::vector<std::string> result;
+  result.reserve(parsers_.size());
+  for (const auto& [key, parser] : parsers_) {
+    (void)parser;
+    result.push_back(key);
+  }
+  return result;
+}
+
+void PartialJsonTracker::erase(const std::string& key) {
+  parsers_.erase(key);
+}
+
+}  // namespace openai
@@ -0,0 +1,309 @@
+#include "openai/poll_scheduler.hpp"
+
+#include "openai/client.hpp"
+#include "openai/error.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <random>
+#include <utility>
+
+namespace openai {
+namespace {
+
+using json = nlohmann::json;
+
+constexpr const char* kBetaHeaderName = "OpenAI-Beta";
+constexpr const char* kBetaHeaderValue = "assistants=v2";
+
+bool is_terminal_run_status(const std::string& status) {
+  return status == "completed" || status == "requires_action" || status == "failed" || status == "cancelled" ||
+         status == "incomplete" || status == "expired";
+}
+
+bool is_terminal_batch_status(const std::string& status) {
+  return status == "completed" || status == "failed" || status == "expired" || status == "cancelled";
+}
+
+bool is_terminal_job_status(const std::string& status) {
+  return status == "succeeded" || status == "failed" || status == "cancelled";
+}
+
+bool is_terminal_video_status(const std::string& status) {
+  return status == "completed" || status == "failed";
+}
+
+bool is_terminal_response_status(const std::optional<std::string>& status) {
+  return status && (*status == "completed" || *status == "failed" || *status == "cancelled" || *status == "incomplete");
+}
+
+double jitter_factor(double jitter) {
+  thread_local std::mt19937 rng(std::random_device{}());
+  jitter = std::clamp(jitter, 0.0, 1.0);
+  std::uniform_real_distribution<double> dist(1.0 - jitter, 1.0 + jitter);
+  return dist(rng);
+}
+
+}  // namespace
+
+PollScheduler::PollScheduler(OpenAIClient& client, PollSchedulerOptions options)
+    : client_(client), options_(std::move(options)) {
+  const std::size_t workers = std::max<std::size_t>(options_.workers, 1);
+  workers_.reserve(workers);
+  for (std::size_t i = 0; i < workers; ++i) {
+    workers_.emplace_back([this]() { work(); });
+  }
+}
+
+PollScheduler::~PollScheduler() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+  const auto stopped = std::make_exception_ptr(OpenAIError("PollScheduler stopped before the poll finished"));
+  while (!heap_.empty()) {
+    heap_.top().task->fail(stopped);
+    heap_.pop();
+  }
+}
+
+std::future<Run> PollScheduler::run(const std::string& thread_id, const std::string& run_id) {
+  auto promise = std::make_shared<std::promise<Run>>();
+  auto future = promise->get_future();
+  run(thread_id, run_id, fulfil(std::move(promise)));
+  return future;
+}
+
+void PollScheduler::run(const std::string& thread_id, const std::string& run_id, PollCallback<Run> on_done) {
+  schedule<Run>(
+      "/threads/" + thread_id + "/runs/" + run_id,
+      true,
+      [](const json& payload) { return parse_run_json(payload); },
+      [](const Run& run) { return is_terminal_run_status(run.status); },
+      std::move(on_done));
+}
+
+std::future<Batch> PollScheduler::batch(const std::string& batch_id) {
+  auto promise = std::make_shared<std::promise<Batch>>();
+  auto future = promise->get_future();
+  batch(batch_id, fulfil(std::move(promise)));
+  return future;
+}
+
+void PollScheduler::batch(const std::string& batch_id, PollCallback<Batch> on_done) {
+  schedule<Batch>(
+      "/batches/" + batch_id,
+      false,
+      [](const json& payload) { return parse_batch_json(payload); },
+      [](const Batch& batch) { return is_terminal_batch_status(batch.status); },
+      std::move(on_done));
+}
+
+std::future<VectorStoreFile> PollScheduler::vector_store_file(const std::string& vector_store_id,
+                                                              const std::string& file_id) {
+  auto promise = std::make_shared<std::promise<VectorStoreFile>>();
+  auto future = promise->get_future();
+  vector_store_file(vector_store_id, file_id, fulfil(std::move(promise)));
+  return future;
+}
+
+void PollScheduler::vector_store_file(const std::string& vector_store_id,
+                                      const std::string& file_id,
+                                      PollCallback<VectorStoreFile> on_done) {
+  schedule<VectorStoreFile>(
+      "/vector_stores/" + vector_store_id + "/files/" + file_id,
+      true,
+      [](const json& payload) { return parse_vector_store_file_json(payload); },
+      [](const VectorStoreFile& file) { return file.status != "in_progress"; },
+      std::move(on_done));
+}
+
+std::future<VectorStoreFileBatch> PollScheduler::vector_store_file_batch(const std::string& vector_store_id,
+                                                                         const std::string& batch_id) {
+  auto promise = std::make_shared<std::promise<VectorStoreFileBatch>>();
+  auto future = promise->get_future();
+  vector_store_file_batch(vector_store_id, batch_id, fulfil(std::move(promise)));
+  return future;
+}
+
+void PollScheduler::vector_store_file_batch(const std::string& vector_store_id,
+                                            const std::string& batch_id,
+                                            PollCallback<VectorStoreFileBatch> on_done) {
+  schedule<VectorStoreFileBatch>(
+      "/vector_stores/" + vector_store_id + "/file_batches/" + batch_id,
+      true,
+      [](const json& payload) { return parse_vector_store_file_batch_json(payload); },
+      [](const VectorStoreFileBatch& batch) { return batch.status != "in_progress"; },
+      std::move(on_done));
+}
+
+std::future<FineTuningJob> PollScheduler::fine_tuning_job(const std::string& job_id) {
+  auto promise = std::make_shared<std::promise<FineTuningJob>>();
+  auto future = promise->get_future();
+  fine_tuning_job(job_id, fulfil(std::move(promise)));
+  return future;
+}
+
+void PollScheduler::fine_tuning_job(const std::string& job_id, PollCallback<FineTuningJob> on_done) {
+  schedule<FineTuningJob>(
+      "/fine_tuning/jobs/" + job_id,
+      false,
+      [](const json& payload) { return parse_fine_tuning_job_json(payload); },
+      [](const FineTuningJob& job) { return is_terminal_job_status(job.status); },
+      std::move(on_done));
+}
+
+std::future<Video> PollScheduler::video(const std::string& video_id) {
+  auto promise = std::make_shared<std::promise<Video>>();
+  auto future = promise->get_future();
+  video(video_id, fulfil(std::move(promise)));
+  return future;
+}
+
+void PollScheduler::video(const std::string& video_id, PollCallback<Video> on_done) {
+  schedule<Video>(
+      "/videos/" + video_id,
+      false,
+      [](const json& payload) { return parse_video_json(payload); },
+      [](const Video& video) { return is_terminal_video_status(video.status); },
+      std::move(on_done));
+}
+
+std::future<Response> PollScheduler::response(const std::string& response_id) {
+  auto promise = std::make_shared<std::promise<Response>>();
+  auto future = promise->get_future();
+  response(response_id, fulfil(std::move(promise)));
+  return future;
+}
+
+void PollScheduler::response(const std::string& response_id, PollCallback<Response> on_done) {
+  schedule<Response>(
+      "/responses/" + response_id,
+      false,
+      [](const json& payload) { return parse_response_json(payload); },
+      [](const Response& response) { return is_terminal_response_status(response.status); },
+      std::move(on_done));
+}
+
+std::size_t PollScheduler::pending() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return heap_.size();
+}
+
+template <typename T>
+void PollScheduler::schedule(std::string path,
+                             bool assistants_beta,
+                             std::function<T(const json&)> parse,
+                             std::function<bool(const T&)> done,
+                             PollCallback<T> on_done) {
+  auto task = std::make_shared<Task>();
+  task->path = std::move(path);
+  task->assistants_beta = assistants_beta;
+  task->interval = options_.initial_interval;
+  auto callback = std::make_shared<PollCallback<T>>(std::move(on_done));
+  task->finish = [parse = std::move(parse), done = std::move(done), callback](const HttpResponse& response) {
+    T value;
+    try {
+      value = parse(json::parse(response.body));
+    } catch (const json::exception& ex) {
+      throw OpenAIError(std::string("Failed to parse polled object: ") + ex.what());
+    }
+    if (!done(value)) {
+      return false;
+    }
+    try {
+      (*callback)(std::move(value), nullptr);
+    } catch (...) {
+      // A throwing callback must not take a worker down or be reported as a failed poll.
+    }
+    return true;
+  };
+  task->fail = [callback](std::exception_ptr error) {
+    try {
+      (*callback)(T{}, error);
+    } catch (...) {
+    }
+  };
+  push(std::move(task), options_.first_poll_delay);
+}
+
+template <typename T>
+PollCallback<T> PollScheduler::fulfil(std::shared_ptr<std::promise<T>> promise) {
+  return [promise = std::move(promise)](T result, std::exception_ptr error) {
+    if (error) {
+      promise->set_exception(error);
+    } else {
+      promise->set_value(std::move(result));
+    }
+  };
+}
+
+void PollScheduler::push(std::shared_ptr<Task> task, std::chrono::milliseconds delay) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    heap_.push(Entry{std::chrono::steady_clock::now() + delay, sequence_++, std::move(task)});
+  }
+  wake_.notify_one();
+}
+
+void PollScheduler::work() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (!stopping_) {
+    if (heap_.empty()) {
+      wake_.wait(lock);
+      continue;
+    }
+    const auto due = heap_.top().due;
+    if (due > std::chrono::steady_clock::now()) {
+      wake_.wait_until(lock, due);
+      continue;
+    }
+    auto task = heap_.top().task;
+    heap_.pop();
+    lock.unlock();
+    try {
+      RequestOptions options;
+      if (task->assistants_beta) {
+        options.headers[kBetaHeaderName] = kBetaHeaderValue;
+      }
+      const auto response = client_.perform_request("GET", task->path, "", options);
+      if (!task->finish(response)) {
+        push(task, next_delay(*task, response));
+      }
+    } catch (...) {
+      const auto error = std::current_exception();
+      if (is_transient_error(error)) {
+        // The client's own retries ran out; the object is still worth polling on the backoff schedule.
+        push(task, backoff(*task));
+      } else {
+        task->fail(error);
+      }
+    }
+    lock.lock();
+  }
+}
+
+std::chrono::milliseconds PollScheduler::next_delay(Task& task, const HttpResponse& response) {
+  auto header = response.headers.find("openai-poll-after-ms");
+  if (header != response.headers.end()) {
+    try {
+      return std::chrono::milliseconds(std::stoll(header->second));
+    } catch (const std::exception&) {
+      // Malformed; fall back to the backoff schedule.
+    }
+  }
+  return backoff(task);
+}
+
+std::chrono::milliseconds PollScheduler::backoff(Task& task) {
+  const auto interval = static_cast<double>(task.interval.count());
+  const auto grown = static_cast<std::int64_t>(interval * std::max(options_.backoff_multiplier, 1.0));
+  task.interval = std::min(std::chrono::milliseconds(grown), options_.max_interval);
+  return std::chrono::milliseconds(static_cast<std::int64_t>(interval * jitter_factor(options_.jitter)));
+}
+
+}  // namespace openai
@@ -4,11 +4,15 @@
 #include "openai/error.hpp"
 #include "openai/pagination.hpp"
 #include "openai/streaming.hpp"
+#include "openai/utils/time.hpp"
 
 #include <nlohmann/json.hpp>
 
+#include <exception>
+#include <limits>
 #include <memory>
 #include <sstream>
+#include <string_view>
 #include <utility>
 
 namespace openai {
@@ -1689,7 +1693,289 @@ ResponseStreamEvent parse_stream_event_payload(const json& payload, const std::o
   return event;
 }
 
-std::optional<ResponseStreamEvent> parse_response_stream_event_internal(const ServerSentEvent& event) {
+constexpr std::string_view kOutputTextDeltaType = "response.output_text.delta";
+
+void skip_json_whitespace(std::string_view input, std::size_t& pos) {
+  while (pos < input.size() &&
+         (input[pos] == ' ' || input[pos] == '\t' || input[pos] == '\n' || input[pos] == '\r')) {
+    ++pos;
+  }
+}
+
+bool parse_hex4(std::string_view input, std::size_t pos, unsigned& value) {
+  if (pos + 4 > input.size()) {
+    return false;
+  }
+  value = 0;
+  for (std::size_t i = pos; i < pos + 4; ++i) {
+    const char ch = input[i];
+    value <<= 4;
+    if (ch >= '0' && ch <= '9') {
+      value |= static_cast<unsigned>(ch - '0');
+    } else if (ch >= 'a' && ch <= 'f') {
+      value |= static_cast<unsigned>(ch - 'a' + 10);
+    } else if (ch >= 'A' && ch <= 'F') {
+      value |= static_cast<unsigned>(ch - 'A' + 10);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+void append_utf8(std::string& out, unsigned code_point) {
+  if (code_point < 0x80) {
+    out.push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800) {
+    out.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+    out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else if (code_point < 0x10000) {
+    out.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+    out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else {
+    out.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+    out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+}
+
+// Decodes a JSON string starting at the opening quote. Returns false on anything malformed so the
+// caller can fall back to nlohmann::json, which produces the canonical error handling.
+bool scan_json_string(std::string_view input, std::size_t& pos, std::string& out) {
+  if (pos >= input.size() || input[pos] != '"') {
+    return false;
+  }
+  ++pos;
+  out.clear();
+  while (pos < input.size()) {
+    const std::size_t run_start = pos;
+    while (pos < input.size() && input[pos] != '"' && input[pos] != '\\') {
+      if (static_cast<unsigned char>(input[pos]) < 0x20) {
+        return false;
+      }
+      ++pos;
+    }
+    out.append(input.data() + run_start, pos - run_start);
+    if (pos >= input.size()) {
+      return false;
+    }
+    if (input[pos] == '"') {
+      ++pos;
+      return true;
+    }
+    if (++pos >= input.size()) {
+      return false;
+    }
+    const char escape = input[pos++];
+    switch (escape) {
+      case '"': out.push_back('"'); break;
+      case '\\': out.push_back('\\'); break;
+      case '/': out.push_back('/'); break;
+      case 'b': out.push_back('\b'); break;
+      case 'f': out.push_back('\f'); break;
+      case 'n': out.push_back('\n'); break;
+      case 'r': out.push_back('\r'); break;
+      case 't': out.push_back('\t'); break;
+      case 'u': {
+        unsigned code_point = 0;
+        if (!parse_hex4(input, pos, code_point)) {
+          return false;
+        }
+        pos += 4;
+        if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+          unsigned low = 0;
+          if (pos + 6 > input.size() || input[pos] != '\\' || input[pos + 1] != 'u' ||
+              !parse_hex4(input, pos + 2, low) || low < 0xDC00 || low > 0xDFFF) {
+            return false;
+          }
+          pos += 6;
+          code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+        } else if (code_point >= 0xDC00 && code_point <= 0xDFFF) {
+          return false;
+        }
+        append_utf8(out, code_point);
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+  return false;
+}
+
+bool scan_json_int(std::string_view input, std::size_t& pos, int& value) {
+  bool negative = false;
+  if (pos < input.size() && input[pos] == '-') {
+    negative = true;
+    ++pos;
+  }
+  const std::size_t digits_start = pos;
+  long long parsed = 0;
+  while (pos < input.size() && input[pos] >= '0' && input[pos] <= '9') {
+    parsed = parsed * 10 + (input[pos] - '0');
+    if (parsed > std::numeric_limits<int>::max()) {
+      return false;
+    }
+    ++pos;
+  }
+  if (pos == digits_start) {
+    return false;
+  }
+  if (pos < input.size() && (input[pos] == '.' || input[pos] == 'e' || input[pos] == 'E')) {
+    return false;
+  }
+  value = static_cast<int>(negative ? -parsed : parsed);
+  return true;
+}
+
+bool skip_json_value(std::string_view input, std::size_t& pos) {
+  if (pos >= input.size()) {
+    return false;
+  }
+  const char first = input[pos];
+  if (first == '"') {
+    std::string ignored;
+    return scan_json_string(input, pos, ignored);
+  }
+  if (first == '{' || first == '[') {
+    int depth = 0;
+    while (pos < input.size()) {
+      const char ch = input[pos];
+      if (ch == '"') {
+        std::string ignored;
+        if (!scan_json_string(input, pos, ignored)) {
+          return false;
+        }
+        continue;
+      }
+      if (ch == '{' || ch == '[') {
+        ++depth;
+      } else if (ch == '}' || ch == ']') {
+        if (--depth == 0) {
+          ++pos;
+          return true;
+        }
+      }
+      ++pos;
+    }
+    return false;
+  }
+  const std::size_t start = pos;
+  while (pos < input.size() && input[pos] != ',' && input[pos] != '}' && input[pos] != ']' &&
+         input[pos] != ' ' && input[pos] != '\t' && input[pos] != '\n' && input[pos] != '\r') {
+    ++pos;
+  }
+  return pos > start;
+}
+
+// Decodes `response.output_text.delta` payloads with a single pass over the top-level object instead
+// of materialising a json DOM. Anything outside the common shape (non-empty logprobs, fractional
+// indices, malformed input) yields nullopt so the generic parser handles it.
+std::optional<ResponseStreamEvent> decode_output_text_delta(std::string_view data,
+                                                            const std::optional<std::string>& event_name) {
+  std::size_t pos = 0;
+  skip_json_whitespace(data, pos);
+  if (pos >= data.size() || data[pos] != '{') {
+    return std::nullopt;
+  }
+  ++pos;
+
+  ResponseTextDeltaEvent delta;
+  bool saw_type = false;
+  bool saw_sequence = false;
+  std::string key;
+  std::string type;
+
+  skip_json_whitespace(data, pos);
+  if (pos < data.size() && data[pos] == '}') {
+    return std::nullopt;
+  }
+  while (true) {
+    skip_json_whitespace(data, pos);
+    if (!scan_json_string(data, pos, key)) {
+      return std::nullopt;
+    }
+    skip_json_whitespace(data, pos);
+    if (pos >= data.size() || data[pos] != ':') {
+      return std::nullopt;
+    }
+    ++pos;
+    skip_json_whitespace(data, pos);
+
+    bool ok = true;
+    if (key == "type") {
+      ok = scan_json_string(data, pos, type) && type == kOutputTextDeltaType;
+      saw_type = ok;
+    } else if (key == "delta") {
+      ok = scan_json_string(data, pos, delta.delta);
+    } else if (key == "item_id") {
+      ok = scan_json_string(data, pos, delta.item_id);
+    } else if (key == "output_index") {
+      ok = scan_json_int(data, pos, delta.output_index);
+    } else if (key == "content_index") {
+      ok = scan_json_int(data, pos, delta.content_index);
+    } else if (key == "sequence_number") {
+      ok = scan_json_int(data, pos, delta.sequence_number);
+      saw_sequence = ok;
+    } else if (key == "logprobs") {
+      ok = pos < data.size() && data[pos] == '[';
+      if (ok) {
+        ++pos;
+        skip_json_whitespace(data, pos);
+        ok = pos < data.size() && data[pos] == ']';
+        ++pos;
+      }
+    } else {
+      ok = skip_json_value(data, pos);
+    }
+    if (!ok) {
+      return std::nullopt;
+    }
+
+    skip_json_whitespace(data, pos);
+    if (pos >= data.size()) {
+      return std::nullopt;
+    }
+    if (data[pos] == ',') {
+      ++pos;
+      continue;
+    }
+    if (data[pos] == '}') {
+      ++pos;
+      break;
+    }
+    return std::nullopt;
+  }
+  skip_json_whitespace(data, pos);
+  if (pos != data.size() || !saw_type || !saw_sequence) {
+    return std::nullopt;
+  }
+
+  ResponseStreamEvent event;
+  event.type = ResponseStreamEvent::Type::OutputTextDelta;
+  event.type_name = std::move(type);
+  event.sequence_number = delta.sequence_number;
+  event.event_name = event_name;
+  event.text_delta = std::move(delta);
+  return event;
+}
+
+bool may_be_output_text_delta(const ServerSentEvent& event) {
+  if (event.event && !event.event->empty() && *event.event != "message") {
+    return *event.event == kOutputTextDeltaType;
+  }
+  return std::string_view(event.data).find(kOutputTextDeltaType) != std::string_view::npos;
+}
+
+std::optional<ResponseStreamEvent> parse_response_stream_event_internal(const ServerSentEvent& event,
+                                                                        const ResponseStreamDecodeOptions& options) {
+  if (options.fast_text_deltas && may_be_output_text_delta(event)) {
+    if (auto fast = decode_output_text_delta(event.data, event.event)) {
+      return fast;
+    }
+  }
   try {
     auto payload = json::parse(event.data);
     return parse_stream_event_payload(payload, event.event);
@@ -2312,8 +2598,46 @@ std::string build_response_path(const std::string& response_id) {
   return std::string(kResponseEndpoint) + "/" + response_id;
 }
 
+void apply_retrieve_stream_query(RequestOptions& request_options, const ResponseRetrieveOptions& retrieve_options) {
+  request_options.query_params["stream"] = retrieve_options.stream ? "true" : "false";
+  if (retrieve_options.include_obfuscation) {
+    request_options.query_params["include_obfuscation"] = *retrieve_options.include_obfuscation ? "true" : "false";
+  }
+  if (retrieve_options.starting_after) {
+    request_options.query_params["starting_after"] = std::to_string(*retrieve_options.starting_after);
+  }
+}
+
+bool is_terminal_stream_event(const ResponseStreamEvent& event) {
+  return event.type_name == "response.completed" || event.type_name == "response.failed" ||
+         event.type_name == "response.incomplete" || event.type_name == "error";
+}
+
+// Every `response.*.delta` event (text, refusal, reasoning, tool arguments, audio) is generated output.
+bool is_response_delta_event(const ServerSentEvent& event) {
+  if (event.event && *event.event != "message") {
+    const std::string& name = *event.event;
+    return name.size() >= 6 && name.compare(name.size() - 6, 6, ".delta") == 0;
+  }
+  return event.data.find(".delta\"") != std::string::npos;
+}
+
+// The typed counterpart of is_response_delta_event, for paths that have already parsed the event.
+bool is_response_delta(const ResponseStreamEvent& event) {
+  const std::string& name = event.type_name;
+  return name.size() >= 6 && name.compare(name.size() - 6, 6, ".delta") == 0;
+}
+
 }  // namespace
 
+json build_response_request_body(const ResponseRequest& request) {
+  return build_request_body(request);
+}
+
+Response parse_response_json(const json& payload) {
+  return parse_response(payload);
+}
+
 CursorPage<Response> ResponsesResource::list_page(const RequestOptions& options) const {
   auto fetch_impl = std::make_shared<std::function<CursorPage<Response>(const PageRequestOptions&)>>();
 
@@ -2355,7 +2679,12 @@ CursorPage<Response> ResponsesResource::list_page() const {
 }
 
 std::optional<ResponseStreamEvent> parse_response_stream_event(const ServerSentEvent& event) {
-  return parse_response_stream_event_internal(event);
+  return parse_response_stream_event_internal(event, ResponseStreamDecodeOptions{});
+}
+
+std::optional<ResponseStreamEvent> parse_response_stream_event(const ServerSentEvent& event,
+                                                               const ResponseStreamDecodeOptions& options) {
+  return parse_response_stream_event_internal(event, options);
 }
 
 Response ResponsesResource::create(const ResponseRequest& request, const RequestOptions& options) const {
@@ -2440,6 +2769,7 @@ std::vector<ServerSentEvent> ResponsesResource::stream(const ResponseRequest& re
   RequestOptions request_options = options;
   request_options.headers["Accept"] = "text/event-stream";
   request_options.collect_body = false;
+  stream.track_stats(client_.stream_stats_recorder(kResponseEndpoint, options), is_response_delta_event);
   request_options.on_chunk = [&](const char* data, std::size_t size) { stream.feed(data, size); };
 
   client_.perform_request("POST", kResponseEndpoint, body.dump(), request_options);
@@ -2456,13 +2786,14 @@ void ResponsesResource::stream(const ResponseRequest& request,
                                const std::function<bool(const ResponseStreamEvent&)>& on_event,
                                const RequestOptions& options) const {
   SSEEventStream stream([&](const ServerSentEvent& sse_event) {
-    if (!on_event) {
+    auto parsed = parse_response_stream_event(sse_event, client_.options().response_stream_decode);
+    if (!parsed) {
       return true;
     }
-    if (auto parsed = parse_response_stream_event(sse_event)) {
-      return on_event(*parsed);
+    if (is_response_delta(*parsed)) {
+      stream.mark_content();
     }
-    return true;
+    return on_event ? on_event(*parsed) : true;
   });
 
   auto body = build_request_body(request);
@@ -2471,6 +2802,7 @@ void ResponsesResource::stream(const ResponseRequest& request,
   RequestOptions request_options = options;
   request_options.headers["Accept"] = "text/event-stream";
   request_options.collect_body = false;
+  stream.track_stats(client_.stream_stats_recorder(kResponseEndpoint, options), nullptr);
   request_options.on_chunk = [&](const char* data, std::size_t size) { stream.feed(data, size); };
 
   client_.perform_request("POST", kResponseEndpoint, body.dump(), request_options);
@@ -2483,6 +2815,135 @@ void ResponsesResource::stream(const ResponseRequest& request,
   stream(request, on_event, RequestOptions{});
 }
 
+void ResponsesResource::stream_resumable(const ResponseRequest& request,
+                                         const std::function<bool(const ResponseStreamEvent&)>& on_event,
+                                         const ResponseStreamResumeOptions& resume_options,
+                                         const RequestOptions& options) const {
+  std::optional<std::string> response_id;
+  std::optional<int> last_sequence;
+  std::exception_ptr callback_error;
+  bool finished = false;
+  bool stopped = false;
+  bool resumed = false;
+  // Replayed overlap is not counted as content in the stream stats.
+  bool delivered_delta = false;
+
+  auto handle_event = [&](const ResponseStreamEvent& event) {
+    delivered_delta = false;
+    if (event.created && !event.created->response.id.empty()) {
+      response_id = event.created->response.id;
+    }
+    // A resumed stream may overlap with what was already delivered.
+    if (resumed && last_sequence && event.sequence_number <= *last_sequence) {
+      return true;
+    }
+    delivered_delta = is_response_delta(event);
+    if (!last_sequence || event.sequence_number > *last_sequence) {
+      last_sequence = event.sequence_number;
+    }
+    if (is_terminal_stream_event(event)) {
+      finished = true;
+    }
+    if (!on_event) {
+      return true;
+    }
+    try {
+      if (!on_event(event)) {
+        stopped = true;
+      }
+    } catch (...) {
+      callback_error = std::current_exception();
+      stopped = true;
+    }
+    return !stopped;
+  };
+
+  auto body = build_request_body(request);
+  body["stream"] = true;
+  const std::string payload = body.dump();
+
+  RequestOptions request_options = options;
+  request_options.headers["Accept"] = "text/event-stream";
+  request_options.collect_body = false;
+  // perform_request would replay a half-consumed stream from scratch; reconnects are handled below instead.
+  request_options.max_retries = 0;
+  if (resume_options.idle_timeout) {
+    request_options.idle_timeout = resume_options.idle_timeout;
+  }
+
+  // One recorder spans every reconnect so the stats describe the whole logical stream.
+  auto stats = client_.stream_stats_recorder(kResponseEndpoint, options);
+  std::size_t reconnects_remaining = resume_options.max_reconnects;
+  while (true) {
+    SSEEventStream stream([&](const ServerSentEvent& sse_event) {
+      if (auto parsed = parse_response_stream_event(sse_event, client_.options().response_stream_decode)) {
+        const bool keep_going = handle_event(*parsed);
+        if (delivered_delta) {
+          stream.mark_content();
+        }
+        return keep_going;
+      }
+      return true;
+    });
+    stream.track_stats(stats, nullptr);
+
+    RequestOptions attempt_options = request_options;
+    attempt_options.on_chunk = [&](const char* data, std::size_t size) {
+      stream.feed(data, size);
+      if (stopped) {
+        throw APIUserAbortError("Response stream stopped by handler");
+      }
+    };
+
+    std::string failure;
+    try {
+      if (response_id) {
+        ResponseRetrieveOptions resume;
+        resume.stream = true;
+        resume.starting_after = last_sequence;
+        apply_retrieve_stream_query(attempt_options, resume);
+        client_.perform_request("GET", build_response_path(*response_id), "", attempt_options);
+      } else {
+        client_.perform_request("POST", kResponseEndpoint, payload, attempt_options);
+      }
+      stream.finalize();
+    } catch (const APIUserAbortError&) {
+      // Thrown from on_chunk once the handler stopped the stream.
+    } catch (const APIConnectionError& error) {
+      failure = error.what();
+    }
+
+    if (callback_error) {
+      std::rethrow_exception(callback_error);
+    }
+    if (stopped || finished) {
+      return;
+    }
+    if (failure.empty()) {
+      if (!response_id) {
+        return;
+      }
+      failure = "Response stream ended before completion";
+    }
+    // Without response.created there is nothing to resume, and re-POSTing would create (and bill) a
+    // second response.
+    if (!response_id || reconnects_remaining == 0) {
+      throw APIConnectionError(failure);
+    }
+
+    auto delay = resume_options.reconnect_delay.value_or(
+        utils::calculate_default_retry_delay(reconnects_remaining, resume_options.max_reconnects));
+    utils::sleep_for(delay);
+    --reconnects_remaining;
+    resumed = true;
+  }
+}
+
+void ResponsesResource::stream_resumable(const ResponseRequest& request,
+                                         const std::function<bool(const ResponseStreamEvent&)>& on_event) const {
+  stream_resumable(request, on_event, ResponseStreamResumeOptions{}, RequestOptions{});
+}
+
 std::vector<ServerSentEvent> ResponsesResource::retrieve_stream(const std::string& response_id,
                                                                 const ResponseRetrieveOptions& retrieve_options,
                                                                 const RequestOptions& options) const {
@@ -2491,7 +2952,8 @@ std::vector<ServerSentEvent> ResponsesResource::retrieve_stream(const std::strin
   RequestOptions request_options = options;
   request_options.headers["Accept"] = "text/event-stream";
   request_options.collect_body = false;
-  request_options.query_params["stream"] = retrieve_options.stream ? "true" : "false";
+  apply_retrieve_stream_query(request_options, retrieve_options);
+  stream.track_stats(client_.stream_stats_recorder("/responses/{response_id}", options), is_response_delta_event);
   request_options.on_chunk = [&](const char* data, std::size_t size) { stream.feed(data, size); };
 
   client_.perform_request("GET", build_response_path(response_id), "", request_options);
@@ -2500,6 +2962,33 @@ std::vector<ServerSentEvent> ResponsesResource::retrieve_stream(const std::strin
   return stream.events();
 }
 
+void ResponsesResource::retrieve_stream(const std::string& response_id,
+                                        const ResponseRetrieveOptions& retrieve_options,
+                                        const std::function<bool(const ResponseStreamEvent&)>& on_event,
+                                        const RequestOptions& options) const {
+  SSEEventStream stream([&](const ServerSentEvent& sse_event) {
+    auto parsed = parse_response_stream_event(sse_event, client_.options().response_stream_decode);
+    if (!parsed) {
+      return true;
+    }
+    if (is_response_delta(*parsed)) {
+      stream.mark_content();
+    }
+    return on_event ? on_event(*parsed) : true;
+  });
+
+  RequestOptions request_options = options;
+  request_options.headers["Accept"] = "text/event-stream";
+  request_options.collect_body = false;
+  apply_retrieve_stream_query(request_options, retrieve_options);
+  stream.track_stats(client_.stream_stats_recorder("/responses/{response_id}", options), nullptr);
+  request_options.on_chunk = [&](const char* data, std::size_t size) { stream.feed(data, size); };
+
+  client_.perform_request("GET", build_response_path(response_id), "", request_options);
+
+  stream.finalize();
+}
+
 std::vector<ServerSentEvent> ResponsesResource::retrieve_stream(const std::string& response_id) const {
   return retrieve_stream(response_id, ResponseRetrieveOptions{.stream = true}, RequestOptions{});
 }
@@ -596,6 +596,8 @@ void RunsResource::stream(const std::string& thread_id,
     return should_continue;
   });
 
+  stream.track_stats(client_.stream_stats_recorder("/threads/{thread_id}/runs", options),
+                     is_assistant_content_event);
   request_options.on_chunk = [&](const char* data, std::size_t size) { stream.feed(data, size); };
 
   if (streaming_request.include && !streaming_request.include->empty()) {
@@ -636,6 +638,8 @@ AssistantStreamSnapshot RunsResource::create_stream_snapshot(const std::string&
     return true;
   });
 
+  stream.track_stats(client_.stream_stats_recorder("/threads/{thread_id}/runs", options),
+                     is_assistant_content_event);
   request_options.on_chunk = [&](const char* data, std::size_t size) { stream.feed(data, size); };
 
   if (streaming_request.include && !streaming_request.include->empty()) {
@@ -714,6 +718,9 @@ void RunsResource::submit_tool_outputs_stream(
     return should_continue;
   });
 
+  stream.track_stats(
+      client_.stream_stats_recorder("/threads/{thread_id}/runs/{run_id}/submit_tool_outputs", options),
+      is_assistant_content_event);
   request_options.on_chunk = [&](const char* data, std::size_t size) { stream.feed(data, size); };
 
   const auto body = submit_tool_outputs_to_json(streaming_request);
@@ -749,6 +756,9 @@ AssistantStreamSnapshot RunsResource::submit_tool_outputs_stream_snapshot(
     return true;
   });
 
+  stream.track_stats(
+      client_.stream_stats_recorder("/threads/{thread_id}/runs/{run_id}/submit_tool_outputs", options),
+      is_assistant_content_event);
   request_options.on_chunk = [&](const char* data, std::size_t size) { stream.feed(data, size); };
 
   const auto body = submit_tool_outputs_to_json(streaming_request);
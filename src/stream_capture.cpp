@@ -0,0 +1,292 @@
+#include "openai/stream_capture.hpp"
+
+#include "openai/error.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <utility>
+
+namespace openai {
+namespace {
+
+using json = nlohmann::json;
+
+// File layout: 8-byte magic, then records of
+//   u8 type | u32 exchange id | u64 offset ns | u32 payload length | payload
+// with all integers little-endian.
+constexpr std::array<char, 8> kCaptureMagic = {'O', 'A', 'I', 'S', 'S', 'E', '0', '1'};
+constexpr std::size_t kRecordHeaderSize = 1 + 4 + 8 + 4;
+
+enum RecordType : std::uint8_t {
+  kRecordBegin = 1,
+  kRecordChunk = 2,
+  kRecordEnd = 3,
+};
+
+void put_le(char* out, std::uint64_t value, std::size_t width) {
+  for (std::size_t i = 0; i < width; ++i) {
+    out[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+  }
+}
+
+std::uint64_t get_le(const char* in, std::size_t width) {
+  std::uint64_t value = 0;
+  for (std::size_t i = 0; i < width; ++i) {
+    value |= static_cast<std::uint64_t>(static_cast<unsigned char>(in[i])) << (8 * i);
+  }
+  return value;
+}
+
+struct CaptureTail {
+  std::uint32_t next_exchange_id = 0;
+  std::uintmax_t valid_size = 0;
+};
+
+// Finds where a previous session left off: one past the highest exchange id, and the end of the last
+// complete record so a record torn by a crash is dropped before appending.
+CaptureTail scan_capture_tail(const std::string& path) {
+  CaptureTail tail;
+  std::error_code ec;
+  const auto file_size = std::filesystem::file_size(path, ec);
+  if (ec || file_size < kCaptureMagic.size()) {
+    return tail;
+  }
+  std::ifstream file(path, std::ios::binary);
+  std::array<char, kCaptureMagic.size()> magic{};
+  if (!file.read(magic.data(), magic.size()) || magic != kCaptureMagic) {
+    throw OpenAIError("Not a stream capture file: " + path);
+  }
+  tail.valid_size = magic.size();
+  std::array<char, kRecordHeaderSize> header{};
+  while (file.read(header.data(), header.size())) {
+    const auto id = static_cast<std::uint32_t>(get_le(header.data() + 1, 4));
+    const auto size = get_le(header.data() + 13, 4);
+    const std::uintmax_t record_end = tail.valid_size + kRecordHeaderSize + size;
+    if (record_end > file_size) {
+      break;
+    }
+    tail.valid_size = record_end;
+    tail.next_exchange_id = std::max(tail.next_exchange_id, id + 1);
+    file.seekg(static_cast<std::streamoff>(size), std::ios::cur);
+  }
+  return tail;
+}
+
+}  // namespace
+
+StreamCaptureWriter::StreamCaptureWriter(const std::string& path) {
+  const auto tail = scan_capture_tail(path);
+  std::error_code ec;
+  if (std::filesystem::exists(path, ec) && std::filesystem::file_size(path, ec) != tail.valid_size) {
+    std::filesystem::resize_file(path, tail.valid_size, ec);
+    if (ec) {
+      throw OpenAIError("Failed to truncate stream capture file: " + path);
+    }
+  }
+  next_exchange_id_ = tail.next_exchange_id;
+
+  file_ = std::fopen(path.c_str(), "ab");
+  if (!file_) {
+    throw OpenAIError("Failed to open stream capture file: " + path);
+  }
+  if (tail.valid_size == 0 &&
+      std::fwrite(kCaptureMagic.data(), 1, kCaptureMagic.size(), file_) != kCaptureMagic.size()) {
+    std::fclose(file_);
+    file_ = nullptr;
+    throw OpenAIError("Failed to write stream capture file: " + path);
+  }
+}
+
+StreamCaptureWriter::~StreamCaptureWriter() {
+  if (file_) {
+    std::fclose(file_);
+  }
+}
+
+std::uint32_t StreamCaptureWriter::begin_exchange(const std::string& method, const std::string& url) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const std::uint32_t id = next_exchange_id_++;
+  started_[id] = std::chrono::steady_clock::now();
+  const std::string payload = method + " " + url;
+  write_record(kRecordBegin, id, 0, payload.data(), payload.size());
+  return id;
+}
+
+void StreamCaptureWriter::record_chunk(std::uint32_t exchange_id, const char* data, std::size_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  write_record(kRecordChunk, exchange_id, elapsed_ns(exchange_id), data, size);
+}
+
+void StreamCaptureWriter::end_exchange(std::uint32_t exchange_id,
+                                       long status_code,
+                                       const std::map<std::string, std::string>& headers) {
+  json summary;
+  summary["status"] = status_code;
+  summary["headers"] = headers;
+  const std::string payload = summary.dump();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  write_record(kRecordEnd, exchange_id, elapsed_ns(exchange_id), payload.data(), payload.size());
+  started_.erase(exchange_id);
+  std::fflush(file_);
+}
+
+void StreamCaptureWriter::fail_exchange(std::uint32_t exchange_id, const std::string& message) {
+  json summary;
+  summary["status"] = 0;
+  summary["error"] = message;
+  const std::string payload = summary.dump();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  write_record(kRecordEnd, exchange_id, elapsed_ns(exchange_id), payload.data(), payload.size());
+  started_.erase(exchange_id);
+  std::fflush(file_);
+}
+
+void StreamCaptureWriter::flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::fflush(file_);
+}
+
+std::uint64_t StreamCaptureWriter::elapsed_ns(std::uint32_t exchange_id) const {
+  auto it = started_.find(exchange_id);
+  if (it == started_.end()) {
+    return 0;
+  }
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - it->second).count());
+}
+
+void StreamCaptureWriter::write_record(std::uint8_t type,
+                                       std::uint32_t exchange_id,
+                                       std::uint64_t offset_ns,
+                                       const char* data,
+                                       std::size_t size) {
+  std::array<char, kRecordHeaderSize> header{};
+  header[0] = static_cast<char>(type);
+  put_le(header.data() + 1, exchange_id, 4);
+  put_le(header.data() + 5, offset_ns, 8);
+  put_le(header.data() + 13, size, 4);
+  if (std::fwrite(header.data(), 1, header.size(), file_) != header.size() ||
+      (size > 0 && std::fwrite(data, 1, size, file_) != size)) {
+    throw OpenAIError("Failed to write stream capture record");
+  }
+}
+
+std::vector<CapturedExchange> read_stream_capture(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    throw OpenAIError("Failed to open stream capture file: " + path);
+  }
+  std::array<char, kCaptureMagic.size()> magic{};
+  if (!file.read(magic.data(), magic.size()) || magic != kCaptureMagic) {
+    throw OpenAIError("Not a stream capture file: " + path);
+  }
+
+  std::vector<CapturedExchange> exchanges;
+  std::map<std::uint32_t, std::size_t> open;
+  std::array<char, kRecordHeaderSize> header{};
+  std::string payload;
+  while (file.read(header.data(), header.size())) {
+    const auto type = static_cast<std::uint8_t>(header[0]);
+    const auto id = static_cast<std::uint32_t>(get_le(header.data() + 1, 4));
+    const auto offset = std::chrono::nanoseconds(static_cast<std::int64_t>(get_le(header.data() + 5, 8)));
+    const auto size = static_cast<std::size_t>(get_le(header.data() + 13, 4));
+    payload.resize(size);
+    if (size > 0 && !file.read(payload.data(), static_cast<std::streamsize>(size))) {
+      break;
+    }
+
+    if (type == kRecordBegin) {
+      CapturedExchange exchange;
+      const auto space = payload.find(' ');
+      exchange.method = payload.substr(0, space);
+      exchange.url = space == std::string::npos ? std::string{} : payload.substr(space + 1);
+      open[id] = exchanges.size();
+      exchanges.push_back(std::move(exchange));
+      continue;
+    }
+
+    auto it = open.find(id);
+    if (it == open.end()) {
+      continue;
+    }
+    auto& exchange = exchanges[it->second];
+    if (type == kRecordChunk) {
+      exchange.chunks.push_back(CapturedChunk{offset, payload});
+    } else if (type == kRecordEnd) {
+      exchange.duration = offset;
+      auto summary = json::parse(payload, nullptr, false);
+      if (summary.is_object()) {
+        exchange.status_code = summary.value("status", 0L);
+        if (summary.contains("headers") && summary.at("headers").is_object()) {
+          exchange.headers = summary.at("headers").get<std::map<std::string, std::string>>();
+        }
+        if (summary.contains("error") && summary.at("error").is_string()) {
+          exchange.error = summary.at("error").get<std::string>();
+        }
+      }
+      open.erase(it);
+    }
+  }
+
+  for (const auto& [id, index] : open) {
+    (void)id;
+    exchanges[index].error = std::string("Stream capture ended before the exchange completed");
+  }
+  return exchanges;
+}
+
+StreamReplayHttpClient::StreamReplayHttpClient(std::vector<CapturedExchange> exchanges, StreamReplayPacing pacing)
+    : exchanges_(std::make_move_iterator(exchanges.begin()), std::make_move_iterator(exchanges.end())),
+      pacing_(pacing) {}
+
+std::unique_ptr<StreamReplayHttpClient> StreamReplayHttpClient::from_file(const std::string& path,
+                                                                          StreamReplayPacing pacing) {
+  return std::make_unique<StreamReplayHttpClient>(read_stream_capture(path), pacing);
+}
+
+HttpResponse StreamReplayHttpClient::request(const HttpRequest& request) {
+  CapturedExchange exchange;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (exchanges_.empty()) {
+      throw OpenAIError("StreamReplayHttpClient has no captured exchanges left");
+    }
+    exchange = std::move(exchanges_.front());
+    exchanges_.pop_front();
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  HttpResponse response;
+  response.status_code = exchange.status_code;
+  response.headers = std::move(exchange.headers);
+  for (const auto& chunk : exchange.chunks) {
+    if (pacing_ == StreamReplayPacing::Original) {
+      std::this_thread::sleep_until(start + chunk.offset);
+    }
+    if (request.on_chunk) {
+      request.on_chunk(chunk.data.data(), chunk.data.size());
+    }
+    if (request.collect_body) {
+      response.body += chunk.data;
+    }
+  }
+  if (exchange.error) {
+    throw OpenAIError(*exchange.error);
+  }
+  return response;
+}
+
+std::size_t StreamReplayHttpClient::remaining() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return exchanges_.size();
+}
+
+}  // namespace openai
@@ -0,0 +1,85 @@
+#include "openai/stream_stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace openai {
+
+double StreamStats::tokens_per_second() const {
+  std::chrono::nanoseconds span{0};
+  for (const auto gap : inter_delta_gaps) {
+    span += gap;
+  }
+  if (span.count() <= 0) {
+    return 0.0;
+  }
+  return static_cast<double>(inter_delta_gaps.size()) / std::chrono::duration<double>(span).count();
+}
+
+std::chrono::nanoseconds StreamStats::inter_delta_percentile(double percentile) const {
+  if (inter_delta_gaps.empty()) {
+    return std::chrono::nanoseconds{0};
+  }
+  auto sorted = inter_delta_gaps;
+  std::sort(sorted.begin(), sorted.end());
+  const double clamped = std::clamp(percentile, 0.0, 100.0);
+  const auto rank = static_cast<std::size_t>(std::ceil(clamped / 100.0 * static_cast<double>(sorted.size())));
+  return sorted[rank == 0 ? 0 : rank - 1];
+}
+
+StreamStatsRecorder::StreamStatsRecorder(std::string endpoint,
+                                         std::shared_ptr<StreamStats> target,
+                                         StreamStatsCallback callback)
+    : target_(std::move(target)), callback_(std::move(callback)), start_(Clock::now()) {
+  stats_.endpoint = std::move(endpoint);
+}
+
+StreamStatsRecorder::~StreamStatsRecorder() {
+  try {
+    finish();
+  } catch (...) {
+    // A throwing metrics callback must not escape a destructor.
+  }
+}
+
+void StreamStatsRecorder::on_bytes(std::size_t size) {
+  if (!stats_.time_to_first_byte) {
+    stats_.time_to_first_byte = Clock::now() - start_;
+  }
+  stats_.bytes += size;
+}
+
+void StreamStatsRecorder::on_event(bool content_delta) {
+  on_event(content_delta, Clock::now());
+}
+
+void StreamStatsRecorder::on_event(bool content_delta, Clock::time_point arrived) {
+  ++stats_.events;
+  if (!content_delta) {
+    return;
+  }
+  if (stats_.content_deltas == 0) {
+    stats_.time_to_first_content = arrived - start_;
+  } else {
+    stats_.inter_delta_gaps.push_back(arrived - last_delta_);
+  }
+  last_delta_ = arrived;
+  ++stats_.content_deltas;
+}
+
+void StreamStatsRecorder::finish() {
+  if (finished_) {
+    return;
+  }
+  finished_ = true;
+  stats_.total_duration = Clock::now() - start_;
+  if (target_) {
+    *target_ = stats_;
+  }
+  if (callback_) {
+    callback_(stats_);
+  }
+}
+
+}  // namespace openai
@@ -1,6 +1,7 @@
 #include "openai/streaming.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <sstream>
 
 namespace openai {
@@ -93,8 +94,14 @@ std::vector<ServerSentEvent> parse_sse_stream(const std::string& payload) {
 
 SSEEventStream::SSEEventStream(EventHandler handler) : handler_(std::move(handler)) {}
 
+void SSEEventStream::track_stats(std::shared_ptr<StreamStatsRecorder> recorder, ContentClassifier is_content) {
+  stats_ = std::move(recorder);
+  is_content_ = is_content;
+}
+
 void SSEEventStream::feed(const char* data, std::size_t size) {
   if (stopped_) return;
+  if (stats_) stats_->on_bytes(size);
   auto events = parser_.feed(data, size);
   dispatch_events(std::move(events));
 }
@@ -113,6 +120,9 @@ void SSEEventStream::dispatch_events(std::vector<ServerSentEvent>&& events) {
   if (events.empty()) return;
   for (const auto& event : events) {
     if (stopped_) break;
+    // Timed before the handler runs so the stats describe arrival, not the caller's processing.
+    const auto arrived = stats_ ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{};
+    current_is_content_ = is_content_ && is_content_(event);
     events_.push_back(event);
     if (handler_) {
       const bool should_continue = handler_(event);
@@ -120,6 +130,7 @@ void SSEEventStream::dispatch_events(std::vector<ServerSentEvent>&& events) {
         stopped_ = true;
       }
     }
+    if (stats_) stats_->on_event(current_is_content_, arrived);
   }
 }
 
@@ -427,6 +427,7 @@ AssistantStreamSnapshot ThreadsResource::create_and_run_stream_snapshot(const Th
     parser.feed(sse_event);
     return true;
   });
+  stream.track_stats(client_.stream_stats_recorder("/threads/runs", options), is_assistant_content_event);
   request_options.on_chunk = [&](const char* data, std::size_t size) { stream.feed(data, size); };
 
   json body;
@@ -2,7 +2,21 @@
 
 #include "openai/client.hpp"
 #include "openai/error.hpp"
+#include "openai/utils/md5.hpp"
 #include "openai/utils/multipart.hpp"
+#include "openai/utils/time.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
 
 namespace openai {
 namespace {
@@ -79,6 +93,123 @@ json build_upload_complete_body(const UploadCompleteParams& params) {
   return body;
 }
 
+// Progress of upload_file, persisted after every finished part so another process can resume it.
+struct UploadCheckpoint {
+  std::string upload_id;
+  int expires_at = 0;
+  std::string path;
+  std::uint64_t file_bytes = 0;
+  std::int64_t file_modified = 0;
+  std::size_t part_size = 0;
+  // Hash of the first md5.length bytes of the file; always a whole number of parts.
+  std::optional<utils::MD5::State> md5;
+  // Finished part index -> part id.
+  std::map<std::size_t, std::string> parts;
+};
+
+constexpr int kCheckpointVersion = 1;
+// A checkpointed Upload this close to expires_at is abandoned rather than resumed.
+constexpr std::chrono::seconds kResumeExpiryMargin{300};
+
+std::int64_t file_modified_time(const std::string& path) {
+  std::error_code error;
+  const auto time = std::filesystem::last_write_time(path, error);
+  return error ? 0 : static_cast<std::int64_t>(time.time_since_epoch().count());
+}
+
+std::string to_hex(std::string_view bytes) {
+  static constexpr char kDigits[] = "0123456789abcdef";
+  std::string hex;
+  hex.reserve(bytes.size() * 2);
+  for (const unsigned char byte : bytes) {
+    hex.push_back(kDigits[byte >> 4]);
+    hex.push_back(kDigits[byte & 0x0fu]);
+  }
+  return hex;
+}
+
+std::string from_hex(const std::string& hex) {
+  if (hex.size() % 2 != 0) {
+    throw std::invalid_argument("odd-length hex string");
+  }
+  std::string bytes;
+  for (std::size_t i = 0; i < hex.size(); i += 2) {
+    bytes.push_back(static_cast<char>(std::stoi(hex.substr(i, 2), nullptr, 16)));
+  }
+  return bytes;
+}
+
+void write_checkpoint(const std::string& path, const UploadCheckpoint& checkpoint) {
+  json parts = json::array();
+  for (const auto& [index, id] : checkpoint.parts) {
+    const std::uint64_t offset = static_cast<std::uint64_t>(index) * checkpoint.part_size;
+    parts.push_back({{"index", index},
+                     {"id", id},
+                     {"offset", offset},
+                     {"bytes", std::min<std::uint64_t>(checkpoint.part_size, checkpoint.file_bytes - offset)}});
+  }
+  json payload = {{"version", kCheckpointVersion},
+                  {"upload_id", checkpoint.upload_id},
+                  {"expires_at", checkpoint.expires_at},
+                  {"file", {{"path", checkpoint.path}, {"bytes", checkpoint.file_bytes}, {"modified", checkpoint.file_modified}}},
+                  {"part_size", checkpoint.part_size},
+                  {"parts", std::move(parts)}};
+  if (checkpoint.md5) {
+    payload["md5"] = {{"words", checkpoint.md5->words},
+                      {"length", checkpoint.md5->length},
+                      {"pending", to_hex(checkpoint.md5->pending)}};
+  }
+
+  // Write-then-rename, so a crash mid-write leaves the previous checkpoint intact.
+  const std::string temporary = path + ".tmp";
+  {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    out << payload.dump();
+    if (!out) {
+      throw OpenAIError("Failed to write upload checkpoint: " + temporary);
+    }
+  }
+  std::error_code error;
+  std::filesystem::rename(temporary, path, error);
+  if (error) {
+    throw OpenAIError("Failed to write upload checkpoint: " + path);
+  }
+}
+
+// Returns nothing when the file is missing or unreadable; a damaged checkpoint just means starting over.
+std::optional<UploadCheckpoint> read_checkpoint(const std::string& path) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    return std::nullopt;
+  }
+  try {
+    const json payload = json::parse(in);
+    if (payload.at("version").get<int>() != kCheckpointVersion) {
+      return std::nullopt;
+    }
+    UploadCheckpoint checkpoint;
+    checkpoint.upload_id = payload.at("upload_id").get<std::string>();
+    checkpoint.expires_at = payload.at("expires_at").get<int>();
+    checkpoint.path = payload.at("file").at("path").get<std::string>();
+    checkpoint.file_bytes = payload.at("file").at("bytes").get<std::uint64_t>();
+    checkpoint.file_modified = payload.at("file").at("modified").get<std::int64_t>();
+    checkpoint.part_size = payload.at("part_size").get<std::size_t>();
+    for (const auto& part : payload.at("parts")) {
+      checkpoint.parts[part.at("index").get<std::size_t>()] = part.at("id").get<std::string>();
+    }
+    if (payload.contains("md5")) {
+      utils::MD5::State state;
+      state.words = payload.at("md5").at("words").get<std::array<std::uint32_t, 4>>();
+      state.length = payload.at("md5").at("length").get<std::uint64_t>();
+      state.pending = from_hex(payload.at("md5").at("pending").get<std::string>());
+      checkpoint.md5 = std::move(state);
+    }
+    return checkpoint;
+  } catch (const std::exception&) {
+    return std::nullopt;
+  }
+}
+
 }  // namespace
 
 UploadPart UploadPartsResource::create(const std::string& upload_id,
@@ -87,8 +218,10 @@ UploadPart UploadPartsResource::create(const std::string& upload_id,
   utils::MultipartFormData form;
   const std::string filename = params.filename.value_or("chunk.bin");
   const std::string content_type = params.content_type.value_or("application/octet-stream");
-  form.append_file("data", filename, content_type, params.data);
-  auto encoded = form.build();
+  // params outlives the request, so the chunk is referenced rather than copied into the body.
+  form.append_file("data", utils::borrow_file(params.data.data(), params.data.size(), filename, content_type),
+                   content_type);
+  auto encoded = form.build_segments();
 
   RequestOptions request_options = options;
   request_options.headers["Content-Type"] = encoded.content_type;
@@ -154,4 +287,266 @@ Upload UploadsResource::complete(const std::string& upload_id, const UploadCompl
   return complete(upload_id, params, RequestOptions{});
 }
 
+Upload UploadsResource::upload_file(const std::string& path,
+                                    const std::string& purpose,
+                                    const std::string& mime_type,
+                                    const UploadFileOptions& upload_options) const {
+  return upload_file(path, purpose, mime_type, upload_options, RequestOptions{});
+}
+
+Upload UploadsResource::upload_file(const std::string& path,
+                                    const std::string& purpose,
+                                    const std::string& mime_type,
+                                    const UploadFileOptions& upload_options,
+                                    const RequestOptions& options) const {
+  if (upload_options.part_size == 0) {
+    throw OpenAIError("UploadFileOptions.part_size must be positive");
+  }
+  std::error_code size_error;
+  const std::size_t total_bytes = static_cast<std::size_t>(std::filesystem::file_size(path, size_error));
+  if (size_error) {
+    throw OpenAIError("Failed to read file size: " + path);
+  }
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    throw OpenAIError("Failed to open file: " + path);
+  }
+
+  const std::size_t part_size = upload_options.part_size;
+  const std::size_t part_count = std::max<std::size_t>((total_bytes + part_size - 1) / part_size, 1);
+  const std::size_t concurrency = std::min(std::max<std::size_t>(upload_options.max_concurrency, 1), part_count);
+  const std::int64_t modified = file_modified_time(path);
+  const auto& checkpoint_path = upload_options.checkpoint_path;
+
+  // Resume only an Upload for this exact file and part layout that will not expire mid-transfer.
+  std::optional<UploadCheckpoint> checkpoint;
+  if (checkpoint_path) {
+    checkpoint = read_checkpoint(*checkpoint_path);
+    const auto now = std::chrono::duration_cast<std::chrono::seconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+    if (checkpoint && (checkpoint->file_bytes != total_bytes || checkpoint->file_modified != modified ||
+                       checkpoint->part_size != part_size ||
+                       (checkpoint->expires_at != 0 && checkpoint->expires_at < now + kResumeExpiryMargin.count()))) {
+      checkpoint.reset();
+    }
+  }
+
+  utils::MD5 md5;
+  std::uint64_t hashed_bytes = 0;
+  std::vector<std::string> part_ids(part_count);
+  std::size_t uploaded_bytes = 0;
+  if (checkpoint) {
+    for (const auto& [index, id] : checkpoint->parts) {
+      if (index < part_count) {
+        part_ids[index] = id;
+        uploaded_bytes += std::min<std::size_t>(part_size, total_bytes - index * part_size);
+      }
+    }
+    if (upload_options.verify_md5 && checkpoint->md5 &&
+        (checkpoint->md5->length % part_size == 0 || checkpoint->md5->length == total_bytes)) {
+      try {
+        md5.restore(*checkpoint->md5);
+        hashed_bytes = checkpoint->md5->length;
+      } catch (const std::invalid_argument&) {
+        md5.reset();
+      }
+    }
+  } else {
+    UploadCreateParams create_params;
+    create_params.bytes = total_bytes;
+    create_params.filename = upload_options.filename.value_or(std::filesystem::path(path).filename().string());
+    create_params.mime_type = mime_type;
+    create_params.purpose = purpose;
+    create_params.expires_after = upload_options.expires_after;
+    const Upload created = create(create_params, options);
+    checkpoint = UploadCheckpoint{};
+    checkpoint->upload_id = created.id;
+    checkpoint->expires_at = created.expires_at;
+    checkpoint->path = path;
+    checkpoint->file_bytes = total_bytes;
+    checkpoint->file_modified = modified;
+    checkpoint->part_size = part_size;
+    if (checkpoint_path) {
+      write_checkpoint(*checkpoint_path, *checkpoint);
+    }
+  }
+  const std::string upload_id = checkpoint->upload_id;
+
+  // The calling thread reads parts in file order, which keeps the MD5 incremental, and hands them to
+  // the workers. Buffers are recycled through `free_buffers`, so at most `concurrency` parts exist.
+  struct PendingPart {
+    std::size_t index = 0;
+    std::vector<std::uint8_t> data;
+  };
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::vector<std::vector<std::uint8_t>> free_buffers(concurrency);
+  std::deque<PendingPart> pending;
+  bool done_reading = false;
+  bool failed = false;
+  std::exception_ptr first_error;
+
+  auto fail = [&](std::exception_ptr error) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!first_error) {
+      first_error = std::move(error);
+    }
+    failed = true;
+    changed.notify_all();
+  };
+
+  auto upload_part = [&](PendingPart& part) {
+    UploadPartCreateParams params;
+    params.data = std::move(part.data);
+    params.content_type = mime_type;
+    RequestOptions part_options = options;
+    if (part_options.idempotency_key) {
+      *part_options.idempotency_key += "-part-" + std::to_string(part.index);
+    }
+    const std::size_t max_attempts = std::max<std::size_t>(upload_options.max_part_attempts, 1);
+    for (std::size_t attempt = 1;; ++attempt) {
+      try {
+        part_ids[part.index] = parts_.create(upload_id, params, part_options).id;
+        break;
+      } catch (...) {
+        auto error = std::current_exception();
+        if (attempt >= max_attempts || !is_transient_error(error)) {
+          throw;
+        }
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (failed) {
+          throw OpenAIError("Upload aborted after another part failed");
+        }
+      }
+      utils::sleep_for(utils::calculate_default_retry_delay(max_attempts - attempt, max_attempts));
+    }
+    part.data = std::move(params.data);
+  };
+
+  auto worker = [&]() {
+    while (true) {
+      PendingPart part;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return failed || !pending.empty() || done_reading; });
+        if (failed || pending.empty()) {
+          return;
+        }
+        part = std::move(pending.front());
+        pending.pop_front();
+      }
+      const std::size_t bytes = part.data.size();
+      try {
+        upload_part(part);
+      } catch (...) {
+        fail(std::current_exception());
+        return;
+      }
+      std::lock_guard<std::mutex> lock(mutex);
+      uploaded_bytes += bytes;
+      free_buffers.push_back(std::move(part.data));
+      if (checkpoint_path) {
+        checkpoint->parts[part.index] = part_ids[part.index];
+        try {
+          write_checkpoint(*checkpoint_path, *checkpoint);
+        } catch (...) {
+          if (!first_error) {
+            first_error = std::current_exception();
+          }
+          failed = true;
+          changed.notify_all();
+          return;
+        }
+      }
+      if (upload_options.on_progress) {
+        upload_options.on_progress(uploaded_bytes, total_bytes);
+      }
+      changed.notify_all();
+    }
+  };
+
+  std::vector<std::thread> threads;
+  threads.reserve(concurrency);
+  for (std::size_t i = 0; i < concurrency; ++i) {
+    threads.emplace_back(worker);
+  }
+
+  for (std::size_t index = 0; index < part_count; ++index) {
+    const std::uint64_t offset = static_cast<std::uint64_t>(index) * part_size;
+    const bool finished = !part_ids[index].empty();
+    // A resumed hash covers whole parts, so parts at or past its end are hashed in order from here.
+    const bool needs_hash = upload_options.verify_md5 && offset >= hashed_bytes;
+    if (finished && !needs_hash) {
+      continue;
+    }
+    std::vector<std::uint8_t> buffer;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      changed.wait(lock, [&] { return failed || !free_buffers.empty(); });
+      if (failed) {
+        break;
+      }
+      buffer = std::move(free_buffers.back());
+      free_buffers.pop_back();
+    }
+    buffer.resize(std::min<std::size_t>(part_size, total_bytes - offset));
+    file.seekg(static_cast<std::streamoff>(offset));
+    if (!file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()))) {
+      fail(std::make_exception_ptr(OpenAIError("Failed to read file: " + path)));
+      break;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (needs_hash) {
+      md5.update(buffer.data(), buffer.size());
+      hashed_bytes += buffer.size();
+      checkpoint->md5 = md5.state();
+    }
+    if (finished) {
+      free_buffers.push_back(std::move(buffer));
+    } else {
+      pending.push_back(PendingPart{index, std::move(buffer)});
+    }
+    changed.notify_all();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    done_reading = true;
+    changed.notify_all();
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  if (first_error) {
+    // With a checkpoint, a transient failure leaves the Upload open for the next attempt to resume.
+    if (!checkpoint_path || !is_transient_error(first_error)) {
+      try {
+        cancel(upload_id, options);
+      } catch (...) {
+        // The original failure is the one worth reporting.
+      }
+      if (checkpoint_path) {
+        std::error_code ignored;
+        std::filesystem::remove(*checkpoint_path, ignored);
+      }
+    }
+    std::rethrow_exception(first_error);
+  }
+
+  UploadCompleteParams complete_params;
+  complete_params.part_ids = std::move(part_ids);
+  if (upload_options.verify_md5) {
+    complete_params.md5 = md5.hex_digest();
+  }
+  auto completed = complete(upload_id, complete_params, options);
+  if (checkpoint_path) {
+    std::error_code ignored;
+    std::filesystem::remove(*checkpoint_path, ignored);
+  }
+  return completed;
+}
+
 }  // namespace openai
@@ -0,0 +1,99 @@
+#include "openai/utils/mapped_file.hpp"
+
+#include "openai/error.hpp"
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace openai::utils {
+
+#if defined(_WIN32)
+
+std::shared_ptr<const MappedFile> MappedFile::open(const std::string& path) {
+  std::shared_ptr<MappedFile> file(new MappedFile());
+  file->path_ = path;
+  HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (handle == INVALID_HANDLE_VALUE) {
+    throw OpenAIError("Failed to open file: " + path);
+  }
+  file->file_ = handle;
+  LARGE_INTEGER size{};
+  if (!GetFileSizeEx(handle, &size)) {
+    throw OpenAIError("Failed to stat file: " + path);
+  }
+  file->size_ = static_cast<std::size_t>(size.QuadPart);
+  if (file->size_ == 0) {
+    return file;
+  }
+  HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping == nullptr) {
+    throw OpenAIError("Failed to map file: " + path);
+  }
+  file->mapping_ = mapping;
+  void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if (view == nullptr) {
+    throw OpenAIError("Failed to map file: " + path);
+  }
+  file->data_ = static_cast<const std::uint8_t*>(view);
+  return file;
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    UnmapViewOfFile(data_);
+  }
+  if (mapping_ != nullptr) {
+    CloseHandle(static_cast<HANDLE>(mapping_));
+  }
+  if (file_ != nullptr) {
+    CloseHandle(static_cast<HANDLE>(file_));
+  }
+}
+
+#else
+
+std::shared_ptr<const MappedFile> MappedFile::open(const std::string& path) {
+  std::shared_ptr<MappedFile> file(new MappedFile());
+  file->path_ = path;
+  const int descriptor = ::open(path.c_str(), O_RDONLY);
+  if (descriptor < 0) {
+    throw OpenAIError("Failed to open file: " + path);
+  }
+  struct stat info {};
+  if (::fstat(descriptor, &info) != 0) {
+    ::close(descriptor);
+    throw OpenAIError("Failed to stat file: " + path);
+  }
+  file->size_ = static_cast<std::size_t>(info.st_size);
+  if (file->size_ > 0) {
+    void* view = ::mmap(nullptr, file->size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (view == MAP_FAILED) {
+      ::close(descriptor);
+      throw OpenAIError("Failed to map file: " + path);
+    }
+    file->data_ = static_cast<const std::uint8_t*>(view);
+  }
+  // The mapping keeps its own reference to the file.
+  ::close(descriptor);
+  return file;
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) {
+    ::munmap(const_cast<std::uint8_t*>(data_), size_);
+  }
+}
+
+#endif
+
+}  // namespace openai::utils
@@ -0,0 +1,162 @@
+#include "openai/utils/md5.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace openai::utils {
+namespace {
+
+std::uint32_t rotl(std::uint32_t x, std::uint32_t n) {
+  return (x << n) | (x >> (32 - n));
+}
+
+std::uint32_t load32_le(const std::uint8_t* p) {
+  return static_cast<std::uint32_t>(p[0]) |
+         (static_cast<std::uint32_t>(p[1]) << 8) |
+         (static_cast<std::uint32_t>(p[2]) << 16) |
+         (static_cast<std::uint32_t>(p[3]) << 24);
+}
+
+}  // namespace
+
+void MD5::reset() {
+  state_[0] = 0x67452301u;
+  state_[1] = 0xefcdab89u;
+  state_[2] = 0x98badcfeu;
+  state_[3] = 0x10325476u;
+  byte_length_ = 0;
+  buffer_size_ = 0;
+}
+
+void MD5::update(const std::uint8_t* data, std::size_t size) {
+  byte_length_ += size;
+  if (buffer_size_ > 0) {
+    const std::size_t to_copy = std::min<std::size_t>(size, 64 - buffer_size_);
+    std::copy(data, data + to_copy, buffer_.begin() + buffer_size_);
+    buffer_size_ += to_copy;
+    data += to_copy;
+    size -= to_copy;
+    if (buffer_size_ < 64) {
+      return;
+    }
+    process_block(buffer_.data());
+    buffer_size_ = 0;
+  }
+  // Whole blocks are hashed straight from the caller's buffer.
+  for (; size >= 64; data += 64, size -= 64) {
+    process_block(data);
+  }
+  std::copy(data, data + size, buffer_.begin());
+  buffer_size_ = size;
+}
+
+std::vector<std::uint8_t> MD5::digest() {
+  const std::uint64_t bit_length = byte_length_ * 8;
+  buffer_[buffer_size_++] = 0x80u;
+  if (buffer_size_ > 56) {
+    while (buffer_size_ < 64) buffer_[buffer_size_++] = 0;
+    process_block(buffer_.data());
+    buffer_size_ = 0;
+  }
+  while (buffer_size_ < 56) buffer_[buffer_size_++] = 0;
+  for (int i = 0; i < 8; ++i) {
+    buffer_[buffer_size_++] = static_cast<std::uint8_t>((bit_length >> (i * 8)) & 0xffu);
+  }
+  process_block(buffer_.data());
+
+  std::vector<std::uint8_t> out(16);
+  for (int i = 0; i < 4; ++i) {
+    for (int b = 0; b < 4; ++b) {
+      out[i * 4 + b] = static_cast<std::uint8_t>((state_[i] >> (b * 8)) & 0xffu);
+    }
+  }
+  return out;
+}
+
+std::string MD5::hex_digest() {
+  static constexpr char kDigits[] = "0123456789abcdef";
+  std::string hex;
+  for (const auto byte : digest()) {
+    hex.push_back(kDigits[byte >> 4]);
+    hex.push_back(kDigits[byte & 0x0fu]);
+  }
+  return hex;
+}
+
+MD5::State MD5::state() const {
+  State state;
+  std::copy(std::begin(state_), std::end(state_), state.words.begin());
+  state.length = byte_length_;
+  state.pending.assign(reinterpret_cast<const char*>(buffer_.data()), buffer_size_);
+  return state;
+}
+
+void MD5::restore(const State& state) {
+  if (state.pending.size() >= 64 || state.length % 64 != state.pending.size()) {
+    throw std::invalid_argument("MD5 state is inconsistent");
+  }
+  std::copy(state.words.begin(), state.words.end(), std::begin(state_));
+  byte_length_ = state.length;
+  buffer_size_ = state.pending.size();
+  std::copy(state.pending.begin(), state.pending.end(), buffer_.begin());
+}
+
+void MD5::process_block(const std::uint8_t* block) {
+  static constexpr std::uint32_t k[64] = {
+      0xd76aa478u, 0xe8c7b756u, 0x242070dbu, 0xc1bdceeeu, 0xf57c0fafu, 0x4787c62au, 0xa8304613u, 0xfd469501u,
+      0x698098d8u, 0x8b44f7afu, 0xffff5bb1u, 0x895cd7beu, 0x6b901122u, 0xfd987193u, 0xa679438eu, 0x49b40821u,
+      0xf61e2562u, 0xc040b340u, 0x265e5a51u, 0xe9b6c7aau, 0xd62f105du, 0x02441453u, 0xd8a1e681u, 0xe7d3fbc8u,
+      0x21e1cde6u, 0xc33707d6u, 0xf4d50d87u, 0x455a14edu, 0xa9e3e905u, 0xfcefa3f8u, 0x676f02d9u, 0x8d2a4c8au,
+      0xfffa3942u, 0x8771f681u, 0x6d9d6122u, 0xfde5380cu, 0xa4beea44u, 0x4bdecfa9u, 0xf6bb4b60u, 0xbebfbc70u,
+      0x289b7ec6u, 0xeaa127fau, 0xd4ef3085u, 0x04881d05u, 0xd9d4d039u, 0xe6db99e5u, 0x1fa27cf8u, 0xc4ac5665u,
+      0xf4292244u, 0x432aff97u, 0xab9423a7u, 0xfc93a039u, 0x655b59c3u, 0x8f0ccc92u, 0xffeff47du, 0x85845dd1u,
+      0x6fa87e4fu, 0xfe2ce6e0u, 0xa3014314u, 0x4e0811a1u, 0xf7537e82u, 0xbd3af235u, 0x2ad7d2bbu, 0xeb86d391u};
+  static constexpr std::uint32_t shifts[64] = {
+      7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 5, 9,  14, 20, 5, 9,  14, 20,
+      5, 9,  14, 20, 5, 9,  14, 20, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+      6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21};
+
+  std::uint32_t m[16];
+  for (int t = 0; t < 16; ++t) m[t] = load32_le(block + t * 4);
+
+  std::uint32_t a = state_[0];
+  std::uint32_t b = state_[1];
+  std::uint32_t c = state_[2];
+  std::uint32_t d = state_[3];
+
+  for (int t = 0; t < 64; ++t) {
+    std::uint32_t f;
+    int g;
+    if (t < 16) {
+      f = (b & c) | (~b & d);
+      g = t;
+    } else if (t < 32) {
+      f = (d & b) | (~d & c);
+      g = (5 * t + 1) % 16;
+    } else if (t < 48) {
+      f = b ^ c ^ d;
+      g = (3 * t + 5) % 16;
+    } else {
+      f = c ^ (b | ~d);
+      g = (7 * t) % 16;
+    }
+    const std::uint32_t rotated = rotl(a + f + k[t] + m[g], shifts[t]);
+    a = d;
+    d = c;
+    c = b;
+    b = b + rotated;
+  }
+
+  state_[0] += a;
+  state_[1] += b;
+  state_[2] += c;
+  state_[3] += d;
+}
+
+std::string md5_hex(std::string_view data) {
+  MD5 ctx;
+  ctx.update(data);
+  return ctx.hex_digest();
+}
+
+}  // namespace openai::utils
@@ -2,7 +2,8 @@
 
 #include "openai/utils/uuid.hpp"
 
-#include <sstream>
+#include <stdexcept>
+#include <utility>
 
 namespace openai::utils {
 namespace {
@@ -50,6 +51,24 @@ void MultipartFormData::append_file(const std::string& name,
                         .data = std::string(reinterpret_cast<const char*>(data.data()), data.size())});
 }
 
+void MultipartFormData::append_file(const std::string& name,
+                                    UploadFile file,
+                                    const std::string& default_content_type) {
+  Part part{.name = name,
+            .filename = std::move(file.filename),
+            .content_type = file.content_type.value_or(default_content_type),
+            .data = {}};
+  if (file.is_borrowed()) {
+    part.borrowed = file.borrowed;
+    part.owner = std::move(file.owner);
+  } else if (!file.data.empty()) {
+    auto owned = std::make_shared<const std::vector<std::uint8_t>>(std::move(file.data));
+    part.borrowed = std::string_view(reinterpret_cast<const char*>(owned->data()), owned->size());
+    part.owner = std::move(owned);
+  }
+  parts_.push_back(std::move(part));
+}
+
 void MultipartFormData::append_json(const std::string& name, const nlohmann::json& value) {
   append_json_internal(name, value);
 }
@@ -72,26 +91,64 @@ void MultipartFormData::append_json_internal(const std::string& name, const nloh
 }
 
 MultipartEncoded MultipartFormData::build() const {
-  std::ostringstream body;
+  auto segments = build_segments();
+  MultipartEncoded encoded;
+  encoded.content_type = std::move(segments.content_type);
+  encoded.body = segments.body->join();
+  return encoded;
+}
+
+MultipartSegments MultipartFormData::build_segments() const {
+  // All framing and text parts go into one buffer; each borrowed part splits it at `breaks`.
+  auto framing = std::make_shared<std::string>();
+  std::vector<std::pair<std::size_t, const Part*>> breaks;
   for (const auto& part : parts_) {
-    body << "--" << boundary_ << "\r\n";
-    body << "Content-Disposition: form-data; name=\"" << escape_quotes(part.name) << "\"";
+    std::string& out = *framing;
+    out += "--";
+    out += boundary_;
+    out += "\r\nContent-Disposition: form-data; name=\"";
+    out += escape_quotes(part.name);
+    out += '"';
     if (part.filename.has_value()) {
-      body << "; filename=\"" << escape_quotes(*part.filename) << "\"";
+      out += "; filename=\"";
+      out += escape_quotes(*part.filename);
+      out += '"';
     }
-    body << "\r\n";
+    out += "\r\n";
     if (part.content_type.has_value()) {
-      body << "Content-Type: " << *part.content_type << "\r\n";
+      out += "Content-Type: ";
+      out += *part.content_type;
+      out += "\r\n";
+    }
+    out += "\r\n";
+    if (part.borrowed) {
+      breaks.emplace_back(out.size(), &part);
+    } else {
+      out += part.data;
     }
-    body << "\r\n";
-    body << part.data;
-    body << "\r\n";
+    out += "\r\n";
   }
-  body << "--" << boundary_ << "--\r\n";
+  *framing += "--" + boundary_ + "--\r\n";
 
-  MultipartEncoded encoded;
+  auto body = std::make_shared<HttpBodySegments>();
+  std::string_view text(*framing);
+  std::size_t offset = 0;
+  for (const auto& [position, part] : breaks) {
+    body->segments.push_back(text.substr(offset, position - offset));
+    if (!part->borrowed->empty()) {
+      body->segments.push_back(*part->borrowed);
+    }
+    if (part->owner) {
+      body->owners.push_back(part->owner);
+    }
+    offset = position;
+  }
+  body->segments.push_back(text.substr(offset));
+  body->owners.push_back(std::move(framing));
+
+  MultipartSegments encoded;
   encoded.content_type = "multipart/form-data; boundary=" + boundary_;
-  encoded.body = body.str();
+  encoded.body = std::move(body);
   return encoded;
 }
 
@@ -1,6 +1,7 @@
 #include "openai/utils/to_file.hpp"
 
 #include "openai/error.hpp"
+#include "openai/utils/mapped_file.hpp"
 
 #include <array>
 #include <filesystem>
@@ -38,6 +39,13 @@ std::string basename(const std::string& path) {
 
 }  // namespace
 
+std::string_view UploadFile::bytes() const {
+  if (is_borrowed()) {
+    return borrowed;
+  }
+  return std::string_view(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
 UploadFile to_file(const std::string& path,
                    std::optional<std::string> filename_override,
                    std::optional<std::string> content_type) {
@@ -53,6 +61,50 @@ UploadFile to_file(const std::string& path,
   return upload;
 }
 
+UploadFile open_upload_file(const std::string& path,
+                            std::optional<std::string> filename_override,
+                            std::optional<std::string> content_type) {
+  std::error_code error;
+  const auto size = std::filesystem::file_size(path, error);
+  if (!error && size >= kMapUploadThreshold) {
+    return map_file(path, std::move(filename_override), std::move(content_type));
+  }
+  return to_file(path, std::move(filename_override), std::move(content_type));
+}
+
+UploadFile map_file(const std::string& path,
+                    std::optional<std::string> filename_override,
+                    std::optional<std::string> content_type) {
+  auto mapping = MappedFile::open(path);
+  UploadFile upload;
+  // An empty file has no mapping to borrow; leave it as empty owned data.
+  if (mapping->size() > 0) {
+    upload.borrowed = std::string_view(reinterpret_cast<const char*>(mapping->data()), mapping->size());
+    upload.owner = std::move(mapping);
+  }
+  upload.filename = filename_override.value_or(basename(path));
+  upload.content_type = std::move(content_type);
+  return upload;
+}
+
+UploadFile borrow_file(const void* data,
+                       std::size_t size,
+                       const std::string& filename,
+                       std::optional<std::string> content_type,
+                       std::shared_ptr<const void> owner) {
+  if (filename.empty()) {
+    throw OpenAIError("Filename must not be empty when wrapping byte data");
+  }
+  UploadFile upload;
+  if (size > 0) {
+    upload.borrowed = std::string_view(static_cast<const char*>(data), size);
+    upload.owner = std::move(owner);
+  }
+  upload.filename = filename;
+  upload.content_type = std::move(content_type);
+  return upload;
+}
+
 UploadFile to_file(std::vector<std::uint8_t> data,
                    const std::string& filename,
                    std::optional<std::string> content_type) {
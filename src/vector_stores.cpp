@@ -527,6 +527,14 @@ json build_search_body(const VectorStoreSearchRequest& request) {
 
 }  // namespace
 
+VectorStoreFile parse_vector_store_file_json(const nlohmann::json& payload) {
+  return parse_vector_store_file(payload);
+}
+
+VectorStoreFileBatch parse_vector_store_file_batch_json(const nlohmann::json& payload) {
+  return parse_vector_store_file_batch(payload);
+}
+
 VectorStore VectorStoresResource::create(const VectorStoreCreateRequest& request) const {
   return create(request, RequestOptions{});
 }
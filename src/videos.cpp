@@ -175,13 +175,14 @@ VideoDeleteResponse parse_video_delete(const json& payload) {
 
 void append_upload(utils::MultipartFormData& form,
                    const std::string& field,
-                   const std::optional<utils::UploadFile>& file) {
+                   std::optional<utils::UploadFile> file) {
   if (!file) {
     return;
   }
-  std::string effective_filename = file->filename.empty() ? "file.bin" : file->filename;
-  std::string effective_type = file->content_type.value_or("application/octet-stream");
-  form.append_file(field, effective_filename, effective_type, file->data);
+  if (file->filename.empty()) {
+    file->filename = "file.bin";
+  }
+  form.append_file(field, std::move(*file), "application/octet-stream");
 }
 
 VideoCreateRequest normalize_create_request(const VideoCreateRequest& request) {
@@ -192,9 +193,9 @@ VideoCreateRequest normalize_create_request(const VideoCreateRequest& request) {
       normalized.input_reference =
           utils::to_file(*normalized.input_reference_data, filename, normalized.input_reference_content_type);
     } else if (normalized.input_reference_path) {
-      normalized.input_reference = utils::to_file(*normalized.input_reference_path,
-                                                  normalized.input_reference_filename,
-                                                  normalized.input_reference_content_type);
+      normalized.input_reference = utils::open_upload_file(*normalized.input_reference_path,
+                                                           normalized.input_reference_filename,
+                                                           normalized.input_reference_content_type);
       if (normalized.input_reference && normalized.input_reference->filename.empty()) {
         normalized.input_reference->filename = filename_from_path(*normalized.input_reference_path);
       }
@@ -211,9 +212,9 @@ VideoRemixParams normalize_remix_request(const VideoRemixParams& params) {
       normalized.input_reference =
           utils::to_file(*normalized.input_reference_data, filename, normalized.input_reference_content_type);
     } else if (normalized.input_reference_path) {
-      normalized.input_reference = utils::to_file(*normalized.input_reference_path,
-                                                  normalized.input_reference_filename,
-                                                  normalized.input_reference_content_type);
+      normalized.input_reference = utils::open_upload_file(*normalized.input_reference_path,
+                                                           normalized.input_reference_filename,
+                                                           normalized.input_reference_content_type);
       if (normalized.input_reference && normalized.input_reference->filename.empty()) {
         normalized.input_reference->filename = filename_from_path(*normalized.input_reference_path);
       }
@@ -224,6 +225,10 @@ VideoRemixParams normalize_remix_request(const VideoRemixParams& params) {
 
 }  // namespace
 
+Video parse_video_json(const nlohmann::json& payload) {
+  return parse_video(payload);
+}
+
 Video VideosResource::create(const VideoCreateRequest& request) const {
   return create(request, RequestOptions{});
 }
@@ -235,14 +240,13 @@ Video VideosResource::create(const VideoCreateRequest& request, const RequestOpt
   if (normalized.model) form.append_text("model", model_to_string(*normalized.model));
   if (normalized.seconds) form.append_text("seconds", seconds_to_string(*normalized.seconds));
   if (normalized.size) form.append_text("size", size_to_string(*normalized.size));
-  append_upload(form, "input_reference", normalized.input_reference);
-  auto encoded = form.build();
+  append_upload(form, "input_reference", std::move(normalized.input_reference));
+  auto encoded = form.build_segments();
 
   RequestOptions request_options = options;
   request_options.headers["Content-Type"] = encoded.content_type;
-  std::string body(encoded.body.begin(), encoded.body.end());
 
-  auto response = client_.perform_request("POST", kVideosPath, body, request_options);
+  auto response = client_.perform_request("POST", kVideosPath, encoded.body, request_options);
   try {
     return parse_video(json::parse(response.body));
   } catch (const json::exception& ex) {
@@ -367,6 +371,29 @@ VideoContent VideosResource::download_content(const std::string& video_id,
   return content;
 }
 
+DownloadResult VideosResource::download_content(const std::string& video_id,
+                                                const VideoDownloadContentParams& params,
+                                                const DownloadSink& sink,
+                                                const DownloadOptions& download_options) const {
+  return download_content(video_id, params, sink, download_options, RequestOptions{});
+}
+
+DownloadResult VideosResource::download_content(const std::string& video_id,
+                                                const VideoDownloadContentParams& params,
+                                                const DownloadSink& sink,
+                                                const DownloadOptions& download_options,
+                                                const RequestOptions& options) const {
+  RequestOptions request_options = options;
+  request_options.headers["Accept"] = "application/binary";
+  if (params.variant) {
+    request_options.query_params["variant"] = variant_to_string(*params.variant);
+  }
+  auto path = std::string(kVideosPath) + "/" + video_id + "/content";
+  return download(sink, download_options, request_options, [&](const RequestOptions& attached) {
+    return client_.perform_request("GET", path, "", attached);
+  });
+}
+
 Video VideosResource::remix(const std::string& video_id, const VideoRemixParams& params) const {
   return remix(video_id, params, RequestOptions{});
 }
@@ -377,15 +404,14 @@ Video VideosResource::remix(const std::string& video_id,
   auto normalized = normalize_remix_request(params);
   utils::MultipartFormData form;
   form.append_text("prompt", normalized.prompt);
-  append_upload(form, "input_reference", normalized.input_reference);
-  auto encoded = form.build();
+  append_upload(form, "input_reference", std::move(normalized.input_reference));
+  auto encoded = form.build_segments();
 
   RequestOptions request_options = options;
   request_options.headers["Content-Type"] = encoded.content_type;
-  std::string body(encoded.body.begin(), encoded.body.end());
 
   auto path = std::string(kVideosPath) + "/" + video_id + "/remix";
-  auto response = client_.perform_request("POST", path, body, request_options);
+  auto response = client_.perform_request("POST", path, encoded.body, request_options);
   try {
     return parse_video(json::parse(response.body));
   } catch (const json::exception& ex) {
@@ -0,0 +1,156 @@
+#include "openai/webhook_waiters.hpp"
+
+#include "openai/client.hpp"
+#include "openai/error.hpp"
+
+#include <utility>
+#include <variant>
+
+namespace openai {
+namespace {
+
+PollSchedulerOptions fallback_options(const WebhookWaiterOptions& options) {
+  PollSchedulerOptions scheduler;
+  scheduler.workers = options.fallback_workers;
+  scheduler.first_poll_delay = options.fallback_interval;
+  scheduler.initial_interval = options.fallback_interval;
+  scheduler.max_interval = options.fallback_interval;
+  scheduler.backoff_multiplier = 1.0;
+  return scheduler;
+}
+
+}  // namespace
+
+WebhookWaiterRegistry::WebhookWaiterRegistry(OpenAIClient& client, WebhookWaiterOptions options)
+    : client_(client), options_(std::move(options)), fallback_(client, fallback_options(options_)) {}
+
+std::future<Batch> WebhookWaiterRegistry::wait_for_batch(const std::string& batch_id) {
+  bool first = false;
+  auto future = wait(batches_, batch_id, first);
+  if (first) {
+    fallback_.batch(batch_id, [this, batch_id](Batch batch, std::exception_ptr error) {
+      settle(batches_, batch_id, std::move(batch), error);
+    });
+  }
+  return future;
+}
+
+std::future<FineTuningJob> WebhookWaiterRegistry::wait_for_fine_tuning_job(const std::string& job_id) {
+  bool first = false;
+  auto future = wait(jobs_, job_id, first);
+  if (first) {
+    fallback_.fine_tuning_job(job_id, [this, job_id](FineTuningJob job, std::exception_ptr error) {
+      settle(jobs_, job_id, std::move(job), error);
+    });
+  }
+  return future;
+}
+
+std::future<Response> WebhookWaiterRegistry::wait_for_response(const std::string& response_id) {
+  bool first = false;
+  auto future = wait(responses_, response_id, first);
+  if (first) {
+    fallback_.response(response_id, [this, response_id](Response response, std::exception_ptr error) {
+      settle(responses_, response_id, std::move(response), error);
+    });
+  }
+  return future;
+}
+
+webhooks::WebhookEvent WebhookWaiterRegistry::deliver(const std::string& payload,
+                                                      const std::map<std::string, std::string>& headers) {
+  auto event = client_.webhooks().unwrap(payload, headers, options_.verify);
+  deliver(event);
+  return event;
+}
+
+bool WebhookWaiterRegistry::deliver(const webhooks::WebhookEvent& event) {
+  using webhooks::EventType;
+  switch (event.type) {
+    case EventType::BatchCancelled:
+    case EventType::BatchCompleted:
+    case EventType::BatchExpired:
+    case EventType::BatchFailed: {
+      const auto* data = std::get_if<webhooks::BatchEventData>(&event.data);
+      if (data == nullptr || !is_waiting(batches_, data->id)) {
+        return false;
+      }
+      settle(batches_, data->id, client_.batches().retrieve(data->id), nullptr);
+      return true;
+    }
+    case EventType::FineTuningJobCancelled:
+    case EventType::FineTuningJobFailed:
+    case EventType::FineTuningJobSucceeded: {
+      const auto* data = std::get_if<webhooks::FineTuningJobEventData>(&event.data);
+      if (data == nullptr || !is_waiting(jobs_, data->id)) {
+        return false;
+      }
+      settle(jobs_, data->id, client_.fine_tuning().jobs().retrieve(data->id), nullptr);
+      return true;
+    }
+    case EventType::ResponseCancelled:
+    case EventType::ResponseCompleted:
+    case EventType::ResponseFailed:
+    case EventType::ResponseIncomplete: {
+      const auto* data = std::get_if<webhooks::ResponseEventData>(&event.data);
+      if (data == nullptr || !is_waiting(responses_, data->id)) {
+        return false;
+      }
+      settle(responses_, data->id, client_.responses().retrieve(data->id), nullptr);
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+std::size_t WebhookWaiterRegistry::waiting() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return batches_.size() + jobs_.size() + responses_.size();
+}
+
+template <typename T>
+std::future<T> WebhookWaiterRegistry::wait(Waiters<T>& waiters, const std::string& id, bool& first) {
+  auto promise = std::make_shared<std::promise<T>>();
+  auto future = promise->get_future();
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& pending = waiters[id];
+  // Only the first waiter on an object starts a fallback poll; later ones share it.
+  first = pending.empty();
+  pending.push_back(std::move(promise));
+  return future;
+}
+
+template <typename T>
+bool WebhookWaiterRegistry::is_waiting(const Waiters<T>& waiters, const std::string& id) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return waiters.count(id) != 0;
+}
+
+template <typename T>
+void WebhookWaiterRegistry::settle(Waiters<T>& waiters, const std::string& id, T value, std::exception_ptr error) {
+  if (error && is_transient_error(error)) {
+    // Says nothing about the object, and its webhook may still arrive; the waiters stay registered.
+    return;
+  }
+  std::vector<std::shared_ptr<std::promise<T>>> pending;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = waiters.find(id);
+    if (it == waiters.end()) {
+      // Already resolved by the other path; a fallback poll still in flight ends here.
+      return;
+    }
+    pending = std::move(it->second);
+    waiters.erase(it);
+  }
+  for (const auto& promise : pending) {
+    if (error) {
+      promise->set_exception(error);
+    } else {
+      promise->set_value(value);
+    }
+  }
+}
+
+}  // namespace openai
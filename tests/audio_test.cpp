@@ -4,8 +4,11 @@
 #include "openai/audio.hpp"
 #include "support/mock_http_client.hpp"
 
+#include <chrono>
 #include <filesystem>
 #include <fstream>
+#include <sstream>
+#include <vector>
 
 namespace oait = openai::testing;
 
@@ -169,3 +172,245 @@ TEST(AudioSpeechResourceTest, CreateReturnsBinaryAudio) {
   ASSERT_TRUE(mock_ptr->last_request().has_value());
   EXPECT_EQ(mock_ptr->last_request()->headers.at("Accept"), "application/octet-stream");
 }
+
+TEST(AudioSpeechResourceTest, CreateStreamsAudioToSink) {
+  using namespace openai;
+
+  auto mock_client = std::make_unique<oait::MockHttpClient>();
+  auto* mock_ptr = mock_client.get();
+  mock_ptr->enqueue_response(HttpResponse{200, {{"Content-Type", "audio/mpeg"}}, std::string("ID3-AUDIO")});
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+  OpenAIClient client(options, std::move(mock_client));
+
+  SpeechRequest request;
+  request.input = "Hello world";
+  request.model = "tts-1";
+  request.voice = "alloy";
+
+  std::ostringstream out("prefix:", std::ios::ate);
+  DownloadOptions download;
+  download.checksum = DownloadChecksum::SHA256;
+  auto result = client.audio().speech().create(request, DownloadSink::stream(out), download);
+  EXPECT_EQ(out.str(), "prefix:ID3-AUDIO");
+  EXPECT_EQ(result.bytes, 9u);
+  ASSERT_TRUE(result.checksum.has_value());
+  EXPECT_EQ(result.checksum->size(), 64u);
+  EXPECT_EQ(result.headers.at("Content-Type"), "audio/mpeg");
+  EXPECT_FALSE(mock_ptr->last_request()->collect_body);
+  EXPECT_EQ(nlohmann::json::parse(mock_ptr->last_request()->body).at("voice"), "alloy");
+}
+
+TEST(AudioSpeechResourceTest, StreamDeliversChunksAsTheyArrive) {
+  using namespace openai;
+
+  // Delivers the body in pieces, the way a slow synthesis arrives over the wire.
+  class ChunkedHttpClient final : public HttpClient {
+  public:
+    HttpResponse request(const HttpRequest& request) override {
+      last_request = request;
+      request.on_status(200);
+      for (const std::string piece : {"RIFF", "fmt ", "data"}) {
+        request.on_chunk(piece.data(), piece.size());
+      }
+      return HttpResponse{200, {{"Content-Type", "audio/wav"}}, ""};
+    }
+    std::optional<HttpRequest> last_request;
+  };
+
+  auto http = std::make_unique<ChunkedHttpClient>();
+  auto* http_ptr = http.get();
+  ClientOptions options;
+  options.api_key = "sk-test";
+  OpenAIClient client(options, std::move(http));
+
+  SpeechRequest request;
+  request.input = "Hello world";
+  request.model = "gpt-4o-mini-tts";
+  request.voice = "alloy";
+  request.response_format = "wav";
+
+  std::string audio;
+  std::vector<std::size_t> indexes;
+  std::chrono::nanoseconds last_elapsed{0};
+  auto result = client.audio().speech().stream(request, [&](const SpeechAudioChunk& chunk) {
+    audio.append(reinterpret_cast<const char*>(chunk.data), chunk.size);
+    indexes.push_back(chunk.index);
+    EXPECT_GE(chunk.elapsed, last_elapsed);
+    last_elapsed = chunk.elapsed;
+    return true;
+  });
+  EXPECT_EQ(audio, "RIFFfmt data");
+  EXPECT_EQ(indexes, (std::vector<std::size_t>{0, 1, 2}));
+  EXPECT_EQ(result.chunks, 3u);
+  EXPECT_EQ(result.bytes, 12u);
+  ASSERT_TRUE(result.time_to_first_audio.has_value());
+  EXPECT_LE(*result.time_to_first_audio, last_elapsed);
+  EXPECT_FALSE(result.stopped);
+  EXPECT_EQ(result.headers.at("Content-Type"), "audio/wav");
+  EXPECT_FALSE(http_ptr->last_request->collect_body);
+  EXPECT_EQ(http_ptr->last_request->headers.at("Accept"), "application/octet-stream");
+
+  // Returning false ends the stream without an error.
+  std::size_t seen = 0;
+  result = client.audio().speech().stream(request, [&](const SpeechAudioChunk&) {
+    ++seen;
+    return false;
+  });
+  EXPECT_EQ(seen, 1u);
+  EXPECT_TRUE(result.stopped);
+  EXPECT_EQ(result.bytes, 4u);
+}
+
+TEST(AudioSpeechResourceTest, StreamDecodesSseAudioDeltas) {
+  using namespace openai;
+
+  auto mock_client = std::make_unique<oait::MockHttpClient>();
+  auto* mock_ptr = mock_client.get();
+  const std::string sse =
+      "data: {\"type\":\"speech.audio.delta\",\"audio\":\"AQJQQ00=\"}\n\n"
+      "data: {\"type\":\"speech.audio.delta\",\"audio\":\"AwQF\"}\n\n"
+      "data: {\"type\":\"speech.audio.done\",\"usage\":{\"input_tokens\":4,\"output_tokens\":20,\"total_tokens\":24}}\n\n";
+  mock_ptr->enqueue_response(HttpResponse{200, {{"Content-Type", "text/event-stream"}}, sse});
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+  OpenAIClient client(options, std::move(mock_client));
+
+  SpeechRequest request;
+  request.input = "Hello world";
+  request.model = "gpt-4o-mini-tts";
+  request.voice = "alloy";
+  request.response_format = "pcm";
+  request.stream_format = "sse";
+
+  std::vector<std::uint8_t> pcm;
+  auto result = client.audio().speech().stream(request, [&](const SpeechAudioChunk& chunk) {
+    pcm.insert(pcm.end(), chunk.data, chunk.data + chunk.size);
+    return true;
+  });
+  EXPECT_EQ(pcm, (std::vector<std::uint8_t>{1, 2, 'P', 'C', 'M', 3, 4, 5}));
+  EXPECT_EQ(result.chunks, 2u);
+  EXPECT_EQ(result.bytes, 8u);
+  ASSERT_TRUE(result.usage.has_value());
+  EXPECT_EQ(result.usage->output_tokens, 20);
+  EXPECT_EQ(result.usage->total_tokens, 24);
+
+  const auto& sent = *mock_ptr->last_request();
+  EXPECT_EQ(sent.headers.at("Accept"), "text/event-stream");
+  EXPECT_EQ(nlohmann::json::parse(sent.body).at("stream_format"), "sse");
+}
+
+TEST(AudioTranscriptionsResourceTest, CreateStreamParsesTranscriptEvents) {
+  using namespace openai;
+
+  // Takes segmented bodies like the curl client and answers with an SSE transcript.
+  class TranscriptHttpClient final : public HttpClient {
+  public:
+    HttpResponse request(const HttpRequest& request) override {
+      last_request = request;
+      const std::string sse =
+          "data: {\"type\":\"transcript.text.delta\",\"delta\":\"Hello\",\"logprobs\":[{\"token\":\"Hello\",\"logprob\":-0.1}]}\n\n"
+          "data: {\"type\":\"transcript.text.delta\",\"delta\":\" wor\"}\n\n"
+          "data: {\"type\":\"transcript.text.delta\",\"delta\":\"ld\"}\n\n"
+          "data: {\"type\":\"transcript.text.done\",\"text\":\"Hello world.\",\"usage\":{\"type\":\"tokens\",\"input_tokens\":14,\"output_tokens\":3,\"total_tokens\":17}}\n\n";
+      if (request.on_status) {
+        request.on_status(200);
+      }
+      // Split mid-event to exercise the incremental parser.
+      request.on_chunk(sse.data(), 40);
+      request.on_chunk(sse.data() + 40, sse.size() - 40);
+      return HttpResponse{200, {}, ""};
+    }
+    bool supports_body_segments() const override { return true; }
+    std::optional<HttpRequest> last_request;
+  };
+
+  auto http = std::make_unique<TranscriptHttpClient>();
+  auto* http_ptr = http.get();
+  ClientOptions options;
+  options.api_key = "sk-test";
+  OpenAIClient client(options, std::move(http));
+
+  std::filesystem::path tmp = std::filesystem::temp_directory_path() / "openai-cpp-audio-stream.wav";
+  const std::string audio(utils::kMapUploadThreshold + 1, 'a');
+  {
+    std::ofstream out(tmp, std::ios::binary);
+    out << audio;
+  }
+
+  TranscriptionRequest request;
+  request.file.file_path = tmp.string();
+  request.model = "gpt-4o-transcribe";
+
+  std::vector<std::string> partials;
+  TranscriptionStreamAccumulator mirror;
+  auto transcript = client.audio().transcriptions().create_stream(request, [&](const TranscriptionStreamEvent& event) {
+    mirror.add(event);
+    if (event.type == TranscriptionStreamEvent::Type::TextDelta) {
+      partials.push_back(mirror.text());
+    }
+    return true;
+  });
+  EXPECT_EQ(partials, (std::vector<std::string>{"Hello", "Hello wor", "Hello world"}));
+  EXPECT_TRUE(mirror.done());
+  EXPECT_EQ(transcript.text, "Hello world.");
+  ASSERT_TRUE(transcript.usage.has_value());
+  EXPECT_EQ(transcript.usage->total_tokens, 17);
+  ASSERT_TRUE(transcript.logprobs.has_value());
+  EXPECT_EQ(transcript.logprobs->front().token, "Hello");
+
+  // The audio goes out as its own segment of the multipart body instead of being copied into it.
+  const auto& sent = *http_ptr->last_request;
+  EXPECT_EQ(sent.headers.at("Accept"), "text/event-stream");
+  EXPECT_TRUE(sent.body.empty());
+  ASSERT_TRUE(sent.body_segments);
+  ASSERT_EQ(sent.body_segments->segments.size(), 3u);
+  EXPECT_EQ(sent.body_segments->segments[1], audio);
+  EXPECT_NE(sent.body_segments->segments[2].find("name=\"stream\"\r\n\r\ntrue"), std::string::npos);
+
+  // Stopping early returns the transcript accumulated so far.
+  transcript = client.audio().transcriptions().create_stream(request, [](const TranscriptionStreamEvent& event) {
+    return event.type != TranscriptionStreamEvent::Type::TextDelta;
+  });
+  EXPECT_EQ(transcript.text, "Hello");
+
+  std::filesystem::remove(tmp);
+}
+
+TEST(AudioTranscriptionsResourceTest, CreateStreamKeepsErrorBodiesOutOfTheParser) {
+  using namespace openai;
+
+  auto mock_client = std::make_unique<oait::MockHttpClient>();
+  auto* mock_ptr = mock_client.get();
+  // A gateway error body that happens to be framed like an event must not reach the handler.
+  mock_ptr->enqueue_response(
+      HttpResponse{400, {}, "data: {\"type\":\"transcript.text.delta\",\"delta\":\"Invalid file format.\"}\n\n"});
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+  OpenAIClient client(options, std::move(mock_client));
+
+  std::filesystem::path tmp = std::filesystem::temp_directory_path() / "openai-cpp-audio-stream-error.wav";
+  {
+    std::ofstream out(tmp, std::ios::binary);
+    out << "audio";
+  }
+
+  TranscriptionRequest request;
+  request.file.file_path = tmp.string();
+  request.model = "gpt-4o-transcribe";
+
+  std::size_t events = 0;
+  EXPECT_THROW(client.audio().transcriptions().create_stream(request,
+                                                             [&](const TranscriptionStreamEvent&) {
+                                                               ++events;
+                                                               return true;
+                                                             }),
+               BadRequestError);
+  EXPECT_EQ(events, 0u);
+  EXPECT_EQ(mock_ptr->call_count(), 1u);
+
+  std::filesystem::remove(tmp);
+}
@@ -1,7 +1,16 @@
 #include <gtest/gtest.h>
 
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
 #include <nlohmann/json.hpp>
 
+#include "openai/batch_input.hpp"
+#include "openai/batch_job.hpp"
+#include "openai/batch_results.hpp"
+#include "openai/local_batch.hpp"
 #include "openai/batches.hpp"
 #include "openai/client.hpp"
 #include "support/mock_http_client.hpp"
@@ -157,3 +166,531 @@ TEST(BatchesResourceTest, CancelPostsToEndpoint) {
   EXPECT_TRUE(payload.is_object());
   EXPECT_TRUE(payload.empty());
 }
+
+namespace {
+
+std::vector<nlohmann::json> read_jsonl(const std::string& path) {
+  std::ifstream in(path);
+  std::vector<nlohmann::json> lines;
+  std::string line;
+  while (std::getline(in, line)) {
+    lines.push_back(nlohmann::json::parse(line));
+  }
+  return lines;
+}
+
+openai::ChatCompletionRequest chat_request(const std::string& text) {
+  openai::ChatCompletionRequest request;
+  request.model = "gpt-4o-mini";
+  openai::ChatMessage message;
+  message.role = "user";
+  openai::ChatMessageContent content;
+  content.type = openai::ChatMessageContent::Type::Text;
+  content.text = text;
+  message.content.push_back(content);
+  request.messages.push_back(message);
+  return request;
+}
+
+std::string batch_output_line(const std::string& custom_id, const std::string& text) {
+  nlohmann::json body = {{"id", "chatcmpl-" + custom_id},
+                         {"object", "chat.completion"},
+                         {"model", "gpt-4o-mini"},
+                         {"choices",
+                          {{{"index", 0},
+                            {"finish_reason", "stop"},
+                            {"message", {{"role", "assistant"}, {"content", text}}}}}}};
+  nlohmann::json line = {{"id", "batch_req_" + custom_id},
+                         {"custom_id", custom_id},
+                         {"response", {{"status_code", 200}, {"request_id", "req_" + custom_id}, {"body", body}}},
+                         {"error", nullptr}};
+  return line.dump() + "\n";
+}
+
+openai::HttpResponse json_response(const nlohmann::json& body) {
+  return openai::HttpResponse{200, {}, body.dump()};
+}
+
+nlohmann::json batch_json(const std::string& id, const std::string& status, const nlohmann::json& extra = {}) {
+  nlohmann::json batch = {{"id", id},
+                          {"object", "batch"},
+                          {"endpoint", "/v1/chat/completions"},
+                          {"input_file_id", "file_" + id},
+                          {"completion_window", "24h"},
+                          {"created_at", 1700000000},
+                          {"status", status}};
+  if (extra.is_object()) {
+    batch.update(extra);
+  }
+  return batch;
+}
+
+}  // namespace
+
+TEST(BatchInputWriterTest, RollsShardsOverAtLineLimitAndEndpointChange) {
+  using namespace openai;
+
+  const auto directory = std::filesystem::temp_directory_path() / "openai-cpp-batch-input";
+  std::filesystem::remove_all(directory);
+  BatchInputOptions options;
+  options.directory = directory.string();
+  options.max_lines = 2;
+
+  BatchInputWriter writer(options);
+  for (int i = 0; i < 3; ++i) {
+    writer.add("chat-" + std::to_string(i), chat_request("question " + std::to_string(i)));
+  }
+  EmbeddingRequest embedding;
+  embedding.model = "text-embedding-3-small";
+  embedding.input = std::string("hello");
+  writer.add("embed-0", embedding);
+  EXPECT_THROW(writer.add("embed-0", embedding), OpenAIError);
+
+  const auto& shards = writer.finish();
+  ASSERT_EQ(shards.size(), 3u);
+  EXPECT_EQ(shards[0].endpoint, "/v1/chat/completions");
+  EXPECT_EQ(shards[0].lines, 2u);
+  EXPECT_EQ(shards[1].lines, 1u);
+  EXPECT_EQ(shards[2].endpoint, "/v1/embeddings");
+  EXPECT_EQ(shards[2].lines, 1u);
+  EXPECT_EQ(std::filesystem::file_size(shards[0].path), shards[0].bytes);
+
+  const auto first = read_jsonl(shards[0].path);
+  ASSERT_EQ(first.size(), 2u);
+  EXPECT_EQ(first[1].at("custom_id"), "chat-1");
+  EXPECT_EQ(first[1].at("method"), "POST");
+  EXPECT_EQ(first[1].at("url"), "/v1/chat/completions");
+  EXPECT_EQ(first[1].at("body").at("model"), "gpt-4o-mini");
+  EXPECT_EQ(first[1].at("body").at("messages")[0].at("role"), "user");
+  EXPECT_FALSE(first[1].at("body").contains("stream"));
+
+  const auto last = read_jsonl(shards[2].path);
+  ASSERT_EQ(last.size(), 1u);
+  EXPECT_EQ(last[0].at("body").at("input"), "hello");
+  EXPECT_FALSE(last[0].at("body").contains("encoding_format"));
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(BatchInputWriterTest, RollsShardsOverAtByteLimitAndUploadsThem) {
+  using namespace openai;
+
+  auto http_mock = std::make_unique<oait::MockHttpClient>();
+  auto* mock_ptr = http_mock.get();
+  ClientOptions client_options;
+  client_options.api_key = "sk-test";
+  OpenAIClient client(std::move(client_options), std::move(http_mock));
+
+  const auto directory = std::filesystem::temp_directory_path() / "openai-cpp-batch-upload";
+  std::filesystem::remove_all(directory);
+  BatchInputOptions options;
+  options.directory = directory.string();
+  options.prefix = "eval";
+  options.max_file_bytes = 400;
+
+  BatchInputWriter writer(options);
+  writer.add("a", chat_request(std::string(150, 'a')));
+  writer.add("b", chat_request(std::string(150, 'b')));
+  EXPECT_THROW(writer.add("c", chat_request(std::string(500, 'c'))), OpenAIError);
+  ASSERT_EQ(writer.shards().size(), 2u);
+  EXPECT_LE(writer.shards()[0].bytes, options.max_file_bytes);
+  EXPECT_NE(writer.shards()[1].path.find("eval-00001.jsonl"), std::string::npos);
+
+  mock_ptr->enqueue_response(HttpResponse{200, {}, R"({"id":"file_1","object":"file","purpose":"batch"})"});
+  mock_ptr->enqueue_response(HttpResponse{200, {}, R"({"id":"file_2","object":"file","purpose":"batch"})"});
+  const auto files = writer.upload(client.files());
+  ASSERT_EQ(files.size(), 2u);
+  EXPECT_EQ(files[0].id, "file_1");
+  EXPECT_EQ(files[1].id, "file_2");
+
+  const auto& http_request = *mock_ptr->last_request();
+  EXPECT_NE(http_request.url.find("/files"), std::string::npos);
+  EXPECT_NE(http_request.body.find("name=\"purpose\"\r\n\r\nbatch"), std::string::npos);
+  EXPECT_NE(http_request.body.find(std::string(150, 'b')), std::string::npos);
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(BatchInputWriterTest, DefaultDirectoryIsUniquePerWriter) {
+  using namespace openai;
+
+  BatchInputWriter first;
+  BatchInputWriter second;
+  first.add("a", chat_request("first"));
+  second.add("a", chat_request("second"));
+  const auto first_path = first.finish().front().path;
+  const auto second_path = second.finish().front().path;
+
+  EXPECT_NE(first_path, second_path);
+  EXPECT_NE(read_jsonl(first_path).front().at("body").dump().find("first"), std::string::npos);
+  EXPECT_NE(read_jsonl(second_path).front().at("body").dump().find("second"), std::string::npos);
+
+  std::filesystem::remove_all(std::filesystem::path(first_path).parent_path());
+  std::filesystem::remove_all(std::filesystem::path(second_path).parent_path());
+}
+
+TEST(BatchResultReaderTest, StreamsOutputFileAndLooksUpResultsThroughIndex) {
+  using namespace openai;
+
+  auto http_mock = std::make_unique<oait::MockHttpClient>();
+  auto* mock_ptr = http_mock.get();
+  ClientOptions client_options;
+  client_options.api_key = "sk-test";
+  OpenAIClient client(std::move(client_options), std::move(http_mock));
+
+  const std::string failed =
+      R"({"id":"batch_req_c","custom_id":"c","response":{"status_code":400,"request_id":"req_c",)"
+      R"("body":{"error":{"message":"bad model"}}},"error":null})"
+      "\n";
+  const std::string file = batch_output_line("a", "first") + batch_output_line("b", "second") + failed;
+  mock_ptr->enqueue_response(HttpResponse{200, {}, file});
+
+  const auto directory = std::filesystem::temp_directory_path() / "openai-cpp-batch-results";
+  std::filesystem::create_directories(directory);
+  BatchResultReaderOptions options;
+  options.output_path = (directory / "output.jsonl").string();
+  options.index_path = (directory / "output.idx").string();
+
+  std::vector<BatchResult> results;
+  BatchResultReader::read(
+      client.files(), "file-out", [&](const BatchResult& result) { results.push_back(result); }, options);
+  EXPECT_NE(mock_ptr->last_request()->url.find("/files/file-out/content"), std::string::npos);
+
+  ASSERT_EQ(results.size(), 3u);
+  EXPECT_TRUE(results[0].ok());
+  EXPECT_EQ(results[0].request_id, "req_a");
+  const auto completion = results[1].chat_completion();
+  EXPECT_EQ(completion.id, "chatcmpl-b");
+  ASSERT_EQ(completion.choices.size(), 1u);
+  EXPECT_FALSE(results[2].ok());
+  EXPECT_EQ(results[2].status_code, 400);
+  try {
+    results[2].chat_completion();
+    FAIL() << "expected the failed line to throw";
+  } catch (const OpenAIError& error) {
+    EXPECT_NE(std::string(error.what()).find("bad model"), std::string::npos);
+  }
+  EXPECT_EQ(results[1].offset, batch_output_line("a", "first").size());
+
+  EXPECT_EQ(std::filesystem::file_size(*options.output_path), file.size());
+  const auto index = BatchResultIndex::open(*options.index_path, *options.output_path);
+  EXPECT_EQ(index.size(), 3u);
+  const auto found = index.find("b");
+  ASSERT_TRUE(found.has_value());
+  EXPECT_EQ(found->chat_completion().id, "chatcmpl-b");
+  EXPECT_EQ(found->offset, results[1].offset);
+  ASSERT_TRUE(index.find("c").has_value());
+  EXPECT_FALSE(index.find("missing").has_value());
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(BatchResultReaderTest, SplitsLinesAcrossChunksAndSkipsDeliveredLinesAfterRestart) {
+  using namespace openai;
+
+  std::string file;
+  for (int i = 0; i < 50; ++i) {
+    file += batch_output_line("id-" + std::to_string(i), std::string(static_cast<std::size_t>(i), 'x'));
+  }
+  // The final line has no trailing newline.
+  file.pop_back();
+
+  std::vector<std::string> ids;
+  BatchResultReader reader([&](const BatchResult& result) { ids.push_back(result.custom_id); });
+  for (std::size_t offset = 0; offset < file.size() / 2; offset += 7) {
+    reader.feed(file.data() + offset, std::min<std::size_t>(7, file.size() / 2 - offset));
+  }
+  const std::size_t before_restart = ids.size();
+  EXPECT_GT(before_restart, 0u);
+  reader.restart();
+  for (std::size_t offset = 0; offset < file.size(); offset += 13) {
+    reader.feed(file.data() + offset, std::min<std::size_t>(13, file.size() - offset));
+  }
+  reader.finish();
+  ASSERT_EQ(ids.size(), 50u);
+  for (int i = 0; i < 50; ++i) {
+    EXPECT_EQ(ids[static_cast<std::size_t>(i)], "id-" + std::to_string(i));
+  }
+
+  const auto directory = std::filesystem::temp_directory_path() / "openai-cpp-batch-read-file";
+  std::filesystem::create_directories(directory);
+  const auto path = (directory / "results.jsonl").string();
+  const auto index_path = (directory / "results.idx").string();
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << file;
+  }
+  std::size_t count = 0;
+  BatchResultReader::read_file(path, [&](const BatchResult&) { ++count; }, index_path);
+  EXPECT_EQ(count, 50u);
+  const auto index = BatchResultIndex::open(index_path, path);
+  for (int i = 0; i < 50; ++i) {
+    const auto result = index.find("id-" + std::to_string(i));
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(result->chat_completion().id, "chatcmpl-id-" + std::to_string(i));
+    EXPECT_EQ(result->body.at("choices")[0].at("message").at("content"), std::string(static_cast<std::size_t>(i), 'x'));
+  }
+  std::filesystem::remove_all(directory);
+}
+
+TEST(BatchJobTest, ShardsSubmitsPollsAndResubmitsExpiredLines) {
+  using namespace openai;
+
+  auto http_mock = std::make_unique<oait::MockHttpClient>();
+  auto* mock_ptr = http_mock.get();
+  ClientOptions client_options;
+  client_options.api_key = "sk-test";
+  client_options.max_retries = 0;
+  OpenAIClient client(std::move(client_options), std::move(http_mock));
+
+  const auto directory = std::filesystem::temp_directory_path() / "openai-cpp-batch-job";
+  std::filesystem::remove_all(directory);
+  BatchJobOptions options;
+  options.input.directory = directory.string();
+  options.input.prefix = "job";
+  options.input.max_lines = 2;
+  options.max_concurrent_uploads = 1;
+  options.poll_interval = std::chrono::milliseconds(0);
+  std::vector<std::string> updates;
+  options.on_batch_update = [&](const Batch& batch) { updates.push_back(batch.id + ":" + batch.status); };
+
+  BatchJob job(client, options);
+  job.add("a", chat_request("one"));
+  job.add("b", chat_request("two"));
+  job.add("c", chat_request("three"));
+
+  const std::string expired_b =
+      R"({"id":"batch_req_b","custom_id":"b","response":null,)"
+      R"("error":{"code":"batch_expired","message":"This request could not be executed before the completion window expired."}})"
+      "\n";
+  mock_ptr->enqueue_response(json_response({{"id", "file_in_a"}, {"object", "file"}, {"purpose", "batch"}}));
+  mock_ptr->enqueue_response(json_response(batch_json("batch_a", "validating")));
+  mock_ptr->enqueue_response(json_response({{"id", "file_in_b"}, {"object", "file"}, {"purpose", "batch"}}));
+  mock_ptr->enqueue_response(json_response(batch_json("batch_b", "validating")));
+  mock_ptr->enqueue_response(
+      json_response(batch_json("batch_a", "expired", {{"output_file_id", "out_a"}, {"error_file_id", "err_a"}})));
+  mock_ptr->enqueue_response(HttpResponse{200, {}, batch_output_line("a", "one")});
+  mock_ptr->enqueue_response(HttpResponse{200, {}, expired_b});
+  mock_ptr->enqueue_response(json_response(batch_json("batch_b", "completed", {{"output_file_id", "out_b"}})));
+  mock_ptr->enqueue_response(HttpResponse{200, {}, batch_output_line("c", "three")});
+  mock_ptr->enqueue_response(json_response({{"id", "file_in_r"}, {"object", "file"}, {"purpose", "batch"}}));
+  mock_ptr->enqueue_response(json_response(batch_json("batch_r", "validating")));
+  mock_ptr->enqueue_response(json_response(batch_json("batch_r", "completed", {{"output_file_id", "out_r"}})));
+  mock_ptr->enqueue_response(HttpResponse{200, {}, batch_output_line("b", "two")});
+
+  std::vector<std::string> finished;
+  const auto summary = job.run([&](const BatchResult& result) {
+    EXPECT_TRUE(result.ok());
+    finished.push_back(result.custom_id);
+  });
+
+  EXPECT_EQ(finished, (std::vector<std::string>{"a", "c", "b"}));
+  EXPECT_EQ(summary.succeeded, 3u);
+  EXPECT_EQ(summary.failed, 0u);
+  EXPECT_EQ(summary.resubmitted, 1u);
+  ASSERT_EQ(summary.batches.size(), 3u);
+  EXPECT_EQ(summary.batches[2].id, "batch_r");
+  EXPECT_EQ(updates, (std::vector<std::string>{"batch_a:expired", "batch_b:completed", "batch_r:completed"}));
+  EXPECT_EQ(mock_ptr->call_count(), 13u);
+
+  const auto retried = read_jsonl((directory / "job-retry-0-00000.jsonl").string());
+  ASSERT_EQ(retried.size(), 1u);
+  EXPECT_EQ(retried[0].at("custom_id"), "b");
+  EXPECT_EQ(retried[0].at("body"), read_jsonl((directory / "job-00000.jsonl").string())[1].at("body"));
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(BatchJobTest, ReportsEveryLineOfAFailedBatch) {
+  using namespace openai;
+
+  auto http_mock = std::make_unique<oait::MockHttpClient>();
+  auto* mock_ptr = http_mock.get();
+  ClientOptions client_options;
+  client_options.api_key = "sk-test";
+  OpenAIClient client(std::move(client_options), std::move(http_mock));
+
+  const auto directory = std::filesystem::temp_directory_path() / "openai-cpp-batch-job-failed";
+  std::filesystem::remove_all(directory);
+  BatchJobOptions options;
+  options.input.directory = directory.string();
+  options.poll_interval = std::chrono::milliseconds(0);
+
+  BatchJob job(client, options);
+  job.add("a", chat_request("one"));
+  job.add("b", chat_request("two"));
+
+  mock_ptr->enqueue_response(json_response({{"id", "file_in"}, {"object", "file"}, {"purpose", "batch"}}));
+  mock_ptr->enqueue_response(json_response(batch_json("batch_f", "validating")));
+  mock_ptr->enqueue_response(json_response(batch_json("batch_f", "in_progress")));
+  mock_ptr->enqueue_response(json_response(batch_json(
+      "batch_f",
+      "failed",
+      {{"errors", {{"object", "list"}, {"data", {{{"code", "invalid_model"}, {"message", "Unknown model"}}}}}}})));
+
+  std::vector<BatchResult> results;
+  const auto summary = job.start([&](const BatchResult& result) { results.push_back(result); }).get();
+
+  EXPECT_EQ(summary.failed, 2u);
+  EXPECT_EQ(summary.resubmitted, 0u);
+  ASSERT_EQ(results.size(), 2u);
+  EXPECT_EQ(results[0].custom_id, "a");
+  ASSERT_TRUE(results[1].error.has_value());
+  EXPECT_EQ(results[1].error->code, "invalid_model");
+  EXPECT_THROW(results[1].chat_completion(), OpenAIError);
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(BatchJobTest, PollsThroughTransientErrorsAndRunsOnce) {
+  using namespace openai;
+
+  auto http_mock = std::make_unique<oait::MockHttpClient>();
+  auto* mock_ptr = http_mock.get();
+  ClientOptions client_options;
+  client_options.api_key = "sk-test";
+  client_options.max_retries = 0;
+  OpenAIClient client(std::move(client_options), std::move(http_mock));
+
+  const auto directory = std::filesystem::temp_directory_path() / "openai-cpp-batch-job-transient";
+  std::filesystem::remove_all(directory);
+  BatchJobOptions options;
+  options.input.directory = directory.string();
+  options.poll_interval = std::chrono::milliseconds(0);
+
+  BatchJob job(client, options);
+  job.add("a", chat_request("one"));
+
+  mock_ptr->enqueue_response(json_response({{"id", "file_in"}, {"object", "file"}, {"purpose", "batch"}}));
+  mock_ptr->enqueue_response(json_response(batch_json("batch_t", "validating")));
+  mock_ptr->enqueue_error("connection reset");
+  mock_ptr->enqueue_response(HttpResponse{503, {}, R"({"error":{"message":"overloaded"}})"});
+  mock_ptr->enqueue_response(json_response(batch_json("batch_t", "cancelled")));
+
+  std::vector<BatchResult> results;
+  const auto summary = job.run([&](const BatchResult& result) { results.push_back(result); });
+  EXPECT_EQ(mock_ptr->call_count(), 5u);
+  ASSERT_EQ(summary.batches.size(), 1u);
+  EXPECT_EQ(summary.batches[0].status, "cancelled");
+  ASSERT_EQ(results.size(), 1u);
+  EXPECT_EQ(results[0].custom_id, "a");
+
+  // The shards were submitted already; running the job again must not submit them twice.
+  EXPECT_THROW(job.run([](const BatchResult&) {}), OpenAIError);
+  EXPECT_THROW(job.start([](const BatchResult&) {}), OpenAIError);
+  EXPECT_EQ(mock_ptr->call_count(), 5u);
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(LocalBatchExecutorTest, WritesBatchFormattedResultsAndResumes) {
+  using namespace openai;
+
+  auto http_mock = std::make_unique<oait::MockHttpClient>();
+  auto* mock_ptr = http_mock.get();
+  ClientOptions client_options;
+  client_options.api_key = "sk-test";
+  client_options.max_retries = 0;
+  OpenAIClient client(std::move(client_options), std::move(http_mock));
+
+  const auto directory = std::filesystem::temp_directory_path() / "openai-cpp-local-batch";
+  std::filesystem::remove_all(directory);
+  BatchInputOptions input_options;
+  input_options.directory = directory.string();
+  BatchInputWriter writer(input_options);
+  writer.add("a", chat_request("one"));
+  writer.add("b", chat_request("two"));
+  writer.add("c", "/v1/images/generations", nlohmann::json{{"prompt", "cat"}});
+  const auto shards = writer.finish();
+  // Lines for another endpoint start their own shard; run them all from one file.
+  const auto input_path = (directory / "input.jsonl").string();
+  {
+    std::ofstream input(input_path, std::ios::binary);
+    for (const auto& shard : shards) {
+      std::ifstream in(shard.path, std::ios::binary);
+      input << in.rdbuf();
+    }
+  }
+  const auto output_path = (directory / "output.jsonl").string();
+  const auto error_path = (directory / "errors.jsonl").string();
+
+  nlohmann::json completion = {{"id", "chatcmpl-a"}, {"object", "chat.completion"}, {"model", "gpt-4o-mini"}};
+  mock_ptr->enqueue_response(HttpResponse{200, {{"x-request-id", "req_a"}}, completion.dump()});
+  mock_ptr->enqueue_response(HttpResponse{400, {}, R"({"error":{"message":"bad input","type":"invalid_request_error"}})"});
+
+  LocalBatchOptions options;
+  options.max_concurrency = 1;
+  LocalBatchExecutor executor(client, options);
+  auto summary = executor.run(input_path, output_path, error_path);
+  EXPECT_EQ(summary.total, 3u);
+  EXPECT_EQ(summary.succeeded, 1u);
+  EXPECT_EQ(summary.failed, 2u);
+  EXPECT_EQ(summary.skipped, 0u);
+  EXPECT_NE(mock_ptr->last_request()->url.find("/v1/chat/completions"), std::string::npos);
+
+  std::string first_line;
+  std::getline(std::ifstream(output_path), first_line);
+  EXPECT_EQ(first_line.rfind(R"({"id":"batch_req_)", 0), 0u);
+  EXPECT_NE(first_line.find(R"("custom_id":"a","response":{"status_code":200,"request_id":"req_a","body":{"id":"chatcmpl-a")"),
+            std::string::npos);
+
+  std::vector<BatchResult> errors;
+  BatchResultReader::read_file(error_path, [&](const BatchResult& result) { errors.push_back(result); });
+  ASSERT_EQ(errors.size(), 2u);
+  EXPECT_EQ(errors[0].custom_id, "b");
+  EXPECT_EQ(errors[0].status_code, 400);
+  EXPECT_EQ(errors[0].body.at("error").at("message"), "bad input");
+  EXPECT_EQ(errors[1].custom_id, "c");
+  ASSERT_TRUE(errors[1].error.has_value());
+  EXPECT_EQ(errors[1].error->code, "invalid_request");
+
+  // A crash mid-write leaves a torn line; resuming drops it and runs only the lines not yet recorded.
+  {
+    std::ofstream torn(output_path, std::ios::binary | std::ios::app);
+    torn << R"({"id":"batch_req_x","custom_id":"b","resp)";
+  }
+  std::filesystem::remove(error_path);
+  completion["id"] = "chatcmpl-b";
+  mock_ptr->enqueue_response(HttpResponse{200, {{"x-request-id", "req_b"}}, completion.dump()});
+  summary = executor.run(input_path, output_path, error_path);
+  EXPECT_EQ(summary.skipped, 1u);
+  EXPECT_EQ(summary.succeeded, 1u);
+  EXPECT_EQ(summary.failed, 1u);
+
+  std::vector<BatchResult> outputs;
+  BatchResultReader::read_file(output_path, [&](const BatchResult& result) { outputs.push_back(result); });
+  ASSERT_EQ(outputs.size(), 2u);
+  EXPECT_EQ(outputs[0].chat_completion().id, "chatcmpl-a");
+  EXPECT_EQ(outputs[1].chat_completion().id, "chatcmpl-b");
+  EXPECT_EQ(outputs[1].request_id, "req_b");
+
+  std::filesystem::remove_all(directory);
+}
+
+TEST(LocalBatchExecutorTest, PostsLinesRelativeToTheClientBaseUrl) {
+  using namespace openai;
+
+  auto http_mock = std::make_unique<oait::MockHttpClient>();
+  auto* mock_ptr = http_mock.get();
+  ClientOptions client_options;
+  client_options.api_key = "sk-test";
+  client_options.base_url = "https://gateway.example.com/openai";
+  OpenAIClient client(std::move(client_options), std::move(http_mock));
+
+  const auto directory = std::filesystem::temp_directory_path() / "openai-cpp-local-batch-base-url";
+  std::filesystem::remove_all(directory);
+  BatchInputOptions input_options;
+  input_options.directory = directory.string();
+  BatchInputWriter writer(input_options);
+  writer.add("a", "/v1/embeddings", nlohmann::json{{"model", "text-embedding-3-small"}, {"input", "hi"}});
+  const auto input_path = writer.finish().front().path;
+
+  mock_ptr->enqueue_response(HttpResponse{200, {}, R"({"object":"list","data":[]})"});
+  LocalBatchExecutor executor(client);
+  const auto summary = executor.run(input_path, (directory / "output.jsonl").string(),
+                                    (directory / "errors.jsonl").string());
+  EXPECT_EQ(summary.succeeded, 1u);
+  EXPECT_EQ(mock_ptr->last_request()->url, "https://gateway.example.com/openai/embeddings");
+
+  std::filesystem::remove_all(directory);
+}
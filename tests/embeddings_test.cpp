@@ -0,0 +1,376 @@
+#include <gtest/gtest.h>
+
+#include "openai/client.hpp"
+#include "openai/embedding_matrix.hpp"
+#include "openai/error.hpp"
+#include "support/mock_http_client.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+namespace {
+
+using json = nlohmann::json;
+
+// Answers /embeddings requests with one-element vectors holding each input's number ("item-7" -> 7),
+// in reverse order, so callers must rely on `index` to reassemble.
+class ShardingHttpClient final : public openai::HttpClient {
+public:
+  openai::HttpResponse request(const openai::HttpRequest& request) override {
+    const int now = ++in_flight_;
+    int seen = max_in_flight_.load();
+    while (now > seen && !max_in_flight_.compare_exchange_weak(seen, now)) {
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    const auto body = json::parse(request.body);
+    const auto& input = body.at("input");
+    openai::HttpResponse response;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ++calls_;
+      shard_sizes_.insert(input.size());
+      for (const auto& item : input) {
+        inputs_.push_back(item.get<std::string>());
+      }
+      const auto first = input.at(0).get<std::string>();
+      if (fail_once_ == first) {
+        fail_once_.clear();
+        response.status_code = fail_status_;
+        response.body = R"({"error":{"message":"try again"}})";
+        --in_flight_;
+        return response;
+      }
+    }
+
+    json data = json::array();
+    for (std::size_t i = input.size(); i-- > 0;) {
+      const int value = std::stoi(input.at(i).get<std::string>().substr(5));
+      data.push_back({{"object", "embedding"}, {"index", i}, {"embedding", {static_cast<double>(value)}}});
+    }
+    response.status_code = 200;
+    response.body = json{{"object", "list"},
+                         {"model", "text-embedding-3-small"},
+                         {"data", data},
+                         {"usage", {{"prompt_tokens", input.size()}, {"total_tokens", input.size()}}}}
+                        .dump();
+    --in_flight_;
+    return response;
+  }
+
+  void fail_once(const std::string& first_input, long status) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    fail_once_ = first_input;
+    fail_status_ = status;
+  }
+
+  std::atomic<int> in_flight_{0};
+  std::atomic<int> max_in_flight_{0};
+  std::mutex mutex_;
+  int calls_ = 0;
+  std::set<std::size_t> shard_sizes_;
+  std::vector<std::string> inputs_;
+  std::string fail_once_;
+  long fail_status_ = 500;
+};
+
+openai::EmbeddingRequest make_request(std::size_t count) {
+  openai::EmbeddingRequest request;
+  request.model = "text-embedding-3-small";
+  request.encoding_format = "float";
+  std::vector<std::string> inputs;
+  for (std::size_t i = 0; i < count; ++i) {
+    inputs.push_back("item-" + std::to_string(i));
+  }
+  request.input = std::move(inputs);
+  return request;
+}
+
+std::string encode_floats_base64(const std::vector<float>& values) {
+  static const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string bytes(values.size() * 4, '\0');
+  std::memcpy(bytes.data(), values.data(), bytes.size());
+  std::string out;
+  for (std::size_t i = 0; i < bytes.size(); i += 3) {
+    std::uint32_t triple = static_cast<std::uint8_t>(bytes[i]) << 16;
+    if (i + 1 < bytes.size()) triple |= static_cast<std::uint8_t>(bytes[i + 1]) << 8;
+    if (i + 2 < bytes.size()) triple |= static_cast<std::uint8_t>(bytes[i + 2]);
+    out += alphabet[(triple >> 18) & 0x3F];
+    out += alphabet[(triple >> 12) & 0x3F];
+    out += i + 1 < bytes.size() ? alphabet[(triple >> 6) & 0x3F] : '=';
+    out += i + 2 < bytes.size() ? alphabet[triple & 0x3F] : '=';
+  }
+  return out;
+}
+
+std::vector<float> test_row(std::size_t row, std::size_t dimensions) {
+  std::vector<float> values(dimensions);
+  for (std::size_t i = 0; i < dimensions; ++i) {
+    values[i] = std::sin(static_cast<float>(row * dimensions + i)) * 0.1f;
+  }
+  return values;
+}
+
+openai::HttpResponse matrix_response(std::size_t rows, std::size_t dimensions) {
+  json data = json::array();
+  for (std::size_t row = rows; row-- > 0;) {
+    data.push_back({{"object", "embedding"}, {"index", row}, {"embedding", encode_floats_base64(test_row(row, dimensions))}});
+  }
+  json body = {{"object", "list"}, {"model", "text-embedding-3-small"}, {"data", data},
+               {"usage", {{"prompt_tokens", 3}, {"total_tokens", 3}}}};
+  return openai::HttpResponse{200, {}, body.dump()};
+}
+
+openai::OpenAIClient make_client(ShardingHttpClient*& http,
+                                 std::shared_ptr<openai::EmbeddingCache> cache = nullptr) {
+  auto owned = std::make_unique<ShardingHttpClient>();
+  http = owned.get();
+  openai::ClientOptions options;
+  options.api_key = "sk-test";
+  options.max_retries = 0;
+  options.embedding_cache = std::move(cache);
+  return openai::OpenAIClient(options, std::move(owned));
+}
+
+std::vector<float> first_values(const openai::CreateEmbeddingResponse& response) {
+  std::vector<float> values;
+  for (const auto& embedding : response.data) {
+    values.push_back(std::get<std::vector<float>>(embedding.embedding).at(0));
+  }
+  return values;
+}
+
+}  // namespace
+
+TEST(EmbeddingsEmbedManyTest, ShardsConcurrentlyAndPreservesOrder) {
+  ShardingHttpClient* http = nullptr;
+  auto client = make_client(http);
+
+  openai::EmbedManyOptions batch_options;
+  batch_options.max_items_per_request = 10;
+  batch_options.max_concurrency = 3;
+  std::size_t last_progress = 0;
+  batch_options.on_progress = [&](std::size_t completed, std::size_t total) {
+    EXPECT_EQ(total, 95u);
+    EXPECT_GT(completed, last_progress);
+    last_progress = completed;
+  };
+
+  auto response = client.embeddings().embed_many(make_request(95), batch_options);
+
+  EXPECT_EQ(http->calls_, 10);
+  EXPECT_EQ(http->shard_sizes_, (std::set<std::size_t>{5, 10}));
+  EXPECT_GT(http->max_in_flight_.load(), 1);
+  EXPECT_LE(http->max_in_flight_.load(), 3);
+  EXPECT_EQ(last_progress, 95u);
+
+  ASSERT_EQ(response.data.size(), 95u);
+  for (std::size_t i = 0; i < response.data.size(); ++i) {
+    EXPECT_EQ(response.data[i].index, static_cast<int>(i));
+    const auto& values = std::get<std::vector<float>>(response.data[i].embedding);
+    ASSERT_EQ(values.size(), 1u);
+    EXPECT_EQ(values[0], static_cast<float>(i));
+  }
+  EXPECT_EQ(response.usage.total_tokens, 95);
+  EXPECT_EQ(response.model, "text-embedding-3-small");
+}
+
+TEST(EmbeddingsEmbedManyTest, SplitsOnEstimatedTokenBudget) {
+  ShardingHttpClient* http = nullptr;
+  auto client = make_client(http);
+
+  openai::EmbedManyOptions batch_options;
+  batch_options.max_tokens_per_request = 100;
+  batch_options.estimate_tokens = [](const std::string&) { return std::size_t{30}; };
+
+  auto response = client.embeddings().embed_many(make_request(10), batch_options);
+  EXPECT_EQ(http->calls_, 4);
+  EXPECT_EQ(http->shard_sizes_, (std::set<std::size_t>{1, 3}));
+  EXPECT_EQ(response.data.size(), 10u);
+}
+
+TEST(EmbeddingsEmbedManyTest, RetriesTransientShardFailuresOnly) {
+  ShardingHttpClient* http = nullptr;
+  auto client = make_client(http);
+
+  openai::EmbedManyOptions batch_options;
+  batch_options.max_items_per_request = 4;
+  http->fail_once("item-4", 503);
+  auto response = client.embeddings().embed_many(make_request(12), batch_options);
+  EXPECT_EQ(http->calls_, 4);
+  EXPECT_EQ(std::get<std::vector<float>>(response.data[5].embedding)[0], 5.0f);
+
+  http->fail_once("item-8", 400);
+  EXPECT_THROW(client.embeddings().embed_many(make_request(12), batch_options), openai::BadRequestError);
+}
+
+TEST(EmbeddingMatrixTest, CreateMatrixDecodesIntoAlignedRows) {
+  auto mock = std::make_unique<openai::testing::MockHttpClient>();
+  auto* mock_ptr = mock.get();
+  mock_ptr->enqueue_response(matrix_response(3, 20));
+  openai::ClientOptions options;
+  options.api_key = "sk-test";
+  openai::OpenAIClient client(options, std::move(mock));
+
+  auto response = client.embeddings().create_matrix(make_request(3));
+  EXPECT_EQ(json::parse(mock_ptr->last_request()->body).at("encoding_format"), "float");
+
+  const auto& matrix = response.matrix;
+  ASSERT_EQ(matrix.rows(), 3u);
+  ASSERT_EQ(matrix.dimensions(), 20u);
+  EXPECT_EQ(matrix.stride(), 32u);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(matrix.data()) % openai::EmbeddingMatrix::kAlignment, 0u);
+  for (std::size_t row = 0; row < 3; ++row) {
+    const auto view = matrix.row(row);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(view.data()) % openai::EmbeddingMatrix::kAlignment, 0u);
+    EXPECT_EQ(std::vector<float>(view.begin(), view.end()), test_row(row, 20));
+  }
+  EXPECT_EQ(response.usage.total_tokens, 3);
+  EXPECT_EQ(response.model, "text-embedding-3-small");
+}
+
+TEST(EmbeddingMatrixTest, CompactStorageRoundTripsWithinPrecision) {
+  auto mock = std::make_unique<openai::testing::MockHttpClient>();
+  mock->enqueue_response(matrix_response(2, 64));
+  mock->enqueue_response(matrix_response(2, 64));
+  openai::ClientOptions options;
+  options.api_key = "sk-test";
+  openai::OpenAIClient client(options, std::move(mock));
+
+  auto request = make_request(2);
+  request.encoding_format.reset();
+  auto half = client.embeddings().create_matrix(request, openai::EmbeddingStorage::Float16);
+  auto quantized = client.embeddings().create_matrix(request, openai::EmbeddingStorage::Int8);
+  EXPECT_EQ(half.matrix.size_bytes(), 2u * 64u * 2u);
+  EXPECT_EQ(quantized.matrix.size_bytes(), 2u * 64u);
+  EXPECT_THROW((void)half.matrix.row(0), openai::OpenAIError);
+
+  for (std::size_t row = 0; row < 2; ++row) {
+    const auto expected = test_row(row, 64);
+    const auto from_half = half.matrix.row_vector(row);
+    const auto from_int8 = quantized.matrix.row_vector(row);
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      EXPECT_NEAR(from_half[i], expected[i], 1e-4);
+      EXPECT_NEAR(from_int8[i], expected[i], quantized.matrix.row_scale(row));
+    }
+  }
+}
+
+TEST(EmbeddingMatrixTest, CreateMatrixRejectsMalformedResponses) {
+  const std::vector<std::string> bodies = {
+      R"({"object":"list","model":"m","data":[{"object":"embedding","index":0,"embedding":"="}]})",
+      R"({"object":"list","model":"m","data":[{"object":"embedding","index":0,"embedding":"AAAAAA"}]})",
+      R"({"object":"list","model":"m","data":[{"object":"embedding","index":0,"embedding":"AAA="}]})",
+      R"({"object":"list","model":"m","data":[{"object":"embedding","index":0,"embedding":[1.0]},)"
+      R"({"object":"embedding","index":0,"embedding":[2.0]}]})",
+  };
+  for (const auto& body : bodies) {
+    auto mock = std::make_unique<openai::testing::MockHttpClient>();
+    mock->enqueue_response(openai::HttpResponse{200, {}, body});
+    openai::ClientOptions options;
+    options.api_key = "sk-test";
+    openai::OpenAIClient client(options, std::move(mock));
+    EXPECT_THROW(client.embeddings().create_matrix(make_request(1)), openai::OpenAIError) << body;
+  }
+}
+
+TEST(EmbeddingMatrixTest, FromResponsePacksByIndex) {
+  openai::CreateEmbeddingResponse response;
+  response.data.push_back({std::vector<float>{3.0f, 4.0f}, 1, "embedding"});
+  response.data.push_back({std::vector<float>{1.0f, 2.0f}, 0, "embedding"});
+  auto matrix = openai::EmbeddingMatrix::from_response(response);
+  EXPECT_EQ(matrix.row_vector(0), (std::vector<float>{1.0f, 2.0f}));
+  EXPECT_EQ(matrix.row_vector(1), (std::vector<float>{3.0f, 4.0f}));
+
+  auto moved = std::move(matrix);
+  EXPECT_EQ(moved.rows(), 2u);
+  EXPECT_EQ(matrix.rows(), 0u);
+
+  response.data.push_back({std::string("AAAA"), 2, "embedding"});
+  EXPECT_THROW(openai::EmbeddingMatrix::from_response(response), openai::OpenAIError);
+
+  response.data.back() = {std::vector<float>{5.0f, 6.0f}, 1, "embedding"};
+  EXPECT_THROW(openai::EmbeddingMatrix::from_response(response), openai::OpenAIError);
+}
+
+TEST(EmbeddingCacheTest, SendsOnlyMissesAndSplicesHitsInOrder) {
+  auto cache = std::make_shared<openai::EmbeddingCache>();
+  ShardingHttpClient* http = nullptr;
+  auto client = make_client(http, cache);
+
+  auto request = make_request(0);
+  request.input = std::vector<std::string>{"item-1", "item-2", "item-1"};
+  auto first = client.embeddings().create(request);
+  EXPECT_EQ(first_values(first), (std::vector<float>{1, 2, 1}));
+  EXPECT_EQ(http->inputs_, (std::vector<std::string>{"item-1", "item-2"}));
+
+  request.input = std::vector<std::string>{"item-3", "item-2", "item-1", "item-4"};
+  auto second = client.embeddings().embed_many(request);
+  EXPECT_EQ(first_values(second), (std::vector<float>{3, 2, 1, 4}));
+  EXPECT_EQ(http->inputs_, (std::vector<std::string>{"item-1", "item-2", "item-3", "item-4"}));
+  EXPECT_EQ(second.usage.prompt_tokens, 2);
+  for (std::size_t i = 0; i < second.data.size(); ++i) {
+    EXPECT_EQ(second.data[i].index, static_cast<int>(i));
+  }
+
+  request.input = std::string("item-4");
+  auto third = client.embeddings().create(request);
+  EXPECT_EQ(first_values(third), (std::vector<float>{4}));
+  EXPECT_EQ(http->calls_, 2);
+  request.input = std::vector<std::string>{"item-4"};
+
+  const auto stats = cache->stats();
+  EXPECT_EQ(stats.memory_hits, 3u);
+  EXPECT_EQ(stats.misses, 4u);
+  EXPECT_EQ(stats.stores, 4u);
+
+  // A different model or dimension count is a different key.
+  request.dimensions = 256;
+  (void)client.embeddings().create(request);
+  EXPECT_EQ(http->calls_, 3);
+}
+
+TEST(EmbeddingCacheTest, DiskTierSurvivesRestartAndDropsTornTail) {
+  const auto path = (std::filesystem::temp_directory_path() / "openai-cpp-embedding-cache.bin").string();
+  std::filesystem::remove(path);
+  openai::EmbeddingCacheOptions options;
+  options.memory_entries = 1;
+  options.disk_path = path;
+  const auto key_a = openai::EmbeddingCache::make_key("m", std::nullopt, "a");
+  const auto key_b = openai::EmbeddingCache::make_key("m", std::nullopt, "b");
+  {
+    openai::EmbeddingCache cache(options);
+    cache.put(key_a, {1.0f, 2.0f});
+    cache.put(key_b, {3.0f, 4.0f, 5.0f});
+    // `a` was evicted from memory, so this read goes through the mapped file.
+    EXPECT_EQ(cache.get(key_a), (std::vector<float>{1.0f, 2.0f}));
+    EXPECT_EQ(cache.stats().disk_hits, 1u);
+  }
+  const auto intact_size = std::filesystem::file_size(path);
+  {
+    std::ofstream torn(path, std::ios::binary | std::ios::app);
+    torn << "OAEC partial";
+  }
+
+  openai::EmbeddingCache reopened(options);
+  EXPECT_EQ(std::filesystem::file_size(path), intact_size);
+  EXPECT_EQ(reopened.disk_entries(), 2u);
+  EXPECT_EQ(reopened.get(key_b), (std::vector<float>{3.0f, 4.0f, 5.0f}));
+  EXPECT_FALSE(reopened.get(openai::EmbeddingCache::make_key("m", 8, "b")).has_value());
+  reopened.put(openai::EmbeddingCache::make_key("m", std::nullopt, "c"), {6.0f});
+  EXPECT_EQ(reopened.get(openai::EmbeddingCache::make_key("m", std::nullopt, "c")), (std::vector<float>{6.0f}));
+  EXPECT_EQ(reopened.stats().disk_hits, 1u);
+  EXPECT_EQ(reopened.stats().memory_hits, 1u);
+  std::filesystem::remove(path);
+}
@@ -3,12 +3,17 @@
 #include "openai/client.hpp"
 #include "openai/files.hpp"
 #include "openai/pagination.hpp"
+#include "openai/utils/md5.hpp"
 #include "support/mock_http_client.hpp"
 
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
+#include <mutex>
+#include <sstream>
+#include <vector>
 
 using json = nlohmann::json;
 namespace oait = openai::testing;
@@ -235,6 +240,51 @@ TEST(FilesResourceTest, CreateBuildsMultipartBody) {
   std::filesystem::remove(tmp);
 }
 
+TEST(FilesResourceTest, CreateStreamsLargeFilesAsSegments) {
+  using namespace openai;
+
+  // Accepts segmented bodies, the way the curl client does, and records what it was handed.
+  class SegmentedHttpClient final : public HttpClient {
+  public:
+    HttpResponse request(const HttpRequest& request) override {
+      last_request = request;
+      return HttpResponse{200, {}, R"({"id":"file-large","bytes":1,"created_at":1,"filename":"large.bin","object":"file","purpose":"batch"})"};
+    }
+    bool supports_body_segments() const override { return true; }
+    std::optional<HttpRequest> last_request;
+  };
+
+  auto http = std::make_unique<SegmentedHttpClient>();
+  auto* http_ptr = http.get();
+
+  std::filesystem::path tmp = std::filesystem::temp_directory_path() / "openai-cpp-upload-large.bin";
+  const std::string contents(utils::kMapUploadThreshold * 2, 'z');
+  {
+    std::ofstream tmp_file(tmp, std::ios::binary);
+    tmp_file << contents;
+  }
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+  OpenAIClient client(options, std::move(http));
+
+  FileUploadRequest request;
+  request.purpose = "batch";
+  request.file_path = tmp.string();
+  EXPECT_EQ(client.files().create(request).id, "file-large");
+
+  ASSERT_TRUE(http_ptr->last_request.has_value());
+  const auto& sent = *http_ptr->last_request;
+  EXPECT_TRUE(sent.body.empty());
+  ASSERT_TRUE(sent.body_segments);
+  EXPECT_NE(sent.headers.at("Content-Type").find("multipart/form-data"), std::string::npos);
+  const std::string joined = sent.body_segments->join();
+  EXPECT_NE(joined.find("filename=\"openai-cpp-upload-large.bin\""), std::string::npos);
+  EXPECT_NE(joined.find(contents), std::string::npos);
+
+  std::filesystem::remove(tmp);
+}
+
 TEST(FilesResourceTest, CreateSupportsInMemoryData) {
   using namespace openai;
 
@@ -287,3 +337,224 @@ TEST(FilesResourceTest, ContentReturnsBinaryData) {
   ASSERT_TRUE(mock_ptr->last_request().has_value());
   EXPECT_NE(mock_ptr->last_request()->url.find("/files/file-123/content"), std::string::npos);
 }
+
+TEST(FilesResourceTest, ContentStreamsToFileAndRestartsOnRetry) {
+  using namespace openai;
+
+  auto mock_client = std::make_unique<oait::MockHttpClient>();
+  auto* mock_ptr = mock_client.get();
+  const std::string body = "line one\nline two\n";
+  // The first attempt drops mid-body after delivering more bytes than the full download.
+  mock_ptr->enqueue_interrupted_stream(std::string(64, 'x'), "connection reset");
+  mock_ptr->enqueue_response(HttpResponse{200, {{"Content-Type", "application/jsonl"}}, body});
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+  OpenAIClient client(options, std::move(mock_client));
+
+  const auto path = std::filesystem::temp_directory_path() / "openai-cpp-download.jsonl";
+  DownloadOptions download;
+  download.preallocate_bytes = 4096;
+  download.checksum = DownloadChecksum::MD5;
+  download.expected_checksum = utils::md5_hex(body);
+  auto result = client.files().content("file-1", DownloadSink::file(path.string()), download);
+
+  EXPECT_EQ(result.bytes, body.size());
+  EXPECT_EQ(result.checksum, utils::md5_hex(body));
+  EXPECT_EQ(result.headers.at("Content-Type"), "application/jsonl");
+  EXPECT_EQ(std::filesystem::file_size(path), body.size());
+  std::ifstream in(path, std::ios::binary);
+  EXPECT_EQ(std::string(std::istreambuf_iterator<char>(in), {}), body);
+  EXPECT_EQ(mock_ptr->call_count(), 2u);
+  EXPECT_FALSE(mock_ptr->last_request()->collect_body);
+  EXPECT_EQ(mock_ptr->last_request()->url, "https://api.openai.com/v1/files/file-1/content");
+
+  std::filesystem::remove(path);
+}
+
+TEST(FilesResourceTest, ContentDoesNotRetrySinkFailures) {
+  using namespace openai;
+
+  auto mock_client = std::make_unique<oait::MockHttpClient>();
+  auto* mock_ptr = mock_client.get();
+  mock_ptr->enqueue_response(HttpResponse{200, {}, "data"});
+  mock_ptr->enqueue_response(HttpResponse{200, {}, "data"});
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+  OpenAIClient client(options, std::move(mock_client));
+
+  auto full_disk = DownloadSink::callback([](const char*, std::size_t) { throw OpenAIError("No space left on device"); },
+                                          [] {});
+  try {
+    client.files().content("file-1", full_disk);
+    FAIL() << "expected the sink error";
+  } catch (const APIConnectionError&) {
+    FAIL() << "a sink failure must not be reported as a connection error";
+  } catch (const OpenAIError& error) {
+    EXPECT_STREQ(error.what(), "No space left on device");
+  }
+  EXPECT_EQ(mock_ptr->call_count(), 1u);
+}
+
+TEST(FilesResourceTest, ContentKeepsErrorBodiesOutOfTheSink) {
+  using namespace openai;
+
+  auto mock_client = std::make_unique<oait::MockHttpClient>();
+  auto* mock_ptr = mock_client.get();
+  mock_ptr->enqueue_response(HttpResponse{404, {}, R"({"error":{"message":"No such file"}})"});
+  mock_ptr->enqueue_response(HttpResponse{200, {}, "data"});
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+  OpenAIClient client(options, std::move(mock_client));
+
+  std::ostringstream out;
+  try {
+    client.files().content("file-missing", DownloadSink::stream(out));
+    FAIL() << "expected NotFoundError";
+  } catch (const NotFoundError& error) {
+    EXPECT_NE(std::string(error.what()).find("No such file"), std::string::npos);
+  }
+  EXPECT_TRUE(out.str().empty());
+
+  // A file sink that never finishes is removed, and a wrong checksum fails the download.
+  const auto path = std::filesystem::temp_directory_path() / "openai-cpp-download-bad.bin";
+  DownloadOptions download;
+  download.checksum = DownloadChecksum::SHA256;
+  download.expected_checksum = std::string(64, '0');
+  EXPECT_THROW(client.files().content("file-1", DownloadSink::file(path.string()), download), OpenAIError);
+  EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+namespace {
+
+// Serves one body and honours "Range: bytes=a-b" unless told not to. `drop_at` makes the first request
+// covering that offset fail after delivering the bytes before it.
+class RangeServerHttpClient final : public openai::HttpClient {
+public:
+  explicit RangeServerHttpClient(std::string body, bool ranges = true) : body_(std::move(body)), ranges_(ranges) {}
+
+  openai::HttpResponse request(const openai::HttpRequest& request) override {
+    std::uint64_t first = 0;
+    std::uint64_t last = body_.size() - 1;
+    const auto range = request.headers.find("Range");
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ranges_seen_.push_back(range == request.headers.end() ? "" : range->second);
+    }
+    const bool partial = ranges_ && range != request.headers.end();
+    if (partial) {
+      const auto dash = range->second.find('-');
+      first = std::stoull(range->second.substr(6, dash - 6));
+      last = std::stoull(range->second.substr(dash + 1));
+    }
+    std::string slice = body_.substr(first, last - first + 1);
+    bool drop = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (drop_at_ && first <= *drop_at_ && *drop_at_ <= last) {
+        slice.resize(*drop_at_ - first);
+        drop_at_.reset();
+        drop = true;
+      }
+    }
+    openai::HttpResponse response{partial ? 206 : 200, {{"content-type", "application/octet-stream"}}, slice};
+    if (partial) {
+      response.headers["content-range"] =
+          "bytes " + std::to_string(first) + "-" + std::to_string(last) + "/" + std::to_string(body_.size());
+    }
+    request.on_status(response.status_code);
+    request.on_chunk(slice.data(), slice.size());
+    if (drop) {
+      throw openai::OpenAIError("connection reset");
+    }
+    response.body.clear();
+    return response;
+  }
+
+  void drop_at(std::uint64_t offset) { drop_at_ = offset; }
+  std::vector<std::string> ranges_seen() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ranges_seen_;
+  }
+
+private:
+  std::string body_;
+  bool ranges_;
+  mutable std::mutex mutex_;
+  std::optional<std::uint64_t> drop_at_;
+  std::vector<std::string> ranges_seen_;
+};
+
+std::string patterned_body(std::size_t size) {
+  std::string body(size, '\0');
+  for (std::size_t i = 0; i < size; ++i) {
+    body[i] = static_cast<char>((i * 131 + i / 7) & 0xff);
+  }
+  return body;
+}
+
+}  // namespace
+
+TEST(FilesResourceTest, ContentFetchesParallelRangesAndResumesAFailedRange) {
+  using namespace openai;
+
+  const std::string body = patterned_body(100000);
+  auto http = std::make_unique<RangeServerHttpClient>(body);
+  auto* http_ptr = http.get();
+  http_ptr->drop_at(40000);
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+  OpenAIClient client(options, std::move(http));
+
+  const auto path = std::filesystem::temp_directory_path() / "openai-cpp-download-ranges.bin";
+  DownloadOptions download;
+  download.parallel_ranges = 4;
+  download.range_bytes = 16384;
+  download.checksum = DownloadChecksum::MD5;
+  download.expected_checksum = utils::md5_hex(body);
+  auto result = client.files().content("file-1", DownloadSink::file(path.string()), download);
+
+  EXPECT_EQ(result.bytes, body.size());
+  EXPECT_EQ(result.checksum, utils::md5_hex(body));
+  EXPECT_EQ(result.headers.at("content-range"), "bytes 0-16383/100000");
+  std::ifstream in(path, std::ios::binary);
+  EXPECT_EQ(std::string(std::istreambuf_iterator<char>(in), {}), body);
+
+  // The probe, seven ranges, and one resumed request for the tail of the range that dropped.
+  const auto seen = http_ptr->ranges_seen();
+  ASSERT_EQ(seen.size(), 9u);
+  EXPECT_EQ(seen.front(), "bytes=0-0");
+  EXPECT_NE(std::find(seen.begin(), seen.end(), "bytes=32768-49151"), seen.end());
+  EXPECT_NE(std::find(seen.begin(), seen.end(), "bytes=40000-49151"), seen.end());
+  EXPECT_NE(std::find(seen.begin(), seen.end(), "bytes=98304-99999"), seen.end());
+
+  std::filesystem::remove(path);
+}
+
+TEST(FilesResourceTest, ContentFallsBackToOneStreamWithoutRangeSupport) {
+  using namespace openai;
+
+  const std::string body = patterned_body(50000);
+  auto http = std::make_unique<RangeServerHttpClient>(body, false);
+  auto* http_ptr = http.get();
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+  OpenAIClient client(options, std::move(http));
+
+  const auto path = std::filesystem::temp_directory_path() / "openai-cpp-download-noranges.bin";
+  DownloadOptions download;
+  download.parallel_ranges = 4;
+  download.range_bytes = 8192;
+  auto result = client.files().content("file-1", DownloadSink::file(path.string()), download);
+
+  EXPECT_EQ(result.bytes, body.size());
+  EXPECT_EQ(http_ptr->ranges_seen(), std::vector<std::string>{"bytes=0-0"});
+  std::ifstream in(path, std::ios::binary);
+  EXPECT_EQ(std::string(std::istreambuf_iterator<char>(in), {}), body);
+
+  std::filesystem::remove(path);
+}
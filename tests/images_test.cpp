@@ -6,9 +6,12 @@
 
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
 #include <filesystem>
 #include <fstream>
 #include <optional>
+#include <sstream>
+#include <vector>
 
 namespace oait = openai::testing;
 
@@ -395,3 +398,206 @@ TEST(ImagesResourceTest, EditStreamParsesTypedEvents) {
 
   std::filesystem::remove(tmp);
 }
+
+namespace {
+
+std::string to_base64(const std::string& bytes) {
+  static constexpr char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  for (std::size_t i = 0; i < bytes.size(); i += 3) {
+    std::uint32_t block = static_cast<std::uint8_t>(bytes[i]) << 16;
+    if (i + 1 < bytes.size()) block |= static_cast<std::uint8_t>(bytes[i + 1]) << 8;
+    if (i + 2 < bytes.size()) block |= static_cast<std::uint8_t>(bytes[i + 2]);
+    out += kAlphabet[(block >> 18) & 63];
+    out += kAlphabet[(block >> 12) & 63];
+    out += i + 1 < bytes.size() ? kAlphabet[(block >> 6) & 63] : '=';
+    out += i + 2 < bytes.size() ? kAlphabet[block & 63] : '=';
+  }
+  return out;
+}
+
+std::string fake_image(std::size_t size, unsigned seed) {
+  std::string bytes(size, '\0');
+  for (std::size_t i = 0; i < size; ++i) {
+    bytes[i] = static_cast<char>((i * 2654435761u + seed) >> 13);
+  }
+  return bytes;
+}
+
+// Delivers a canned body in small pieces so payloads and escapes straddle chunk boundaries.
+class ChunkingHttpClient final : public openai::HttpClient {
+public:
+  explicit ChunkingHttpClient(std::string body) : body_(std::move(body)) {}
+
+  openai::HttpResponse request(const openai::HttpRequest& request) override {
+    last_request = request;
+    if (request.on_status) {
+      request.on_status(200);
+    }
+    for (std::size_t offset = 0; offset < body_.size(); offset += 997) {
+      request.on_chunk(body_.data() + offset, std::min<std::size_t>(997, body_.size() - offset));
+    }
+    return openai::HttpResponse{200, {}, request.collect_body ? body_ : ""};
+  }
+
+  std::optional<openai::HttpRequest> last_request;
+
+private:
+  std::string body_;
+};
+
+}  // namespace
+
+TEST(ImagesResourceTest, GenerateDecodesImagesIntoSinks) {
+  using namespace openai;
+
+  const std::string first = fake_image(150000, 1);
+  const std::string second = fake_image(1001, 2);
+  // JSON encoders may escape the '/' of the base64 alphabet.
+  std::string escaped = to_base64(first);
+  for (std::size_t pos = escaped.find('/'); pos != std::string::npos; pos = escaped.find('/', pos + 2)) {
+    escaped.replace(pos, 1, "\\/");
+  }
+  const std::string body = "{\"created\": 1, \"data\": [{\"b64_json\": \"" + escaped +
+                           "\", \"revised_prompt\": \"a \\\"b64_json\\\": cat\"}, {\"revised_prompt\": \"dog\", "
+                           "\"b64_json\":\"" + to_base64(second) + "\"}], \"usage\": {\"total_tokens\": 9}}";
+  auto http = std::make_unique<ChunkingHttpClient>(body);
+  auto* http_ptr = http.get();
+  ClientOptions options;
+  options.api_key = "sk-test";
+  OpenAIClient client(options, std::move(http));
+
+  const auto path = std::filesystem::temp_directory_path() / "openai-cpp-image-0.png";
+  std::ostringstream second_out;
+  ImageSinks sinks;
+  sinks.sink_for = [&](std::size_t index) {
+    return index == 0 ? DownloadSink::file(path.string()) : DownloadSink::stream(second_out);
+  };
+  sinks.download_options.checksum = DownloadChecksum::SHA256;
+
+  ImageGenerateRequest request;
+  request.prompt = "A cat";
+  request.response_format = "b64_json";
+  auto response = client.images().generate(request, sinks);
+
+  EXPECT_FALSE(http_ptr->last_request->collect_body);
+  ASSERT_EQ(response.data.size(), 2u);
+  EXPECT_FALSE(response.data[0].b64_json.has_value());
+  EXPECT_FALSE(response.data[0].raw.contains("b64_json"));
+  ASSERT_TRUE(response.data[0].output.has_value());
+  EXPECT_EQ(response.data[0].output->bytes, first.size());
+  EXPECT_EQ(response.data[0].revised_prompt, "a \"b64_json\": cat");
+  ASSERT_TRUE(response.data[1].output.has_value());
+  EXPECT_EQ(response.data[1].output->bytes, second.size());
+  EXPECT_EQ(response.data[1].revised_prompt, "dog");
+  ASSERT_TRUE(response.usage.has_value());
+  EXPECT_EQ(response.usage->total_tokens, 9);
+
+  std::ifstream in(path, std::ios::binary);
+  EXPECT_EQ(std::string(std::istreambuf_iterator<char>(in), {}), first);
+  EXPECT_EQ(second_out.str(), second);
+  std::filesystem::remove(path);
+}
+
+TEST(ImagesResourceTest, GenerateStreamDecodesPartialImagesIntoSinks) {
+  using namespace openai;
+
+  const std::string partial = fake_image(5000, 3);
+  const std::string final_image = fake_image(9000, 4);
+  const std::string body =
+      "event: image_generation.partial_image\n"
+      "data: {\"type\":\"image_generation.partial_image\",\"b64_json\":\"" + to_base64(partial) +
+      "\",\"partial_image_index\":0}\n\n"
+      "event: image_generation.completed\n"
+      "data: {\"type\":\"image_generation.completed\",\"b64_json\":\"" + to_base64(final_image) +
+      "\",\"usage\":{\"total_tokens\":12}}\n\n";
+  auto http = std::make_unique<ChunkingHttpClient>(body);
+  auto* http_ptr = http.get();
+  ClientOptions options;
+  options.api_key = "sk-test";
+  OpenAIClient client(options, std::move(http));
+
+  std::vector<std::string> images(2);
+  ImageSinks sinks;
+  sinks.sink_for = [&](std::size_t index) {
+    return DownloadSink::callback([&images, index](const char* data, std::size_t size) {
+      images[index].append(data, size);
+    });
+  };
+
+  ImageGenerateRequest request;
+  request.prompt = "A cat";
+  request.partial_images = 1;
+  std::vector<std::uint64_t> event_bytes;
+  client.images().generate_stream(request, sinks, [&](const ImageStreamEvent& event) {
+    if (event.generation_partial) {
+      EXPECT_FALSE(event.generation_partial->b64_json.has_value());
+      event_bytes.push_back(event.generation_partial->output->bytes);
+    }
+    if (event.generation_completed) {
+      EXPECT_FALSE(event.generation_completed->b64_json.has_value());
+      event_bytes.push_back(event.generation_completed->output->bytes);
+      EXPECT_EQ(event.generation_completed->usage->total_tokens, 12);
+    }
+    return true;
+  });
+
+  EXPECT_EQ(event_bytes, (std::vector<std::uint64_t>{partial.size(), final_image.size()}));
+  EXPECT_EQ(images[0], partial);
+  EXPECT_EQ(images[1], final_image);
+  EXPECT_EQ(http_ptr->last_request->headers.at("Accept"), "text/event-stream");
+}
+
+TEST(ImagesResourceTest, GenerateIntoSinksRestartsAfterADroppedBody) {
+  using namespace openai;
+
+  const std::string image = fake_image(20000, 5);
+  const std::string body =
+      "{\"created\": 1, \"data\": [{\"b64_json\": \"" + to_base64(image) + "\"}], \"usage\": {\"total_tokens\": 3}}";
+  auto mock_client = std::make_unique<oait::MockHttpClient>();
+  auto* mock_ptr = mock_client.get();
+  mock_ptr->enqueue_interrupted_stream(body.substr(0, body.size() / 2), "connection reset");
+  mock_ptr->enqueue_response(HttpResponse{200, {}, body});
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+  OpenAIClient client(options, std::move(mock_client));
+
+  const auto path = std::filesystem::temp_directory_path() / "openai-cpp-image-retry.png";
+  ImageSinks sinks;
+  sinks.sink_for = [&](std::size_t) { return DownloadSink::file(path.string()); };
+
+  ImageGenerateRequest request;
+  request.prompt = "A cat";
+  request.response_format = "b64_json";
+  auto response = client.images().generate(request, sinks);
+
+  EXPECT_EQ(mock_ptr->call_count(), 2u);
+  ASSERT_EQ(response.data.size(), 1u);
+  ASSERT_TRUE(response.data[0].output.has_value());
+  EXPECT_EQ(response.data[0].output->bytes, image.size());
+  ASSERT_TRUE(response.usage.has_value());
+  EXPECT_EQ(response.usage->total_tokens, 3);
+  std::ifstream in(path, std::ios::binary);
+  EXPECT_EQ(std::string(std::istreambuf_iterator<char>(in), {}), image);
+  std::filesystem::remove(path);
+
+  // Partial images already reached the handler, so a dropped stream is reported instead of replayed.
+  mock_ptr->enqueue_interrupted_stream(
+      "event: image_generation.partial_image\n"
+      "data: {\"type\":\"image_generation.partial_image\",\"b64_json\":\"" + to_base64(image) +
+          "\",\"partial_image_index\":0}\n\n",
+      "connection reset");
+  mock_ptr->enqueue_response(HttpResponse{200, {}, ""});
+  std::size_t events = 0;
+  request.partial_images = 1;
+  EXPECT_THROW(client.images().generate_stream(request, sinks,
+                                               [&](const ImageStreamEvent&) {
+                                                 ++events;
+                                                 return true;
+                                               }),
+               APIConnectionError);
+  EXPECT_EQ(events, 1u);
+  EXPECT_EQ(mock_ptr->call_count(), 3u);
+  std::filesystem::remove(path);
+}
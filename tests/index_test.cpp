@@ -0,0 +1,173 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "openai/error.hpp"
+#include "openai/index/flat_index.hpp"
+#include "openai/index/hnsw_index.hpp"
+
+using namespace openai::index;
+
+namespace {
+
+std::vector<std::vector<float>> random_vectors(std::size_t count, std::size_t dimensions, unsigned seed) {
+  std::mt19937 rng(seed);
+  std::normal_distribution<float> normal(0.0f, 1.0f);
+  std::vector<std::vector<float>> vectors(count, std::vector<float>(dimensions));
+  for (auto& vector : vectors) {
+    for (auto& value : vector) {
+      value = normal(rng);
+    }
+  }
+  return vectors;
+}
+
+std::vector<std::uint64_t> brute_force(const std::vector<std::vector<float>>& data,
+                                       const std::vector<float>& query,
+                                       std::size_t k) {
+  auto unit = [](std::vector<float> v) {
+    normalize(v.data(), v.size());
+    return v;
+  };
+  const auto q = unit(query);
+  std::vector<std::pair<float, std::uint64_t>> scored;
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    const auto row = unit(data[i]);
+    float score = 0.0f;
+    for (std::size_t d = 0; d < row.size(); ++d) {
+      score += row[d] * q[d];
+    }
+    scored.emplace_back(-score, i);
+  }
+  std::sort(scored.begin(), scored.end());
+  std::vector<std::uint64_t> ids;
+  for (std::size_t i = 0; i < k; ++i) {
+    ids.push_back(scored[i].second);
+  }
+  return ids;
+}
+
+std::vector<std::uint64_t> ids_of(const std::vector<SearchResult>& results) {
+  std::vector<std::uint64_t> ids;
+  for (const auto& result : results) {
+    ids.push_back(result.id);
+  }
+  return ids;
+}
+
+}  // namespace
+
+TEST(IndexTest, DotKernelMatchesScalarSumForEveryTailLength) {
+  const auto vectors = random_vectors(2, 131, 7);
+  for (std::size_t size = 0; size <= 131; ++size) {
+    double expected = 0.0;
+    for (std::size_t i = 0; i < size; ++i) {
+      expected += static_cast<double>(vectors[0][i]) * vectors[1][i];
+    }
+    EXPECT_NEAR(dot(vectors[0].data(), vectors[1].data(), size), expected, 1e-3) << dot_kernel_name() << " " << size;
+  }
+}
+
+TEST(IndexTest, FlatIndexIsExactAndSupportsRemoveAndReplace) {
+  const auto data = random_vectors(500, 40, 1);
+  const auto queries = random_vectors(20, 40, 2);
+  FlatIndex index(40);
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    index.add(i, data[i]);
+  }
+  for (const auto& query : queries) {
+    EXPECT_EQ(ids_of(index.search(query, 10)), brute_force(data, query, 10));
+  }
+
+  const auto batch = index.search_batch(queries, 10, 3);
+  ASSERT_EQ(batch.size(), queries.size());
+  for (std::size_t q = 0; q < queries.size(); ++q) {
+    EXPECT_EQ(ids_of(batch[q]), ids_of(index.search(queries[q], 10)));
+  }
+
+  const auto top = index.search(queries[0], 1).front();
+  EXPECT_TRUE(index.remove(top.id));
+  EXPECT_FALSE(index.remove(top.id));
+  EXPECT_EQ(index.size(), data.size() - 1);
+  EXPECT_NE(index.search(queries[0], 1).front().id, top.id);
+
+  // Re-adding an id replaces its vector rather than duplicating it.
+  index.add(3, queries[0]);
+  EXPECT_EQ(index.size(), data.size() - 1);
+  const auto best = index.search(queries[0], 1).front();
+  EXPECT_EQ(best.id, 3u);
+  EXPECT_NEAR(best.score, 1.0f, 1e-5);
+
+  EXPECT_THROW(index.add(9999, std::vector<float>(39)), openai::OpenAIError);
+}
+
+TEST(IndexTest, FlatIndexRoundTripsThroughMappedFile) {
+  const auto data = random_vectors(300, 24, 3);
+  const auto queries = random_vectors(5, 24, 4);
+  FlatIndex index(24, Metric::InnerProduct);
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    index.add(1000 + i, data[i]);
+  }
+  const auto path = (std::filesystem::temp_directory_path() / "openai-cpp-flat.idx").string();
+  index.save(path);
+
+  auto mapped = FlatIndex::load(path);
+  EXPECT_EQ(mapped.metric(), Metric::InnerProduct);
+  EXPECT_EQ(mapped.size(), index.size());
+  for (const auto& query : queries) {
+    EXPECT_EQ(ids_of(mapped.search(query, 5)), ids_of(index.search(query, 5)));
+  }
+
+  // Mutating a mapped index copies it into memory and leaves the file alone.
+  EXPECT_TRUE(mapped.remove(1000));
+  mapped.add(5000, queries[0]);
+  EXPECT_EQ(FlatIndex::load(path, false).size(), data.size());
+  EXPECT_EQ(mapped.search(queries[0], 1).front().id, 5000u);
+
+  EXPECT_THROW(HnswIndex::load(path), openai::OpenAIError);
+  std::filesystem::remove(path);
+}
+
+TEST(IndexTest, HnswIndexReachesHighRecallAndPersists) {
+  const auto data = random_vectors(2000, 32, 5);
+  const auto queries = random_vectors(50, 32, 6);
+  HnswIndex index(32);
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    index.add(i, data[i]);
+  }
+
+  std::size_t hits = 0;
+  const auto batch = index.search_batch(queries, 10, 4, 100);
+  for (std::size_t q = 0; q < queries.size(); ++q) {
+    const auto expected = brute_force(data, queries[q], 10);
+    const std::set<std::uint64_t> truth(expected.begin(), expected.end());
+    for (const auto id : ids_of(batch[q])) {
+      hits += truth.count(id);
+    }
+  }
+  EXPECT_GE(static_cast<double>(hits) / (queries.size() * 10), 0.9);
+
+  const auto top = index.search(queries[0], 1).front();
+  EXPECT_TRUE(index.remove(top.id));
+  for (const auto& result : index.search(queries[0], 10)) {
+    EXPECT_NE(result.id, top.id);
+  }
+  EXPECT_EQ(index.size(), data.size() - 1);
+  EXPECT_EQ(index.node_count(), data.size());
+
+  const auto path = (std::filesystem::temp_directory_path() / "openai-cpp-hnsw.idx").string();
+  index.save(path);
+  auto loaded = HnswIndex::load(path);
+  EXPECT_EQ(loaded.size(), index.size());
+  EXPECT_FALSE(loaded.contains(top.id));
+  for (const auto& query : queries) {
+    EXPECT_EQ(ids_of(loaded.search(query, 10)), ids_of(index.search(query, 10)));
+  }
+  loaded.add(top.id, queries[0]);
+  EXPECT_EQ(loaded.search(queries[0], 1).front().id, top.id);
+  std::filesystem::remove(path);
+}
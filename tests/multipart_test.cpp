@@ -41,3 +41,29 @@ TEST(MultipartFormDataTest, EncodesNestedJsonValues) {
   EXPECT_NE(encoded.body.find("name=\"config[count]\""), std::string::npos);
   EXPECT_NE(encoded.body.find("3"), std::string::npos);
 }
+
+TEST(MultipartFormDataTest, SegmentsReferenceFileBytesInPlace) {
+  const std::string contents(4096, 'x');
+  MultipartFormData form;
+  form.append_text("purpose", "assistants");
+  form.append_file("file", openai::utils::borrow_file(contents.data(), contents.size(), "big.bin"), "application/octet-stream");
+  std::vector<std::uint8_t> small{'h', 'i'};
+  form.append_file("small", openai::utils::to_file(small, "small.txt"), "text/plain");
+
+  auto segments = form.build_segments();
+  ASSERT_TRUE(segments.body);
+  bool borrowed = false;
+  for (const auto& segment : segments.body->segments) {
+    borrowed = borrowed || segment.data() == contents.data();
+  }
+  EXPECT_TRUE(borrowed);
+
+  // Joining the segments gives exactly the single-buffer encoding.
+  MultipartEncoded encoded = form.build();
+  EXPECT_EQ(segments.content_type, encoded.content_type);
+  EXPECT_EQ(segments.body->join(), encoded.body);
+  EXPECT_EQ(segments.body->size(), encoded.body.size());
+  EXPECT_NE(encoded.body.find("filename=\"big.bin\"\r\nContent-Type: application/octet-stream\r\n\r\n" + contents + "\r\n"),
+            std::string::npos);
+  EXPECT_NE(encoded.body.find("Content-Type: text/plain\r\n\r\nhi\r\n"), std::string::npos);
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include "openai/error.hpp"
+#include "openai/partial_json.hpp"
+#include "openai/responses.hpp"
+#include "openai/run_steps.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <string>
+
+TEST(PartialJsonParserTest, ExposesValueAfterEachFragment) {
+  openai::PartialJsonParser parser;
+  parser.feed("{\"city\": \"Par");
+  EXPECT_TRUE(parser.started());
+  EXPECT_FALSE(parser.complete());
+  EXPECT_EQ(parser.value(), nlohmann::json({{"city", "Par"}}));
+
+  parser.feed("is\", \"days\": [1, 2");
+  // 2 may still be the start of 20, so only terminated numbers are visible.
+  EXPECT_EQ(parser.value(), nlohmann::json({{"city", "Paris"}, {"days", {1}}}));
+
+  parser.feed("0], \"units\": {\"metric\": tr");
+  EXPECT_EQ(parser.value()["days"], nlohmann::json({1, 20}));
+  EXPECT_EQ(parser.value()["units"], nlohmann::json::object());
+
+  parser.feed("ue, \"scale\": -1.5e2, \"note\": null}}");
+  EXPECT_TRUE(parser.complete());
+  EXPECT_EQ(parser.finish(), nlohmann::json::parse(
+                                 R"({"city":"Paris","days":[1,20],"units":{"metric":true,"scale":-150.0,"note":null}})"));
+}
+
+TEST(PartialJsonParserTest, MatchesFullParseWhenFedOneByteAtATime) {
+  const std::string document =
+      R"({"a":[{"b":"x\"y\\z\n"},[],{},[[1,2],[3]]],"emoji":"😀 é","esc":"\u00e9\ud83d\ude00","t":false,"n":0.25})";
+  openai::PartialJsonParser parser;
+  for (char c : document) {
+    parser.feed(std::string_view(&c, 1));
+  }
+  EXPECT_EQ(parser.finish(), nlohmann::json::parse(document));
+  EXPECT_EQ(parser.bytes_consumed(), document.size());
+
+  openai::PartialJsonParser lone_surrogate;
+  lone_surrogate.feed(R"(["\ud800x"])");
+  EXPECT_EQ(lone_surrogate.finish(), nlohmann::json({"\xEF\xBF\xBDx"}));
+}
+
+TEST(PartialJsonParserTest, FinishFlushesTopLevelNumberAndRejectsIncompleteInput) {
+  openai::PartialJsonParser number;
+  number.feed("4");
+  number.feed("2");
+  EXPECT_FALSE(number.complete());
+  EXPECT_EQ(number.finish(), nlohmann::json(42));
+
+  openai::PartialJsonParser truncated;
+  truncated.feed("{\"a\": [1, 2");
+  EXPECT_THROW(truncated.finish(), openai::OpenAIError);
+
+  openai::PartialJsonParser malformed;
+  EXPECT_THROW(malformed.feed("{\"a\" 1}"), openai::OpenAIError);
+
+  openai::PartialJsonParser bad_literal;
+  EXPECT_THROW(bad_literal.feed("[trax]"), openai::OpenAIError);
+
+  openai::PartialJsonParser trailing;
+  trailing.feed("{} ");
+  EXPECT_THROW(trailing.feed("x"), openai::OpenAIError);
+
+  trailing.reset();
+  trailing.feed("[]");
+  EXPECT_EQ(trailing.finish(), nlohmann::json::array());
+}
+
+TEST(PartialJsonTrackerTest, RoutesChatResponsesAndRunStepDeltas) {
+  openai::PartialJsonTracker tracker;
+
+  tracker.feed_chat_chunk(nlohmann::json::parse(
+      R"({"choices":[{"index":0,"delta":{"tool_calls":[{"index":0,"function":{"name":"f","arguments":""}}]}}]})"));
+  tracker.feed_chat_chunk(nlohmann::json::parse(
+      R"({"choices":[{"index":0,"delta":{"tool_calls":[{"index":0,"function":{"arguments":"{\"q\":\"wea"}}]}}]})"));
+  tracker.feed_chat_chunk(nlohmann::json::parse(
+      R"({"choices":[{"index":0,"delta":{"tool_calls":[{"index":0,"function":{"arguments":"ther\"}"}}]}}]})"));
+  ASSERT_NE(tracker.find("0:0"), nullptr);
+  EXPECT_TRUE(tracker.find("0:0")->complete());
+  EXPECT_EQ(tracker.find("0:0")->value(), nlohmann::json({{"q", "weather"}}));
+
+  openai::ResponseStreamEvent event;
+  event.function_arguments_delta = openai::ResponseFunctionCallArgumentsDeltaEvent{};
+  event.function_arguments_delta->item_id = "fc_1";
+  event.function_arguments_delta->delta = "{\"id\": 7";
+  tracker.feed(event);
+  event.function_arguments_delta->delta = "}";
+  tracker.feed(event);
+  EXPECT_EQ(tracker.find("fc_1")->value(), nlohmann::json({{"id", 7}}));
+
+  openai::RunStepDeltaEvent step;
+  step.id = "step_1";
+  openai::RunStepDeltaDetails details;
+  openai::ToolCallDelta tool_call;
+  tool_call.index = 1;
+  tool_call.function = openai::FunctionToolCallDetails{};
+  tool_call.function->arguments = "[\"a\",";
+  details.tool_calls.push_back(tool_call);
+  step.delta.step_details = details;
+  tracker.feed(step);
+  EXPECT_EQ(tracker.find("step_1:1")->value(), nlohmann::json({"a"}));
+
+  EXPECT_EQ(tracker.keys().size(), 3u);
+  tracker.erase("fc_1");
+  EXPECT_EQ(tracker.find("fc_1"), nullptr);
+}
@@ -516,6 +516,165 @@ data: [DONE]
   EXPECT_EQ(final_text, "The answer is 42");
 }
 
+TEST(ResponsesResourceTest, StreamResumableReconnectsFromLastSequence) {
+  using namespace openai;
+
+  auto mock_client = std::make_unique<oait::MockHttpClient>();
+  auto* mock_ptr = mock_client.get();
+
+  const std::string first = R"(data: {"response":{"id":"resp_resume","object":"response","created_at":1,"model":"o3","status":"in_progress","output":[]},"sequence_number":0,"type":"response.created"}
+
+data: {"content_index":0,"delta":"Hello ","item_id":"msg_1","output_index":0,"sequence_number":1,"type":"response.output_text.delta"}
+
+data: {"content_index":0,"delta":"wor)";
+
+  const std::string resumed = R"(data: {"content_index":0,"delta":"Hello ","item_id":"msg_1","output_index":0,"sequence_number":1,"type":"response.output_text.delta"}
+
+data: {"content_index":0,"delta":"world","item_id":"msg_1","output_index":0,"sequence_number":2,"type":"response.output_text.delta"}
+
+data: {"response":{"id":"resp_resume","object":"response","created_at":1,"model":"o3","status":"completed","output":[]},"sequence_number":3,"type":"response.completed"}
+
+)";
+
+  mock_ptr->enqueue_interrupted_stream(first, "connection reset");
+  mock_ptr->enqueue_response(HttpResponse{200, {}, resumed});
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+  options.response_stream_decode.fast_text_deltas = true;
+
+  OpenAIClient client(options, std::move(mock_client));
+
+  ResponseRequest request;
+  request.model = "o3";
+  request.background = true;
+
+  ResponseStreamResumeOptions resume_options;
+  resume_options.reconnect_delay = std::chrono::milliseconds(0);
+
+  std::string text;
+  std::vector<int> sequence_numbers;
+  client.responses().stream_resumable(
+      request,
+      [&](const ResponseStreamEvent& event) {
+        sequence_numbers.push_back(event.sequence_number);
+        if (event.text_delta) {
+          text += event.text_delta->delta;
+        }
+        return true;
+      },
+      resume_options,
+      RequestOptions{});
+
+  EXPECT_EQ(text, "Hello world");
+  EXPECT_EQ(sequence_numbers, (std::vector<int>{0, 1, 2, 3}));
+  EXPECT_EQ(mock_ptr->call_count(), 2u);
+  ASSERT_TRUE(mock_ptr->last_request().has_value());
+  const auto& last = *mock_ptr->last_request();
+  EXPECT_EQ(last.method, "GET");
+  EXPECT_NE(last.url.find("/responses/resp_resume?"), std::string::npos);
+  EXPECT_NE(last.url.find("stream=true"), std::string::npos);
+  EXPECT_NE(last.url.find("starting_after=1"), std::string::npos);
+}
+
+TEST(ResponsesResourceTest, StreamResumableThrowsWhenReconnectsExhausted) {
+  using namespace openai;
+
+  auto mock_client = std::make_unique<oait::MockHttpClient>();
+  auto* mock_ptr = mock_client.get();
+
+  const std::string partial = R"(data: {"response":{"id":"resp_drop","object":"response","created_at":1,"model":"o3","status":"in_progress","output":[]},"sequence_number":0,"type":"response.created"}
+
+)";
+
+  mock_ptr->enqueue_interrupted_stream(partial, "connection reset");
+  mock_ptr->enqueue_error("connection refused");
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+
+  OpenAIClient client(options, std::move(mock_client));
+
+  ResponseRequest request;
+  request.model = "o3";
+
+  ResponseStreamResumeOptions resume_options;
+  resume_options.max_reconnects = 1;
+  resume_options.reconnect_delay = std::chrono::milliseconds(0);
+
+  std::size_t event_count = 0;
+  EXPECT_THROW(client.responses().stream_resumable(
+                   request,
+                   [&](const ResponseStreamEvent&) {
+                     ++event_count;
+                     return true;
+                   },
+                   resume_options,
+                   RequestOptions{}),
+               APIConnectionError);
+  EXPECT_EQ(event_count, 1u);
+  EXPECT_EQ(mock_ptr->call_count(), 2u);
+}
+
+TEST(ResponsesResourceTest, StreamResumableDoesNotRepostWhenDroppedBeforeCreated) {
+  using namespace openai;
+
+  auto mock_client = std::make_unique<oait::MockHttpClient>();
+  auto* mock_ptr = mock_client.get();
+
+  mock_ptr->enqueue_interrupted_stream("data: {\"sequence_num", "connection reset");
+  mock_ptr->enqueue_response(HttpResponse{200, {}, ""});
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+
+  OpenAIClient client(options, std::move(mock_client));
+
+  ResponseRequest request;
+  request.model = "o3";
+  request.background = true;
+
+  ResponseStreamResumeOptions resume_options;
+  resume_options.reconnect_delay = std::chrono::milliseconds(0);
+
+  EXPECT_THROW(client.responses().stream_resumable(
+                   request, [](const ResponseStreamEvent&) { return true; }, resume_options, RequestOptions{}),
+               APIConnectionError);
+  EXPECT_EQ(mock_ptr->call_count(), 1u);
+}
+
+TEST(ResponsesResourceTest, RetrieveStreamForwardsStartingAfter) {
+  using namespace openai;
+
+  auto mock_client = std::make_unique<oait::MockHttpClient>();
+  auto* mock_ptr = mock_client.get();
+
+  mock_ptr->enqueue_response(HttpResponse{200, {}, "data: {\"type\":\"response.output_text.delta\",\"sequence_number\":5,\"delta\":\"x\"}\n\n"});
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+
+  OpenAIClient client(options, std::move(mock_client));
+
+  ResponseRetrieveOptions retrieve_options;
+  retrieve_options.stream = true;
+  retrieve_options.starting_after = 4;
+
+  std::vector<int> sequence_numbers;
+  client.responses().retrieve_stream(
+      "resp_1",
+      retrieve_options,
+      [&](const ResponseStreamEvent& event) {
+        sequence_numbers.push_back(event.sequence_number);
+        return true;
+      },
+      RequestOptions{});
+
+  EXPECT_EQ(sequence_numbers, (std::vector<int>{5}));
+  ASSERT_TRUE(mock_ptr->last_request().has_value());
+  EXPECT_NE(mock_ptr->last_request()->url.find("starting_after=4"), std::string::npos);
+}
+
 TEST(ResponsesResourceTest, ListParsesResponsesArray) {
   using namespace openai;
 
@@ -755,6 +914,85 @@ TEST(ResponsesStreamEventTest, ParsesTextDeltaEvent) {
   ASSERT_EQ(parsed->text_delta->logprobs[0].top_logprobs.size(), 1u);
 }
 
+TEST(ResponsesStreamEventTest, FastPathTextDeltaMatchesGenericParser) {
+  using namespace openai;
+
+  const std::vector<std::string> payloads = {
+      R"({"type":"response.output_text.delta","sequence_number":7,"item_id":"msg_1","output_index":1,"content_index":2,"delta":"Hi","logprobs":[]})",
+      R"({ "content_index" : 0, "delta" : "line\nquote\" slash\\ é 😀", "item_id":"msg_2", "logprobs" : [ ], "obfuscation":"abc", "output_index":0, "sequence_number":12, "type":"response.output_text.delta", "extra":{"nested":[1,{"k":"}"}]} })",
+      R"({"type":"response.output_text.delta","sequence_number":3,"delta":""})",
+  };
+
+  for (const auto& payload : payloads) {
+    ServerSentEvent fast_event;
+    fast_event.event = "response.output_text.delta";
+    fast_event.data = payload;
+
+    auto fast = parse_response_stream_event(fast_event, ResponseStreamDecodeOptions{.fast_text_deltas = true});
+    ASSERT_TRUE(fast.has_value()) << payload;
+    ASSERT_TRUE(fast->text_delta.has_value()) << payload;
+
+    const auto expected = json::parse(payload);
+    EXPECT_EQ(fast->type, ResponseStreamEvent::Type::OutputTextDelta);
+    EXPECT_EQ(fast->type_name, "response.output_text.delta");
+    EXPECT_EQ(fast->sequence_number, expected.at("sequence_number").get<int>());
+    EXPECT_EQ(fast->text_delta->delta, expected.value("delta", std::string{}));
+    EXPECT_EQ(fast->text_delta->item_id, expected.value("item_id", std::string{}));
+    EXPECT_EQ(fast->text_delta->output_index, expected.value("output_index", 0));
+    EXPECT_EQ(fast->text_delta->content_index, expected.value("content_index", 0));
+    EXPECT_EQ(fast->text_delta->sequence_number, fast->sequence_number);
+    ASSERT_TRUE(fast->event_name.has_value());
+    EXPECT_EQ(*fast->event_name, "response.output_text.delta");
+  }
+}
+
+TEST(ResponsesStreamEventTest, TextDeltaKeepsRawPayloadByDefault) {
+  using namespace openai;
+
+  ServerSentEvent sse_event;
+  sse_event.event = "response.output_text.delta";
+  sse_event.data =
+      R"({"type":"response.output_text.delta","sequence_number":5,"item_id":"msg_1","output_index":0,"content_index":0,"delta":"Hi","logprobs":[],"obfuscation":"q8Zr4"})";
+
+  auto parsed = parse_response_stream_event(sse_event);
+  ASSERT_TRUE(parsed.has_value());
+  ASSERT_TRUE(parsed->text_delta.has_value());
+  EXPECT_EQ(parsed->text_delta->delta, "Hi");
+  EXPECT_EQ(parsed->raw.value("obfuscation", std::string{}), "q8Zr4");
+  EXPECT_EQ(parsed->text_delta->raw.value("obfuscation", std::string{}), "q8Zr4");
+
+  auto fast = parse_response_stream_event(sse_event, ResponseStreamDecodeOptions{.fast_text_deltas = true});
+  ASSERT_TRUE(fast.has_value());
+  EXPECT_EQ(fast->text_delta->delta, "Hi");
+  EXPECT_TRUE(fast->raw.empty());
+}
+
+TEST(ResponsesStreamEventTest, FastPathFallsBackForUnusualDeltas) {
+  using namespace openai;
+
+  const ResponseStreamDecodeOptions fast_options{.fast_text_deltas = true};
+
+  ServerSentEvent no_sequence;
+  no_sequence.data = R"({"type":"response.output_text.delta","delta":"Hi"})";
+  auto parsed = parse_response_stream_event(no_sequence, fast_options);
+  ASSERT_TRUE(parsed.has_value());
+  ASSERT_TRUE(parsed->text_delta.has_value());
+  EXPECT_EQ(parsed->text_delta->delta, "Hi");
+  EXPECT_TRUE(parsed->raw.contains("delta"));
+
+  ServerSentEvent mentions_type;
+  mentions_type.data = R"({"type":"response.output_text.done","sequence_number":4,"text":"response.output_text.delta"})";
+  parsed = parse_response_stream_event(mentions_type, fast_options);
+  ASSERT_TRUE(parsed.has_value());
+  EXPECT_EQ(parsed->type, ResponseStreamEvent::Type::OutputTextDone);
+  ASSERT_TRUE(parsed->text_done.has_value());
+  EXPECT_EQ(parsed->text_done->text, "response.output_text.delta");
+
+  ServerSentEvent truncated;
+  truncated.data = R"({"type":"response.output_text.delta","sequence_number":4,"delta":"Hi)";
+  EXPECT_FALSE(parse_response_stream_event(truncated, fast_options).has_value());
+}
+
 TEST(ResponsesStreamEventTest, ParsesFunctionArgumentsDoneEvent) {
   using namespace openai;
 
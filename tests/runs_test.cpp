@@ -2,11 +2,13 @@
 
 #include "openai/client.hpp"
 #include "openai/runs.hpp"
+#include "openai/poll_scheduler.hpp"
 #include "openai/assistant_stream.hpp"
 #include "support/mock_http_client.hpp"
 
 #include <nlohmann/json.hpp>
 #include <chrono>
+#include <future>
 
 namespace oait = openai::testing;
 
@@ -135,7 +137,7 @@ TEST(RunsResourceTest, ListAndSubmitToolOutputs) {
 
   RunSubmitToolOutputsRequest submit;
   submit.thread_id = "thread_1";
-  submit.tool_outputs.push_back(RunSubmitToolOutput{.tool_call_id = "call_1", .output = "result"});
+  submit.tool_outputs.push_back(RunSubmitToolOutput{.output = "result", .tool_call_id = "call_1"});
   auto run = client.runs().submit_tool_outputs("run_1", submit);
   EXPECT_EQ(run.status, "in_progress");
 }
@@ -287,7 +289,7 @@ TEST(RunsResourceTest, SubmitToolOutputsStreamCollectsEvents) {
 
   RunSubmitToolOutputsRequest request;
   request.thread_id = "thread_1";
-  request.tool_outputs.push_back(RunSubmitToolOutput{.tool_call_id = "call_1", .output = "{}"});
+  request.tool_outputs.push_back(RunSubmitToolOutput{.output = "{}", .tool_call_id = "call_1"});
 
   auto events = client.runs().submit_tool_outputs_stream("run_1", request);
   ASSERT_EQ(events.size(), 2u);
@@ -348,7 +350,7 @@ TEST(RunsResourceTest, SubmitToolOutputsStreamRequiresThreadId) {
 
   RunSubmitToolOutputsRequest request;
   // thread_id intentionally left empty
-  request.tool_outputs.push_back(RunSubmitToolOutput{.tool_call_id = "call", .output = "{}"});
+  request.tool_outputs.push_back(RunSubmitToolOutput{.output = "{}", .tool_call_id = "call"});
 
   EXPECT_THROW(client.runs().submit_tool_outputs_stream("run_1", request), OpenAIError);
 }
@@ -432,7 +434,7 @@ TEST(RunsResourceTest, SubmitToolOutputsAndPoll) {
 
   RunSubmitToolOutputsRequest request;
   request.thread_id = "thread_1";
-  request.tool_outputs.push_back(RunSubmitToolOutput{.tool_call_id = "call", .output = "result"});
+  request.tool_outputs.push_back(RunSubmitToolOutput{.output = "result", .tool_call_id = "call"});
 
   RequestOptions request_options;
   auto run = client.runs().submit_tool_outputs_and_poll(
@@ -453,7 +455,7 @@ TEST(RunsResourceTest, SubmitToolOutputsRequiresThreadIdForHelper) {
   OpenAIClient client(options, std::move(mock_client));
 
   RunSubmitToolOutputsRequest request;
-  request.tool_outputs.push_back(RunSubmitToolOutput{.tool_call_id = "call", .output = "{}"});
+  request.tool_outputs.push_back(RunSubmitToolOutput{.output = "{}", .tool_call_id = "call"});
 
   EXPECT_THROW(client.runs().submit_tool_outputs("run_1", request), OpenAIError);
 }
@@ -559,3 +561,117 @@ TEST(RunsResourceTest, CreateAndRunAutoResolvesToolCalls) {
   EXPECT_EQ(final_run.status, "completed");
   EXPECT_EQ(generator_invocations, 1);
 }
+
+TEST(PollSchedulerTest, ResolvesRunFutureOnTerminalStatus) {
+  using namespace openai;
+
+  auto mock_client = std::make_unique<oait::MockHttpClient>();
+  auto* mock_ptr = mock_client.get();
+
+  const std::string queued =
+      R"({"id":"run_1","assistant_id":"asst","created_at":1,"model":"gpt-4o","object":"thread.run","parallel_tool_calls":false,"status":"in_progress","thread_id":"thread_1","tools":[]})";
+  const std::string completed =
+      R"({"id":"run_1","assistant_id":"asst","created_at":1,"model":"gpt-4o","object":"thread.run","parallel_tool_calls":false,"status":"completed","thread_id":"thread_1","tools":[]})";
+
+  mock_ptr->enqueue_response(HttpResponse{200, {{"openai-poll-after-ms", "1"}}, queued});
+  mock_ptr->enqueue_response(HttpResponse{200, {}, completed});
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+
+  OpenAIClient client(options, std::move(mock_client));
+
+  // The header overrides an initial interval far longer than the test would wait.
+  PollSchedulerOptions scheduler_options;
+  scheduler_options.initial_interval = std::chrono::milliseconds(60000);
+  PollScheduler scheduler(client, scheduler_options);
+
+  auto future = scheduler.run("thread_1", "run_1");
+  ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+  EXPECT_EQ(future.get().status, "completed");
+  EXPECT_EQ(mock_ptr->call_count(), 2u);
+  ASSERT_TRUE(mock_ptr->last_request().has_value());
+  EXPECT_EQ(mock_ptr->last_request()->method, "GET");
+  EXPECT_NE(mock_ptr->last_request()->url.find("/threads/thread_1/runs/run_1"), std::string::npos);
+  EXPECT_EQ(mock_ptr->last_request()->headers.at("OpenAI-Beta"), "assistants=v2");
+  EXPECT_EQ(scheduler.pending(), 0u);
+}
+
+TEST(PollSchedulerTest, InterleavesPollsAndReportsErrorsToCallbacks) {
+  using namespace openai;
+
+  auto mock_client = std::make_unique<oait::MockHttpClient>();
+  auto* mock_ptr = mock_client.get();
+
+  const std::string queued =
+      R"({"id":"run_1","assistant_id":"asst","created_at":1,"model":"gpt-4o","object":"thread.run","parallel_tool_calls":false,"status":"queued","thread_id":"thread_1","tools":[]})";
+  const std::string requires_action =
+      R"({"id":"run_1","assistant_id":"asst","created_at":1,"model":"gpt-4o","object":"thread.run","parallel_tool_calls":false,"status":"requires_action","thread_id":"thread_1","tools":[]})";
+
+  // With one worker the run is polled first, then the job while the run waits out its delay.
+  mock_ptr->enqueue_response(HttpResponse{200, {{"openai-poll-after-ms", "100"}}, queued});
+  mock_ptr->enqueue_response(HttpResponse{404, {}, R"({"error":{"message":"No such job","type":"invalid_request_error"}})"});
+  mock_ptr->enqueue_response(HttpResponse{200, {}, requires_action});
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+  options.max_retries = 0;
+
+  OpenAIClient client(options, std::move(mock_client));
+
+  PollSchedulerOptions scheduler_options;
+  scheduler_options.workers = 1;
+  PollScheduler scheduler(client, scheduler_options);
+
+  auto run = scheduler.run("thread_1", "run_1");
+  std::promise<std::exception_ptr> job_error;
+  scheduler.fine_tuning_job("ftjob_missing", [&job_error](FineTuningJob job, std::exception_ptr error) {
+    EXPECT_TRUE(job.id.empty());
+    job_error.set_value(error);
+  });
+
+  auto error_future = job_error.get_future();
+  ASSERT_EQ(error_future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+  const auto error = error_future.get();
+  ASSERT_TRUE(error);
+  try {
+    std::rethrow_exception(error);
+  } catch (const APIError& ex) {
+    EXPECT_EQ(ex.status_code(), 404);
+  } catch (...) {
+    FAIL() << "expected APIError";
+  }
+
+  ASSERT_EQ(run.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+  EXPECT_EQ(run.get().status, "requires_action");
+  EXPECT_EQ(mock_ptr->call_count(), 3u);
+}
+
+TEST(PollSchedulerTest, KeepsPollingThroughTransientErrors) {
+  using namespace openai;
+
+  auto mock_client = std::make_unique<oait::MockHttpClient>();
+  auto* mock_ptr = mock_client.get();
+
+  const std::string completed =
+      R"({"id":"run_1","assistant_id":"asst","created_at":1,"model":"gpt-4o","object":"thread.run","parallel_tool_calls":false,"status":"completed","thread_id":"thread_1","tools":[]})";
+
+  mock_ptr->enqueue_error("connection reset");
+  mock_ptr->enqueue_response(HttpResponse{503, {}, R"({"error":{"message":"overloaded"}})"});
+  mock_ptr->enqueue_response(HttpResponse{200, {}, completed});
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+  options.max_retries = 0;
+
+  OpenAIClient client(options, std::move(mock_client));
+
+  PollSchedulerOptions scheduler_options;
+  scheduler_options.initial_interval = std::chrono::milliseconds(1);
+  PollScheduler scheduler(client, scheduler_options);
+
+  auto future = scheduler.run("thread_1", "run_1");
+  ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+  EXPECT_EQ(future.get().status, "completed");
+  EXPECT_EQ(mock_ptr->call_count(), 3u);
+}
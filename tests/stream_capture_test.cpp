@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+
+#include "openai/client.hpp"
+#include "openai/stream_capture.hpp"
+#include "support/mock_http_client.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+namespace oait = openai::testing;
+
+namespace {
+
+std::filesystem::path fresh_capture_path(const std::string& name) {
+  auto path = std::filesystem::temp_directory_path() / name;
+  std::filesystem::remove(path);
+  return path;
+}
+
+openai::ResponseRequest make_request() {
+  openai::ResponseRequest request;
+  request.model = "gpt-4o-mini";
+  return request;
+}
+
+}  // namespace
+
+TEST(StreamCaptureTest, WriterRoundTripsExchanges) {
+  const auto path = fresh_capture_path("openai-capture-roundtrip.bin");
+  {
+    openai::StreamCaptureWriter writer(path.string());
+    const auto first = writer.begin_exchange("POST", "https://api.openai.com/v1/responses");
+    writer.record_chunk(first, "data: a\n\n", 9);
+    writer.record_chunk(first, "data: b\n\n", 9);
+    writer.end_exchange(first, 200, {{"content-type", "text/event-stream"}});
+
+    const auto second = writer.begin_exchange("GET", "https://api.openai.com/v1/responses/resp_1");
+    writer.record_chunk(second, "data: c", 7);
+    writer.fail_exchange(second, "connection reset");
+  }
+  {
+    openai::StreamCaptureWriter appender(path.string());
+    const auto third = appender.begin_exchange("GET", "https://api.openai.com/v1/models");
+    appender.record_chunk(third, "{}", 2);
+  }
+
+  auto exchanges = openai::read_stream_capture(path.string());
+  ASSERT_EQ(exchanges.size(), 3u);
+
+  EXPECT_EQ(exchanges[0].method, "POST");
+  EXPECT_EQ(exchanges[0].url, "https://api.openai.com/v1/responses");
+  EXPECT_EQ(exchanges[0].status_code, 200);
+  EXPECT_EQ(exchanges[0].headers.at("content-type"), "text/event-stream");
+  ASSERT_EQ(exchanges[0].chunks.size(), 2u);
+  EXPECT_EQ(exchanges[0].chunks[1].data, "data: b\n\n");
+  EXPECT_LE(exchanges[0].chunks[0].offset, exchanges[0].chunks[1].offset);
+  EXPECT_FALSE(exchanges[0].error.has_value());
+
+  ASSERT_TRUE(exchanges[1].error.has_value());
+  EXPECT_EQ(*exchanges[1].error, "connection reset");
+  ASSERT_EQ(exchanges[1].chunks.size(), 1u);
+
+  EXPECT_EQ(exchanges[2].method, "GET");
+  EXPECT_TRUE(exchanges[2].error.has_value());
+
+  std::filesystem::remove(path);
+}
+
+
+TEST(StreamCaptureTest, AppendingAfterACrashKeepsExchangeIdsDistinct) {
+  const auto path = fresh_capture_path("openai-capture-crash.bin");
+  {
+    openai::StreamCaptureWriter writer(path.string());
+    const auto first = writer.begin_exchange("POST", "https://api.openai.com/v1/responses");
+    writer.record_chunk(first, "data: a\n\n", 9);
+    writer.flush();
+  }
+  // Simulate a crash mid-record: a header promising more payload than was written.
+  {
+    std::ofstream torn(path, std::ios::binary | std::ios::app);
+    const char partial[] = {2, 0, 0, 0, 0};
+    torn.write(partial, sizeof(partial));
+  }
+  {
+    openai::StreamCaptureWriter writer(path.string());
+    const auto second = writer.begin_exchange("GET", "https://api.openai.com/v1/models");
+    EXPECT_NE(second, 0u);
+    writer.record_chunk(second, "{}", 2);
+    writer.end_exchange(second, 200, {});
+  }
+
+  auto exchanges = openai::read_stream_capture(path.string());
+  ASSERT_EQ(exchanges.size(), 2u);
+  ASSERT_EQ(exchanges[0].chunks.size(), 1u);
+  EXPECT_EQ(exchanges[0].chunks[0].data, "data: a\n\n");
+  ASSERT_TRUE(exchanges[0].error.has_value());
+  EXPECT_EQ(exchanges[1].url, "https://api.openai.com/v1/models");
+  EXPECT_EQ(exchanges[1].status_code, 200);
+  ASSERT_EQ(exchanges[1].chunks.size(), 1u);
+  EXPECT_EQ(exchanges[1].chunks[0].data, "{}");
+  EXPECT_FALSE(exchanges[1].error.has_value());
+}
+
+TEST(StreamCaptureTest, CapturedStreamReplaysThroughClient) {
+  using namespace openai;
+
+  const auto path = fresh_capture_path("openai-capture-client.bin");
+  const std::string body =
+      "data: {\"type\":\"response.output_text.delta\",\"sequence_number\":1,\"delta\":\"Hello\"}\n\n"
+      "data: {\"type\":\"response.output_text.delta\",\"sequence_number\":2,\"delta\":\" world\"}\n\n";
+
+  auto mock_client = std::make_unique<oait::MockHttpClient>();
+  mock_client->enqueue_response(HttpResponse{200, {{"content-type", "text/event-stream"}}, body});
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+
+  std::string live_text;
+  {
+    OpenAIClient client(options, std::move(mock_client));
+    RequestOptions request_options;
+    request_options.stream_capture = std::make_shared<StreamCaptureWriter>(path.string());
+    client.responses().stream(
+        make_request(),
+        [&](const ResponseStreamEvent& event) {
+          if (event.text_delta) {
+            live_text += event.text_delta->delta;
+          }
+          return true;
+        },
+        request_options);
+  }
+  EXPECT_EQ(live_text, "Hello world");
+
+  auto replay = StreamReplayHttpClient::from_file(path.string());
+  auto* replay_ptr = replay.get();
+  OpenAIClient replay_client(options, std::move(replay));
+  std::string replayed_text;
+  replay_client.responses().stream(make_request(), [&](const ResponseStreamEvent& event) {
+    if (event.text_delta) {
+      replayed_text += event.text_delta->delta;
+    }
+    return true;
+  });
+  EXPECT_EQ(replayed_text, live_text);
+  EXPECT_EQ(replay_ptr->remaining(), 0u);
+
+  std::filesystem::remove(path);
+}
+
+TEST(StreamCaptureTest, ReplayRethrowsCapturedTransportFailureAfterChunks) {
+  openai::CapturedExchange exchange;
+  exchange.method = "POST";
+  exchange.chunks.push_back(openai::CapturedChunk{std::chrono::nanoseconds(0), "data: partial"});
+  exchange.error = std::string("connection reset");
+
+  openai::StreamReplayHttpClient client({exchange});
+  openai::HttpRequest request;
+  std::string received;
+  request.on_chunk = [&](const char* data, std::size_t size) { received.append(data, size); };
+  EXPECT_THROW(client.request(request), openai::OpenAIError);
+  EXPECT_EQ(received, "data: partial");
+}
+
+TEST(StreamCaptureTest, OriginalPacingHonoursChunkOffsets) {
+  openai::CapturedExchange exchange;
+  exchange.status_code = 200;
+  exchange.chunks.push_back(openai::CapturedChunk{std::chrono::milliseconds(0), "a"});
+  exchange.chunks.push_back(openai::CapturedChunk{std::chrono::milliseconds(30), "b"});
+
+  openai::StreamReplayHttpClient paced({exchange, exchange}, openai::StreamReplayPacing::Original);
+  openai::HttpRequest request;
+  const auto start = std::chrono::steady_clock::now();
+  auto response = paced.request(request);
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(response.body, "ab");
+  EXPECT_GE(elapsed, std::chrono::milliseconds(30));
+  EXPECT_EQ(paced.remaining(), 1u);
+}
@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+
+#include "openai/stream_hub.hpp"
+#include "openai/streaming.hpp"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::vector<int> drain(openai::StreamSubscription<int>& subscription) {
+  std::vector<int> values;
+  while (auto value = subscription.next(std::chrono::milliseconds(1000))) {
+    values.push_back(*value);
+  }
+  return values;
+}
+
+}  // namespace
+
+TEST(StreamHubTest, FansOutEveryEventToEverySubscriber) {
+  openai::StreamHub<int> hub;
+  auto first = hub.subscribe();
+  auto second = hub.subscribe();
+  EXPECT_EQ(hub.subscriber_count(), 2u);
+
+  for (int i = 1; i <= 3; ++i) {
+    hub.publish(i);
+  }
+  hub.close();
+
+  EXPECT_EQ(drain(*first), (std::vector<int>{1, 2, 3}));
+  EXPECT_EQ(drain(*second), (std::vector<int>{1, 2, 3}));
+  EXPECT_TRUE(first->finished());
+}
+
+TEST(StreamHubTest, DropPolicyKeepsSlowSubscriberFromStallingOthers) {
+  openai::StreamHub<int> hub;
+
+  openai::StreamSubscriberOptions slow_options;
+  slow_options.capacity = 2;
+  slow_options.overflow = openai::StreamHubOverflowPolicy::DropNewest;
+  auto slow = hub.subscribe(slow_options);
+  auto fast = hub.subscribe();
+
+  for (int i = 0; i < 10; ++i) {
+    hub.publish(i);
+  }
+  hub.close();
+
+  EXPECT_EQ(drain(*fast).size(), 10u);
+  EXPECT_EQ(drain(*slow), (std::vector<int>{0, 1}));
+  EXPECT_EQ(slow->dropped(), 8u);
+  EXPECT_EQ(fast->dropped(), 0u);
+}
+
+TEST(StreamHubTest, BlockPolicyDeliversEveryEventThroughSmallRing) {
+  openai::StreamHub<int> hub;
+
+  openai::StreamSubscriberOptions options;
+  options.capacity = 4;
+  options.overflow = openai::StreamHubOverflowPolicy::Block;
+  auto subscription = hub.subscribe(options);
+
+  std::vector<int> received;
+  std::thread consumer([&] { received = drain(*subscription); });
+
+  for (int i = 0; i < 500; ++i) {
+    hub.publish(i);
+  }
+  hub.close();
+  consumer.join();
+
+  ASSERT_EQ(received.size(), 500u);
+  for (int i = 0; i < 500; ++i) {
+    EXPECT_EQ(received[static_cast<std::size_t>(i)], i);
+  }
+  EXPECT_EQ(subscription->dropped(), 0u);
+}
+
+TEST(StreamHubTest, BlockedPublisherDoesNotStallSubscribe) {
+  openai::StreamHub<int> hub;
+
+  openai::StreamSubscriberOptions options;
+  options.capacity = 2;
+  options.overflow = openai::StreamHubOverflowPolicy::Block;
+  auto slow = hub.subscribe(options);
+
+  std::thread publisher([&] {
+    for (int i = 0; i < 3; ++i) {
+      hub.publish(i);
+    }
+  });
+  while (slow->pending() < 2) {
+    std::this_thread::yield();
+  }
+
+  // The publisher is now parked on the full ring; the hub itself must stay usable.
+  auto late = hub.subscribe();
+  EXPECT_EQ(hub.subscriber_count(), 2u);
+
+  EXPECT_EQ(slow->next(), 0);
+  publisher.join();
+  EXPECT_EQ(slow->next(), 1);
+  EXPECT_EQ(slow->next(), 2);
+  hub.close();
+  EXPECT_FALSE(slow->next().has_value());
+}
+
+TEST(StreamHubTest, LateSubscriberReplaysBoundedHistory) {
+  openai::StreamHubOptions hub_options;
+  hub_options.history_size = 3;
+  openai::StreamHub<int> hub(hub_options);
+
+  for (int i = 1; i <= 5; ++i) {
+    hub.publish(i);
+  }
+  auto late = hub.subscribe();
+
+  openai::StreamSubscriberOptions live_only;
+  live_only.replay_history = false;
+  auto live = hub.subscribe(live_only);
+
+  hub.publish(6);
+  hub.close();
+
+  EXPECT_EQ(drain(*late), (std::vector<int>{3, 4, 5, 6}));
+  EXPECT_EQ(drain(*live), (std::vector<int>{6}));
+}
+
+TEST(StreamHubTest, UnsubscribedSubscribersStopReceiving) {
+  openai::StreamHub<int> hub;
+  auto kept = hub.subscribe();
+  auto dropped = hub.subscribe();
+
+  hub.publish(1);
+  dropped->unsubscribe();
+  hub.publish(2);
+  EXPECT_EQ(hub.subscriber_count(), 1u);
+  hub.close();
+
+  EXPECT_EQ(drain(*kept), (std::vector<int>{1, 2}));
+  EXPECT_EQ(dropped->pending(), 1u);
+  EXPECT_THROW(hub.publish(3), openai::OpenAIError);
+}
+
+TEST(StreamHubTest, PublisherPlugsIntoSSEEventStream) {
+  openai::StreamHub<openai::ServerSentEvent> hub;
+  auto audit = hub.subscribe();
+  auto websocket = hub.subscribe();
+
+  openai::SSEEventStream stream(hub.publisher());
+  const std::string payload = "event: response.output_text.delta\ndata: {\"delta\":\"Hi\"}\n\ndata: [DONE]\n\n";
+  stream.feed(payload.data(), payload.size());
+  stream.finalize();
+  hub.close();
+
+  for (auto* subscription : {audit.get(), websocket.get()}) {
+    auto first = subscription->next(std::chrono::milliseconds(1000));
+    ASSERT_TRUE(first.has_value());
+    ASSERT_TRUE(first->event.has_value());
+    EXPECT_EQ(*first->event, "response.output_text.delta");
+    auto second = subscription->next(std::chrono::milliseconds(1000));
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(second->data, "[DONE]");
+    EXPECT_FALSE(subscription->next(std::chrono::milliseconds(1000)).has_value());
+  }
+}
@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+
+#include "openai/client.hpp"
+#include "openai/stream_capture.hpp"
+#include "openai/stream_stats.hpp"
+#include "support/mock_http_client.hpp"
+
+#include <chrono>
+#include <thread>
+
+namespace oait = openai::testing;
+
+namespace {
+
+using namespace std::chrono_literals;
+
+std::string chat_chunk(const std::string& delta) {
+  return "data: {\"id\":\"chatcmpl-1\",\"object\":\"chat.completion.chunk\",\"created\":1,\"model\":\"gpt-4o-mini\","
+         "\"choices\":[{\"index\":0,\"delta\":" +
+         delta + ",\"finish_reason\":null}]}\n\n";
+}
+
+openai::ChatCompletionRequest make_chat_request() {
+  openai::ChatCompletionRequest request;
+  request.model = "gpt-4o-mini";
+  return request;
+}
+
+}  // namespace
+
+TEST(StreamStatsTest, PercentilesAndRate) {
+  openai::StreamStats stats;
+  EXPECT_EQ(stats.inter_delta_percentile(50), 0ns);
+  EXPECT_DOUBLE_EQ(stats.tokens_per_second(), 0.0);
+
+  stats.inter_delta_gaps = {40ms, 10ms, 30ms, 20ms};
+  EXPECT_EQ(stats.inter_delta_percentile(0), 10ms);
+  EXPECT_EQ(stats.inter_delta_percentile(50), 20ms);
+  EXPECT_EQ(stats.inter_delta_percentile(99), 40ms);
+  EXPECT_NEAR(stats.tokens_per_second(), 4 / 0.1, 1e-9);
+}
+
+TEST(StreamStatsTest, ChatStreamRecordsFirstContentAndGaps) {
+  using namespace openai;
+
+  CapturedExchange exchange;
+  exchange.status_code = 200;
+  exchange.headers = {{"content-type", "text/event-stream"}};
+  exchange.chunks.push_back({0ms, chat_chunk("{\"role\":\"assistant\",\"content\":\"\"}")});
+  exchange.chunks.push_back({30ms, chat_chunk("{\"content\":\"Hel\"}")});
+  exchange.chunks.push_back({50ms, chat_chunk("{\"content\":\"lo\"}")});
+  exchange.chunks.push_back({70ms, chat_chunk("{\"content\":\"!\"}") + "data: [DONE]\n\n"});
+
+  std::vector<StreamStats> published;
+  ClientOptions options;
+  options.api_key = "sk-test";
+  options.on_stream_stats = [&](const StreamStats& stats) { published.push_back(stats); };
+  OpenAIClient client(options, std::make_unique<StreamReplayHttpClient>(std::vector<CapturedExchange>{exchange},
+                                                                          StreamReplayPacing::Original));
+
+  RequestOptions request_options;
+  request_options.stream_stats = std::make_shared<StreamStats>();
+  client.chat().completions().stream(make_chat_request(), [](const ServerSentEvent&) { return true; },
+                                     request_options);
+
+  const auto& stats = *request_options.stream_stats;
+  EXPECT_EQ(stats.endpoint, "/chat/completions");
+  EXPECT_EQ(stats.events, 5u);
+  EXPECT_EQ(stats.content_deltas, 3u);
+  ASSERT_TRUE(stats.time_to_first_byte.has_value());
+  ASSERT_TRUE(stats.time_to_first_content.has_value());
+  EXPECT_GE(*stats.time_to_first_content, 25ms);
+  EXPECT_LT(*stats.time_to_first_byte, *stats.time_to_first_content);
+  ASSERT_EQ(stats.inter_delta_gaps.size(), 2u);
+  EXPECT_GE(stats.inter_delta_percentile(0), 15ms);
+  EXPECT_GE(stats.total_duration, 70ms);
+  EXPECT_GT(stats.tokens_per_second(), 0.0);
+
+  ASSERT_EQ(published.size(), 1u);
+  EXPECT_EQ(published[0].content_deltas, 3u);
+}
+
+TEST(StreamStatsTest, ResponsesStreamCountsDeltaEventsOnly) {
+  using namespace openai;
+
+  const std::string body =
+      "event: response.created\n"
+      "data: {\"type\":\"response.created\",\"sequence_number\":0,\"response\":{\"id\":\"resp_1\",\"object\":\"response\",\"created_at\":1,\"model\":\"gpt-4o-mini\",\"output\":[]}}\n\n"
+      "event: response.output_text.delta\n"
+      "data: {\"type\":\"response.output_text.delta\",\"sequence_number\":1,\"item_id\":\"msg_1\",\"output_index\":0,\"content_index\":0,\"delta\":\"Hi\",\"logprobs\":[]}\n\n"
+      "event: response.reasoning_summary_text.delta\n"
+      "data: {\"type\":\"response.reasoning_summary_text.delta\",\"sequence_number\":2,\"item_id\":\"rs_1\",\"output_index\":0,\"summary_index\":0,\"delta\":\"x\"}\n\n"
+      "event: response.output_text.done\n"
+      "data: {\"type\":\"response.output_text.done\",\"sequence_number\":3,\"item_id\":\"msg_1\",\"output_index\":0,\"content_index\":0,\"text\":\"Hi\"}\n\n";
+
+  auto mock_client = std::make_unique<oait::MockHttpClient>();
+  mock_client->enqueue_response(HttpResponse{200, {{"content-type", "text/event-stream"}}, body});
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+  OpenAIClient client(options, std::move(mock_client));
+
+  RequestOptions request_options;
+  request_options.stream_stats = std::make_shared<StreamStats>();
+  ResponseRequest request;
+  request.model = "gpt-4o-mini";
+  client.responses().stream(request, [](const ResponseStreamEvent&) { return true; }, request_options);
+
+  EXPECT_EQ(request_options.stream_stats->endpoint, "/responses");
+  EXPECT_EQ(request_options.stream_stats->events, 4u);
+  EXPECT_EQ(request_options.stream_stats->content_deltas, 2u);
+  EXPECT_EQ(request_options.stream_stats->bytes, body.size());
+}
+
+TEST(StreamStatsTest, TypedResponsesStreamClassifiesFromParsedEvents) {
+  using namespace openai;
+
+  // No SSE event names, and a non-delta payload that mentions ".delta" in a string value.
+  const std::string body =
+      "data: {\"type\":\"response.created\",\"sequence_number\":0,\"response\":{\"id\":\"resp_1\",\"object\":\"response\",\"created_at\":1,\"model\":\"gpt-4o-mini\",\"metadata\":{\"note\":\"x.delta\"},\"output\":[]}}\n\n"
+      "data: {\"type\":\"response.output_text.delta\",\"sequence_number\":1,\"item_id\":\"msg_1\",\"output_index\":0,\"content_index\":0,\"delta\":\"Hi\",\"logprobs\":[]}\n\n";
+
+  auto mock_client = std::make_unique<oait::MockHttpClient>();
+  mock_client->enqueue_response(HttpResponse{200, {{"content-type", "text/event-stream"}}, body});
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+  OpenAIClient client(options, std::move(mock_client));
+
+  RequestOptions request_options;
+  request_options.stream_stats = std::make_shared<StreamStats>();
+  ResponseRequest request;
+  request.model = "gpt-4o-mini";
+  client.responses().stream(
+      request,
+      [](const ResponseStreamEvent& event) {
+        if (event.text_delta) {
+          std::this_thread::sleep_for(20ms);
+        }
+        return true;
+      },
+      request_options);
+
+  const auto& stats = *request_options.stream_stats;
+  EXPECT_EQ(stats.events, 2u);
+  EXPECT_EQ(stats.content_deltas, 1u);
+  // Deltas are timed on arrival, before the handler runs.
+  ASSERT_TRUE(stats.time_to_first_content.has_value());
+  EXPECT_LT(*stats.time_to_first_content, 20ms);
+}
+
+TEST(StreamStatsTest, UnmeasuredStreamsSkipTheRecorder) {
+  openai::SSEEventStream stream;
+  stream.track_stats(nullptr, nullptr);
+  const std::string body = "data: {}\n\n";
+  stream.feed(body.data(), body.size());
+  stream.finalize();
+  EXPECT_EQ(stream.events().size(), 1u);
+}
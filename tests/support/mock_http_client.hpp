@@ -21,7 +21,12 @@ public:
     std::string message;
   };
 
-  using Enqueued = std::variant<HttpResponse, EnqueuedError>;
+  struct EnqueuedInterruptedStream {
+    std::string body;
+    std::string message;
+  };
+
+  using Enqueued = std::variant<HttpResponse, EnqueuedError, EnqueuedInterruptedStream>;
 
   HttpResponse request(const HttpRequest& request) override {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -37,7 +42,20 @@ public:
     if (std::holds_alternative<EnqueuedError>(next)) {
       throw OpenAIError(std::get<EnqueuedError>(next).message);
     }
+    if (std::holds_alternative<EnqueuedInterruptedStream>(next)) {
+      const auto& interrupted = std::get<EnqueuedInterruptedStream>(next);
+      if (request.on_status) {
+        request.on_status(200);
+      }
+      if (request.on_chunk) {
+        request.on_chunk(interrupted.body.data(), interrupted.body.size());
+      }
+      throw OpenAIError(interrupted.message);
+    }
     auto response = std::get<HttpResponse>(next);
+    if (request.on_status) {
+      request.on_status(response.status_code);
+    }
     if (request.on_chunk) {
       request.on_chunk(response.body.data(), response.body.size());
     }
@@ -57,6 +75,11 @@ public:
     responses_.push(EnqueuedError{std::move(message)});
   }
 
+  void enqueue_interrupted_stream(std::string body, std::string message) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    responses_.push(EnqueuedInterruptedStream{std::move(body), std::move(message)});
+  }
+
   [[nodiscard]] const std::optional<HttpRequest>& last_request() const {
     return last_request_;
   }
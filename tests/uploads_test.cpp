@@ -2,10 +2,100 @@
 
 #include "openai/client.hpp"
 #include "openai/uploads.hpp"
+#include "openai/utils/md5.hpp"
 #include "support/mock_http_client.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <thread>
+
 namespace oait = openai::testing;
 
+namespace {
+
+// Serves the create / parts / complete / cancel endpoints of one Upload, from several threads at once.
+class PartServerHttpClient final : public openai::HttpClient {
+public:
+  openai::HttpResponse request(const openai::HttpRequest& request) override {
+    const auto path = request.url.substr(request.url.find("/v1") + 3);
+    if (path == "/uploads") {
+      ++creates_;
+      return ok(R"({"id":"upl_1","object":"upload","status":"pending"})");
+    }
+    if (path == "/uploads/upl_1/complete") {
+      std::lock_guard<std::mutex> lock(mutex_);
+      complete_body_ = nlohmann::json::parse(request.body);
+      return ok(R"({"id":"upl_1","object":"upload","status":"completed"})");
+    }
+    if (path == "/uploads/upl_1/cancel") {
+      cancelled_ = true;
+      return ok(R"({"id":"upl_1","object":"upload","status":"cancelled"})");
+    }
+
+    const int now = ++in_flight_;
+    int seen = max_in_flight_.load();
+    while (now > seen && !max_in_flight_.compare_exchange_weak(seen, now)) {
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    --in_flight_;
+
+    // Framing, the part's bytes in place, closing framing.
+    EXPECT_TRUE(request.body_segments);
+    EXPECT_EQ(request.body_segments->segments.size(), 3u);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fail_status_ != 0 && part_calls_++ == 1) {
+      openai::HttpResponse failure;
+      failure.status_code = fail_status_;
+      failure.body = R"({"error":{"message":"part failed"}})";
+      return failure;
+    }
+    const std::string id = id_prefix_ + std::to_string(parts_.size());
+    parts_[id] = std::string(request.body_segments->segments[1]);
+    return ok(nlohmann::json{{"id", id}, {"object", "upload.part"}, {"upload_id", "upl_1"}}.dump());
+  }
+
+  bool supports_body_segments() const override { return true; }
+
+  std::string assembled() const {
+    std::string bytes;
+    for (const auto& id : complete_body_.at("part_ids")) {
+      bytes += parts_.at(id.get<std::string>());
+    }
+    return bytes;
+  }
+
+  int fail_status_ = 0;
+  std::string id_prefix_ = "part_";
+  std::atomic<int> creates_{0};
+  std::atomic<int> in_flight_{0};
+  std::atomic<int> max_in_flight_{0};
+  std::atomic<bool> cancelled_{false};
+  nlohmann::json complete_body_;
+  std::map<std::string, std::string> parts_;
+
+private:
+  static openai::HttpResponse ok(std::string body) { return openai::HttpResponse{200, {}, std::move(body)}; }
+
+  std::mutex mutex_;
+  int part_calls_ = 0;
+};
+
+std::string write_dataset(const std::filesystem::path& path, std::size_t size) {
+  std::string contents(size, '\0');
+  for (std::size_t i = 0; i < size; ++i) {
+    contents[i] = static_cast<char>('a' + (i * 7) % 26);
+  }
+  std::ofstream out(path, std::ios::binary);
+  out << contents;
+  return contents;
+}
+
+}  // namespace
+
 TEST(UploadsResourceTest, CreateUploadSendsJson) {
   using namespace openai;
 
@@ -136,3 +226,125 @@ TEST(UploadPartsResourceTest, CreatePartSendsMultipart) {
   EXPECT_NE(request.body.find("chunk.bin"), std::string::npos);
   EXPECT_NE(request.body.find("test"), std::string::npos);
 }
+
+TEST(UploadsResourceTest, UploadFileSendsOrderedPartsConcurrently) {
+  using namespace openai;
+
+  auto http = std::make_unique<PartServerHttpClient>();
+  auto* server = http.get();
+  server->fail_status_ = 503;
+
+  const auto path = std::filesystem::temp_directory_path() / "openai-cpp-upload-parts.jsonl";
+  const std::string contents = write_dataset(path, 10 * 1000 + 123);
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+  options.max_retries = 0;
+  OpenAIClient client(options, std::move(http));
+
+  UploadFileOptions upload_options;
+  upload_options.part_size = 1000;
+  upload_options.max_concurrency = 3;
+  std::size_t last_progress = 0;
+  upload_options.on_progress = [&](std::size_t uploaded, std::size_t total) {
+    EXPECT_GT(uploaded, last_progress);
+    EXPECT_EQ(total, contents.size());
+    last_progress = uploaded;
+  };
+
+  auto upload = client.uploads().upload_file(path.string(), "fine-tune", "application/jsonl", upload_options);
+  EXPECT_EQ(upload.status, "completed");
+
+  // The 503 on one part was retried on its own; every part id appears once, in file order.
+  EXPECT_EQ(server->complete_body_.at("part_ids").size(), 11u);
+  EXPECT_EQ(server->assembled(), contents);
+  EXPECT_EQ(server->complete_body_.at("md5"), utils::md5_hex(contents));
+  EXPECT_LE(server->max_in_flight_.load(), 3);
+  EXPECT_GT(server->max_in_flight_.load(), 1);
+  EXPECT_EQ(last_progress, contents.size());
+  EXPECT_FALSE(server->cancelled_.load());
+
+  std::filesystem::remove(path);
+}
+
+TEST(UploadsResourceTest, UploadFileCancelsOnPermanentPartFailure) {
+  using namespace openai;
+
+  auto http = std::make_unique<PartServerHttpClient>();
+  auto* server = http.get();
+  server->fail_status_ = 400;
+
+  const auto path = std::filesystem::temp_directory_path() / "openai-cpp-upload-fail.jsonl";
+  write_dataset(path, 4000);
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+  options.max_retries = 0;
+  OpenAIClient client(options, std::move(http));
+
+  UploadFileOptions upload_options;
+  upload_options.part_size = 1000;
+  EXPECT_THROW(client.uploads().upload_file(path.string(), "fine-tune", "application/jsonl", upload_options),
+               BadRequestError);
+  EXPECT_TRUE(server->cancelled_.load());
+  EXPECT_TRUE(server->complete_body_.is_null());
+
+  std::filesystem::remove(path);
+}
+
+TEST(UploadsResourceTest, UploadFileResumesFromCheckpoint) {
+  using namespace openai;
+
+  const auto path = std::filesystem::temp_directory_path() / "openai-cpp-upload-resume.jsonl";
+  const auto checkpoint = std::filesystem::temp_directory_path() / "openai-cpp-upload-resume.checkpoint";
+  std::filesystem::remove(checkpoint);
+  const std::string contents = write_dataset(path, 5 * 1000 + 10);
+
+  UploadFileOptions upload_options;
+  upload_options.part_size = 1000;
+  upload_options.max_concurrency = 1;
+  upload_options.max_part_attempts = 1;
+  upload_options.checkpoint_path = checkpoint.string();
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+  options.max_retries = 0;
+
+  // The first process loses its second part to a 503 and gives up, leaving the Upload open.
+  auto first_http = std::make_unique<PartServerHttpClient>();
+  auto* first = first_http.get();
+  first->fail_status_ = 503;
+  first->id_prefix_ = "first_";
+  {
+    OpenAIClient client(options, std::move(first_http));
+    EXPECT_THROW(client.uploads().upload_file(path.string(), "batch", "application/jsonl", upload_options),
+                 InternalServerError);
+    EXPECT_FALSE(first->cancelled_.load());
+    ASSERT_TRUE(std::filesystem::exists(checkpoint));
+    const auto saved = nlohmann::json::parse(std::ifstream(checkpoint));
+    EXPECT_EQ(saved.at("upload_id"), "upl_1");
+    ASSERT_EQ(saved.at("parts").size(), 1u);
+    EXPECT_EQ(saved.at("parts")[0].at("offset"), 0);
+    EXPECT_EQ(saved.at("parts")[0].at("bytes"), 1000);
+    EXPECT_EQ(saved.at("md5").at("length"), 1000);
+
+    // The second process sends only the missing parts to the same Upload.
+    auto second_http = std::make_unique<PartServerHttpClient>();
+    auto* second = second_http.get();
+    second->id_prefix_ = "second_";
+    upload_options.max_concurrency = 3;
+    OpenAIClient resumed(options, std::move(second_http));
+    auto upload = resumed.uploads().upload_file(path.string(), "batch", "application/jsonl", upload_options);
+    EXPECT_EQ(upload.status, "completed");
+    EXPECT_EQ(second->creates_.load(), 0);
+    EXPECT_EQ(second->parts_.size(), 5u);
+
+    second->parts_.insert(first->parts_.begin(), first->parts_.end());
+    EXPECT_EQ(second->complete_body_.at("part_ids")[0], "first_0");
+    EXPECT_EQ(second->assembled(), contents);
+    EXPECT_EQ(second->complete_body_.at("md5"), utils::md5_hex(contents));
+    EXPECT_FALSE(std::filesystem::exists(checkpoint));
+  }
+
+  std::filesystem::remove(path);
+}
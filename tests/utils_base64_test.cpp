@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "openai/error.hpp"
+#include "openai/utils/base64.hpp"
+
+using openai::utils::decode_base64;
+using openai::utils::decode_base64_floats;
+using openai::utils::decode_base64_into;
+using openai::utils::decoded_base64_size;
+
+namespace {
+
+std::string encode(const std::vector<std::uint8_t>& data) {
+  static constexpr char kAlphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  std::size_t i = 0;
+  for (; i + 3 <= data.size(); i += 3) {
+    const std::uint32_t word = (data[i] << 16) | (data[i + 1] << 8) | data[i + 2];
+    out += kAlphabet[(word >> 18) & 0x3F];
+    out += kAlphabet[(word >> 12) & 0x3F];
+    out += kAlphabet[(word >> 6) & 0x3F];
+    out += kAlphabet[word & 0x3F];
+  }
+  if (data.size() - i == 1) {
+    const std::uint32_t word = data[i] << 16;
+    out += kAlphabet[(word >> 18) & 0x3F];
+    out += kAlphabet[(word >> 12) & 0x3F];
+    out += "==";
+  } else if (data.size() - i == 2) {
+    const std::uint32_t word = (data[i] << 16) | (data[i + 1] << 8);
+    out += kAlphabet[(word >> 18) & 0x3F];
+    out += kAlphabet[(word >> 12) & 0x3F];
+    out += kAlphabet[(word >> 6) & 0x3F];
+    out += '=';
+  }
+  return out;
+}
+
+}  // namespace
+
+TEST(UtilsBase64Test, RoundTripsEveryLengthAcrossVectorWidths) {
+  // Lengths straddle the 12/24-byte SIMD blocks and their tail handling.
+  for (std::size_t length = 0; length < 300; ++length) {
+    std::vector<std::uint8_t> data(length);
+    for (std::size_t i = 0; i < length; ++i) {
+      data[i] = static_cast<std::uint8_t>((i * 131 + length * 7) & 0xFF);
+    }
+    const auto encoded = encode(data);
+    EXPECT_EQ(decoded_base64_size(encoded), length);
+    EXPECT_EQ(decode_base64(encoded), data) << "length " << length;
+  }
+}
+
+TEST(UtilsBase64Test, HandlesPaddingAndSurroundingWhitespace) {
+  const std::vector<std::uint8_t> expected{'h', 'i'};
+  EXPECT_EQ(decode_base64("aGk="), expected);
+  EXPECT_EQ(decode_base64("  aGk=\n"), expected);
+  EXPECT_TRUE(decode_base64("").empty());
+
+  std::uint8_t out[2];
+  EXPECT_THROW(decode_base64_into("aGVsbG8=", out, sizeof(out)), openai::OpenAIError);
+}
+
+TEST(UtilsBase64Test, RejectsCharactersOutsideTheAlphabet) {
+  std::string long_input = encode(std::vector<std::uint8_t>(200, 0x5A));
+  long_input[97] = '*';
+  EXPECT_THROW(decode_base64(long_input), openai::OpenAIError);
+  EXPECT_THROW(decode_base64("aG=k"), openai::OpenAIError);
+  EXPECT_THROW(decode_base64("aGk"), openai::OpenAIError);
+  EXPECT_THROW(decode_base64("aGk-"), openai::OpenAIError);
+}
+
+TEST(UtilsBase64Test, DecodesFloat32PayloadDirectly) {
+  std::vector<float> values(1536);
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    values[i] = static_cast<float>(i) * 0.001f - 0.75f;
+  }
+  std::vector<std::uint8_t> bytes(values.size() * sizeof(float));
+  std::memcpy(bytes.data(), values.data(), bytes.size());
+  const auto encoded = encode(bytes);
+
+  std::vector<float> decoded(values.size());
+  decode_base64_floats(encoded, decoded.data(), decoded.size());
+  EXPECT_EQ(decoded, values);
+
+  std::vector<float> wrong(values.size() + 1);
+  EXPECT_THROW(decode_base64_floats(encoded, wrong.data(), wrong.size()), openai::OpenAIError);
+}
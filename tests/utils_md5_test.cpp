@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "openai/utils/md5.hpp"
+
+using openai::utils::MD5;
+using openai::utils::md5_hex;
+
+TEST(UtilsMd5Test, MatchesReferenceDigests) {
+  EXPECT_EQ(md5_hex(""), "d41d8cd98f00b204e9800998ecf8427e");
+  EXPECT_EQ(md5_hex("abc"), "900150983cd24fb0d6963f7d28e17f72");
+  EXPECT_EQ(md5_hex("The quick brown fox jumps over the lazy dog"), "9e107d9d372bb6826bd81d3542a419d6");
+  EXPECT_EQ(md5_hex(std::string(56, 'a')), "3b0c8ac703f828b04c6c197006d17218");
+}
+
+TEST(UtilsMd5Test, IncrementalUpdatesMatchOneShot) {
+  std::string data(10007, '\0');
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<char>(i * 13);
+  }
+  MD5 ctx;
+  std::size_t offset = 0;
+  for (std::size_t step = 1; offset < data.size(); step = step * 5 % 211 + 1) {
+    const std::size_t count = std::min(step, data.size() - offset);
+    ctx.update(std::string_view(data).substr(offset, count));
+    offset += count;
+  }
+  EXPECT_EQ(ctx.hex_digest(), md5_hex(data));
+}
+
+TEST(UtilsMd5Test, RestoredStateContinuesTheSameHash) {
+  const std::string data = "resumable uploads hash the file across process restarts";
+  MD5 first;
+  first.update(std::string_view(data).substr(0, 21));
+  const MD5::State saved = first.state();
+  EXPECT_EQ(saved.length, 21u);
+  EXPECT_EQ(saved.pending, data.substr(0, 21));
+
+  MD5 resumed;
+  resumed.restore(saved);
+  resumed.update(std::string_view(data).substr(21));
+  EXPECT_EQ(resumed.hex_digest(), md5_hex(data));
+
+  MD5::State bad = saved;
+  bad.length = 22;
+  EXPECT_THROW(resumed.restore(bad), std::invalid_argument);
+}
@@ -5,6 +5,7 @@
 #include <sstream>
 #include <vector>
 
+#include "openai/error.hpp"
 #include "openai/utils/to_file.hpp"
 
 using openai::utils::UploadFile;
@@ -43,3 +44,43 @@ TEST(UtilsToFileTest, ReadsFromStringStream) {
   ASSERT_EQ(upload.data.size(), 11u);
   EXPECT_EQ(std::string(upload.data.begin(), upload.data.end()), "stream-data");
 }
+
+TEST(UtilsToFileTest, MapsLargeFilesInsteadOfCopying) {
+  std::filesystem::path tmp = std::filesystem::temp_directory_path() / "openai-to-file-large.bin";
+  std::string contents(openai::utils::kMapUploadThreshold + 17, '\0');
+  for (std::size_t i = 0; i < contents.size(); ++i) {
+    contents[i] = static_cast<char>(i * 31);
+  }
+  {
+    std::ofstream out(tmp, std::ios::binary);
+    out.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+  }
+
+  // to_file(path) always hands back owned bytes.
+  UploadFile owned = to_file(tmp.string());
+  EXPECT_FALSE(owned.is_borrowed());
+  EXPECT_EQ(std::string(owned.data.begin(), owned.data.end()), contents);
+
+  UploadFile copy;
+  {
+    UploadFile upload = openai::utils::open_upload_file(tmp.string());
+    EXPECT_TRUE(upload.is_borrowed());
+    EXPECT_TRUE(upload.data.empty());
+    EXPECT_EQ(upload.filename, "openai-to-file-large.bin");
+    copy = upload;
+  }
+  // The mapping stays alive as long as any copy does.
+  ASSERT_EQ(copy.size(), contents.size());
+  EXPECT_EQ(copy.bytes(), contents);
+
+  std::filesystem::remove(tmp);
+}
+
+TEST(UtilsToFileTest, BorrowsCallerBuffer) {
+  const std::string buffer = "borrowed-bytes";
+  UploadFile upload = openai::utils::borrow_file(buffer.data(), buffer.size(), "b.txt", "text/plain");
+  EXPECT_TRUE(upload.is_borrowed());
+  EXPECT_EQ(upload.bytes().data(), buffer.data());
+  EXPECT_EQ(upload.size(), buffer.size());
+  EXPECT_THROW(openai::utils::borrow_file(buffer.data(), buffer.size(), ""), openai::OpenAIError);
+}
@@ -1,11 +1,13 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <future>
 #include <map>
 #include <string>
 #include <vector>
 
 #include "openai/client.hpp"
+#include "openai/webhook_waiters.hpp"
 #include "openai/webhooks.hpp"
 #include "support/mock_http_client.hpp"
 
@@ -205,6 +207,14 @@ std::string build_signature(const std::string& secret,
   return base64_encode(digest);
 }
 
+std::map<std::string, std::string> signed_headers(const std::string& payload) {
+  const auto timestamp = std::to_string(
+      std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+  return {{"webhook-signature", "v1," + build_signature("mysecret", payload, timestamp, "wh_abc")},
+          {"webhook-timestamp", timestamp},
+          {"webhook-id", "wh_abc"}};
+}
+
 }  // namespace
 
 TEST(WebhooksResourceTest, VerifySignatureAndUnwrap) {
@@ -268,3 +278,108 @@ TEST(WebhooksResourceTest, InvalidSignatureFails) {
   EXPECT_FALSE(client.webhooks().verify_signature(payload, headers, {}));
   EXPECT_THROW(client.webhooks().unwrap(payload, headers), openai::OpenAIError);
 }
+
+TEST(WebhookWaiterRegistryTest, VerifiedDeliveryResolvesEveryWaiter) {
+  using namespace openai;
+
+  auto http = std::make_unique<openai::testing::MockHttpClient>();
+  auto* mock_ptr = http.get();
+  mock_ptr->enqueue_response(HttpResponse{
+      200,
+      {},
+      R"({"id":"batch_1","object":"batch","endpoint":"/v1/chat/completions","input_file_id":"file_1","completion_window":"24h","created_at":1700000000,"status":"completed","output_file_id":"file_out"})"});
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+  options.webhook_secret = "whsec_bXlzZWNyZXQ=";
+
+  OpenAIClient client(std::move(options), std::move(http));
+
+  WebhookWaiterOptions waiter_options;
+  waiter_options.fallback_interval = std::chrono::minutes(10);
+  WebhookWaiterRegistry registry(client, waiter_options);
+
+  auto first = registry.wait_for_batch("batch_1");
+  auto second = registry.wait_for_batch("batch_1");
+  EXPECT_EQ(registry.waiting(), 1u);
+
+  const std::string other =
+      R"({"id":"evt_1","created_at":1,"object":"event","type":"batch.completed","data":{"id":"batch_2"}})";
+  auto event = registry.deliver(other, signed_headers(other));
+  EXPECT_EQ(event.type, webhooks::EventType::BatchCompleted);
+  EXPECT_EQ(mock_ptr->call_count(), 0u);
+
+  const std::string payload =
+      R"({"id":"evt_2","created_at":1,"object":"event","type":"batch.completed","data":{"id":"batch_1"}})";
+  EXPECT_THROW(registry.deliver(payload, {{"webhook-signature", "v1,invalid"}}), OpenAIError);
+  EXPECT_EQ(registry.waiting(), 1u);
+
+  registry.deliver(payload, signed_headers(payload));
+  ASSERT_EQ(first.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+  ASSERT_EQ(second.wait_for(std::chrono::seconds(0)), std::future_status::ready);
+  const auto batch = first.get();
+  EXPECT_EQ(batch.status, "completed");
+  ASSERT_TRUE(batch.output_file_id.has_value());
+  EXPECT_EQ(*batch.output_file_id, "file_out");
+  EXPECT_EQ(second.get().id, "batch_1");
+  EXPECT_EQ(registry.waiting(), 0u);
+  EXPECT_EQ(mock_ptr->call_count(), 1u);
+  ASSERT_TRUE(mock_ptr->last_request().has_value());
+  EXPECT_NE(mock_ptr->last_request()->url.find("/batches/batch_1"), std::string::npos);
+}
+
+TEST(WebhookWaiterRegistryTest, FallbackPollCoversMissedWebhook) {
+  using namespace openai;
+
+  auto http = std::make_unique<openai::testing::MockHttpClient>();
+  auto* mock_ptr = http.get();
+  const std::string running =
+      R"({"id":"ftjob_1","created_at":1700000000,"object":"fine_tuning.job","model":"gpt-4o-mini","organization_id":"org_1","result_files":[],"seed":1,"status":"running","training_file":"file_train"})";
+  const std::string succeeded =
+      R"({"id":"ftjob_1","created_at":1700000000,"object":"fine_tuning.job","model":"gpt-4o-mini","organization_id":"org_1","result_files":[],"seed":1,"status":"succeeded","training_file":"file_train"})";
+  mock_ptr->enqueue_response(HttpResponse{200, {}, running});
+  mock_ptr->enqueue_response(HttpResponse{200, {}, succeeded});
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+
+  OpenAIClient client(std::move(options), std::move(http));
+
+  WebhookWaiterOptions waiter_options;
+  waiter_options.fallback_interval = std::chrono::milliseconds(10);
+  WebhookWaiterRegistry registry(client, waiter_options);
+
+  auto job = registry.wait_for_fine_tuning_job("ftjob_1");
+  ASSERT_EQ(job.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+  EXPECT_EQ(job.get().status, "succeeded");
+  EXPECT_EQ(mock_ptr->call_count(), 2u);
+  EXPECT_EQ(registry.waiting(), 0u);
+}
+
+TEST(WebhookWaiterRegistryTest, FallbackPollOutlastsTransientErrors) {
+  using namespace openai;
+
+  auto http = std::make_unique<openai::testing::MockHttpClient>();
+  auto* mock_ptr = http.get();
+  const std::string succeeded =
+      R"({"id":"ftjob_1","created_at":1700000000,"object":"fine_tuning.job","model":"gpt-4o-mini","organization_id":"org_1","result_files":[],"seed":1,"status":"succeeded","training_file":"file_train"})";
+  mock_ptr->enqueue_error("connection reset");
+  mock_ptr->enqueue_response(HttpResponse{502, {}, R"({"error":{"message":"bad gateway"}})"});
+  mock_ptr->enqueue_response(HttpResponse{200, {}, succeeded});
+
+  ClientOptions options;
+  options.api_key = "sk-test";
+  options.max_retries = 0;
+
+  OpenAIClient client(std::move(options), std::move(http));
+
+  WebhookWaiterOptions waiter_options;
+  waiter_options.fallback_interval = std::chrono::milliseconds(10);
+  WebhookWaiterRegistry registry(client, waiter_options);
+
+  auto job = registry.wait_for_fine_tuning_job("ftjob_1");
+  ASSERT_EQ(job.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+  EXPECT_EQ(job.get().status, "succeeded");
+  EXPECT_EQ(mock_ptr->call_count(), 3u);
+  EXPECT_EQ(registry.waiting(), 0u);
+}